@@ -0,0 +1,100 @@
+// Google Benchmark of the time a training loop is blocked by checkpointing: a synchronous
+// cgrad_storage_save against the snapshot taken by cgrad_checkpoint_save_async
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_file.h"
+#include "storage/cgrad_checkpoint.h"
+#include <stdint.h>
+#include <unistd.h>
+}
+
+#include <string>
+#include <vector>
+
+#define CGRAD_BACKEND "cpu_f32"
+#define BENCH_NUM_TENSORS 8
+
+static const char* bench_path = "/tmp/cgrad_bench_checkpoint.tensors";
+
+struct BenchParams {
+    std::vector<cgrad_storage> tensors;
+    std::vector<std::string> names;
+    std::vector<const char*> name_ptrs;
+    std::vector<const cgrad_storage*> ptrs;
+};
+
+// BENCH_NUM_TENSORS (rows, 1024) parameter matrices holding mib MiB in total
+static bool bench_init_params(benchmark::State& state, int64_t mib, BenchParams& p) {
+    cgrad_init();
+    uint32_t shape[2] = {(uint32_t)(((uint64_t)mib << 20) / (BENCH_NUM_TENSORS * 1024 * sizeof(float))), 1024};
+    p.tensors.resize(BENCH_NUM_TENSORS);
+    for (int i = 0; i < BENCH_NUM_TENSORS; i++) {
+        if (cgrad_storage_init(&p.tensors[i], shape, 2, CGRAD_BACKEND) || cgrad_storage_fill_rand(&p.tensors[i])) {
+            state.SkipWithError("Failed to initialize tensors");
+            return false;
+        }
+        p.names.push_back("layer" + std::to_string(i) + ".weight");
+    }
+    for (int i = 0; i < BENCH_NUM_TENSORS; i++) {
+        p.name_ptrs.push_back(p.names[i].c_str());
+        p.ptrs.push_back(&p.tensors[i]);
+    }
+    state.SetBytesProcessed(0);
+    return true;
+}
+
+static void bench_cleanup(BenchParams& p) {
+    for (auto& t : p.tensors) cgrad_storage_free(&t);
+    unlink(bench_path);
+    cgrad_cleanup();
+}
+
+// The loop is blocked until the file is written
+static void BM_CheckpointSaveSync(benchmark::State& state) {
+    BenchParams p;
+    if (bench_init_params(state, state.range(0), p)) {
+        for (auto _ : state) {
+            if (cgrad_storage_save(bench_path, p.name_ptrs.data(), p.ptrs.data(), BENCH_NUM_TENSORS) != CGRAD_SUCCESS) {
+                state.SkipWithError("save failed");
+                break;
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+    }
+    bench_cleanup(p);
+}
+
+// The loop is blocked for the snapshot only; the background write (including fsync) is
+// awaited outside the timed region, as the next training steps would overlap with it
+static void BM_CheckpointSaveAsync(benchmark::State& state) {
+    BenchParams p;
+    if (bench_init_params(state, state.range(0), p)) {
+        double throughput = 0.0;
+        for (auto _ : state) {
+            cgrad_checkpoint* ckpt = NULL;
+            if (cgrad_checkpoint_save_async(bench_path, p.name_ptrs.data(), p.ptrs.data(), BENCH_NUM_TENSORS, &ckpt) != CGRAD_SUCCESS) {
+                state.SkipWithError("save_async failed");
+                break;
+            }
+            state.PauseTiming();
+            cgrad_checkpoint_stats stats;
+            if (cgrad_checkpoint_wait(ckpt, &stats) != CGRAD_SUCCESS) state.SkipWithError("background write failed");
+            throughput += stats.throughput;
+            cgrad_checkpoint_free(ckpt);
+            state.ResumeTiming();
+        }
+        state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+        state.counters["write_MiB/s"] = state.iterations() ? throughput / state.iterations() / (1 << 20) : 0.0;
+    }
+    bench_cleanup(p);
+}
+
+// Checkpoint sizes from 16 MiB to 256 MiB
+BENCHMARK(BM_CheckpointSaveSync)->ArgName("MiB")->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CheckpointSaveAsync)->ArgName("MiB")->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
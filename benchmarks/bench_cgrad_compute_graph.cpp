@@ -0,0 +1,234 @@
+// Google Benchmark of the compute graph bookkeeping on graphs of 1x1 tensors, where the math is
+// negligible: node creation, forward execution (topological sort and dispatch), backward
+// dispatch and recursive teardown through reference counting. Every benchmark reports the cost
+// per node ("per_node", in seconds) so the overhead can be tracked across versions.
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_compute_graph.h"
+#include "autograd/cgrad_ops.h"
+#include "storage/cgrad_storage.h"
+#include <stdint.h>
+#include <uuid/uuid.h>
+}
+
+#include <vector>
+
+#define CGRAD_BACKEND "cpu_f32"
+
+// uuid_t is an array and cannot be stored in a std::vector directly
+struct NodeId {
+    uuid_t id;
+};
+
+struct GraphBench {
+    cgrad_compute_graph graph = {};
+    cgrad_storage value = {};           // 1x1 storage shared by all leaves
+    cgrad_storage_layout layout = {};
+    cgrad_op_info axpy = {};
+    uuid_t constant;                    // leaf feeding the first input of single-column graphs
+    bool ready = false;
+};
+
+static bool graph_bench_init(benchmark::State& state, GraphBench& b) {
+    cgrad_init();
+    uint32_t shape[2] = {1, 1};
+    if (cgrad_storage_init(&b.value, shape, 2, CGRAD_BACKEND) || cgrad_storage_fill(&b.value, 1.0f)
+        || cgrad_compute_graph_create(&b.graph)) {
+        state.SkipWithError("Failed to initialize graph");
+        return false;
+    }
+    b.layout = *b.value.backend->storage_get_layout(b.value.data);
+    b.axpy.descriptor = &cgrad_op_axpy;
+    b.axpy.metadata.axpy.alpha = 1.0f;
+    b.ready = true;
+    return true;
+}
+
+static void graph_bench_cleanup(GraphBench& b) {
+    if (b.ready) cgrad_compute_graph_free(&b.graph);
+    if (b.value.data) cgrad_storage_free(&b.value);
+    cgrad_cleanup();
+}
+
+// Per-iteration node count, reported as throughput and as time per node
+static void graph_bench_report(benchmark::State& state, int64_t nodes) {
+    state.SetItemsProcessed(state.iterations() * nodes);
+    state.counters["per_node"] = benchmark::Counter(
+        (double)nodes, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+    );
+}
+
+static cgrad_status graph_bench_add_leaf(GraphBench& b, uuid_t out) {
+    return cgrad_compute_graph_add_leaf(&b.graph, &b.layout, &b.value, out);
+}
+
+// out = x + y
+static cgrad_status graph_bench_add_op(GraphBench& b, const uuid_t x, const uuid_t y, uuid_t out) {
+    uuid_t inputs[2];
+    uuid_copy(inputs[0], x);
+    uuid_copy(inputs[1], y);
+    return cgrad_compute_graph_add_op(&b.graph, &b.axpy, &b.layout, inputs, 2, out);
+}
+
+// Chain of n ops over one leaf: ids[0] is the leaf, ids[i] = ids[0] + ids[i - 1]
+static cgrad_status graph_bench_build_chain(GraphBench& b, int n, std::vector<NodeId>& ids) {
+    ids.resize(n + 1);
+    cgrad_status err = graph_bench_add_leaf(b, ids[0].id);
+    for (int i = 1; i <= n && err == CGRAD_SUCCESS; i++) {
+        err = graph_bench_add_op(b, ids[0].id, ids[i - 1].id, ids[i].id);
+    }
+    return err;
+}
+
+// Release the references held by the builder, last node first: every release frees one node
+static void graph_bench_release(GraphBench& b, std::vector<NodeId>& ids) {
+    for (size_t i = ids.size(); i-- > 0;) cgrad_compute_graph_decrement_ref(&b.graph, ids[i].id);
+    ids.clear();
+}
+
+// Graph of the given width and depth: a layer of width leaves, depth layers of width ops
+// node[l][i] = node[l - 1][i + 1 mod width] + node[l - 1][i], and a chain summing up the last
+// layer into a single target. Returns the ids of all nodes, the target last.
+static cgrad_status graph_bench_build_grid(GraphBench& b, int width, int depth, std::vector<NodeId>& ids) {
+    ids.resize((size_t)width * (depth + 1) + (width - 1));
+    cgrad_status err = CGRAD_SUCCESS;
+    for (int i = 0; i < width && err == CGRAD_SUCCESS; i++) err = graph_bench_add_leaf(b, ids[i].id);
+    for (int l = 1; l <= depth && err == CGRAD_SUCCESS; l++) {
+        const NodeId* prev = &ids[(size_t)(l - 1) * width];
+        NodeId* cur = &ids[(size_t)l * width];
+        for (int i = 0; i < width && err == CGRAD_SUCCESS; i++) {
+            err = graph_bench_add_op(b, width > 1 ? prev[(i + 1) % width].id : b.constant, prev[i].id, cur[i].id);
+        }
+    }
+    const NodeId* last = &ids[(size_t)depth * width];
+    NodeId* sums = &ids[(size_t)width * (depth + 1)];
+    for (int i = 1; i < width && err == CGRAD_SUCCESS; i++) {
+        err = graph_bench_add_op(b, last[i].id, i == 1 ? last[0].id : sums[i - 2].id, sums[i - 1].id);
+    }
+    return err;
+}
+
+// ============================================================================
+// Node creation
+// ============================================================================
+
+// Args: leaves added per iteration
+static void BM_GraphAddLeaf(benchmark::State& state) {
+    GraphBench b;
+    int n = (int)state.range(0);
+    std::vector<NodeId> ids(n);
+    if (graph_bench_init(state, b)) {
+        for (auto _ : state) {
+            for (int i = 0; i < n; i++) graph_bench_add_leaf(b, ids[i].id);
+            state.PauseTiming();
+            for (int i = 0; i < n; i++) cgrad_compute_graph_decrement_ref(&b.graph, ids[i].id);
+            state.ResumeTiming();
+        }
+        graph_bench_report(state, n);
+    }
+    graph_bench_cleanup(b);
+}
+
+// Args: ops added per iteration (as a chain over one leaf)
+static void BM_GraphAddOp(benchmark::State& state) {
+    GraphBench b;
+    int n = (int)state.range(0);
+    std::vector<NodeId> ids(n + 1);
+    if (graph_bench_init(state, b)) {
+        for (auto _ : state) {
+            state.PauseTiming();
+            graph_bench_add_leaf(b, ids[0].id);
+            state.ResumeTiming();
+            for (int i = 1; i <= n; i++) graph_bench_add_op(b, ids[0].id, ids[i - 1].id, ids[i].id);
+            state.PauseTiming();
+            graph_bench_release(b, ids);
+            ids.resize(n + 1);
+            state.ResumeTiming();
+        }
+        graph_bench_report(state, n);
+    }
+    graph_bench_cleanup(b);
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+// Args: width, depth
+static void BM_GraphForward(benchmark::State& state) {
+    GraphBench b;
+    int width = (int)state.range(0), depth = (int)state.range(1);
+    std::vector<NodeId> ids;
+    if (graph_bench_init(state, b)) {
+        if (graph_bench_add_leaf(b, b.constant) || graph_bench_build_grid(b, width, depth, ids)
+            || cgrad_compute_graph_forward(&b.graph, ids.back().id)) {
+            state.SkipWithError("Failed to build graph");
+        } else {
+            for (auto _ : state) {
+                state.PauseTiming();
+                cgrad_compute_graph_invalidate(&b.graph, ids.back().id);
+                state.ResumeTiming();
+                cgrad_compute_graph_forward(&b.graph, ids.back().id);
+            }
+            graph_bench_report(state, (int64_t)(ids.size() - width));
+        }
+    }
+    graph_bench_cleanup(b);
+}
+
+// Args: width, depth
+static void BM_GraphBackward(benchmark::State& state) {
+    GraphBench b;
+    int width = (int)state.range(0), depth = (int)state.range(1);
+    std::vector<NodeId> ids;
+    if (graph_bench_init(state, b)) {
+        if (graph_bench_add_leaf(b, b.constant) || graph_bench_build_grid(b, width, depth, ids)
+            || cgrad_compute_graph_forward(&b.graph, ids.back().id)
+            || cgrad_compute_graph_backward(&b.graph, ids.back().id)) {
+            state.SkipWithError("Failed to build graph");
+        } else {
+            for (auto _ : state) {
+                cgrad_compute_graph_backward(&b.graph, ids.back().id);
+            }
+            graph_bench_report(state, (int64_t)(ids.size() - width));
+        }
+    }
+    graph_bench_cleanup(b);
+}
+
+// ============================================================================
+// Teardown
+// ============================================================================
+
+// Free a chain of executed nodes by releasing its last node: every node is only referenced by
+// its consumer, so the release cascades through cgrad_compute_graph_decrement_ref down to the leaf.
+// Args: chain length
+static void BM_GraphTeardown(benchmark::State& state) {
+    GraphBench b;
+    int n = (int)state.range(0);
+    std::vector<NodeId> ids;
+    if (graph_bench_init(state, b)) {
+        for (auto _ : state) {
+            state.PauseTiming();
+            graph_bench_build_chain(b, n, ids);
+            cgrad_compute_graph_forward(&b.graph, ids.back().id);
+            for (int i = 0; i < n; i++) cgrad_compute_graph_decrement_ref(&b.graph, ids[i].id);
+            state.ResumeTiming();
+            cgrad_compute_graph_decrement_ref(&b.graph, ids.back().id);
+        }
+        graph_bench_report(state, n + 1);
+    }
+    graph_bench_cleanup(b);
+}
+
+BENCHMARK(BM_GraphAddLeaf)->ArgName("nodes")->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK(BM_GraphAddOp)->ArgName("nodes")->RangeMultiplier(8)->Range(8, 512);
+// topological sorts are limited to MAX_GRAPH_NODES nodes
+BENCHMARK(BM_GraphForward)->ArgNames({"width", "depth"})->ArgsProduct({{1, 4, 16}, {4, 16, 48}});
+BENCHMARK(BM_GraphBackward)->ArgNames({"width", "depth"})->ArgsProduct({{1, 4, 16}, {4, 16, 48}});
+BENCHMARK(BM_GraphTeardown)->ArgName("nodes")->RangeMultiplier(8)->Range(8, 512);
+
+BENCHMARK_MAIN();
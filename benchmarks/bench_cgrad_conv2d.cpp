@@ -0,0 +1,142 @@
+// Google Benchmark comparison of the conv2d lowerings (im2col + GEMM vs. implicit GEMM)
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include <stdint.h>
+}
+
+#define CGRAD_BACKEND "cpu_f32"
+
+// Common convolution shapes (batch of 8, ResNet-style layers)
+struct conv2d_bench_shape {
+    const char* name;
+    uint32_t n, c, h, w, o, k, stride, padding;
+};
+
+static const conv2d_bench_shape conv2d_bench_shapes[] = {
+    {"stem_7x7_s2",    8,   3, 224, 224,  64, 7, 2, 3},
+    {"3x3_c64_56x56",  8,  64,  56,  56,  64, 3, 1, 1},
+    {"3x3_c256_14x14", 8, 256,  14,  14, 256, 3, 1, 1},
+    {"3x3_c128_s2",    8, 128,  56,  56, 128, 3, 2, 1},
+    {"1x1_c128_28x28", 8, 128,  28,  28, 512, 1, 1, 0},
+};
+
+struct conv2d_bench_fixture {
+    cgrad_storage x, w, y, grad_y, grad_x, grad_w;
+    cgrad_conv2d_params params;
+    double flops;
+};
+
+static bool conv2d_bench_setup(benchmark::State& state, const conv2d_bench_shape& s, conv2d_bench_fixture& f, bool backward) {
+    cgrad_init();
+
+    f.params = cgrad_conv2d_params{};
+    f.params.stride[0] = f.params.stride[1] = s.stride;
+    f.params.padding[0] = f.params.padding[1] = s.padding;
+    f.params.dilation[0] = f.params.dilation[1] = 1;
+
+    uint32_t oh = (s.h + 2 * s.padding - s.k) / s.stride + 1;
+    uint32_t ow = (s.w + 2 * s.padding - s.k) / s.stride + 1;
+    uint32_t x_shape[4] = {s.n, s.c, s.h, s.w};
+    uint32_t w_shape[4] = {s.o, s.c, s.k, s.k};
+    uint32_t y_shape[4] = {s.n, s.o, oh, ow};
+
+    if (
+        cgrad_storage_init(&f.x, x_shape, 4, CGRAD_BACKEND)
+        || cgrad_storage_init(&f.w, w_shape, 4, CGRAD_BACKEND)
+        || cgrad_storage_init(&f.y, y_shape, 4, CGRAD_BACKEND)
+    ) {
+        state.SkipWithError("Failed to initialize tensors for conv2d");
+        return false;
+    }
+    cgrad_storage_fill_rand(&f.x);
+    cgrad_storage_fill_rand(&f.w);
+
+    if (backward) {
+        if (
+            cgrad_storage_init(&f.grad_y, y_shape, 4, CGRAD_BACKEND)
+            || cgrad_storage_init(&f.grad_x, x_shape, 4, CGRAD_BACKEND)
+            || cgrad_storage_init(&f.grad_w, w_shape, 4, CGRAD_BACKEND)
+        ) {
+            state.SkipWithError("Failed to initialize gradients for conv2d");
+            return false;
+        }
+        cgrad_storage_fill_rand(&f.grad_y);
+        cgrad_storage_fill(&f.grad_x, 0.0f);
+        cgrad_storage_fill(&f.grad_w, 0.0f);
+    }
+
+    f.flops = 2.0 * s.n * s.o * oh * ow * s.c * s.k * s.k;
+    state.SetLabel(s.name);
+    return true;
+}
+
+static void BM_Conv2dForward(benchmark::State& state) {
+    cgrad_conv2d_algo algo = static_cast<cgrad_conv2d_algo>(state.range(0));
+    const conv2d_bench_shape& s = conv2d_bench_shapes[state.range(1)];
+
+    conv2d_bench_fixture f;
+    if (!conv2d_bench_setup(state, s, f, false)) {
+        cgrad_cleanup();
+        return;
+    }
+
+    for (auto _ : state) {
+        int err = cgrad_storage_conv2d(algo, &f.params, &f.x, &f.w, &f.y);
+        if (err != CGRAD_SUCCESS) {
+            state.SkipWithError("conv2d failed");
+            break;
+        }
+    }
+    state.counters["FLOPS"] = benchmark::Counter(f.flops, benchmark::Counter::kIsIterationInvariantRate);
+
+    cgrad_cleanup();
+}
+
+static void BM_Conv2dBackward(benchmark::State& state) {
+    const conv2d_bench_shape& s = conv2d_bench_shapes[state.range(0)];
+
+    conv2d_bench_fixture f;
+    if (!conv2d_bench_setup(state, s, f, true)) {
+        cgrad_cleanup();
+        return;
+    }
+
+    for (auto _ : state) {
+        int err = cgrad_storage_conv2d_backward(&f.params, &f.x, &f.w, &f.grad_y, &f.grad_x, &f.grad_w);
+        if (err != CGRAD_SUCCESS) {
+            state.SkipWithError("conv2d backward failed");
+            break;
+        }
+    }
+    state.counters["FLOPS"] = benchmark::Counter(2.0 * f.flops, benchmark::Counter::kIsIterationInvariantRate);
+
+    cgrad_cleanup();
+}
+
+static const int conv2d_bench_num_shapes = sizeof(conv2d_bench_shapes) / sizeof(conv2d_bench_shapes[0]);
+
+// Register forward for (algo, shape) pairs
+static void conv2d_forward_args(benchmark::internal::Benchmark* b) {
+    for (int s = 0; s < conv2d_bench_num_shapes; s++) {
+        b->Args({CGRAD_CONV2D_IM2COL, s});
+        b->Args({CGRAD_CONV2D_IMPLICIT_GEMM, s});
+    }
+}
+BENCHMARK(BM_Conv2dForward)
+    ->ArgNames({"algo", "shape"})
+    ->Apply(conv2d_forward_args)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Register backward for every shape
+BENCHMARK(BM_Conv2dBackward)
+    ->ArgName("shape")
+    ->DenseRange(0, conv2d_bench_num_shapes - 1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,100 @@
+// Google Benchmark of feeding mini-batches: hand-filling a tensor element by element from the
+// dataset records against the prefetching data loader
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "data/cgrad_data_loader.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+}
+
+#include <vector>
+
+#define BENCH_SAMPLES 16384
+#define BENCH_FEATURES 784
+
+static const char* bench_path = "/tmp/cgrad_bench_data_loader.data";
+
+// Dataset of BENCH_SAMPLES records with BENCH_FEATURES inputs and one target each
+static bool bench_write_dataset(benchmark::State& state, std::vector<float>& records) {
+    size_t record = BENCH_FEATURES + 1;
+    records.resize((size_t)BENCH_SAMPLES * record);
+    for (size_t i = 0; i < records.size(); i++) records[i] = (float)(i % 251);
+    FILE* f = fopen(bench_path, "wb");
+    bool ok = f && fwrite(records.data(), sizeof(float), records.size(), f) == records.size();
+    if (f) fclose(f);
+    if (!ok) state.SkipWithError("Failed to write dataset");
+    return ok;
+}
+
+// Set every element of the batch storage from the records in memory
+static void BM_BatchManualFill(benchmark::State& state) {
+    cgrad_init();
+    std::vector<float> records;
+    uint32_t batch_size = (uint32_t)state.range(0);
+    uint32_t shape[2] = {batch_size, BENCH_FEATURES};
+    cgrad_storage inputs;
+    if (bench_write_dataset(state, records) && cgrad_storage_init(&inputs, shape, 2, "cpu_f32") == CGRAD_SUCCESS) {
+        uint64_t batch = 0;
+        uint64_t num_batches = BENCH_SAMPLES / batch_size;
+        for (auto _ : state) {
+            for (uint32_t i = 0; i < batch_size; i++) {
+                const float* record = &records[((batch % num_batches) * batch_size + i) * (BENCH_FEATURES + 1)];
+                for (uint32_t j = 0; j < BENCH_FEATURES; j++) {
+                    uint32_t idx[2] = {i, j};
+                    inputs.backend->storage_set(inputs.data, idx, 2, record[j]);
+                }
+            }
+            batch++;
+        }
+        state.SetItemsProcessed(state.iterations() * batch_size);
+        cgrad_storage_free(&inputs);
+    }
+    unlink(bench_path);
+    cgrad_cleanup();
+}
+
+// Shuffled batches assembled by the loader workers into the ring buffers
+static void BM_BatchDataLoader(benchmark::State& state) {
+    cgrad_init();
+    std::vector<float> records;
+    uint32_t batch_size = (uint32_t)state.range(0);
+    cgrad_data_loader* loader = NULL;
+    if (bench_write_dataset(state, records)) {
+        cgrad_data_loader_config config;
+        cgrad_data_loader_config_init(&config);
+        config.path = bench_path;
+        config.input_shape[0] = BENCH_FEATURES;
+        config.input_ndim = 1;
+        config.target_shape[0] = 1;
+        config.target_ndim = 1;
+        config.batch_size = batch_size;
+        config.shuffle = 1;
+        config.num_buffers = 4;
+        if (cgrad_data_loader_create(&config, &loader) != CGRAD_SUCCESS) {
+            state.SkipWithError("Failed to create data loader");
+        } else {
+            cgrad_data_batch batch;
+            for (auto _ : state) {
+                if (cgrad_data_loader_next(loader, &batch) != CGRAD_SUCCESS) {
+                    state.SkipWithError("next failed");
+                    break;
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * batch_size);
+        }
+    }
+    cgrad_data_loader_free(loader);
+    unlink(bench_path);
+    cgrad_cleanup();
+}
+
+// Batch sizes from 32 to 512 samples
+BENCHMARK(BM_BatchManualFill)->ArgName("batch")->RangeMultiplier(4)->Range(32, 512)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_BatchDataLoader)->ArgName("batch")->RangeMultiplier(4)->Range(32, 512)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,215 @@
+// Google Benchmark of a full training step of an MLP on the autograd API: forward pass through
+// cgrad_tensor_gemm / add / relu / reduce_sum, backward pass, optimizer step and freeing the graph.
+// Besides steps per second it reports where the time goes beyond the math:
+//   outside_blas     share of the step spent outside the backend's gemm (i.e. in graph
+//                    bookkeeping, elementwise ops, allocation and the update)
+//   allocs_per_step  storages allocated by the backend per step
+//   peak_rss_MiB     peak resident set size of the process so far
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "storage/cgrad_storage.h"
+#include "backends/cgrad_backend.h"
+#include "backends/cgrad_backend_registry.h"
+#include "optim/cgrad_param_group.h"
+#include "optim/cgrad_optimizer.h"
+#include <stdint.h>
+#include <sys/resource.h>
+}
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#define CGRAD_BACKEND "cpu_f32"
+
+// ============================================================================
+// Backend instrumentation
+// ============================================================================
+
+// Time spent in gemm and number of storages allocated, counted by wrapping the backend's ops
+static struct {
+    cgrad_backend* backend;
+    int (*storage_init)(void* t, const uint32_t* shape, int ndim);
+    int (*storage_gemm)(float alpha, void* a, void* b, float beta, void* c);
+    double gemm_seconds;
+    int64_t allocs;
+} mlp_probe;
+
+static int mlp_probe_init(void* t, const uint32_t* shape, int ndim) {
+    mlp_probe.allocs++;
+    return mlp_probe.storage_init(t, shape, ndim);
+}
+
+static int mlp_probe_gemm(float alpha, void* a, void* b, float beta, void* c) {
+    auto start = std::chrono::steady_clock::now();
+    int err = mlp_probe.storage_gemm(alpha, a, b, beta, c);
+    mlp_probe.gemm_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return err;
+}
+
+static void mlp_probe_install(void) {
+    mlp_probe.backend = cgrad_get_backend(CGRAD_BACKEND);
+    mlp_probe.storage_init = mlp_probe.backend->storage_init;
+    mlp_probe.storage_gemm = mlp_probe.backend->storage_gemm;
+    mlp_probe.backend->storage_init = mlp_probe_init;
+    mlp_probe.backend->storage_gemm = mlp_probe_gemm;
+    mlp_probe.gemm_seconds = 0.0;
+    mlp_probe.allocs = 0;
+}
+
+static void mlp_probe_remove(void) {
+    mlp_probe.backend->storage_init = mlp_probe.storage_init;
+    mlp_probe.backend->storage_gemm = mlp_probe.storage_gemm;
+}
+
+// ============================================================================
+// Model
+// ============================================================================
+
+// layers x (W: (width, width), b: (width)) in one parameter group, and an input batch
+struct MlpModel {
+    int layers = 0;
+    cgrad_param_group* group = NULL;
+    cgrad_optimizer* opt = NULL;
+    cgrad_tensor x = {};
+    bool has_x = false;
+};
+
+static bool mlp_init(benchmark::State& state, int layers, uint32_t batch, uint32_t width, MlpModel& m) {
+    cgrad_init();
+    m.layers = layers;
+    uint32_t w_shape[2] = {width, width};
+    uint32_t b_shape[1] = {width};
+    std::vector<const uint32_t*> shapes;
+    std::vector<int> ndims;
+    for (int l = 0; l < layers; l++) {
+        shapes.push_back(w_shape);
+        ndims.push_back(2);
+        shapes.push_back(b_shape);
+        ndims.push_back(1);
+    }
+
+    // weights uniform in [0, 1 / sqrt(width)) keep the activations in range over all layers
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_SGD);
+    config.lr = 1e-9f;
+    cgrad_storage* flat = NULL;
+    cgrad_storage* flat_ptr[1];
+    uint32_t x_shape[2] = {batch, width};
+    if (cgrad_param_group_create(shapes.data(), ndims.data(), 2 * layers, CGRAD_BACKEND, &m.group)
+        || !(flat = cgrad_param_group_get_flat(m.group))
+        || cgrad_storage_fill_rand(flat)
+        || (flat_ptr[0] = flat, cgrad_storage_scale(1, flat_ptr, 1.0f / std::sqrt((float)width)))
+        || cgrad_optimizer_create_for_group(&config, m.group, &m.opt)
+        || cgrad_tensor_init(&m.x, x_shape, 2, CGRAD_BACKEND)
+        || !(m.has_x = true)
+        || cgrad_tensor_fill_rand(&m.x)
+        || cgrad_tensor_set_requires_grad(&m.x, 0)) {
+        state.SkipWithError("Failed to initialize model");
+        return false;
+    }
+    return true;
+}
+
+static void mlp_cleanup(MlpModel& m) {
+    if (m.has_x) cgrad_tensor_free(&m.x);
+    cgrad_optimizer_free(m.opt);
+    cgrad_param_group_free(m.group);
+    cgrad_cleanup();
+}
+
+// Forward pass, backward pass, update and release of all intermediate tensors
+static cgrad_status mlp_step(MlpModel& m, std::vector<cgrad_tensor>& nodes) {
+    cgrad_tensor* params = cgrad_param_group_get_params(m.group);
+    cgrad_status err = CGRAD_SUCCESS;
+    nodes.clear();
+
+    const cgrad_tensor* h = &m.x;
+    for (int l = 0; l < m.layers && err == CGRAD_SUCCESS; l++) {
+        cgrad_tensor z, a;
+        err = cgrad_tensor_gemm(h, &params[2 * l], &z);
+        if (err != CGRAD_SUCCESS) break;
+        nodes.push_back(z);
+        err = cgrad_tensor_add(&nodes.back(), &params[2 * l + 1], &a);
+        if (err != CGRAD_SUCCESS) break;
+        nodes.push_back(a);
+        if (l < m.layers - 1) {
+            cgrad_tensor r;
+            err = cgrad_tensor_relu(&nodes.back(), &r);
+            if (err != CGRAD_SUCCESS) break;
+            nodes.push_back(r);
+        }
+        h = &nodes.back();
+    }
+
+    uint8_t mask[2] = {1, 1};
+    cgrad_tensor loss;
+    if (err == CGRAD_SUCCESS) err = cgrad_tensor_reduce_sum(h, mask, 2, &loss);
+    if (err == CGRAD_SUCCESS) {
+        nodes.push_back(loss);
+        err = cgrad_tensor_backward(&nodes.back());
+    }
+    if (err == CGRAD_SUCCESS) err = cgrad_optimizer_step(m.opt);
+    if (err == CGRAD_SUCCESS) err = cgrad_optimizer_zero_grad(m.opt);
+
+    for (size_t i = nodes.size(); i-- > 0;) {
+        cgrad_status free_err = cgrad_tensor_free(&nodes[i]);
+        if (err == CGRAD_SUCCESS) err = free_err;
+    }
+    return err;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+// Args: layers, batch size, width
+static void BM_MlpTrainStep(benchmark::State& state) {
+    MlpModel m;
+    int layers = (int)state.range(0);
+    uint32_t batch = (uint32_t)state.range(1), width = (uint32_t)state.range(2);
+    if (mlp_init(state, layers, batch, width, m)) {
+        std::vector<cgrad_tensor> nodes;
+        nodes.reserve(4 * layers + 1);
+
+        // one untimed step for lazily allocated gradients
+        if (mlp_step(m, nodes) != CGRAD_SUCCESS) {
+            state.SkipWithError("Training step failed");
+        } else {
+            mlp_probe_install();
+            auto start = std::chrono::steady_clock::now();
+            for (auto _ : state) {
+                if (mlp_step(m, nodes) != CGRAD_SUCCESS) {
+                    state.SkipWithError("Training step failed");
+                    break;
+                }
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            mlp_probe_remove();
+
+            // forward 2 * batch * width^2 per layer, backward twice that
+            double flops = 6.0 * layers * batch * (double)width * width;
+            state.counters["steps"] = benchmark::Counter(1.0, benchmark::Counter::kIsIterationInvariantRate);
+            state.counters["FLOPS"] = benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::kIs1000);
+            state.counters["outside_blas"] = seconds > 0.0 ? 1.0 - mlp_probe.gemm_seconds / seconds : 0.0;
+            state.counters["allocs_per_step"] = benchmark::Counter((double)mlp_probe.allocs, benchmark::Counter::kAvgIterations);
+
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            state.counters["peak_rss_MiB"] = (double)usage.ru_maxrss / 1024.0;
+        }
+    }
+    mlp_cleanup(m);
+}
+
+// 3 and 5 layers; small batches and widths are dominated by per-node overhead
+BENCHMARK(BM_MlpTrainStep)
+    ->ArgNames({"layers", "batch", "width"})
+    ->ArgsProduct({{3, 5}, {1, 32, 256}, {64, 256, 1024}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,173 @@
+// Google Benchmark of a parameter update over many tensors: one cgrad_storage_axpy per tensor
+// against the fused multi-tensor kernels behind cgrad_storage_optim_step, and per-tensor
+// gradient clipping against cgrad_storage_clip_grad_norm
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "backends/cgrad_backend.h"
+#include <stdint.h>
+}
+
+#include <vector>
+
+#define CGRAD_BACKEND "cpu_f32"
+#define BENCH_TOTAL_ELEMENTS (1u << 22)
+
+struct BenchModel {
+    int n = 0;
+    std::vector<cgrad_storage> params, grads, m, v;
+    std::vector<cgrad_storage*> param_ptrs, m_ptrs, v_ptrs;
+    std::vector<const cgrad_storage*> grad_ptrs;
+};
+
+// n parameter vectors holding BENCH_TOTAL_ELEMENTS floats in total, with gradients and state
+static bool bench_init_model(benchmark::State& state, int n, BenchModel& b) {
+    cgrad_init();
+    uint32_t shape[1] = {BENCH_TOTAL_ELEMENTS / (uint32_t)n};
+    b.n = n;
+    b.params.resize(n);
+    b.grads.resize(n);
+    b.m.resize(n);
+    b.v.resize(n);
+    for (int i = 0; i < n; i++) {
+        if (cgrad_storage_init(&b.params[i], shape, 1, CGRAD_BACKEND) || cgrad_storage_fill_rand(&b.params[i])
+            || cgrad_storage_init(&b.grads[i], shape, 1, CGRAD_BACKEND) || cgrad_storage_fill_rand(&b.grads[i])
+            || cgrad_storage_init(&b.m[i], shape, 1, CGRAD_BACKEND) || cgrad_storage_fill(&b.m[i], 0.0f)
+            || cgrad_storage_init(&b.v[i], shape, 1, CGRAD_BACKEND) || cgrad_storage_fill(&b.v[i], 0.0f)) {
+            state.SkipWithError("Failed to initialize tensors");
+            return false;
+        }
+        b.param_ptrs.push_back(&b.params[i]);
+        b.grad_ptrs.push_back(&b.grads[i]);
+        b.m_ptrs.push_back(&b.m[i]);
+        b.v_ptrs.push_back(&b.v[i]);
+    }
+    return true;
+}
+
+static void bench_cleanup(BenchModel& b) {
+    for (int i = 0; i < b.n; i++) {
+        cgrad_storage_free(&b.params[i]);
+        cgrad_storage_free(&b.grads[i]);
+        cgrad_storage_free(&b.m[i]);
+        cgrad_storage_free(&b.v[i]);
+    }
+    cgrad_cleanup();
+}
+
+static cgrad_optim_update bench_update(cgrad_optim_kind kind) {
+    cgrad_optim_update u = {};
+    u.kind = kind;
+    u.lr = 1e-3f;
+    u.momentum = 0.9f;
+    u.beta1 = 0.9f;
+    u.beta2 = 0.999f;
+    u.eps = 1e-8f;
+    u.weight_decay = kind == CGRAD_OPTIM_ADAMW ? 1e-2f : 0.0f;
+    u.bias_correction1 = 0.1f;
+    u.bias_correction2 = 0.001f;
+    return u;
+}
+
+// Plain SGD as a loop of per-tensor storage ops
+static void BM_SgdAxpyLoop(benchmark::State& state) {
+    BenchModel b;
+    if (bench_init_model(state, (int)state.range(0), b)) {
+        for (auto _ : state) {
+            for (int i = 0; i < b.n; i++) {
+                cgrad_storage_axpy(-1e-3f, &b.grads[i], &b.params[i], &b.params[i]);
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * (int64_t)BENCH_TOTAL_ELEMENTS * 3 * sizeof(float));
+    }
+    bench_cleanup(b);
+}
+
+// Plain SGD as a single fused multi-tensor step
+static void BM_SgdFused(benchmark::State& state) {
+    BenchModel b;
+    if (bench_init_model(state, (int)state.range(0), b)) {
+        cgrad_optim_update u = bench_update(CGRAD_OPTIM_SGD);
+        u.momentum = 0.0f;
+        for (auto _ : state) {
+            cgrad_storage_optim_step(&u, b.n, b.param_ptrs.data(), b.grad_ptrs.data(), NULL, NULL);
+        }
+        state.SetBytesProcessed(state.iterations() * (int64_t)BENCH_TOTAL_ELEMENTS * 3 * sizeof(float));
+    }
+    bench_cleanup(b);
+}
+
+// SGD with momentum, Adam and AdamW as fused steps (bytes: read p, g and state, write p and state)
+static void BM_OptimFused(benchmark::State& state, cgrad_optim_kind kind, int num_states) {
+    BenchModel b;
+    if (bench_init_model(state, (int)state.range(0), b)) {
+        cgrad_optim_update u = bench_update(kind);
+        for (auto _ : state) {
+            cgrad_storage_optim_step(
+                &u, b.n, b.param_ptrs.data(), b.grad_ptrs.data(),
+                b.m_ptrs.data(), num_states > 1 ? b.v_ptrs.data() : NULL
+            );
+        }
+        state.SetBytesProcessed(state.iterations() * (int64_t)BENCH_TOTAL_ELEMENTS * (3 + 2 * num_states) * sizeof(float));
+    }
+    bench_cleanup(b);
+}
+
+// Global norm clipping with per-tensor storage ops: square, reduce and read back every gradient,
+// then rescale each one with an axpy
+static void BM_ClipGradNormPerTensor(benchmark::State& state) {
+    BenchModel b;
+    if (bench_init_model(state, (int)state.range(0), b)) {
+        uint8_t mask[1] = {1};
+        uint32_t first[1] = {0};
+        for (auto _ : state) {
+            double sum = 0.0;
+            for (int i = 0; i < b.n; i++) {
+                cgrad_storage sq = {}, total = {};
+                cgrad_storage_mul(1.0f, &b.grads[i], &b.grads[i], 0.0f, &sq);
+                cgrad_storage_reduce(1.0f, &sq, mask, 1, 0.0f, &total);
+                float value = 0.0f;
+                cgrad_storage_get(&total, first, 1, &value);
+                sum += value;
+                cgrad_storage_free(&total);
+                cgrad_storage_free(&sq);
+            }
+            // a threshold just below the norm keeps the gradients at a constant scale
+            float scale = 1.0f - 1e-7f;
+            benchmark::DoNotOptimize(sum);
+            for (int i = 0; i < b.n; i++) cgrad_storage_axpy(scale - 1.0f, &b.grads[i], &b.grads[i], &b.grads[i]);
+        }
+        state.SetBytesProcessed(state.iterations() * (int64_t)BENCH_TOTAL_ELEMENTS * 3 * sizeof(float));
+    }
+    bench_cleanup(b);
+}
+
+// Global norm clipping as one reduction pass and one scaling pass over all gradients
+static void BM_ClipGradNormFused(benchmark::State& state) {
+    BenchModel b;
+    if (bench_init_model(state, (int)state.range(0), b)) {
+        std::vector<cgrad_storage*> grads;
+        for (auto& g : b.grads) grads.push_back(&g);
+        float norm = 0.0f;
+        cgrad_storage_clip_grad_norm(b.n, grads.data(), 1e30f, &norm);
+        for (auto _ : state) {
+            cgrad_storage_clip_grad_norm(b.n, grads.data(), norm * (1.0f - 1e-7f), &norm);
+        }
+        state.SetBytesProcessed(state.iterations() * (int64_t)BENCH_TOTAL_ELEMENTS * 3 * sizeof(float));
+    }
+    bench_cleanup(b);
+}
+
+// 4M parameters split into 4 to 256 tensors
+BENCHMARK(BM_SgdAxpyLoop)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SgdFused)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_OptimFused, momentum, CGRAD_OPTIM_SGD, 1)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_OptimFused, adam, CGRAD_OPTIM_ADAM, 2)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_OptimFused, adamw, CGRAD_OPTIM_ADAMW, 2)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ClipGradNormPerTensor)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ClipGradNormFused)->ArgName("tensors")->RangeMultiplier(8)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,54 @@
+// Performance counters of a benchmark loop as Google Benchmark user counters: construct a
+// BenchPerf right before `for (auto _ : state)` and call report() right after it. Counters are
+// reported per iteration (including paused regions) as far as the machine provides them, plus
+// "IPC" and "vector_ratio" (packed / all FP instructions). Set CGRAD_BENCH_PERF_VECTOR=1 to also
+// count the Intel FP_ARITH events; without perf_event_open support no counters are added.
+#ifndef BENCH_CGRAD_PERF_H
+#define BENCH_CGRAD_PERF_H
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "profiler/cgrad_perf.h"
+}
+
+#include <cstdlib>
+#include <cstring>
+
+class BenchPerf {
+public:
+    BenchPerf() {
+        static const char* vector = std::getenv("CGRAD_BENCH_PERF_VECTOR");
+        if (!cgrad_perf_is_open()) cgrad_perf_open(vector != nullptr && std::strcmp(vector, "1") == 0);
+        cgrad_perf_read(&start_);
+    }
+
+    void report(benchmark::State& state) {
+        cgrad_perf_counts end, delta;
+        cgrad_perf_read(&end);
+        cgrad_perf_diff(&start_, &end, &delta);
+        for (int c = 0; c < CGRAD_PERF_NUM_COUNTERS; c++) {
+            if (delta.available & (1u << c)) {
+                state.counters[cgrad_perf_counter_name((cgrad_perf_counter)c)] =
+                    benchmark::Counter((double)delta.values[c], benchmark::Counter::kAvgIterations);
+            }
+        }
+        const uint64_t* v = delta.values;
+        if (has(delta, CGRAD_PERF_CYCLES) && has(delta, CGRAD_PERF_INSTRUCTIONS) && v[CGRAD_PERF_CYCLES] > 0) {
+            state.counters["IPC"] = (double)v[CGRAD_PERF_INSTRUCTIONS] / (double)v[CGRAD_PERF_CYCLES];
+        }
+        uint64_t fp = v[CGRAD_PERF_FP_SCALAR] + v[CGRAD_PERF_FP_PACKED];
+        if (has(delta, CGRAD_PERF_FP_SCALAR) && has(delta, CGRAD_PERF_FP_PACKED) && fp > 0) {
+            state.counters["vector_ratio"] = (double)v[CGRAD_PERF_FP_PACKED] / (double)fp;
+        }
+    }
+
+private:
+    static bool has(const cgrad_perf_counts& counts, cgrad_perf_counter c) {
+        return (counts.available & (1u << c)) != 0;
+    }
+
+    cgrad_perf_counts start_;
+};
+
+#endif // BENCH_CGRAD_PERF_H
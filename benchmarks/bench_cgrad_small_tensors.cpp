@@ -0,0 +1,129 @@
+// Google Benchmark of storage ops on small tensors, where per-call overhead (layout
+// arithmetic, BLAS dispatch) dominates over the actual math
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include <stdint.h>
+}
+
+#define CGRAD_BACKEND "cpu_f32"
+
+// Square (n, n) storages filled with random values
+static bool small_bench_init(benchmark::State& state, uint32_t n, cgrad_storage* tensors, int count) {
+    cgrad_init();
+    uint32_t shape[2] = {n, n};
+    for (int i = 0; i < count; i++) {
+        if (cgrad_storage_init(&tensors[i], shape, 2, CGRAD_BACKEND) || cgrad_storage_fill_rand(&tensors[i])) {
+            state.SkipWithError("Failed to initialize tensors");
+            return false;
+        }
+    }
+    return true;
+}
+
+static void BM_SmallFill(benchmark::State& state) {
+    cgrad_storage t;
+    if (small_bench_init(state, (uint32_t)state.range(0), &t, 1)) {
+        for (auto _ : state) {
+            cgrad_storage_fill(&t, 1.0f);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+    }
+    cgrad_cleanup();
+}
+
+static void BM_SmallAxpy(benchmark::State& state) {
+    cgrad_storage t[2];
+    if (small_bench_init(state, (uint32_t)state.range(0), t, 2)) {
+        for (auto _ : state) {
+            if (cgrad_storage_axpy(0.5f, &t[0], &t[1], &t[1]) != CGRAD_SUCCESS) {
+                state.SkipWithError("axpy failed");
+                break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+    }
+    cgrad_cleanup();
+}
+
+static void BM_SmallMul(benchmark::State& state) {
+    cgrad_storage t[3];
+    if (small_bench_init(state, (uint32_t)state.range(0), t, 3)) {
+        for (auto _ : state) {
+            if (cgrad_storage_mul(1.0f, &t[0], &t[1], 0.0f, &t[2]) != CGRAD_SUCCESS) {
+                state.SkipWithError("mul failed");
+                break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+    }
+    cgrad_cleanup();
+}
+
+// Copy a transposed view into a contiguous storage (strided copy path)
+static void BM_SmallCopyTransposed(benchmark::State& state) {
+    cgrad_storage t[2];
+    if (small_bench_init(state, (uint32_t)state.range(0), t, 2)) {
+        cgrad_storage t_view = {};
+        uint32_t perm[2] = {1, 0};
+        if (cgrad_storage_transpose(&t[0], &t_view, perm, 2) != CGRAD_SUCCESS) {
+            state.SkipWithError("transpose failed");
+        } else {
+            for (auto _ : state) {
+                if (cgrad_storage_copy(&t_view, &t[1]) != CGRAD_SUCCESS) {
+                    state.SkipWithError("copy failed");
+                    break;
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+    }
+    cgrad_cleanup();
+}
+
+static void BM_SmallGemm(benchmark::State& state) {
+    cgrad_storage t[3];
+    if (small_bench_init(state, (uint32_t)state.range(0), t, 3)) {
+        for (auto _ : state) {
+            if (cgrad_storage_gemm(1.0f, &t[0], &t[1], 0.0f, &t[2]) != CGRAD_SUCCESS) {
+                state.SkipWithError("gemm failed");
+                break;
+            }
+        }
+        double n = (double)state.range(0);
+        state.counters["FLOPS"] = benchmark::Counter(2.0 * n * n * n, benchmark::Counter::kIsIterationInvariantRate);
+    }
+    cgrad_cleanup();
+}
+
+// Element access goes through the layout's flat index computation
+static void BM_SmallGet(benchmark::State& state) {
+    cgrad_storage t;
+    uint32_t n = (uint32_t)state.range(0);
+    if (small_bench_init(state, n, &t, 1)) {
+        float value, sum = 0.0f;
+        for (auto _ : state) {
+            for (uint32_t i = 0; i < n; i++) {
+                uint32_t idx[2] = {i, n - 1 - i};
+                cgrad_storage_get(&t, idx, 2, &value);
+                sum += value;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    cgrad_cleanup();
+}
+
+// Square sizes from 4x4 (16 elements) to 64x64 (4096 elements)
+BENCHMARK(BM_SmallFill)->ArgName("n")->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK(BM_SmallAxpy)->ArgName("n")->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK(BM_SmallMul)->ArgName("n")->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK(BM_SmallCopyTransposed)->ArgName("n")->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK(BM_SmallGemm)->ArgName("n")->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK(BM_SmallGet)->ArgName("n")->RangeMultiplier(2)->Range(4, 64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+// Google Benchmark comparing zero-copy (mmap) loading of a tensor file against copying
+// every tensor into freshly allocated storage
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_file.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+}
+
+#include <string>
+#include <vector>
+
+#define CGRAD_BACKEND "cpu_f32"
+#define BENCH_NUM_TENSORS 8
+
+static const char* bench_path = "/tmp/cgrad_bench_storage_file.tensors";
+
+// Resident set size of the process in KiB
+static double bench_rss_kib() {
+    long pages = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0.0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return (double)resident * (double)sysconf(_SC_PAGESIZE) / 1024.0;
+}
+
+// Write BENCH_NUM_TENSORS (rows, 1024) matrices holding mib MiB in total
+static bool bench_write_file(benchmark::State& state, int64_t mib) {
+    uint32_t shape[2] = {(uint32_t)(((uint64_t)mib << 20) / (BENCH_NUM_TENSORS * 1024 * sizeof(float))), 1024};
+
+    std::vector<cgrad_storage> tensors(BENCH_NUM_TENSORS);
+    std::vector<std::string> names;
+    std::vector<const char*> name_ptrs;
+    std::vector<const cgrad_storage*> ptrs;
+    for (int i = 0; i < BENCH_NUM_TENSORS; i++) {
+        if (cgrad_storage_init(&tensors[i], shape, 2, CGRAD_BACKEND) || cgrad_storage_fill(&tensors[i], (float)i)) {
+            state.SkipWithError("Failed to initialize tensors");
+            return false;
+        }
+        names.push_back("layer" + std::to_string(i) + ".weight");
+        ptrs.push_back(&tensors[i]);
+    }
+    for (auto& name : names) name_ptrs.push_back(name.c_str());
+
+    cgrad_status err = cgrad_storage_save(bench_path, name_ptrs.data(), ptrs.data(), BENCH_NUM_TENSORS);
+    for (auto& t : tensors) cgrad_storage_free(&t);
+    if (err != CGRAD_SUCCESS) {
+        state.SkipWithError("Failed to write tensor file");
+        return false;
+    }
+    state.counters["bytes"] = (double)BENCH_NUM_TENSORS * shape[0] * shape[1] * sizeof(float);
+    return true;
+}
+
+// Open the file and load every tensor, either mapped or copied. Reports the RSS growth
+// caused by the loaded tensors in the first iteration, before the allocator holds on to
+// memory freed by earlier iterations.
+static void bench_load(benchmark::State& state, bool mmap_load) {
+    cgrad_init();
+    if (bench_write_file(state, state.range(0))) {
+        double rss_growth = -1.0;
+        for (auto _ : state) {
+            double rss_before = bench_rss_kib();
+            cgrad_storage_file* file = NULL;
+            if (cgrad_storage_file_open(bench_path, &file) != CGRAD_SUCCESS) {
+                state.SkipWithError("Failed to open tensor file");
+                break;
+            }
+            cgrad_storage tensors[BENCH_NUM_TENSORS];
+            for (int i = 0; i < BENCH_NUM_TENSORS; i++) {
+                const char* name = cgrad_storage_file_tensor_name(file, i);
+                cgrad_status err = mmap_load
+                    ? cgrad_storage_load_mmap(file, name, &tensors[i])
+                    : cgrad_storage_file_load(file, name, &tensors[i], CGRAD_BACKEND);
+                if (err != CGRAD_SUCCESS) state.SkipWithError("Failed to load tensor");
+            }
+            cgrad_storage_file_close(file);
+
+            state.PauseTiming();
+            if (rss_growth < 0.0) rss_growth = bench_rss_kib() - rss_before;
+            for (int i = 0; i < BENCH_NUM_TENSORS; i++) cgrad_storage_free(&tensors[i]);
+            state.ResumeTiming();
+        }
+        state.counters["rss_kib"] = rss_growth;
+    }
+    unlink(bench_path);
+    cgrad_cleanup();
+}
+
+static void BM_LoadMmap(benchmark::State& state) {
+    bench_load(state, true);
+}
+
+static void BM_LoadCopy(benchmark::State& state) {
+    bench_load(state, false);
+}
+
+// Total file sizes from 4 MiB to 256 MiB
+BENCHMARK(BM_LoadMmap)->ArgName("MiB")->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_LoadCopy)->ArgName("MiB")->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
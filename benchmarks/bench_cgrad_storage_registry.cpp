@@ -0,0 +1,158 @@
+// Google Benchmark of the storage registry: registering and deregistering roots and views,
+// shallow-copy chains growing one bucket, nested recording scopes (as opened by gemm, axpy,
+// reduce and the backward helpers) and freeing records with many entries. Every benchmark
+// reports the cost per operation ("per_op", in seconds) so registry redesigns can be compared.
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_registry.h"
+#include <stdint.h>
+#include <uuid/uuid.h>
+}
+
+#include <vector>
+
+#define CGRAD_BACKEND "cpu_f32"
+
+// Per-iteration operation count, reported as throughput and as time per operation
+static void registry_bench_report(benchmark::State& state, int64_t ops) {
+    state.SetItemsProcessed(state.iterations() * ops);
+    state.counters["per_op"] = benchmark::Counter(
+        (double)ops, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+    );
+}
+
+// Storages for a private registry: only their uuid matters, no data is allocated
+static std::vector<cgrad_storage> registry_bench_handles(int n) {
+    std::vector<cgrad_storage> handles(n);
+    for (auto& h : handles) uuid_generate(h.uuid);
+    return handles;
+}
+
+// ============================================================================
+// Private registry: register / deregister
+// ============================================================================
+
+// Register a new root and delete its bucket again, with the given number of other live roots
+// Args: live roots
+static void BM_RegistryRoot(benchmark::State& state) {
+    cgrad_storage_registry registry;
+    cgrad_storage_registry_init(&registry);
+    std::vector<cgrad_storage> live = registry_bench_handles((int)state.range(0));
+    for (auto& h : live) cgrad_storage_registry_register(&registry, &h, NULL);
+
+    cgrad_storage t = registry_bench_handles(1)[0];
+    for (auto _ : state) {
+        cgrad_storage_registry_register(&registry, &t, NULL);
+        cgrad_storage_registry_deregister_and_delete_bucket(&registry, &t);
+    }
+    registry_bench_report(state, 1);
+
+    for (auto& h : live) cgrad_storage_registry_deregister_and_delete_bucket(&registry, &h);
+    cgrad_storage_registry_free(&registry);
+}
+
+// Register a view into a bucket and deregister it again
+// Args: views already in the bucket
+static void BM_RegistryView(benchmark::State& state) {
+    cgrad_storage_registry registry;
+    cgrad_storage_registry_init(&registry);
+    std::vector<cgrad_storage> bucket = registry_bench_handles((int)state.range(0) + 1);
+    cgrad_storage_registry_register(&registry, &bucket[0], NULL);
+    for (size_t i = 1; i < bucket.size(); i++) cgrad_storage_registry_register(&registry, &bucket[i], &bucket[i - 1]);
+
+    cgrad_storage t = registry_bench_handles(1)[0];
+    for (auto _ : state) {
+        cgrad_storage_registry_register(&registry, &t, &bucket.back());
+        cgrad_storage_registry_deregister(&registry, &t);
+    }
+    registry_bench_report(state, 1);
+
+    for (size_t i = bucket.size(); i-- > 1;) cgrad_storage_registry_deregister(&registry, &bucket[i]);
+    cgrad_storage_registry_deregister_and_delete_bucket(&registry, &bucket[0]);
+    cgrad_storage_registry_free(&registry);
+}
+
+// ============================================================================
+// Global registry: storage API
+// ============================================================================
+
+// Shallow copy of the last storage of a chain of shallow copies, and its release
+// Args: chain depth
+static void BM_RegistryShallowCopyChain(benchmark::State& state) {
+    cgrad_init();
+    int depth = (int)state.range(0);
+    uint32_t shape[2] = {1, 1};
+    std::vector<cgrad_storage> chain(depth + 1);
+    bool ok = cgrad_storage_init(&chain[0], shape, 2, CGRAD_BACKEND) == CGRAD_SUCCESS;
+    for (int i = 1; i <= depth && ok; i++) ok = cgrad_storage_shallow_copy(&chain[i - 1], &chain[i]) == CGRAD_SUCCESS;
+    if (!ok) {
+        state.SkipWithError("Failed to build chain");
+    } else {
+        for (auto _ : state) {
+            cgrad_storage view;
+            cgrad_storage_shallow_copy(&chain.back(), &view);
+            cgrad_storage_free(&view);
+        }
+        registry_bench_report(state, 1);
+    }
+    for (int i = depth; i >= 0; i--) {
+        if (chain[i].data) cgrad_storage_free(&chain[i]);
+    }
+    cgrad_cleanup();
+}
+
+// A recording scope as opened by the storage ops (start, allocate a temporary, stop, free the
+// record) inside the given number of enclosing scopes: every registration is added to, and
+// every release removed from, all active records
+// Args: enclosing scopes
+static void BM_RegistryNestedRecording(benchmark::State& state) {
+    cgrad_init();
+    int depth = (int)state.range(0);
+    uint32_t shape[2] = {1, 1};
+    std::vector<cgrad_storage_registry_record*> outer;
+    for (int i = 0; i < depth; i++) outer.push_back(cgrad_storage_start_recording());
+    for (auto _ : state) {
+        cgrad_storage_registry_record* record = cgrad_storage_start_recording();
+        cgrad_storage tmp;
+        cgrad_storage_init(&tmp, shape, 2, CGRAD_BACKEND);
+        cgrad_storage_stop_recording(record);
+        cgrad_storage_free_record(record);
+    }
+    registry_bench_report(state, 1);
+    for (int i = depth; i-- > 0;) {
+        cgrad_storage_stop_recording(outer[i]);
+        cgrad_storage_free_record(outer[i]);
+    }
+    cgrad_cleanup();
+}
+
+// Free a record holding many storages
+// Args: recorded storages
+static void BM_RegistryFreeRecord(benchmark::State& state) {
+    cgrad_init();
+    int n = (int)state.range(0);
+    uint32_t shape[2] = {1, 1};
+    std::vector<cgrad_storage> storages(n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        cgrad_storage_registry_record* record = cgrad_storage_start_recording();
+        for (auto& s : storages) cgrad_storage_init(&s, shape, 2, CGRAD_BACKEND);
+        cgrad_storage_stop_recording(record);
+        state.ResumeTiming();
+        cgrad_storage_free_record(record);
+    }
+    registry_bench_report(state, n);
+    cgrad_cleanup();
+}
+
+BENCHMARK(BM_RegistryRoot)->ArgName("live")->RangeMultiplier(16)->Range(1, 4096);
+BENCHMARK(BM_RegistryView)->ArgName("views")->RangeMultiplier(16)->Range(1, 4096);
+BENCHMARK(BM_RegistryShallowCopyChain)->ArgName("depth")->RangeMultiplier(16)->Range(1, 4096);
+BENCHMARK(BM_RegistryNestedRecording)->ArgName("depth")->DenseRange(0, 8, 2)->Arg(32);
+BENCHMARK(BM_RegistryFreeRecord)->ArgName("entries")->RangeMultiplier(16)->Range(16, 4096);
+
+BENCHMARK_MAIN();
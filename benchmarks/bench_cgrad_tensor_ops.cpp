@@ -1,142 +1,386 @@
-// Google Benchmark version of contiguous benchmark
+// Google Benchmark of the core storage ops (gemm and its backward pass, axpy, reduce, contiguous,
+// fill, reshape) over shapes, ranks, broadcast patterns and transposed layouts. Every benchmark
+// reports its FLOP rate ("FLOPS") and memory traffic ("bytes_per_second", counting every operand
+// read or written once), and the per-iteration performance counters of bench_cgrad_perf.h where
+// available.
+// Run with --benchmark_out=<file> --benchmark_out_format=json (or `make bench-json`) to keep
+// results for comparisons between commits.
 #include <benchmark/benchmark.h>
 
 extern "C" {
+#include "cgrad.h"
 #include "cgrad_status.h"
-#include "cgrad_storage.h"
+#include "storage/cgrad_storage.h"
+#include "backends/cgrad_backend.h"
+#include "autograd/cgrad_ops.h"
 #include <stdint.h>
-#include <stdlib.h>
-#include <stdio.h>
 }
 
-#define CGRAD_BACKEND CGRAD_BACKEND_F32_CPU
+#include "bench_cgrad_perf.h"
 
-static void BM_MakeContiguous(benchmark::State& state) {
+#include <initializer_list>
+#include <string>
 
-    // create tensor instances
-    cgrad_tensor t, t_contig;
+#define CGRAD_BACKEND "cpu_f32"
 
-    // initialize tensor and fill with random values
-    uint32_t shape[4] = {512, 32, 32, 32};
-    if (cgrad_storage_init(&t, shape, 4, CGRAD_BACKEND)) {
-        state.SkipWithError("Failed to initialize tensor");
-        return;
+// Operand layouts selected by a benchmark argument
+enum OpsLayout {
+    OPS_CONTIGUOUS = 0,     // row-major storage of the given shape
+    OPS_TRANSPOSED = 1,     // transposed view of a storage of the swapped shape
+    OPS_BCAST_ROW = 2,      // (1, n) operand broadcast over the rows
+    OPS_BCAST_COL = 3,      // (m, 1) operand broadcast over the columns
+};
+
+static const char* ops_layout_name(int layout) {
+    switch (layout) {
+        case OPS_CONTIGUOUS: return "contiguous";
+        case OPS_TRANSPOSED: return "transposed";
+        case OPS_BCAST_ROW: return "bcast_row";
+        case OPS_BCAST_COL: return "bcast_col";
+        default: return "unknown";
     }
-    
-    if (cgrad_storage_fill_rand(&t)) {
-        state.SkipWithError("Failed to fill tensor with random values");
-        cgrad_storage_free(&t);
-        return;
+}
+
+// Storage of the given shape filled with random values
+static bool ops_init(benchmark::State& state, const uint32_t* shape, int ndim, cgrad_storage* t) {
+    if (cgrad_storage_init(t, shape, ndim, CGRAD_BACKEND) || cgrad_storage_fill_rand(t)) {
+        state.SkipWithError("Failed to initialize storage");
+        return false;
     }
+    return true;
+}
 
-    uint32_t perm[4] = {2, 1, 3, 0};
-    cgrad_storage t_transposed;
-    int err = cgrad_storage_transpose(&t, &t_transposed, perm, 4);
+// Matrix operand of logical shape (rows, cols) in the given layout. Transposed operands are a
+// view of a (cols, rows) storage, so `base` must be freed after `view`.
+static bool ops_init_matrix(benchmark::State& state, uint32_t rows, uint32_t cols, int layout, cgrad_storage* base, cgrad_storage* view) {
+    uint32_t shape[2] = {rows, cols};
+    if (layout == OPS_BCAST_ROW) shape[0] = 1;
+    if (layout == OPS_BCAST_COL) shape[1] = 1;
+    if (layout == OPS_TRANSPOSED) {
+        shape[0] = cols;
+        shape[1] = rows;
+    }
+    if (!ops_init(state, shape, 2, base)) return false;
+
+    uint32_t perm[2] = {1, 0};
+    int err = layout == OPS_TRANSPOSED
+        ? cgrad_storage_transpose(base, view, perm, 2)
+        : cgrad_storage_shallow_copy(base, view);
     if (err != CGRAD_SUCCESS) {
-        // skip error with error code
-        state.SkipWithError("Failed to transpose tensor");
-        cgrad_storage_free(&t);
-        return;
+        state.SkipWithError("Failed to create view");
+        return false;
+    }
+    return true;
+}
+
+static uint64_t ops_numel(const cgrad_storage* t) {
+    return t->backend->storage_get_layout(t->data)->size;
+}
+
+// Free the initialized storages among ts (views before their base) and shut cgrad down
+static void ops_free(std::initializer_list<cgrad_storage*> ts) {
+    for (cgrad_storage* t : ts) {
+        if (t->data) cgrad_storage_free(t);
+    }
+    cgrad_cleanup();
+}
+
+// Per-iteration work, reported as rates (pure data movement reports no FLOPS), and counters
+static void ops_report(benchmark::State& state, BenchPerf& perf, double flops, double bytes) {
+    perf.report(state);
+    if (flops > 0.0) {
+        state.counters["FLOPS"] = benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::kIs1000);
     }
-    cgrad_storage_free(&t);
-    t = t_transposed;
+    state.SetBytesProcessed((int64_t)(bytes * (double)state.iterations()));
+}
+
+// ============================================================================
+// gemm: (batch, m, k) x (k, n) with transposed and batch-broadcast operands
+// ============================================================================
 
-    for (auto _ : state) {
-        int _err = cgrad_storage_contiguous(&t, &t_contig);
+// Args: batch, m, k, n, layout of a, layout of b, 1 if b is a single matrix broadcast over the batch
+static void BM_Gemm(benchmark::State& state) {
+    uint32_t batch = (uint32_t)state.range(0), m = (uint32_t)state.range(1), k = (uint32_t)state.range(2), n = (uint32_t)state.range(3);
+    int layout_a = (int)state.range(4), layout_b = (int)state.range(5);
+    bool bcast_b = state.range(6) != 0;
+    state.SetLabel(std::string(ops_layout_name(layout_a)) + "/" + ops_layout_name(layout_b) + (bcast_b ? "/bcast_batch" : ""));
 
-        state.PauseTiming();
+    cgrad_init();
+    cgrad_storage a = {}, a_view = {}, b = {}, b_view = {}, r = {};
+    uint32_t shape_a[3] = {batch, m, k};
+    uint32_t shape_b[3] = {batch, k, n};
+    bool ok;
+    if (layout_a == OPS_TRANSPOSED) {
+        // transpose the trailing matrices of a (batch, k, m) storage
+        uint32_t shape_at[3] = {batch, k, m};
+        uint32_t perm[2] = {1, 0};
+        ok = ops_init(state, shape_at, 3, &a) && cgrad_storage_transpose(&a, &a_view, perm, 2) == CGRAD_SUCCESS;
+    } else {
+        ok = ops_init(state, shape_a, 3, &a) && cgrad_storage_shallow_copy(&a, &a_view) == CGRAD_SUCCESS;
+    }
+    if (ok && bcast_b) {
+        ok = ops_init_matrix(state, k, n, layout_b, &b, &b_view);
+    } else if (ok && layout_b == OPS_TRANSPOSED) {
+        uint32_t shape_bt[3] = {batch, n, k};
+        uint32_t perm[2] = {1, 0};
+        ok = ops_init(state, shape_bt, 3, &b) && cgrad_storage_transpose(&b, &b_view, perm, 2) == CGRAD_SUCCESS;
+    } else if (ok) {
+        ok = ops_init(state, shape_b, 3, &b) && cgrad_storage_shallow_copy(&b, &b_view) == CGRAD_SUCCESS;
+    }
 
-        if (_err != CGRAD_SUCCESS) {
-            state.SkipWithError("Failed to make tensor contiguous");
-            break;
+    if (ok) {
+        // the first call allocates r, the timed ones overwrite it
+        ok = cgrad_storage_gemm(1.0f, &a_view, &b_view, 0.0f, &r) == CGRAD_SUCCESS;
+        if (!ok) state.SkipWithError("gemm failed");
+    }
+    if (ok) {
+        BenchPerf perf;
+        for (auto _ : state) {
+            cgrad_storage_gemm(1.0f, &a_view, &b_view, 0.0f, &r);
         }
-        // free contiguous tensor
-        cgrad_storage_free(&t_contig);
+        double b_elems = (double)(bcast_b ? 1 : batch) * k * n;
+        ops_report(state, perf, 2.0 * batch * m * k * n, 4.0 * ((double)batch * m * k + b_elems + (double)batch * m * n));
+    }
+    ops_free({&r, &b_view, &b, &a_view, &a});
+}
 
-        state.ResumeTiming();
+// ============================================================================
+// gemm backward: gradients of (batch, m, k) x (k, n) with b broadcast over the batch
+// ============================================================================
+
+// The gradient of the broadcast operand is computed per batch and then reduced over the batch.
+// Args: batch, m, k, n
+static void BM_GemmBackward(benchmark::State& state) {
+    uint32_t batch = (uint32_t)state.range(0), m = (uint32_t)state.range(1), k = (uint32_t)state.range(2), n = (uint32_t)state.range(3);
+    state.SetLabel("bcast_batch");
+
+    cgrad_init();
+    cgrad_storage a = {}, b = {}, grad_out = {}, grad_a = {}, grad_b = {};
+    uint32_t shape_a[3] = {batch, m, k};
+    uint32_t shape_b[2] = {k, n};
+    uint32_t shape_out[3] = {batch, m, n};
+    if (ops_init(state, shape_a, 3, &a) && ops_init(state, shape_b, 2, &b) && ops_init(state, shape_out, 3, &grad_out)
+        && ops_init(state, shape_a, 3, &grad_a) && ops_init(state, shape_b, 2, &grad_b)) {
+        cgrad_storage* inputs[2] = {&a, &b};
+        cgrad_storage* grads[2] = {&grad_a, &grad_b};
+        int requires_grad[2] = {1, 1};
+        if (cgrad_op_gemm_backward(inputs, 2, NULL, &grad_out, NULL, NULL, grads, requires_grad) != CGRAD_SUCCESS) {
+            state.SkipWithError("gemm backward failed");
+        } else {
+            // gradients accumulate, so the timed iterations keep adding to them
+            BenchPerf perf;
+            for (auto _ : state) {
+                cgrad_op_gemm_backward(inputs, 2, NULL, &grad_out, NULL, NULL, grads, requires_grad);
+            }
+            double elems_a = (double)batch * m * k, elems_b = (double)k * n, elems_out = (double)batch * m * n;
+            // grad_a and grad_b read grad_out, a, b and update both gradients through the
+            // (batch, k, n) contribution of b
+            ops_report(state, perf, 4.0 * batch * m * k * n, 4.0 * (2.0 * elems_out + 3.0 * elems_a + 3.0 * elems_b + 2.0 * batch * elems_b));
+        }
     }
+    ops_free({&grad_b, &grad_a, &grad_out, &b, &a});
+}
 
-    // free tensors
-    cgrad_storage_free(&t);
+// ============================================================================
+// axpy: r = alpha * x + r with broadcast and transposed x
+// ============================================================================
+
+// Args: rows, cols, layout of x
+static void BM_Axpy(benchmark::State& state) {
+    uint32_t rows = (uint32_t)state.range(0), cols = (uint32_t)state.range(1);
+    int layout = (int)state.range(2);
+    state.SetLabel(ops_layout_name(layout));
+
+    cgrad_init();
+    cgrad_storage x = {}, x_view = {}, y = {};
+    uint32_t shape[2] = {rows, cols};
+    if (ops_init_matrix(state, rows, cols, layout, &x, &x_view) && ops_init(state, shape, 2, &y)) {
+        BenchPerf perf;
+        for (auto _ : state) {
+            cgrad_storage_axpy(1e-3f, &x_view, &y, &y);
+        }
+        double n = (double)rows * cols;
+        ops_report(state, perf, 2.0 * n, 4.0 * ((double)ops_numel(&x) + 2.0 * n));
+    }
+    ops_free({&y, &x_view, &x});
+}
+
+// ============================================================================
+// reduce: sums over the rows, the columns or both, of contiguous and transposed inputs
+// ============================================================================
+
+// Args: rows, cols, reduced axes (1 = rows, 2 = columns, 3 = both), layout of the input
+static void BM_Reduce(benchmark::State& state) {
+    uint32_t rows = (uint32_t)state.range(0), cols = (uint32_t)state.range(1);
+    int axes = (int)state.range(2), layout = (int)state.range(3);
+    uint8_t mask[2] = {(uint8_t)((axes & 1) != 0), (uint8_t)((axes & 2) != 0)};
+    static const char* axes_names[] = {"", "rows", "cols", "all"};
+    state.SetLabel(std::string(axes_names[axes & 3]) + "/" + ops_layout_name(layout));
+
+    cgrad_init();
+    cgrad_storage a = {}, a_view = {}, r = {};
+    if (ops_init_matrix(state, rows, cols, layout, &a, &a_view)) {
+        if (cgrad_storage_reduce(1.0f, &a_view, mask, 2, 0.0f, &r) != CGRAD_SUCCESS) {
+            state.SkipWithError("reduce failed");
+        } else {
+            // reduce allocates its result, so every iteration includes that allocation
+            BenchPerf perf;
+            for (auto _ : state) {
+                cgrad_storage out = {};
+                cgrad_storage_reduce(1.0f, &a_view, mask, 2, 0.0f, &out);
+                cgrad_storage_free(&out);
+            }
+            double n = (double)rows * cols;
+            ops_report(state, perf, n, 4.0 * (n + (double)ops_numel(&r)));
+        }
+    }
+    ops_free({&r, &a_view, &a});
 }
-BENCHMARK(BM_MakeContiguous)
-    ->Unit(benchmark::kSecond)
-    ->MinTime(1.0);
-
-static void BM_TensorGEMM(benchmark::State& state) {
-    int B = state.range(0);
-    int M = state.range(0);
-    int K = state.range(1);
-    int N = state.range(2);
-
-    uint32_t shape_a[3] = {static_cast<uint32_t>(B), static_cast<uint32_t>(M), static_cast<uint32_t>(K)};
-    uint32_t shape_b[3] = {static_cast<uint32_t>(B), static_cast<uint32_t>(K), static_cast<uint32_t>(N)};
-    cgrad_tensor a, b, r;
-
-    if (
-        cgrad_storage_init(&a, shape_a, 2, CGRAD_BACKEND_F32_CPU)
-        || cgrad_storage_init(&b, shape_b, 2, CGRAD_BACKEND_F32_CPU)
-    ) {
-        state.SkipWithError("Failed to initialize tensors for GEMM");
-        return;
-    }
-    cgrad_storage_fill_rand(&a);
-    cgrad_storage_fill_rand(&b);
-
-    for (auto _ : state) {
-        r.data = NULL; r.backend = NULL;
-        int err = cgrad_storage_gemm(&a, &b, &r);
-        if (err != CGRAD_SUCCESS) {
-            state.SkipWithError("GEMM failed");
-            break;
+
+// ============================================================================
+// contiguous: materialize permuted views of rank 2 to 4
+// ============================================================================
+
+// Permutations of the trailing dims: swap the two outer dims (rows stay contiguous), transpose
+// the innermost matrix and reverse all dims
+static const uint32_t ops_perms[3][3][4] = {
+    {{1, 0}, {1, 0}, {1, 0}},
+    {{1, 0, 2}, {0, 2, 1}, {2, 1, 0}},
+    {{1, 0, 2, 3}, {0, 1, 3, 2}, {3, 2, 1, 0}},
+};
+
+// Args: rank (2 to 4), elements along every dim, index of the permutation in ops_perms
+static void BM_Contiguous(benchmark::State& state) {
+    int ndim = (int)state.range(0);
+    uint32_t dim = (uint32_t)state.range(1);
+    const uint32_t* perm = ops_perms[ndim - 2][state.range(2)];
+    std::string label = "perm";
+    for (int i = 0; i < ndim; i++) label += std::to_string(perm[i]);
+    state.SetLabel(label);
+
+    cgrad_init();
+    uint32_t shape[4] = {dim, dim, dim, dim};
+    cgrad_storage t = {}, view = {};
+    if (ops_init(state, shape, ndim, &t) && cgrad_storage_transpose(&t, &view, perm, ndim) == CGRAD_SUCCESS) {
+        BenchPerf perf;
+        for (auto _ : state) {
+            cgrad_storage out = {};
+            cgrad_storage_contiguous(&view, &out);
+            cgrad_storage_free(&out);
         }
-        cgrad_storage_free(&r);
+        ops_report(state, perf, 0.0, 8.0 * (double)ops_numel(&t));
     }
-    cgrad_storage_free(&a);
-    cgrad_storage_free(&b);
+    ops_free({&view, &t});
 }
-// Register GEMM for several shape setups (M, K, N)
-BENCHMARK(BM_TensorGEMM)
-    ->Args({1, 256, 256, 256})
-    ->Args({1, 512, 512, 512})
-    ->Args({1, 1024, 1024, 1024})
-    ->Args({1, 512, 1024, 256})
-    ->MinTime(1.0);
-
-static void BM_TensorAdd(benchmark::State& state) {
-    // state.range(0): total elements = shape[0] * shape[1]
-    int dim0 = state.range(0);
-    int dim1 = state.range(1);
-    uint32_t shape[2] = {static_cast<uint32_t>(dim0), static_cast<uint32_t>(dim1)};
-    cgrad_tensor a, b, r;
-
-    if (
-        cgrad_storage_init(&a, shape, 2, CGRAD_BACKEND_F32_CPU)
-        || cgrad_storage_init(&b, shape, 2, CGRAD_BACKEND_F32_CPU)
-    ) {
-        state.SkipWithError("Failed to initialize tensors for add");
-        return;
-    }
-    cgrad_storage_fill_rand(&a);
-    cgrad_storage_fill_rand(&b);
-
-    for (auto _ : state) {
-        r.data = NULL; r.backend = NULL;
-        int err = cgrad_storage_add(&a, &b, &r);
-        if (err != CGRAD_SUCCESS) {
-            state.SkipWithError("Add failed");
-            break;
+
+// ============================================================================
+// fill: constant and zero fills of contiguous storages and strided views
+// ============================================================================
+
+// Args: elements, value (0 or 1), 1 to fill every other column instead of the whole storage
+static void BM_Fill(benchmark::State& state) {
+    uint32_t n = (uint32_t)state.range(0);
+    float value = (float)state.range(1);
+    bool strided = state.range(2) != 0;
+    state.SetLabel(std::string(value == 0.0f ? "zero" : "one") + (strided ? "/strided" : ""));
+
+    cgrad_init();
+    uint32_t shape[2] = {n / 256, 256};
+    cgrad_storage t = {}, view = {};
+    uint32_t start[2] = {0, 0}, stop[2] = {shape[0], shape[1]};
+    uint32_t step[2] = {1, 2};
+    if (ops_init(state, shape, 2, &t)
+        && (strided ? cgrad_storage_slice(&t, &view, start, stop, step, 2) : cgrad_storage_shallow_copy(&t, &view)) == CGRAD_SUCCESS) {
+        BenchPerf perf;
+        for (auto _ : state) {
+            cgrad_storage_fill(&view, value);
         }
-        cgrad_storage_free(&r);
+        ops_report(state, perf, 0.0, 4.0 * (double)ops_numel(&view));
     }
-    cgrad_storage_free(&a);
-    cgrad_storage_free(&b);
+    ops_free({&view, &t});
 }
-// Register add for several shape setups (dim0, dim1)
-BENCHMARK(BM_TensorAdd)
-    ->Args({256, 256})
-    ->Args({512, 512})
-    ->Args({1024, 1024})
-    ->MinTime(1.0);
+
+// ============================================================================
+// reshape: views of contiguous storages and copies of transposed ones
+// ============================================================================
+
+// Args: rows, cols, layout of the input (contiguous or transposed)
+static void BM_Reshape(benchmark::State& state) {
+    uint32_t rows = (uint32_t)state.range(0), cols = (uint32_t)state.range(1);
+    int layout = (int)state.range(2);
+    state.SetLabel(ops_layout_name(layout));
+
+    cgrad_init();
+    cgrad_storage t = {}, view = {};
+    int32_t new_shape[1] = {-1};
+    if (ops_init_matrix(state, rows, cols, layout, &t, &view)) {
+        BenchPerf perf;
+        for (auto _ : state) {
+            cgrad_storage out = {};
+            cgrad_storage_reshape(&view, &out, new_shape, 1);
+            cgrad_storage_free(&out);
+        }
+        // a contiguous input is only relabeled, a transposed one is copied
+        double n = (double)rows * cols;
+        ops_report(state, perf, 0.0, layout == OPS_TRANSPOSED ? 8.0 * n : 0.0);
+    }
+    ops_free({&view, &t});
+}
+
+BENCHMARK(BM_Gemm)
+    ->ArgNames({"batch", "m", "k", "n", "a", "b", "bcast"})
+    ->Args({1, 128, 128, 128, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 0})
+    ->Args({1, 512, 512, 512, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 0})
+    ->Args({1, 1024, 1024, 1024, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 0})
+    ->Args({1, 512, 1024, 256, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 0})
+    ->Args({1, 512, 512, 512, OPS_TRANSPOSED, OPS_CONTIGUOUS, 0})
+    ->Args({1, 512, 512, 512, OPS_CONTIGUOUS, OPS_TRANSPOSED, 0})
+    ->Args({1, 512, 512, 512, OPS_TRANSPOSED, OPS_TRANSPOSED, 0})
+    ->Args({32, 64, 64, 64, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 0})
+    ->Args({32, 64, 64, 64, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 1})
+    ->Args({32, 64, 64, 64, OPS_CONTIGUOUS, OPS_TRANSPOSED, 1})
+    ->Args({256, 16, 16, 16, OPS_CONTIGUOUS, OPS_CONTIGUOUS, 0})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_GemmBackward)
+    ->ArgNames({"batch", "m", "k", "n"})
+    ->Args({32, 64, 64, 64})
+    ->Args({4, 128, 128, 128})
+    ->Args({256, 16, 16, 16})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_Axpy)
+    ->ArgNames({"rows", "cols", "x"})
+    ->ArgsProduct({{64, 1024}, {1024}, {OPS_CONTIGUOUS, OPS_TRANSPOSED, OPS_BCAST_ROW, OPS_BCAST_COL}})
+    ->Args({4096, 4096, OPS_CONTIGUOUS})
+    ->Args({4096, 4096, OPS_TRANSPOSED})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_Reduce)
+    ->ArgNames({"rows", "cols", "axes", "a"})
+    ->ArgsProduct({{1024}, {1024}, {1, 2, 3}, {OPS_CONTIGUOUS, OPS_TRANSPOSED}})
+    ->Args({64, 16384, 1, OPS_CONTIGUOUS})
+    ->Args({16384, 64, 2, OPS_CONTIGUOUS})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_Contiguous)
+    ->ArgNames({"ndim", "dim", "perm"})
+    ->Args({2, 1024, 0})
+    ->Args({2, 4096, 0})
+    ->ArgsProduct({{3}, {128}, {0, 1, 2}})
+    ->ArgsProduct({{4}, {32}, {0, 1, 2}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_Fill)
+    ->ArgNames({"n", "value", "strided"})
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 22}, {0, 1}, {0}})
+    ->Args({1 << 22, 0, 1})
+    ->Args({1 << 22, 1, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_Reshape)
+    ->ArgNames({"rows", "cols", "a"})
+    ->ArgsProduct({{64, 1024}, {1024}, {OPS_CONTIGUOUS, OPS_TRANSPOSED}})
+    ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""Compare Google Benchmark JSON results against a baseline.
+
+Both sides must be run with --benchmark_repetitions=N (N >= 5, ideally 10 or more): the
+repetitions of a benchmark are compared with a one-sided Mann-Whitney U test, which makes no
+assumption about the distribution of the timings and is robust against outliers. A benchmark
+counts as slower if its median time grew by more than the threshold and the test finds the
+current timings significantly larger than the baseline ones.
+
+Usage:
+    bench_compare.py BASELINE CURRENT [--gate REGEX] [--threshold 0.05] [--alpha 0.05]
+    bench_compare.py BASELINE CURRENT --update [--gate REGEX]
+
+BASELINE and CURRENT are JSON files written with --benchmark_out, or directories of them
+(matched by file name). Slower benchmarks matching --gate fail the comparison (exit code 1);
+all other differences are only reported.
+
+Timings are only comparable on the machine they were taken on: the baseline keeps the host
+and CPU description of the run that produced it, and a comparison against a baseline from a
+different CPU is refused (exit code 2) unless --ignore-host is given. --update writes the
+repetitions of the gated benchmarks in CURRENT to BASELINE, together with that description.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import re
+import statistics
+import sys
+
+TIME_UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+# context fields that must match for timings to be comparable; host_name is only reported,
+# since the runners of a CI pool have different names but the same hardware
+HOST_FIELDS = ("cpu_model", "num_cpus", "mhz_per_cpu", "caches", "library_build_type")
+
+# per-repetition fields kept in a baseline
+BASELINE_FIELDS = ("name", "run_name", "run_type", "repetitions", "repetition_index", "iterations",
+                   "real_time", "cpu_time", "time_unit")
+
+
+def is_repetition(b):
+    """Whether a benchmark entry is a successful repetition, not a mean / median / stddev aggregate."""
+    return b.get("run_type", "iteration") == "iteration" and not b.get("error_occurred")
+
+
+def load_runs(data, metric):
+    """Map benchmark name -> list of per-repetition times in seconds."""
+    runs = {}
+    for b in data.get("benchmarks", []):
+        if is_repetition(b):
+            name = b.get("run_name", b["name"])
+            runs.setdefault(name, []).append(b[metric] * TIME_UNITS[b.get("time_unit", "ns")])
+    return runs
+
+
+def load_files(path):
+    """Map result file name -> parsed JSON, for a single file or a directory of files."""
+    if os.path.isdir(path):
+        files = sorted(f for f in os.listdir(path) if f.endswith(".json"))
+    else:
+        path, files = os.path.dirname(path), [os.path.basename(path)]
+    results = {}
+    for f in files:
+        with open(os.path.join(path, f)) as fp:
+            results[f] = json.load(fp)
+    return results
+
+
+def local_cpu_model():
+    """CPU model of this machine; Google Benchmark does not record it."""
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or platform.machine()
+
+
+def host_of(data):
+    """Host description of a result file; results without a CPU model were taken on this machine."""
+    context = dict(data.get("context", {}))
+    context.setdefault("cpu_model", local_cpu_model())
+    caches = context.get("caches")
+    if caches is not None:
+        context["caches"] = ["L%d %s %d" % (c.get("level", 0), c.get("type", ""), c.get("size", 0)) for c in caches]
+    return context
+
+
+def host_mismatches(baseline, current):
+    """Descriptions of the host fields that differ between the baseline and the current results."""
+    mismatches = []
+    for file_name in sorted(set(baseline) & set(current)):
+        base_host, host = host_of(baseline[file_name]), host_of(current[file_name])
+        for field in HOST_FIELDS:
+            if field in base_host and field in host and base_host[field] != host[field]:
+                mismatches.append("%s: %s is %s in the baseline, %s now" % (file_name, field, base_host[field], host[field]))
+    return mismatches
+
+
+def write_baseline(path, current, gate):
+    """Write the gated repetitions of the current results as the baseline, one benchmark per line."""
+    os.makedirs(path, exist_ok=True)
+    for file_name, data in sorted(current.items()):
+        benchmarks = [{k: b[k] for k in BASELINE_FIELDS if k in b} for b in data.get("benchmarks", [])
+                      if is_repetition(b) and gate.search(b.get("run_name", b["name"]))]
+        out = os.path.join(path, file_name)
+        if not benchmarks:
+            if os.path.exists(out):
+                os.remove(out)
+            continue
+        context = {k: v for k, v in data.get("context", {}).items() if k not in ("load_avg", "executable")}
+        context.setdefault("cpu_model", local_cpu_model())
+        context["gate"] = gate.pattern
+        benchmarks.sort(key=lambda b: (b.get("run_name", b["name"]), b.get("repetition_index", 0)))
+        with open(out, "w") as f:
+            f.write('{\n"context": %s,\n"benchmarks": [\n' % json.dumps(context, sort_keys=True))
+            f.write(",\n".join(json.dumps(b) for b in benchmarks))
+            f.write("\n]\n}\n")
+        print("Wrote %d repetitions of %d benchmarks to %s"
+              % (len(benchmarks), len(set(b.get("run_name", b["name"]) for b in benchmarks)), out))
+
+
+def mann_whitney_greater(xs, ys):
+    """p-value of the one-sided Mann-Whitney U test that ys tend to be larger than xs.
+
+    Exact for small samples without ties, normal approximation with tie and continuity
+    correction otherwise.
+    """
+    n1, n2 = len(xs), len(ys)
+    # rank the pooled sample, ties get the average rank
+    pooled = sorted([(v, 1) for v in ys] + [(v, 0) for v in xs])
+    ranks, ties, i = [0.0] * len(pooled), [], 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for r in range(i, j + 1):
+            ranks[r] = (i + j) / 2.0 + 1.0
+        if j > i:
+            ties.append(j - i + 1)
+        i = j + 1
+    rank_sum = sum(r for r, (_, is_y) in zip(ranks, pooled) if is_y)
+    u = rank_sum - n2 * (n2 + 1) / 2.0     # pairs (x, y) with y > x
+
+    if not ties and n1 * n2 <= 400:
+        # counts[k]: number of orderings of n1 xs and n2 ys with U = k
+        counts = mann_whitney_counts(n1, n2)
+        total = sum(counts)
+        return sum(counts[int(u):]) / total
+
+    mean = n1 * n2 / 2.0
+    n = n1 + n2
+    tie_term = sum(t ** 3 - t for t in ties) / (n * (n - 1))
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term)
+    if var <= 0:
+        return 1.0
+    z = (u - mean - 0.5) / math.sqrt(var)
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def mann_whitney_counts(n1, n2):
+    """Distribution of U over all orderings, by the recurrence on the largest element."""
+    # table[a][b]: distribution for a xs and b ys
+    table = [[None] * (n2 + 1) for _ in range(n1 + 1)]
+    for a in range(n1 + 1):
+        for b in range(n2 + 1):
+            if a == 0 or b == 0:
+                table[a][b] = [1]
+                continue
+            # the largest element is a y (beats all a xs) or an x (beats nothing)
+            with_y = [0] * a + table[a][b - 1]
+            with_x = table[a - 1][b]
+            size = a * b + 1
+            table[a][b] = [
+                (with_y[k] if k < len(with_y) else 0) + (with_x[k] if k < len(with_x) else 0)
+                for k in range(size)
+            ]
+    return table[n1][n2]
+
+
+def format_time(seconds):
+    for unit in ("s", "ms", "us", "ns"):
+        if seconds >= TIME_UNITS[unit] or unit == "ns":
+            return "%.3f %s" % (seconds / TIME_UNITS[unit], unit)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="baseline JSON file or directory")
+    parser.add_argument("current", help="current JSON file or directory")
+    parser.add_argument("--gate", default=".*", help="regex of the benchmarks whose slowdowns fail the comparison")
+    parser.add_argument("--threshold", type=float, default=0.05, help="relative slowdown of the median to report (default 0.05)")
+    parser.add_argument("--alpha", type=float, default=0.05, help="significance level of the U test (default 0.05)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    parser.add_argument("--ignore-host", action="store_true", help="compare against a baseline taken on a different CPU")
+    parser.add_argument("--update", action="store_true", help="write the gated benchmarks of CURRENT to the BASELINE directory")
+    args = parser.parse_args()
+
+    gate = re.compile(args.gate)
+    current_files = load_files(args.current)
+    if args.update:
+        write_baseline(args.baseline, current_files, gate)
+        return 0
+
+    baseline_files = load_files(args.baseline)
+    mismatches = host_mismatches(baseline_files, current_files)
+    if mismatches:
+        print("The baseline was taken on a different host:", file=sys.stderr)
+        for m in mismatches:
+            print("  " + m, file=sys.stderr)
+        if not args.ignore_host:
+            print("Refusing to gate; regenerate the baseline on this machine or pass --ignore-host", file=sys.stderr)
+            return 2
+
+    baseline = {f: load_runs(data, args.metric) for f, data in baseline_files.items()}
+    current = {f: load_runs(data, args.metric) for f, data in current_files.items()}
+
+    failures, rows, too_few = [], [], False
+    for file_name in sorted(current):
+        base_runs = baseline.get(file_name, {})
+        # repetitions may be interleaved, so report in name order
+        for name, times in sorted(current[file_name].items()):
+            if name not in base_runs:
+                rows.append((name, "-", format_time(statistics.median(times)), "", "", "new"))
+                continue
+            base_times = base_runs[name]
+            base_median, median = statistics.median(base_times), statistics.median(times)
+            change = median / base_median - 1.0 if base_median > 0 else 0.0
+            p_slower = mann_whitney_greater(base_times, times)
+            p_faster = mann_whitney_greater(times, base_times)
+            too_few |= min(len(base_times), len(times)) < 5
+
+            status = ""
+            if change > args.threshold and p_slower < args.alpha:
+                gated = gate.search(name) is not None
+                status = "SLOWER" if gated else "slower"
+                if gated:
+                    failures.append(name)
+            elif change < -args.threshold and p_faster < args.alpha:
+                status = "faster"
+            p = p_slower if change >= 0 else p_faster
+            rows.append((name, format_time(base_median), format_time(median), "%+.1f%%" % (100.0 * change), "%.4f" % p, status))
+
+    if not rows:
+        print("No benchmark results to compare", file=sys.stderr)
+        return 2
+
+    header = ("Benchmark", "Baseline", "Current", "Change", "p-value", "")
+    widths = [max(len(r[c]) for r in rows + [header]) for c in range(len(header))]
+    for r in [header] + rows:
+        print("  ".join(v.ljust(w) if c == 0 else v.rjust(w) for c, (v, w) in enumerate(zip(r, widths))).rstrip())
+
+    if too_few:
+        print("\nWarning: fewer than 5 repetitions per benchmark, the U test cannot detect slowdowns reliably", file=sys.stderr)
+    if failures:
+        print("\n%d gated benchmark(s) significantly slower than the baseline (median > +%.0f%%, p < %g):"
+              % (len(failures), 100.0 * args.threshold, args.alpha))
+        for name in failures:
+            print("  " + name)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -255,6 +255,23 @@ cgrad_status cgrad_compute_graph_forward(
     const uuid_t target_node_id
 );
 
+/**
+ * @brief Drop the cached result of an operation node.
+ * 
+ * The next forward pass to the node executes its whole dependency subgraph again, reusing
+ * the storage objects of the intermediate nodes. Until then, backward passes through the
+ * node fail with CGRAD_ERR_COMPUTE_GRAPH_FORWARD_NOT_EXECUTED.
+ * 
+ * @param graph Compute graph containing the node.
+ * @param node_id Operation node whose result to drop.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION for leaf nodes,
+ *         error code otherwise.
+ */
+cgrad_status cgrad_compute_graph_invalidate(
+    cgrad_compute_graph* graph,
+    const uuid_t node_id
+);
+
 // ============================================================================
 // Backward Pass Functions
 // ============================================================================
@@ -269,6 +286,10 @@ cgrad_status cgrad_compute_graph_forward(
  * 4. Accumulates gradients when a node is used multiple times
  * 5. Stores gradients in each node's grad_storage field
  * 
+ * Leaf gradients accumulate over backward passes until they are zeroed, so several
+ * micro-batches can be backpropagated into the same buffers. Gradients of operation nodes
+ * are cleared in place at the start of every pass instead of being reallocated.
+ * 
  * The target tensor must have been executed (forward pass) before calling backward.
  * 
  * @param graph Compute graph containing the nodes.
@@ -280,6 +301,37 @@ cgrad_status cgrad_compute_graph_backward(
     const uuid_t target_node_id
 );
 
+/**
+ * @brief Callback invoked by a backward pass once the gradient of a leaf node is final.
+ * 
+ * @param node_id Leaf node.
+ * @param grad_storage Gradient storage of the node. It is not modified by the rest of the pass.
+ * @param user_data Argument given to the backward pass.
+ */
+typedef void (*cgrad_grad_ready_hook)(const uuid_t node_id, cgrad_storage* grad_storage, void* user_data);
+
+/**
+ * @brief Compute gradients like cgrad_compute_graph_backward and report every leaf gradient
+ *        as soon as it is final.
+ * 
+ * Nodes are processed in reverse topological order, so all consumers of a leaf are processed
+ * before the leaf is reached: the hook is called at that point, for every leaf that requires
+ * gradients and received one. Leaves close to the target (e.g. the last layer of a model) are
+ * reported first.
+ * 
+ * @param graph Compute graph containing the nodes.
+ * @param target_node_id Target node (typically a scalar loss).
+ * @param hook Callback invoked once per leaf gradient (may be NULL).
+ * @param user_data Argument passed to hook.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_compute_graph_backward_with_hook(
+    cgrad_compute_graph* graph,
+    const uuid_t target_node_id,
+    cgrad_grad_ready_hook hook,
+    void* user_data
+);
+
 /**
  * @brief Zero out all gradients in the computation graph.
  * 
@@ -316,6 +368,25 @@ cgrad_status cgrad_compute_graph_set_requires_grad(
     int requires_grad
 );
 
+/**
+ * @brief Use the given storage as gradient storage of a node.
+ * 
+ * The node keeps a shallow copy of the storage (replacing any existing gradient), so
+ * backward passes accumulate directly into its memory, e.g. a view into a flat buffer
+ * shared by all parameters.
+ * 
+ * @param graph Compute graph.
+ * @param node_id Node identifier.
+ * @param storage Gradient storage with the shape of the node.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH if the shapes differ,
+ *         error code otherwise.
+ */
+cgrad_status cgrad_compute_graph_set_grad_storage(
+    cgrad_compute_graph* graph,
+    const uuid_t node_id,
+    const cgrad_storage* storage
+);
+
 /**
  * @brief Get the storage of a node.
  * 
@@ -34,6 +34,22 @@ typedef union cgrad_op_metadata {
         int ndim;                   /**< Number of dimensions */
     } reduce_sum;
     
+    struct {
+        uint32_t start[TENSOR_DIM]; /**< First index per dim */
+        uint32_t stop[TENSOR_DIM];  /**< End index per dim (exclusive) */
+        uint32_t step[TENSOR_DIM];  /**< Step per dim */
+        int ndim;                   /**< Number of trailing dimensions to slice */
+    } slice;
+    
+    struct {
+        int dim;                    /**< Dimension to select from */
+        uint32_t index;             /**< Index along dim */
+    } select;
+    
+    struct {
+        int dim;                    /**< Dimension to concatenate along */
+    } cat;
+    
     struct {
         float alpha;                /**< Scalar multiplier for A*B */
         float beta;                 /**< Scalar multiplier for C */
@@ -43,6 +59,19 @@ typedef union cgrad_op_metadata {
         float alpha;                /**< Scalar multiplier for x in y = alpha*x + y */
     } axpy;
     
+    struct {
+        cgrad_unary_op op;          /**< Elementwise function to apply */
+    } unary;
+    
+    struct {
+        int log;                    /**< 1 for log-softmax, 0 for softmax */
+    } softmax;
+    
+    struct {
+        cgrad_conv2d_params params; /**< Stride, padding and dilation (kernel is taken from the weight) */
+        cgrad_conv2d_algo algo;     /**< Lowering used by the forward pass */
+    } conv2d;
+    
     float scalar;                   /**< For scalar operations */
 } cgrad_op_metadata;
 
@@ -93,6 +122,15 @@ typedef int (*cgrad_op_backward_fn)(
     const int* input_requires_grad
 );
 
+/**
+ * @brief Function pointer type for releasing an operation context.
+ * 
+ * Called before the forward pass is re-executed and when the owning node is freed.
+ * 
+ * @param ctx Context pointer set by the forward pass (may be NULL).
+ */
+typedef void (*cgrad_op_free_ctx_fn)(void* ctx);
+
 /**
  * @brief Operation descriptor containing forward and backward functions.
  */
@@ -100,6 +138,8 @@ typedef struct cgrad_op_descriptor {
     const char* name;                /**< Human-readable name */
     cgrad_op_forward_fn forward;     /**< Forward pass function */
     cgrad_op_backward_fn backward;   /**< Backward pass function */
+    cgrad_op_free_ctx_fn free_ctx;   /**< Releases the forward context (NULL if the op never allocates one) */
+    int inplace;                     /**< 1 if forward accepts an output that shares the data of input 0 */
 } cgrad_op_descriptor;
 
 /**
@@ -156,6 +196,115 @@ int cgrad_op_gemm_backward(
     const int* input_requires_grad
 );
 
+// Elementwise multiplication operation
+int cgrad_op_mul_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_mul_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
+// Elementwise unary operations (ReLU, GELU, tanh, sigmoid, exp, log)
+int cgrad_op_unary_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_unary_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
+void cgrad_op_unary_free_ctx(void* ctx);
+
+// Softmax and log-softmax along the last dimension
+int cgrad_op_softmax_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_softmax_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
+// Fused softmax cross-entropy loss (mean over rows)
+int cgrad_op_softmax_cross_entropy_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_softmax_cross_entropy_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
+void cgrad_op_softmax_cross_entropy_free_ctx(void* ctx);
+
+// 2D convolution
+int cgrad_op_conv2d_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_conv2d_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
 // Transpose operation
 int cgrad_op_transpose_forward(
     cgrad_storage** inputs,
@@ -198,6 +347,69 @@ int cgrad_op_reshape_backward(
     const int* input_requires_grad
 );
 
+// Slice operation (also used for narrow)
+int cgrad_op_slice_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_slice_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
+// Select operation
+int cgrad_op_select_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_select_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
+// Concatenation
+int cgrad_op_cat_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+);
+
+int cgrad_op_cat_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+);
+
 // Reduce sum operation
 int cgrad_op_reduce_sum_forward(
     cgrad_storage** inputs,
@@ -235,6 +447,87 @@ static const cgrad_op_descriptor cgrad_op_gemm = {
     .backward = cgrad_op_gemm_backward
 };
 
+static const cgrad_op_descriptor cgrad_op_mul = {
+    .name = "MUL",
+    .forward = cgrad_op_mul_forward,
+    .backward = cgrad_op_mul_backward
+};
+
+static const cgrad_op_descriptor cgrad_op_relu = {
+    .name = "RELU",
+    .forward = cgrad_op_unary_forward,
+    .backward = cgrad_op_unary_backward,
+    .free_ctx = cgrad_op_unary_free_ctx,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_gelu = {
+    .name = "GELU",
+    .forward = cgrad_op_unary_forward,
+    .backward = cgrad_op_unary_backward,
+    .free_ctx = cgrad_op_unary_free_ctx,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_tanh = {
+    .name = "TANH",
+    .forward = cgrad_op_unary_forward,
+    .backward = cgrad_op_unary_backward,
+    .free_ctx = cgrad_op_unary_free_ctx,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_sigmoid = {
+    .name = "SIGMOID",
+    .forward = cgrad_op_unary_forward,
+    .backward = cgrad_op_unary_backward,
+    .free_ctx = cgrad_op_unary_free_ctx,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_exp = {
+    .name = "EXP",
+    .forward = cgrad_op_unary_forward,
+    .backward = cgrad_op_unary_backward,
+    .free_ctx = cgrad_op_unary_free_ctx,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_log = {
+    .name = "LOG",
+    .forward = cgrad_op_unary_forward,
+    .backward = cgrad_op_unary_backward,
+    .free_ctx = cgrad_op_unary_free_ctx,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_softmax = {
+    .name = "SOFTMAX",
+    .forward = cgrad_op_softmax_forward,
+    .backward = cgrad_op_softmax_backward,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_log_softmax = {
+    .name = "LOG_SOFTMAX",
+    .forward = cgrad_op_softmax_forward,
+    .backward = cgrad_op_softmax_backward,
+    .inplace = 1
+};
+
+static const cgrad_op_descriptor cgrad_op_softmax_cross_entropy = {
+    .name = "SOFTMAX_CROSS_ENTROPY",
+    .forward = cgrad_op_softmax_cross_entropy_forward,
+    .backward = cgrad_op_softmax_cross_entropy_backward,
+    .free_ctx = cgrad_op_softmax_cross_entropy_free_ctx
+};
+
+static const cgrad_op_descriptor cgrad_op_conv2d = {
+    .name = "CONV2D",
+    .forward = cgrad_op_conv2d_forward,
+    .backward = cgrad_op_conv2d_backward
+};
+
 static const cgrad_op_descriptor cgrad_op_transpose = {
     .name = "TRANSPOSE",
     .forward = cgrad_op_transpose_forward,
@@ -247,6 +540,24 @@ static const cgrad_op_descriptor cgrad_op_reshape = {
     .backward = cgrad_op_reshape_backward
 };
 
+static const cgrad_op_descriptor cgrad_op_slice = {
+    .name = "SLICE",
+    .forward = cgrad_op_slice_forward,
+    .backward = cgrad_op_slice_backward
+};
+
+static const cgrad_op_descriptor cgrad_op_select = {
+    .name = "SELECT",
+    .forward = cgrad_op_select_forward,
+    .backward = cgrad_op_select_backward
+};
+
+static const cgrad_op_descriptor cgrad_op_cat = {
+    .name = "CAT",
+    .forward = cgrad_op_cat_forward,
+    .backward = cgrad_op_cat_backward
+};
+
 static const cgrad_op_descriptor cgrad_op_reduce_sum = {
     .name = "REDUCE_SUM",
     .forward = cgrad_op_reduce_sum_forward,
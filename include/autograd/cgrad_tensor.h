@@ -202,6 +202,23 @@ cgrad_status cgrad_tensor_sub(
     cgrad_tensor* out_tensor
 );
 
+/**
+ * @brief Element-wise (Hadamard) multiplication: out = a * b
+ * 
+ * Supports broadcasting; the gradient of a broadcasted input is summed
+ * over the broadcasted dimensions.
+ * 
+ * @param a First input tensor.
+ * @param b Second input tensor.
+ * @param out_tensor Pointer to output tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_mul(
+    const cgrad_tensor* a,
+    const cgrad_tensor* b,
+    cgrad_tensor* out_tensor
+);
+
 /**
  * @brief Batched matrix multiplication: out = a @ b
  * @param a First input tensor (shape: ..., m, k).
@@ -215,6 +232,30 @@ cgrad_status cgrad_tensor_gemm(
     cgrad_tensor* out_tensor
 );
 
+/**
+ * @brief 2D convolution (cross-correlation) over the last two dimensions.
+ * 
+ * The kernel size is taken from the weight. The forward pass lowers to im2col
+ * followed by a batched GEMM, or to a direct implicit-GEMM kernel when the
+ * column buffer would get too large.
+ * 
+ * @param input Input tensor (shape: N, C, H, W).
+ * @param weight Weight tensor (shape: O, C, KH, KW).
+ * @param stride Stride along (H, W), or NULL for {1, 1}.
+ * @param padding Zero padding along (H, W), or NULL for {0, 0}.
+ * @param dilation Dilation along (H, W), or NULL for {1, 1}.
+ * @param out_tensor Pointer to output tensor (shape: N, O, OH, OW).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_conv2d(
+    const cgrad_tensor* input,
+    const cgrad_tensor* weight,
+    const uint32_t* stride,
+    const uint32_t* padding,
+    const uint32_t* dilation,
+    cgrad_tensor* out_tensor
+);
+
 // ============================================================================
 // Unary Operations
 // ============================================================================
@@ -259,6 +300,89 @@ cgrad_status cgrad_tensor_reshape(
     cgrad_tensor* out_tensor
 );
 
+/**
+ * @brief Slice the last ndim dimensions to the ranges [start, stop) with the given steps.
+ * 
+ * The output is a view into the input (no data is copied).
+ * Example: start={1,0}, stop={3,4}, step={1,2} on shape (4,4) -> shape (2,2)
+ * 
+ * @param tensor Input tensor.
+ * @param start Array of first indices (length ndim).
+ * @param stop Array of end indices, exclusive (length ndim).
+ * @param step Array of steps (length ndim), or NULL for all ones.
+ * @param ndim Number of dimensions to slice.
+ * @param out_tensor Pointer to output tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_slice(
+    const cgrad_tensor* tensor,
+    const uint32_t* start,
+    const uint32_t* stop,
+    const uint32_t* step,
+    int ndim,
+    cgrad_tensor* out_tensor
+);
+
+/**
+ * @brief Narrow a single dimension to [start, start + length).
+ * 
+ * The output is a view into the input (no data is copied).
+ * Negative dims count from the last dimension (-1 is the last).
+ * 
+ * @param tensor Input tensor.
+ * @param dim Dimension to narrow.
+ * @param start First index along dim.
+ * @param length Number of indices to keep.
+ * @param out_tensor Pointer to output tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_narrow(
+    const cgrad_tensor* tensor,
+    int dim,
+    uint32_t start,
+    uint32_t length,
+    cgrad_tensor* out_tensor
+);
+
+/**
+ * @brief Pick a single index along a dimension and drop that dimension.
+ * 
+ * The output is a view into the input (no data is copied).
+ * Example: dim=-2, index=1 on shape (4,3) -> shape (3,)
+ * 
+ * @param tensor Input tensor.
+ * @param dim Dimension to select from (negative dims count from the last dimension).
+ * @param index Index along dim.
+ * @param out_tensor Pointer to output tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_select(
+    const cgrad_tensor* tensor,
+    int dim,
+    uint32_t index,
+    cgrad_tensor* out_tensor
+);
+
+/**
+ * @brief Concatenate tensors along a dimension.
+ * 
+ * All tensors must match in every other dimension. Each input is written
+ * directly into its slice of the output.
+ * Example: shapes (2,3) and (2,5) with dim=-1 -> shape (2,8)
+ * 
+ * @param tensors Array of input tensors.
+ * @param n Number of input tensors (at most MAX_NODE_INPUTS).
+ * @param dim Dimension to concatenate along (negative dims count from the last dimension).
+ * @param out_tensor Pointer to output tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_cat(
+    const cgrad_tensor* const* tensors,
+    int n,
+    int dim,
+    cgrad_tensor* out_tensor
+);
+
 /**
  * @brief Sum reduction along specified axes.
  * 
@@ -278,6 +402,62 @@ cgrad_status cgrad_tensor_reduce_sum(
     cgrad_tensor* out_tensor
 );
 
+// ============================================================================
+// Activation Functions
+// ============================================================================
+
+/**
+ * @brief Elementwise activations: out = f(tensor) for f in ReLU, GELU, tanh, sigmoid, exp, log.
+ * 
+ * GELU uses the tanh approximation. When gradients are required, the derivative
+ * is computed during the forward pass and cached for the backward pass. Without
+ * gradients, the result may be written into the storage of the input if the input
+ * is an intermediate result that nothing else refers to.
+ * 
+ * @param tensor Input tensor.
+ * @param out_tensor Pointer to output tensor (same shape as input).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_relu(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+cgrad_status cgrad_tensor_gelu(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+cgrad_status cgrad_tensor_tanh(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+cgrad_status cgrad_tensor_sigmoid(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+cgrad_status cgrad_tensor_exp(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+cgrad_status cgrad_tensor_log(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+
+/**
+ * @brief Softmax and log-softmax along the last dimension.
+ * 
+ * Each row is normalized with a numerically stable logsumexp, so large logits
+ * do not overflow. Like the elementwise activations, the result may be written
+ * into the storage of the input when no gradients are required.
+ * 
+ * @param tensor Input tensor.
+ * @param out_tensor Pointer to output tensor (same shape as input).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_softmax(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+cgrad_status cgrad_tensor_log_softmax(const cgrad_tensor* tensor, cgrad_tensor* out_tensor);
+
+/**
+ * @brief Fused softmax cross-entropy loss: out = mean over rows of -sum(target * log_softmax(logits)).
+ * 
+ * Rows are taken along the last dimension. The target holds a distribution per row
+ * (e.g. one-hot class labels) and must have the same shape as the logits. The
+ * softmax itself is never materialized; only the per-row logsumexp is kept for
+ * the backward pass.
+ * 
+ * @param logits Unnormalized scores.
+ * @param target Target distribution (same shape as logits).
+ * @param out_tensor Pointer to output tensor (scalar).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_softmax_cross_entropy(
+    const cgrad_tensor* logits,
+    const cgrad_tensor* target,
+    cgrad_tensor* out_tensor
+);
+
 // ============================================================================
 // Execution
 // ============================================================================
@@ -302,6 +482,18 @@ cgrad_status cgrad_tensor_reduce_sum(
  */
 cgrad_status cgrad_tensor_execute(cgrad_tensor* tensor);
 
+/**
+ * @brief Drop the cached result of a tensor computed by an operation.
+ * 
+ * The next execution recomputes the tensor and all operations it depends on, e.g. after
+ * the data of its leaves changed in place.
+ * 
+ * @param tensor Tensor whose cached result to drop.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION for leaf tensors,
+ *         error code otherwise.
+ */
+cgrad_status cgrad_tensor_invalidate(cgrad_tensor* tensor);
+
 /**
  * @brief Get the underlying storage of a tensor.
  * 
@@ -398,6 +590,18 @@ cgrad_status cgrad_tensor_get_gradient(const cgrad_tensor* t, cgrad_tensor* grad
  */
 cgrad_status cgrad_tensor_zero_grad(cgrad_tensor* tensor);
 
+/**
+ * @brief Make backward passes accumulate the gradient of a tensor into the given storage.
+ * 
+ * The storage replaces any existing gradient and is shared, not copied: it typically is a
+ * view into a flat gradient buffer (see cgrad_param_group.h).
+ * 
+ * @param tensor Tensor whose gradient storage is set.
+ * @param storage Gradient storage with the shape of the tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_set_grad_storage(cgrad_tensor* tensor, const cgrad_storage* storage);
+
 /**
  * @brief Compute gradients by backpropagation through the computation graph.
  * 
@@ -408,6 +612,10 @@ cgrad_status cgrad_tensor_zero_grad(cgrad_tensor* tensor);
  * 4. Accumulates gradients when a node is used multiple times
  * 5. Stores gradients in each node's grad_storage field
  * 
+ * Leaf gradients accumulate over backward passes until they are zeroed, so several
+ * micro-batches can be backpropagated into the same buffers. Gradients of operation nodes
+ * are cleared in place at the start of every pass instead of being reallocated.
+ * 
  * The target tensor must have been executed (forward pass) before calling backward.
  * 
  * @param tensor Target tensor (typically a scalar loss).
@@ -415,4 +623,18 @@ cgrad_status cgrad_tensor_zero_grad(cgrad_tensor* tensor);
  */
 cgrad_status cgrad_tensor_backward(cgrad_tensor* tensor);
 
+/**
+ * @brief Compute gradients like cgrad_tensor_backward and report every leaf gradient as soon
+ *        as it is final (see cgrad_compute_graph_backward_with_hook).
+ * 
+ * The remaining backward pass can then overlap with work on the finished gradients, e.g.
+ * communicating them to other processes.
+ * 
+ * @param tensor Target tensor (typically a scalar loss).
+ * @param hook Callback invoked once per leaf gradient, on the calling thread (may be NULL).
+ * @param user_data Argument passed to hook.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_tensor_backward_with_hook(cgrad_tensor* tensor, cgrad_grad_ready_hook hook, void* user_data);
+
 #endif // CGRAD_TENSOR_H
@@ -14,6 +14,48 @@
  * Backends are responsible for managing data storage and performing operations on that data.
  */
 
+/**
+ * @brief Elementwise unary functions supported by storage_unary.
+ */
+typedef enum cgrad_unary_op {
+    CGRAD_UNARY_RELU,       /**< max(x, 0) */
+    CGRAD_UNARY_GELU,       /**< x * sigmoid(2 * sqrt(2/pi) * (x + 0.044715 * x^3)), i.e. tanh-approximated GELU */
+    CGRAD_UNARY_TANH,       /**< tanh(x) */
+    CGRAD_UNARY_SIGMOID,    /**< 1 / (1 + exp(-x)) */
+    CGRAD_UNARY_EXP,        /**< exp(x) */
+    CGRAD_UNARY_LOG,        /**< log(x) */
+} cgrad_unary_op;
+
+/**
+ * @brief Parameter update rules supported by storage_optim_step.
+ */
+typedef enum cgrad_optim_kind {
+    CGRAD_OPTIM_SGD,        /**< p -= lr * d with d = g + weight_decay * p, optionally through a (Nesterov) momentum buffer */
+    CGRAD_OPTIM_ADAM,       /**< Adam, weight decay is added to the gradient (L2 penalty) */
+    CGRAD_OPTIM_ADAMW,      /**< Adam with decoupled weight decay p -= lr * weight_decay * p */
+} cgrad_optim_kind;
+
+/**
+ * @brief Hyperparameters of one optimizer step, including the Adam bias corrections of the step.
+ */
+typedef struct cgrad_optim_update {
+    cgrad_optim_kind kind;
+    float lr;                   /**< Learning rate */
+    float weight_decay;         /**< L2 penalty (SGD, Adam) or decoupled decay (AdamW) */
+    float momentum;             /**< SGD momentum, 0 to update without momentum buffer */
+    int nesterov;               /**< SGD: nonzero for Nesterov momentum */
+    float beta1;                /**< Adam: decay of the first moment */
+    float beta2;                /**< Adam: decay of the second moment */
+    float eps;                  /**< Adam: term added to the denominator */
+    float bias_correction1;     /**< Adam: 1 - beta1^t for step t */
+    float bias_correction2;     /**< Adam: 1 - beta2^t for step t */
+} cgrad_optim_update;
+
+/**
+ * @brief Maximum number of tensors a single storage_optim_step call updates.
+ */
+#define CGRAD_BACKEND_OPTIM_MAX_TENSORS 32
+
 /**
  * @brief Backend interface for storage operations.
  * 
@@ -39,6 +81,18 @@ typedef struct cgrad_backend {
      */
     int  (*storage_init)(void* t, const uint32_t* shape, int ndim);
 
+    /**
+     * @brief Initialize a storage around existing host memory without copying it.
+     * The storage does not own data: when it is freed, release(release_ctx) is called
+     * instead of freeing data (nothing is called if release is NULL).
+     * @param t Pointer to storage.
+     * @param layout Layout of the elements in data (including its offset).
+     * @param data Memory holding the elements addressed by layout.
+     * @param release Callback invoked when the storage is freed, or NULL.
+     * @param release_ctx Argument passed to release.
+     */
+    int  (*storage_wrap)(void* t, const cgrad_storage_layout* layout, void* data, void (*release)(void* ctx), void* release_ctx);
+
     /**
      * @brief Fill the storage with a constant value.
      * @param t Pointer to storage.
@@ -46,6 +100,13 @@ typedef struct cgrad_backend {
      */
     int  (*storage_fill)(void* t, float value);
 
+    /**
+     * @brief Set all elements of the storage to zero in-place (e.g. resetting gradient buffers).
+     * Optional: storages of backends without it are filled with 0.0f instead.
+     * @param t Pointer to storage.
+     */
+    int  (*storage_zero)(void* t);
+
     /**
      * @brief Fill the storage with random values.
      */
@@ -62,6 +123,12 @@ typedef struct cgrad_backend {
      */
     int  (*storage_contiguous)(const void* src, void* dst);
 
+    /**
+     * @brief Copy the elements of src into dst. Both storages must have the same shape;
+     * dst may be a strided view (e.g. a slice of a larger storage) but not a broadcast.
+     */
+    int  (*storage_copy)(const void* src, void* dst);
+
     /**
      * @brief Free the memory associated with a storage.
      */
@@ -70,6 +137,7 @@ typedef struct cgrad_backend {
     // --- Math Ops ---
     /**
      * @brief Compute y = alpha * x + y (AXPY operation).
+     * y may be a strided view (e.g. a slice of a larger storage) but not a broadcast.
      * @param alpha Scaling factor for x.
      * @param x First input storage (read-only).
      * @param y Second input storage (modified in-place).
@@ -86,6 +154,133 @@ typedef struct cgrad_backend {
      */
     int  (*storage_gemm)(float alpha, void* a, void* b, float beta, void* c);
 
+    /**
+     * @brief Compute the elementwise product r = alpha * x * y + beta * r.
+     * All storages must have the same shape. r may contain zero strides (a broadcast
+     * view of a smaller storage), in which case the products are summed into the
+     * shared elements and beta is applied to each shared element exactly once.
+     * @param alpha Scaling factor for the product.
+     * @param x First input storage.
+     * @param y Second input storage.
+     * @param beta Scaling factor for the output storage.
+     * @param r Output storage (modified in-place).
+     */
+    int  (*storage_mul)(float alpha, void* x, void* y, float beta, void* r);
+
+    /**
+     * @brief Apply an elementwise unary function r = f(x), optionally writing f'(x) into dr.
+     * All storages must have the same shape. r and dr must be contiguous; r may share
+     * its data with x (in-place execution) as long as both use the same layout.
+     * @param op Unary function to apply.
+     * @param x Input storage.
+     * @param r Output storage (modified in-place).
+     * @param dr Storage receiving the derivative of f at x, or NULL to skip it.
+     */
+    int  (*storage_unary)(cgrad_unary_op op, void* x, void* r, void* dr);
+
+    /**
+     * @brief Compute r = softmax(x) or r = log_softmax(x) along the last dimension.
+     * x and r must have the same shape and r must be contiguous; r may share its data
+     * with x (in-place execution) as long as both use the same layout.
+     * @param log_softmax Nonzero to compute log-softmax instead of softmax.
+     * @param x Input storage.
+     * @param r Output storage (modified in-place).
+     */
+    int  (*storage_softmax)(int log_softmax, void* x, void* r);
+
+    /**
+     * @brief Accumulate the gradient of a (log-)softmax into grad_x, given its output y.
+     * All storages must have the same shape and be contiguous.
+     * @param log_softmax Nonzero if y is the output of log-softmax.
+     * @param y Output of the forward pass.
+     * @param grad_y Gradient with respect to y.
+     * @param grad_x Gradient with respect to the input (modified in-place).
+     */
+    int  (*storage_softmax_backward)(int log_softmax, void* y, void* grad_y, void* grad_x);
+
+    /**
+     * @brief Compute the mean cross-entropy between softmax(x) and target over all rows
+     * of the last dimension. All storages must be contiguous.
+     * @param x Logits.
+     * @param target Target distribution, same shape as x (e.g. one-hot rows).
+     * @param loss Single-element storage receiving the mean loss.
+     * @param lse Storage with one element per row receiving log(sum(exp(x))), or NULL.
+     */
+    int  (*storage_softmax_cross_entropy)(void* x, void* target, void* loss, void* lse);
+
+    /**
+     * @brief Accumulate alpha times the per-row cross-entropy gradients:
+     * grad_x += alpha * (softmax(x) * sum(target) - target) and
+     * grad_target += alpha * (lse - x). All storages must be contiguous.
+     * @param alpha Scaling factor for the gradients.
+     * @param x Logits.
+     * @param target Target distribution, same shape as x.
+     * @param lse Per-row log(sum(exp(x))) from the forward pass.
+     * @param grad_x Gradient with respect to x (modified in-place), or NULL to skip it.
+     * @param grad_target Gradient with respect to target (modified in-place), or NULL to skip it.
+     */
+    int  (*storage_softmax_cross_entropy_backward)(float alpha, void* x, void* target, void* lse, void* grad_x, void* grad_target);
+
+    /**
+     * @brief Unfold the convolution patches of an (N, C, H, W) input into columns.
+     * cols has shape (N, C * KH * KW, OH * OW); out-of-bounds taps (padding) are zero.
+     * Both storages must be contiguous.
+     * @param p Convolution parameters (kernel must be set).
+     * @param x Input storage.
+     * @param cols Column storage (overwritten).
+     */
+    int  (*storage_im2col)(const cgrad_conv2d_params* p, void* x, void* cols);
+
+    /**
+     * @brief Inverse of storage_im2col: add every column entry to the input element it
+     * was taken from. Both storages must be contiguous.
+     * @param p Convolution parameters (kernel must be set).
+     * @param cols Column storage of shape (N, C * KH * KW, OH * OW).
+     * @param x Storage of shape (N, C, H, W) (modified in-place).
+     */
+    int  (*storage_col2im)(const cgrad_conv2d_params* p, void* cols, void* x);
+
+    /**
+     * @brief Direct (implicit GEMM) 2D convolution r = conv2d(x, w) without an im2col buffer.
+     * x has shape (N, C, H, W), w has shape (O, C, KH, KW) and r has shape (N, O, OH, OW).
+     * All storages must be contiguous.
+     * @param p Convolution parameters (kernel must be set).
+     * @param x Input storage.
+     * @param w Weight storage.
+     * @param r Output storage (overwritten).
+     */
+    int  (*storage_conv2d)(const cgrad_conv2d_params* p, void* x, void* w, void* r);
+
+    /**
+     * @brief Apply one optimizer step to n parameters in a single pass, updating the
+     * parameters and their optimizer state in-place. For every i, params[i], grads[i],
+     * m[i] and v[i] must have the same shape and be contiguous.
+     * @param u Update rule and hyperparameters.
+     * @param n Number of parameters (<= CGRAD_BACKEND_OPTIM_MAX_TENSORS).
+     * @param params Parameter storages (modified in-place).
+     * @param grads Gradient storages.
+     * @param m SGD momentum buffers or Adam first moments (modified in-place), NULL for SGD without momentum.
+     * @param v Adam second moments (modified in-place), NULL for SGD.
+     */
+    int  (*storage_optim_step)(const cgrad_optim_update* u, int n, void* const* params, void* const* grads, void* const* m, void* const* v);
+
+    /**
+     * @brief Compute the sum of squares of all elements of n contiguous storages in a single pass.
+     * The result does not depend on the number of threads.
+     * @param n Number of storages (<= CGRAD_BACKEND_OPTIM_MAX_TENSORS).
+     * @param ts Storages.
+     * @param out Receives the sum of squares.
+     */
+    int  (*storage_sum_squares)(int n, void* const* ts, double* out);
+
+    /**
+     * @brief Multiply all elements of n contiguous storages in-place by alpha in a single pass.
+     * @param n Number of storages (<= CGRAD_BACKEND_OPTIM_MAX_TENSORS).
+     * @param ts Storages (modified in-place).
+     * @param alpha Scale factor.
+     */
+    int  (*storage_scale)(int n, void* const* ts, float alpha);
+
     // --- Data Access/Info ---
     /**
      * @brief Get the value at the given indices.
@@ -44,7 +44,8 @@ cgrad_status cgrad_init(void) __attribute__((constructor));
  * This function cleans up all global state in the cgrad library:
  * 1. Global compute graph
  * 2. Global storage registry
- * 3. Backend registry
+ * 3. Spare checkpoint staging buffer
+ * 4. Backend registry
  * 
  * This should be called when the library is no longer needed, typically
  * at program shutdown. After calling this function, the library must be
@@ -38,6 +38,12 @@
 #define CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE      -1306
 #define CGRAD_ERR_STORAGE_LAYOUT_NOT_REGULAR                -1307
 #define CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS             -1308
+#define CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE                  -1309
+
+// Storage file errors
+#define CGRAD_ERR_STORAGE_FILE_IO                           -1401
+#define CGRAD_ERR_STORAGE_FILE_INVALID                      -1402
+#define CGRAD_ERR_STORAGE_FILE_TENSOR_NOT_FOUND             -1403
 
 // Compute graph errors
 #define CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION           -1501
@@ -51,6 +57,25 @@
 #define CGRAD_ERR_COMPUTE_GRAPH_FORWARD_NOT_EXECUTED        -1509
 #define CGRAD_ERR_COMPUTE_GRAPH_REQUIRES_GRAD_FALSE         -1510
 
+// Data loader errors
+#define CGRAD_ERR_DATA_LOADER_INVALID_CONFIG                -1601
+#define CGRAD_ERR_DATA_LOADER_EXHAUSTED                     -1602
+
+// Data parallel errors
+#define CGRAD_ERR_DATA_PARALLEL_INVALID_CONFIG              -1701
+#define CGRAD_ERR_DATA_PARALLEL_SHM                         -1702
+#define CGRAD_ERR_DATA_PARALLEL_MISMATCH                    -1703
+#define CGRAD_ERR_DATA_PARALLEL_TIMEOUT                     -1704
+#define CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED               -1705
+
+// Profiler errors
+#define CGRAD_ERR_PROFILER_IO                               -1801
+#define CGRAD_ERR_PROFILER_INVALID_HOOK                     -1802
+#define CGRAD_ERR_PROFILER_PERF_UNAVAILABLE                 -1803
+
+// Optimizer errors
+#define CGRAD_ERR_OPTIM_INVALID_CONFIG                      -1901
+
 /**
  * @typedef cgrad_status
  * @brief Represents the result of a cgrad operation.
@@ -0,0 +1,103 @@
+#ifndef CGRAD_DATA_LOADER_H
+#define CGRAD_DATA_LOADER_H
+
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "storage/cgrad_storage_layout.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_data_loader.h
+ * @brief Streaming mini-batch loader for fixed-record binary files.
+ *
+ * A dataset file is a flat sequence of records without header. Every record holds the float32
+ * values of one input sample followed by the float32 values of its target, in native byte order.
+ * The file is memory-mapped, so datasets larger than memory are paged in on demand.
+ *
+ * Worker threads assemble batches in order into a ring of reusable batch buffers, while the
+ * training loop consumes the previous ones: batch N+1 is ready when step N finishes. Every ring
+ * slot owns a pair of leaf tensors over its buffers that are created once, so consuming a batch
+ * neither allocates storage nor adds graph nodes.
+ */
+
+/**
+ * @brief Configuration of a data loader.
+ */
+typedef struct cgrad_data_loader_config {
+    const char* path;                       /**< Dataset file */
+    uint32_t input_shape[TENSOR_DIM];       /**< Shape of one input sample (first input_ndim entries) */
+    int input_ndim;                         /**< Number of input sample dims (1 <= input_ndim < TENSOR_DIM) */
+    uint32_t target_shape[TENSOR_DIM];      /**< Shape of one target sample (first target_ndim entries) */
+    int target_ndim;                        /**< Number of target sample dims (0 if records hold no target) */
+    uint32_t batch_size;                    /**< Samples per batch; an incomplete last batch of an epoch is dropped */
+    int shuffle;                            /**< 1 to visit the samples of every epoch in a new random order */
+    uint64_t seed;                          /**< Seed of the shuffle permutations (same seed, same order) */
+    uint64_t num_epochs;                    /**< Number of epochs to deliver, 0 for no limit */
+    int num_workers;                        /**< Threads assembling batches (>= 1) */
+    int num_buffers;                        /**< Size of the batch ring (>= 2), i.e. up to num_buffers - 1 batches are prefetched */
+} cgrad_data_loader_config;
+
+/**
+ * @brief A batch delivered by the loader.
+ *        The tensors are owned by the loader: they must not be freed and stay valid until the
+ *        next call to cgrad_data_loader_next, which recycles their buffers.
+ */
+typedef struct cgrad_data_batch {
+    cgrad_tensor inputs;        /**< Leaf tensor of shape (batch_size, *input_shape), requires_grad = 0 */
+    cgrad_tensor targets;       /**< Leaf tensor of shape (batch_size, *target_shape), unset if target_ndim is 0 */
+    uint64_t epoch;             /**< Epoch of the batch, counting from 0 */
+    uint64_t index;             /**< Index of the batch within its epoch */
+} cgrad_data_batch;
+
+/**
+ * @brief A running data loader.
+ */
+typedef struct cgrad_data_loader cgrad_data_loader;
+
+/**
+ * @brief Initialize a config with defaults: no shuffling, seed 0, unlimited epochs,
+ *        one worker and two buffers. Shapes, path and batch size must be set by the caller.
+ * @param config Config to initialize.
+ */
+void cgrad_data_loader_config_init(cgrad_data_loader_config* config);
+
+/**
+ * @brief Map the dataset file, allocate the batch ring and start the workers.
+ * @param config Loader configuration.
+ * @param out Receives the loader (release with cgrad_data_loader_free).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_DATA_LOADER_INVALID_CONFIG for invalid settings,
+ *         CGRAD_ERR_STORAGE_FILE_IO if the file cannot be mapped, CGRAD_ERR_STORAGE_FILE_INVALID
+ *         if its size is not a multiple of the record size or it holds less than one batch.
+ */
+cgrad_status cgrad_data_loader_create(const cgrad_data_loader_config* config, cgrad_data_loader** out);
+
+/**
+ * @brief Recycle the previously delivered batch and get the next one, waiting for the workers if
+ *        it is not assembled yet.
+ * @param loader Data loader.
+ * @param out Receives the batch.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_DATA_LOADER_EXHAUSTED once num_epochs epochs were delivered.
+ */
+cgrad_status cgrad_data_loader_next(cgrad_data_loader* loader, cgrad_data_batch* out);
+
+/**
+ * @brief Get the number of records in the dataset file.
+ * @param loader Data loader.
+ * @return Number of samples.
+ */
+uint64_t cgrad_data_loader_num_samples(const cgrad_data_loader* loader);
+
+/**
+ * @brief Get the number of (complete) batches per epoch.
+ * @param loader Data loader.
+ * @return Number of batches.
+ */
+uint64_t cgrad_data_loader_num_batches(const cgrad_data_loader* loader);
+
+/**
+ * @brief Stop the workers and release the batch ring (including the tensors of the last batch) and the mapping.
+ * @param loader Data loader (may be NULL).
+ */
+void cgrad_data_loader_free(cgrad_data_loader* loader);
+
+#endif // CGRAD_DATA_LOADER_H
@@ -0,0 +1,127 @@
+#ifndef CGRAD_DATA_PARALLEL_H
+#define CGRAD_DATA_PARALLEL_H
+
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "optim/cgrad_param_group.h"
+#include <stddef.h>
+
+/**
+ * @file cgrad_data_parallel.h
+ * @brief Data-parallel training over processes of one host, communicating through shared memory.
+ *
+ * Every process (rank) holds a replica of the model in a parameter group, computes the gradients
+ * of its share of a batch and averages them with all other ranks before the optimizer step. The
+ * ranks attach to one POSIX shared memory segment that holds a staging area per rank and a
+ * result area, both as large as the flat gradient buffer.
+ *
+ * The flat gradient buffer is split into buckets of about bucket_bytes along parameter
+ * boundaries. A bucket is allreduced in the bandwidth-optimal reduce-scatter / allgather pattern
+ * of a ring allreduce. Each rank copies the bucket into its staging area. Rank r then reduces
+ * the r-th chunk of the bucket over all staging areas into the result area, and all ranks copy
+ * the reduced bucket back. Every rank reads and writes about 3x the bucket size once, however
+ * many ranks there are.
+ *
+ * cgrad_data_parallel_backward overlaps communication with the backward pass. A background
+ * thread allreduces every bucket as soon as the gradients of all its parameters are final,
+ * while the backward pass continues on the layers further from the loss.
+ */
+
+#define CGRAD_DATA_PARALLEL_MAX_RANKS 64    /**< Maximum number of processes of a group */
+
+/**
+ * @brief Configuration of a rank.
+ */
+typedef struct cgrad_data_parallel_config {
+    const char* name;           /**< Name of the shared memory segment ("/name"), the same on all ranks */
+    int world_size;             /**< Number of ranks (1 <= world_size <= CGRAD_DATA_PARALLEL_MAX_RANKS) */
+    int rank;                   /**< Rank of this process (0 <= rank < world_size); rank 0 creates the segment */
+    size_t bucket_bytes;        /**< Target size of a bucket */
+    int average;                /**< 1 to average the gradients over the ranks, 0 to sum them */
+    int timeout_ms;             /**< Give up waiting for other ranks after this long (0 to wait forever) */
+} cgrad_data_parallel_config;
+
+/**
+ * @brief The data-parallel state of one rank.
+ */
+typedef struct cgrad_data_parallel cgrad_data_parallel;
+
+/**
+ * @brief Entry point of a worker process started by cgrad_data_parallel_spawn.
+ * @param rank Rank of the process.
+ * @param world_size Number of ranks.
+ * @param arg Argument given to cgrad_data_parallel_spawn.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+typedef cgrad_status (*cgrad_data_parallel_worker)(int rank, int world_size, void* arg);
+
+/**
+ * @brief Initialize a config with defaults: 4 MiB buckets, averaging and a timeout of 60 s.
+ *        Name, world size and rank must be set by the caller.
+ * @param config Config to initialize.
+ */
+void cgrad_data_parallel_config_init(cgrad_data_parallel_config* config);
+
+/**
+ * @brief Run fn on world_size ranks: ranks 1 to world_size - 1 in forked child processes,
+ *        rank 0 in the calling process. Returns once all of them have finished.
+ * @param world_size Number of ranks.
+ * @param fn Worker function, typically creating a cgrad_data_parallel for its rank.
+ * @param arg Argument passed to fn.
+ * @return The result of rank 0 if it failed, CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED if one of
+ *         the child processes failed, CGRAD_SUCCESS otherwise.
+ */
+cgrad_status cgrad_data_parallel_spawn(int world_size, cgrad_data_parallel_worker fn, void* arg);
+
+/**
+ * @brief Attach a rank to the shared memory segment of its group and wait for all other ranks.
+ *        All ranks must pass groups with the same parameter shapes.
+ * @param config Rank configuration.
+ * @param group Parameter group whose gradients are allreduced (must outlive the rank).
+ * @param out Receives the rank (release with cgrad_data_parallel_free).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_DATA_PARALLEL_INVALID_CONFIG for invalid settings,
+ *         CGRAD_ERR_DATA_PARALLEL_SHM if the segment cannot be created or mapped,
+ *         CGRAD_ERR_DATA_PARALLEL_MISMATCH if the ranks disagree on the group layout,
+ *         CGRAD_ERR_DATA_PARALLEL_TIMEOUT if not all ranks attach in time.
+ */
+cgrad_status cgrad_data_parallel_create(
+    const cgrad_data_parallel_config* config,
+    cgrad_param_group* group,
+    cgrad_data_parallel** out
+);
+
+/**
+ * @brief Backpropagate from a loss and allreduce the gradients of the group, bucket by bucket
+ *        while the backward pass is still running. Returns once all buckets are reduced.
+ *        Every rank must call it the same number of times.
+ *
+ *        With gradient accumulation, earlier micro-batches use cgrad_tensor_backward and only
+ *        the last one of a window uses this function.
+ * @param dp Rank.
+ * @param loss Loss tensor of this rank.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_data_parallel_backward(cgrad_data_parallel* dp, cgrad_tensor* loss);
+
+/**
+ * @brief Allreduce the current gradients of the group without a backward pass.
+ * @param dp Rank.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_data_parallel_allreduce(cgrad_data_parallel* dp);
+
+/**
+ * @brief Get the number of buckets the gradients are split into.
+ * @param dp Rank.
+ * @return Number of buckets.
+ */
+int cgrad_data_parallel_num_buckets(const cgrad_data_parallel* dp);
+
+/**
+ * @brief Detach from the shared memory segment and stop the communication thread. The segment
+ *        is removed once all ranks have detached.
+ * @param dp Rank (may be NULL).
+ */
+void cgrad_data_parallel_free(cgrad_data_parallel* dp);
+
+#endif // CGRAD_DATA_PARALLEL_H
@@ -0,0 +1,142 @@
+#ifndef CGRAD_OPTIMIZER_H
+#define CGRAD_OPTIMIZER_H
+
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "backends/cgrad_backend.h"
+#include "optim/cgrad_param_group.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_optimizer.h
+ * @brief Optimizers updating parameter tensors from their gradients.
+ *
+ * An optimizer holds the parameters of a model together with their state (momentum buffers,
+ * Adam moments), which is allocated once at creation. A step updates all parameters outside of
+ * the compute graph with the backend's fused multi-tensor kernel: no graph nodes, registry
+ * records or temporary storages are created per step.
+ *
+ * With accumulation_steps = K > 1 the optimizer runs in accumulation mode: every micro-batch
+ * backpropagates into the same persistent gradient buffers and calls cgrad_optimizer_step.
+ * Only every K-th call updates the parameters. It scales the summed gradients by 1/K once
+ * (in the same pass as gradient clipping) and then clears them in place for the next window.
+ */
+
+/**
+ * @brief Hyperparameters of an optimizer.
+ */
+typedef struct cgrad_optimizer_config {
+    cgrad_optim_kind kind;      /**< Update rule */
+    float lr;                   /**< Learning rate */
+    float weight_decay;         /**< L2 penalty (SGD, Adam) or decoupled weight decay (AdamW) */
+    float momentum;             /**< SGD momentum (0 for plain SGD) */
+    int nesterov;               /**< SGD: nonzero for Nesterov momentum */
+    float beta1;                /**< Adam: decay of the first moment */
+    float beta2;                /**< Adam: decay of the second moment */
+    float eps;                  /**< Adam: term added to the denominator */
+    float max_grad_norm;        /**< Clip the global gradient norm to this value before every step (0 to disable) */
+    int accumulation_steps;     /**< Micro-batches accumulated per update (0 or 1 to update on every step) */
+} cgrad_optimizer_config;
+
+/**
+ * @brief An optimizer over a fixed set of parameters.
+ */
+typedef struct cgrad_optimizer cgrad_optimizer;
+
+/**
+ * @brief Initialize a config with the usual defaults for an update rule: lr = 1e-3,
+ *        momentum = 0, betas = (0.9, 0.999), eps = 1e-8, no gradient clipping or accumulation and
+ *        weight decay 0 (0.01 for AdamW).
+ * @param config Config to initialize.
+ * @param kind Update rule.
+ */
+void cgrad_optimizer_config_init(cgrad_optimizer_config* config, cgrad_optim_kind kind);
+
+/**
+ * @brief Create an optimizer for the given parameter tensors and allocate its state.
+ * @param config Hyperparameters.
+ * @param params Parameter tensors (leaf tensors with materialized, contiguous storage).
+ * @param n Number of parameters.
+ * @param out Receives the optimizer (release with cgrad_optimizer_free).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_OPTIM_INVALID_CONFIG for a negative n, an unknown
+ *         kind or negative accumulation_steps, CGRAD_ERR_STORAGE_BACKEND_MISMATCH if the
+ *         parameters use different backends, error code otherwise.
+ */
+cgrad_status cgrad_optimizer_create(
+    const cgrad_optimizer_config* config,
+    const cgrad_tensor* params,
+    int n,
+    cgrad_optimizer** out
+);
+
+/**
+ * @brief Create an optimizer for all parameters of a group. Its state is laid out like the
+ *        flat buffers of the group, so every step is a single kernel over the whole model.
+ * @param config Hyperparameters.
+ * @param group Parameter group (must outlive the optimizer).
+ * @param out Receives the optimizer (release with cgrad_optimizer_free).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_optimizer_create_for_group(
+    const cgrad_optimizer_config* config,
+    cgrad_param_group* group,
+    cgrad_optimizer** out
+);
+
+/**
+ * @brief Update every parameter that has a gradient. Parameters without gradient (not reached
+ *        by the last backward pass) are skipped and keep their state; parameters of a group
+ *        always have a gradient.
+ *
+ *        In accumulation mode, only counts the micro-batch until accumulation_steps of them
+ *        have been backpropagated. The update then uses the mean gradient of the window and
+ *        zeroes the gradients afterwards.
+ * @param opt Optimizer.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_optimizer_step(cgrad_optimizer* opt);
+
+/**
+ * @brief Zero the gradients of all parameters (a single fill for a group).
+ * @param opt Optimizer.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_optimizer_zero_grad(cgrad_optimizer* opt);
+
+/**
+ * @brief Change the learning rate used by subsequent steps (e.g. for a schedule).
+ * @param opt Optimizer.
+ * @param lr New learning rate.
+ */
+void cgrad_optimizer_set_lr(cgrad_optimizer* opt, float lr);
+
+/**
+ * @brief Get the number of steps taken so far.
+ * @param opt Optimizer.
+ * @return Number of steps.
+ */
+uint64_t cgrad_optimizer_num_steps(const cgrad_optimizer* opt);
+
+/**
+ * @brief Get the number of micro-batches accumulated into the gradients since the last update.
+ * @param opt Optimizer.
+ * @return Number of micro-batches (always 0 outside of accumulation mode).
+ */
+int cgrad_optimizer_num_micro_batches(const cgrad_optimizer* opt);
+
+/**
+ * @brief Get the global gradient norm (before clipping) computed by the last step. In
+ *        accumulation mode this is the norm of the mean gradient.
+ *        Only available if max_grad_norm is set, 0 otherwise.
+ * @param opt Optimizer.
+ * @return Gradient norm.
+ */
+float cgrad_optimizer_get_grad_norm(const cgrad_optimizer* opt);
+
+/**
+ * @brief Free the optimizer state. The parameter tensors are not affected.
+ * @param opt Optimizer (may be NULL).
+ */
+void cgrad_optimizer_free(cgrad_optimizer* opt);
+
+#endif // CGRAD_OPTIMIZER_H
@@ -0,0 +1,135 @@
+#ifndef CGRAD_PARAM_GROUP_H
+#define CGRAD_PARAM_GROUP_H
+
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "storage/cgrad_storage.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_param_group.h
+ * @brief Parameters and gradients of a model allocated in two flat buffers.
+ *
+ * A parameter group allocates one buffer for the values and one for the gradients of all its
+ * parameters. Every parameter is a leaf tensor over a view into the value buffer, and its
+ * gradient storage is the matching view into the gradient buffer, attached before the first
+ * backward pass. Whole-model operations (zeroing gradients, the global gradient norm,
+ * optimizer steps, checkpointing) then run as single kernels over one contiguous storage
+ * instead of iterating over many small ones.
+ *
+ * Each parameter starts at a multiple of CGRAD_PARAM_GROUP_ALIGNMENT elements. The padding
+ * between parameters is zero and stays zero under all group operations.
+ */
+
+#define CGRAD_PARAM_GROUP_ALIGNMENT 16      /**< Alignment of every parameter in elements (one cache line of floats) */
+
+/**
+ * @brief A group of parameters sharing flat value and gradient buffers.
+ */
+typedef struct cgrad_param_group cgrad_param_group;
+
+/**
+ * @brief Allocate the flat buffers of n parameters and create their tensors.
+ *        Parameters are zero-initialized and require gradients.
+ * @param shapes Shape of every parameter (shapes[i] has ndims[i] entries).
+ * @param ndims Number of dimensions of every parameter.
+ * @param n Number of parameters.
+ * @param backend_name Backend to use (must be able to wrap host memory, e.g. "cpu_f32").
+ * @param out Receives the group (release with cgrad_param_group_free).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_OPTIM_INVALID_CONFIG if n is not positive,
+ *         CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE if the group holds more than UINT32_MAX elements,
+ *         error code otherwise.
+ */
+cgrad_status cgrad_param_group_create(
+    const uint32_t* const* shapes,
+    const int* ndims,
+    int n,
+    const char* backend_name,
+    cgrad_param_group** out
+);
+
+/**
+ * @brief Get the number of parameters.
+ * @param group Parameter group.
+ * @return Number of parameters.
+ */
+int cgrad_param_group_num_params(const cgrad_param_group* group);
+
+/**
+ * @brief Get the parameter tensors. They are owned by the group and must not be freed.
+ * @param group Parameter group.
+ * @return Array of cgrad_param_group_num_params tensors.
+ */
+cgrad_tensor* cgrad_param_group_get_params(cgrad_param_group* group);
+
+/**
+ * @brief Get the flat storage of all parameter values, a 1-d storage including the padding.
+ * @param group Parameter group.
+ * @return Flat value storage, owned by the group.
+ */
+cgrad_storage* cgrad_param_group_get_flat(cgrad_param_group* group);
+
+/**
+ * @brief Get the flat storage of all gradients, laid out like the value storage.
+ * @param group Parameter group.
+ * @return Flat gradient storage, owned by the group.
+ */
+cgrad_storage* cgrad_param_group_get_flat_grad(cgrad_param_group* group);
+
+/**
+ * @brief Get the number of elements of the flat buffers, including the padding.
+ * @param group Parameter group.
+ * @return Number of elements.
+ */
+uint64_t cgrad_param_group_num_elements(const cgrad_param_group* group);
+
+/**
+ * @brief Get the element offset at which a parameter starts in the flat buffers.
+ *        Offsets increase with the parameter index.
+ * @param group Parameter group.
+ * @param index Parameter index.
+ * @return Offset in elements (0 for an invalid index).
+ */
+uint64_t cgrad_param_group_get_offset(const cgrad_param_group* group, int index);
+
+/**
+ * @brief Get the host memory of the flat gradient buffer, e.g. to exchange gradients with
+ *        other processes.
+ * @param group Parameter group.
+ * @return cgrad_param_group_num_elements floats, owned by the group.
+ */
+float* cgrad_param_group_get_grad_data(cgrad_param_group* group);
+
+/**
+ * @brief Zero all gradients with a single fill of the flat gradient buffer.
+ * @param group Parameter group.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_param_group_zero_grad(cgrad_param_group* group);
+
+/**
+ * @brief Compute the global L2 norm of all gradients in a single pass over the flat buffer.
+ * @param group Parameter group.
+ * @param out_norm Receives the norm.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_param_group_grad_norm(cgrad_param_group* group, float* out_norm);
+
+/**
+ * @brief Clip all gradients by their global L2 norm (see cgrad_storage_clip_grad_norm),
+ *        one pass over the flat buffer to compute the norm and one to rescale it.
+ * @param group Parameter group.
+ * @param max_norm Maximum global norm (> 0).
+ * @param out_norm Receives the norm before clipping (may be NULL).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_param_group_clip_grad_norm(cgrad_param_group* group, float max_norm, float* out_norm);
+
+/**
+ * @brief Free the parameter tensors and the group. The flat buffers are released once no
+ *        tensor refers to them anymore.
+ * @param group Parameter group (may be NULL).
+ */
+void cgrad_param_group_free(cgrad_param_group* group);
+
+#endif // CGRAD_PARAM_GROUP_H
@@ -0,0 +1,133 @@
+#ifndef CGRAD_HOOKS_H
+#define CGRAD_HOOKS_H
+
+#include "cgrad_status.h"
+#include "autograd/cgrad_ops.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_hooks.h
+ * @brief Callbacks around op execution and storage allocation, for tracing and telemetry.
+ *
+ * Subscribers register a callback for a set of event kinds and are called before (PRE) and
+ * after (POST) every op forward, op backward, storage allocation and storage free. Subscribers
+ * live in a list that dispatch walks without locks, so callbacks may be added and removed while
+ * other threads execute graphs. Unregistration unlinks the entry right away and frees it once no
+ * dispatch is in flight (at the latest on the next register or unregister), so registering and
+ * unregistering a scoped callback every step does not grow the list.
+ *
+ * Storages wrapping external memory (cgrad_storage_wrap: parameter group buffers, data loader
+ * batches, mapped storage files) report STORAGE_ALLOC with the wrapped bytes, so that summing
+ * allocated and released bytes stays balanced. Their bytes are not necessarily heap memory:
+ * releasing them runs the release callback given to cgrad_storage_wrap, e.g. an munmap.
+ *
+ * Every instrumented code path first tests a per-kind subscriber count, so kinds without
+ * subscribers cost a single branch.
+ */
+
+/**
+ * @brief Kind of event a callback is invoked for.
+ */
+typedef enum cgrad_hook_kind {
+    CGRAD_HOOK_OP_FORWARD,      /**< Forward pass of an op node */
+    CGRAD_HOOK_OP_BACKWARD,     /**< Backward step of an op node */
+    CGRAD_HOOK_STORAGE_ALLOC,   /**< cgrad_storage_init and cgrad_storage_wrap */
+    CGRAD_HOOK_STORAGE_FREE,    /**< cgrad_storage_free */
+    CGRAD_HOOK_NUM_KINDS,
+} cgrad_hook_kind;
+
+#define CGRAD_HOOK_MASK(kind) (1u << (kind))                            /**< Mask of a single kind */
+#define CGRAD_HOOK_MASK_ALL   ((1u << CGRAD_HOOK_NUM_KINDS) - 1)        /**< Mask of all kinds */
+
+/**
+ * @brief Whether a callback runs before or after the event.
+ */
+typedef enum cgrad_hook_stage {
+    CGRAD_HOOK_PRE,
+    CGRAD_HOOK_POST,
+} cgrad_hook_stage;
+
+/**
+ * @brief Event passed to the callbacks. Pointers are only valid during the callback.
+ */
+typedef struct cgrad_hook_event {
+    cgrad_hook_kind kind;                           /**< Event kind */
+    cgrad_hook_stage stage;                         /**< Before or after the event */
+    const cgrad_op_descriptor* descriptor;          /**< Op events: the op */
+    const cgrad_op_metadata* metadata;              /**< Op events: the op metadata */
+    const cgrad_storage_layout* const* inputs;      /**< Op events: layouts of the inputs */
+    int num_inputs;                                 /**< Op events: number of inputs */
+    const cgrad_storage_layout* output;             /**< Layout of the op output or of the storage (NULL before an allocation) */
+    const cgrad_storage* storage;                   /**< Storage events: the storage handle */
+    uint64_t bytes;                                 /**< Storage events: bytes requested or wrapped, or released at POST (0 while other views remain) */
+    uint64_t start_ns;                              /**< Monotonic clock at the PRE stage */
+    uint64_t duration_ns;                           /**< POST: wall time since the PRE stage */
+    cgrad_status status;                            /**< POST: result of the op or storage call */
+} cgrad_hook_event;
+
+/**
+ * @brief Callback of a subscriber.
+ * @param event The event.
+ * @param user_data Pointer given at registration.
+ */
+typedef void (*cgrad_hook_fn)(const cgrad_hook_event* event, void* user_data);
+
+/**
+ * @brief A registered subscriber.
+ */
+typedef struct cgrad_hook cgrad_hook;
+
+/**
+ * @brief Register a callback. Callbacks are invoked in reverse order of registration.
+ * @param kinds Mask of the event kinds (CGRAD_HOOK_MASK / CGRAD_HOOK_MASK_ALL).
+ * @param fn Callback.
+ * @param user_data Pointer passed to the callback.
+ * @param out_hook Pointer to store the subscriber handle (may be NULL).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_PROFILER_INVALID_HOOK if kinds selects no kind,
+ *         error code otherwise.
+ */
+cgrad_status cgrad_hooks_register(unsigned kinds, cgrad_hook_fn fn, void* user_data, cgrad_hook** out_hook);
+
+/**
+ * @brief Stop invoking a callback. Calls already in progress on other threads may still complete.
+ *        The handle must not be used afterwards.
+ * @param hook Subscriber returned by cgrad_hooks_register.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_hooks_unregister(cgrad_hook* hook);
+
+/**
+ * @brief Unregister and free all subscribers. Must not run concurrently with instrumented code.
+ */
+void cgrad_hooks_clear(void);
+
+// ============================================================================
+// Instrumentation (used by the compute graph and the storage)
+// ============================================================================
+
+/**
+ * @brief Number of subscribers per kind. Use CGRAD_HOOKS_ACTIVE() instead.
+ */
+extern int g_cgrad_hook_counts[CGRAD_HOOK_NUM_KINDS];
+
+/**
+ * @brief The single branch guarding the instrumentation of a kind.
+ */
+#define CGRAD_HOOKS_ACTIVE(kind) __builtin_expect(__atomic_load_n(&g_cgrad_hook_counts[kind], __ATOMIC_RELAXED) != 0, 0)
+
+/**
+ * @brief Start an event: stamp its start and invoke the PRE callbacks.
+ * @param event Event with kind and payload set.
+ */
+void cgrad_hooks_begin(cgrad_hook_event* event);
+
+/**
+ * @brief Finish an event: stamp its duration and status and invoke the POST callbacks.
+ * @param event Event started by cgrad_hooks_begin (payload may be updated in between).
+ * @param status Result of the op or storage call.
+ */
+void cgrad_hooks_end(cgrad_hook_event* event, cgrad_status status);
+
+#endif // CGRAD_HOOKS_H
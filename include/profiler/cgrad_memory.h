@@ -0,0 +1,198 @@
+#ifndef CGRAD_MEMORY_H
+#define CGRAD_MEMORY_H
+
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+#include <uuid/uuid.h>
+#include <stdint.h>
+
+/**
+ * @file cgrad_memory.h
+ * @brief Opt-in accounting of the storage memory allocated through cgrad_storage_init.
+ *
+ * While accounting is running, every buffer allocated by cgrad_storage_init or wrapped by
+ * cgrad_storage_wrap is recorded with its size, backend and the graph node it belongs to, and
+ * removed again when the last storage sharing it is freed. Live bytes, peak bytes and allocation counts are kept per backend and per
+ * graph, and split by what the buffer holds:
+ *   - activations: outputs of op nodes computed by a forward pass
+ *   - gradients: gradient buffers allocated by a backward pass
+ *   - temporaries: everything else allocated while an op runs (e.g. cached intermediates)
+ *   - other: buffers allocated outside graph execution (leaves, user storages)
+ *   - external: memory wrapped by cgrad_storage_wrap, whoever owns it (the flat parameter and
+ *     gradient buffers of parameter groups, data loader batches, mapped storage files)
+ *
+ * Buffers allocated before cgrad_memory_start are not accounted, also when they are freed.
+ * When accounting is stopped, the instrumented code paths only test a single flag.
+ */
+
+#define CGRAD_MEMORY_MAX_BACKENDS 8     /**< Backends tracked separately */
+
+/**
+ * @brief What a buffer holds.
+ */
+typedef enum cgrad_memory_category {
+    CGRAD_MEMORY_OTHER,
+    CGRAD_MEMORY_ACTIVATION,
+    CGRAD_MEMORY_GRADIENT,
+    CGRAD_MEMORY_TEMPORARY,
+    CGRAD_MEMORY_EXTERNAL,
+    CGRAD_MEMORY_NUM_CATEGORIES,
+} cgrad_memory_category;
+
+/**
+ * @brief Accounting of a backend or a graph.
+ */
+typedef struct cgrad_memory_stats {
+    uint64_t live_bytes;                                        /**< Bytes of live buffers */
+    uint64_t peak_bytes;                                        /**< Maximum of live_bytes since start */
+    uint64_t live_buffers;                                      /**< Number of live buffers */
+    uint64_t num_allocs;                                        /**< Buffers allocated since start */
+    uint64_t num_frees;                                         /**< Buffers released since start */
+    uint64_t category_bytes[CGRAD_MEMORY_NUM_CATEGORIES];       /**< Live bytes per category */
+} cgrad_memory_stats;
+
+/**
+ * @brief Accounting of all backends at one point in time.
+ */
+typedef struct cgrad_memory_snapshot {
+    int num_backends;                                           /**< Backends that allocated since start */
+    const char* backend_names[CGRAD_MEMORY_MAX_BACKENDS];       /**< Backend names */
+    cgrad_memory_stats backends[CGRAD_MEMORY_MAX_BACKENDS];     /**< Accounting per backend */
+    cgrad_memory_stats total;                                   /**< Sum over all backends (peak of the sum) */
+} cgrad_memory_snapshot;
+
+/**
+ * @brief A live buffer.
+ */
+typedef struct cgrad_memory_buffer {
+    uuid_t storage_id;                  /**< Uuid of the root storage owning the buffer */
+    uuid_t graph_id;                    /**< Graph the buffer was allocated for (if has_node) */
+    uuid_t node_id;                     /**< Node the buffer was allocated for (if has_node) */
+    int has_node;                       /**< 1 if allocated while a graph node was executed */
+    cgrad_memory_category category;     /**< What the buffer holds */
+    const char* backend_name;           /**< Backend of the buffer */
+    uint32_t shape[TENSOR_DIM];         /**< Shape the buffer was allocated with */
+    uint64_t bytes;                     /**< Size of the buffer */
+} cgrad_memory_buffer;
+
+/**
+ * @brief Discard all accounting and start recording allocations.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_memory_start(void);
+
+/**
+ * @brief Stop recording. The accounting keeps the state at this point until the next start or reset.
+ */
+void cgrad_memory_stop(void);
+
+/**
+ * @brief Check whether allocations are recorded.
+ * @return 1 if recording, 0 otherwise.
+ */
+int cgrad_memory_is_enabled(void);
+
+/**
+ * @brief Stop recording and free all accounting.
+ */
+void cgrad_memory_reset(void);
+
+/**
+ * @brief Get the accounting of all backends.
+ * @param out_snapshot Snapshot to fill.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_memory_get_snapshot(cgrad_memory_snapshot* out_snapshot);
+
+/**
+ * @brief Get the accounting of the buffers allocated for the nodes of a graph.
+ * @param graph_id Uuid of the graph.
+ * @param out_stats Stats to fill (all zero if the graph allocated nothing).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_memory_get_graph_stats(const uuid_t graph_id, cgrad_memory_stats* out_stats);
+
+/**
+ * @brief Get the largest live buffers.
+ * @param out_buffers Array of at least max_buffers buffers, largest first.
+ * @param max_buffers Maximum number of buffers to return.
+ * @param out_num_buffers Pointer to store the number of buffers returned.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_memory_get_top_buffers(cgrad_memory_buffer* out_buffers, int max_buffers, int* out_num_buffers);
+
+/**
+ * @brief Print the accounting per backend and the n largest live buffers to stdout.
+ * @param n Number of buffers to print.
+ */
+void cgrad_memory_print(int n);
+
+// ============================================================================
+// Instrumentation (used by the compute graph and the storage)
+// ============================================================================
+
+/**
+ * @brief Flag tested by the instrumented code paths. Use CGRAD_MEMORY_ENABLED() instead.
+ */
+extern int g_cgrad_memory_enabled;
+
+/**
+ * @brief The single branch guarding all instrumentation.
+ */
+#define CGRAD_MEMORY_ENABLED() __builtin_expect(g_cgrad_memory_enabled, 0)
+
+/**
+ * @brief Attribution of the allocations of the calling thread.
+ */
+typedef struct cgrad_memory_scope {
+    uint64_t id;                        /**< Unique id of the scope (0 outside graph execution) */
+    cgrad_memory_category category;     /**< Category of buffers allocated in the scope */
+    uuid_t graph_id;                    /**< Graph of the node being executed */
+    uuid_t node_id;                     /**< Node being executed */
+} cgrad_memory_scope;
+
+/**
+ * @brief Attribute the following allocations of the calling thread to a graph node.
+ * @param category Category of the allocations.
+ * @param graph_id Graph of the node.
+ * @param node_id Node being executed.
+ * @param out_previous Scope to restore with cgrad_memory_pop_scope.
+ */
+void cgrad_memory_push_scope(cgrad_memory_category category, const uuid_t graph_id, const uuid_t node_id, cgrad_memory_scope* out_previous);
+
+/**
+ * @brief Restore the scope replaced by cgrad_memory_push_scope.
+ * @param previous Scope returned by cgrad_memory_push_scope.
+ */
+void cgrad_memory_pop_scope(const cgrad_memory_scope* previous);
+
+/**
+ * @brief Change the category of the buffer holding the data of t, if it was allocated in the
+ *        current scope (e.g. the output of the node among its temporaries).
+ * @param t Storage.
+ * @param category New category.
+ */
+void cgrad_memory_tag_storage(const cgrad_storage* t, cgrad_memory_category category);
+
+/**
+ * @brief Record the allocation of a root storage.
+ * @param t Root storage.
+ * @param bytes Size of its data.
+ */
+void cgrad_memory_record_alloc(const cgrad_storage* t, uint64_t bytes);
+
+/**
+ * @brief Record a root storage wrapping external memory, accounted as CGRAD_MEMORY_EXTERNAL.
+ * @param t Root storage.
+ * @param bytes Size of the memory addressed by its layout.
+ */
+void cgrad_memory_record_wrap(const cgrad_storage* t, uint64_t bytes);
+
+/**
+ * @brief Record the release of the data of a root storage.
+ * @param root_id Uuid of the root storage.
+ */
+void cgrad_memory_record_free(const uuid_t root_id);
+
+#endif // CGRAD_MEMORY_H
@@ -0,0 +1,92 @@
+#ifndef CGRAD_PERF_H
+#define CGRAD_PERF_H
+
+#include "cgrad_status.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_perf.h
+ * @brief Hardware and software performance counters of the process (Linux perf_event_open).
+ *
+ * cgrad_perf_open opens one counter per event for every thread of the process, in user space
+ * only, so the counts include the CPU backend workers and BLAS threads whether they were
+ * started before or after the counters were opened (and any other thread of the process, e.g.
+ * data loader workers). Counters the machine or the kernel settings (perf_event_paranoid) do
+ * not provide are left unavailable; e.g. virtual machines often provide the software counters
+ * only. A read costs one syscall per event and thread, so reads belong around kernels and
+ * benchmark loops, not inside them.
+ *
+ * While counters are open, the profiler adds their deltas to every event (cgrad_profiler.h).
+ */
+
+/**
+ * @brief A counted event.
+ */
+typedef enum cgrad_perf_counter {
+    CGRAD_PERF_CYCLES,              /**< CPU cycles */
+    CGRAD_PERF_INSTRUCTIONS,        /**< Retired instructions */
+    CGRAD_PERF_CACHE_REFERENCES,    /**< Last level cache accesses */
+    CGRAD_PERF_CACHE_MISSES,        /**< Last level cache misses */
+    CGRAD_PERF_BRANCH_MISSES,       /**< Mispredicted branches */
+    CGRAD_PERF_FP_SCALAR,           /**< Retired scalar single precision FP instructions (vector_events) */
+    CGRAD_PERF_FP_PACKED,           /**< Retired packed single precision FP instructions (vector_events) */
+    CGRAD_PERF_TASK_CLOCK_NS,       /**< Time on CPU (software counter) */
+    CGRAD_PERF_PAGE_FAULTS,         /**< Page faults (software counter) */
+    CGRAD_PERF_NUM_COUNTERS,
+} cgrad_perf_counter;
+
+/**
+ * @brief Counter values; only counters in the available mask are meaningful.
+ */
+typedef struct cgrad_perf_counts {
+    uint64_t values[CGRAD_PERF_NUM_COUNTERS];   /**< Value per counter, scaled if the counter was multiplexed */
+    unsigned available;                         /**< Bit c is set if counter c is available */
+} cgrad_perf_counts;
+
+/**
+ * @brief Open the counters of all threads of the process. The counters belong to the calling
+ *        thread: it reads and closes them.
+ *
+ * The FP instruction counters are the Intel FP_ARITH_INST_RETIRED raw events (Skylake and
+ * later). They count the vector utilization of the kernels, FP_PACKED / (FP_SCALAR + FP_PACKED),
+ * and are only opened if vector_events is set, since other CPUs define these raw codes differently.
+ *
+ * @param vector_events 1 to also open the FP instruction counters.
+ * @return CGRAD_SUCCESS if at least one counter is available, CGRAD_ERR_PROFILER_PERF_UNAVAILABLE otherwise.
+ */
+cgrad_status cgrad_perf_open(int vector_events);
+
+/**
+ * @brief Close the counters of the calling thread.
+ */
+void cgrad_perf_close(void);
+
+/**
+ * @brief Check whether counters are open on the calling thread.
+ * @return 1 if open, 0 otherwise.
+ */
+int cgrad_perf_is_open(void);
+
+/**
+ * @brief Read the counters of the calling thread.
+ * @param out_counts Counts to fill.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_PROFILER_PERF_UNAVAILABLE if no counters are open.
+ */
+cgrad_status cgrad_perf_read(cgrad_perf_counts* out_counts);
+
+/**
+ * @brief Difference end - start of two reads.
+ * @param start Earlier read.
+ * @param end Later read.
+ * @param out_delta Counts to fill (available in both reads).
+ */
+void cgrad_perf_diff(const cgrad_perf_counts* start, const cgrad_perf_counts* end, cgrad_perf_counts* out_delta);
+
+/**
+ * @brief Short name of a counter (e.g. "cache_misses"), as used in traces and benchmark counters.
+ * @param counter Counter.
+ * @return The name.
+ */
+const char* cgrad_perf_counter_name(cgrad_perf_counter counter);
+
+#endif // CGRAD_PERF_H
@@ -0,0 +1,149 @@
+#ifndef CGRAD_PROFILER_H
+#define CGRAD_PROFILER_H
+
+#include "cgrad_status.h"
+#include "storage/cgrad_storage_layout.h"
+#include "profiler/cgrad_perf.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_profiler.h
+ * @brief Opt-in per-node profiler of the forward and backward passes of the compute graph.
+ *
+ * While the profiler is running, every operation node executed by cgrad_compute_graph_forward
+ * and every backward step of cgrad_compute_graph_backward records one event: op name, input and
+ * output shapes, wall time, estimated FLOPs and bytes moved, and the bytes of storage allocated
+ * while the node ran. The events can be written as Chrome trace-event JSON, which opens in
+ * chrome://tracing and https://ui.perfetto.dev.
+ *
+ * If performance counters are open on the executing thread (cgrad_perf_open), every event also
+ * holds the counter deltas of its node.
+ *
+ * When the profiler is stopped, the instrumented code paths only test a single flag.
+ * Events are recorded by the thread executing the graph; the profiler is not meant to be
+ * started or stopped while another thread executes a graph.
+ */
+
+#define CGRAD_PROFILER_MAX_INPUTS 4     /**< Inputs whose shapes are recorded per event */
+
+/**
+ * @brief Pass of the compute graph an event belongs to.
+ */
+typedef enum cgrad_profiler_phase {
+    CGRAD_PROFILER_FORWARD,
+    CGRAD_PROFILER_BACKWARD,
+} cgrad_profiler_phase;
+
+/**
+ * @brief Execution of one node in one pass.
+ *
+ * FLOPs and bytes moved are estimates derived from the op and the shapes: elementwise ops count
+ * one FLOP per output element and gemm / conv2d two per multiply-add; bytes moved count every
+ * input and output element once (gradients included in the backward pass), and nothing for
+ * the forward pass of view ops.
+ */
+typedef struct cgrad_profiler_event {
+    const char* name;                                           /**< Op name (e.g. "GEMM") */
+    cgrad_profiler_phase phase;                                 /**< Forward or backward */
+    int num_inputs;                                             /**< Number of inputs of the node */
+    uint32_t input_shapes[CGRAD_PROFILER_MAX_INPUTS][TENSOR_DIM]; /**< Shapes of the first inputs */
+    uint32_t output_shape[TENSOR_DIM];                          /**< Shape of the output */
+    uint64_t start_ns;                                          /**< Start, relative to cgrad_profiler_start */
+    uint64_t duration_ns;                                       /**< Wall time */
+    uint64_t flops;                                             /**< Estimated floating point operations */
+    uint64_t bytes_moved;                                       /**< Estimated bytes read and written */
+    uint64_t bytes_allocated;                                   /**< Bytes of storage allocated by the node */
+    cgrad_perf_counts perf;                                     /**< Performance counter deltas (none available if no counters are open) */
+} cgrad_profiler_event;
+
+/**
+ * @brief Discard all recorded events and start recording.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_profiler_start(void);
+
+/**
+ * @brief Stop recording. Recorded events are kept until the next start or reset.
+ */
+void cgrad_profiler_stop(void);
+
+/**
+ * @brief Check whether the profiler is recording.
+ * @return 1 if recording, 0 otherwise.
+ */
+int cgrad_profiler_is_enabled(void);
+
+/**
+ * @brief Stop recording and free all recorded events.
+ */
+void cgrad_profiler_reset(void);
+
+/**
+ * @brief Get the recorded events in the order their nodes finished.
+ * @param out_num_events Pointer to store the number of events.
+ * @return The events (owned by the profiler, valid until the next event is recorded), or NULL if there are none.
+ */
+const cgrad_profiler_event* cgrad_profiler_get_events(int* out_num_events);
+
+/**
+ * @brief Write the recorded events as Chrome trace-event JSON ("X" complete events, one
+ *        category per phase, shapes, FLOPs, bytes and available counters in the event args).
+ * @param path Output file path.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_PROFILER_IO if the file cannot be written.
+ */
+cgrad_status cgrad_profiler_write_chrome_trace(const char* path);
+
+// ============================================================================
+// Instrumentation (used by the compute graph and the storage)
+// ============================================================================
+
+/**
+ * @brief Flag tested by the instrumented code paths. Use CGRAD_PROFILER_ENABLED() instead.
+ */
+extern int g_cgrad_profiler_enabled;
+
+/**
+ * @brief The single branch guarding all instrumentation.
+ */
+#define CGRAD_PROFILER_ENABLED() __builtin_expect(g_cgrad_profiler_enabled, 0)
+
+/**
+ * @brief Start of a profiled node execution.
+ */
+typedef struct cgrad_profiler_span {
+    uint64_t start_ns;          /**< Monotonic clock at the start */
+    uint64_t allocated;         /**< Allocation counter at the start */
+    cgrad_perf_counts perf;     /**< Performance counters at the start */
+} cgrad_profiler_span;
+
+/**
+ * @brief Begin timing a node.
+ * @param span Span to initialize.
+ */
+void cgrad_profiler_begin(cgrad_profiler_span* span);
+
+/**
+ * @brief Finish timing a node and record its event.
+ * @param span Span started by cgrad_profiler_begin.
+ * @param phase Pass the node was executed in.
+ * @param name Op name (must outlive the profiler events).
+ * @param inputs Layouts of the inputs.
+ * @param num_inputs Number of inputs.
+ * @param output Layout of the output.
+ */
+void cgrad_profiler_end(
+    const cgrad_profiler_span* span,
+    cgrad_profiler_phase phase,
+    const char* name,
+    const cgrad_storage_layout* const* inputs,
+    int num_inputs,
+    const cgrad_storage_layout* output
+);
+
+/**
+ * @brief Account a storage allocation to the node being profiled.
+ * @param bytes Bytes allocated.
+ */
+void cgrad_profiler_add_allocation(uint64_t bytes);
+
+#endif // CGRAD_PROFILER_H
@@ -0,0 +1,89 @@
+#ifndef CGRAD_CHECKPOINT_H
+#define CGRAD_CHECKPOINT_H
+
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include <stdint.h>
+
+/**
+ * @file cgrad_checkpoint.h
+ * @brief Asynchronous checkpoint writer for tensor files.
+ *
+ * cgrad_checkpoint_save_async snapshots the given storages into a private staging buffer
+ * (the complete tensor file image, see cgrad_storage_file.h) and returns. A background thread
+ * then streams the buffer to disk with large sequential writes, fsyncs the file and atomically
+ * renames it into place. The storages may be modified (e.g. by the next optimizer step) as soon
+ * as the call returns; the caller only pays for a memory copy of the parameters.
+ *
+ * The staging buffer of a finished checkpoint is kept as spare and reused by the next one, so
+ * periodic checkpoints copy into memory that is already faulted in (double buffering).
+ */
+
+#define CGRAD_CHECKPOINT_WRITE_CHUNK (8u << 20)    /**< Size of a single write() call in bytes */
+
+/**
+ * @brief Statistics of a finished checkpoint write.
+ */
+typedef struct cgrad_checkpoint_stats {
+    uint64_t bytes;             /**< Size of the written file in bytes */
+    double snapshot_seconds;    /**< Time the caller spent copying the storages into the staging buffer */
+    double write_seconds;       /**< Time the writer thread spent in write() */
+    double sync_seconds;        /**< Time the writer thread spent in fsync() of the file and its directory */
+    double throughput;          /**< bytes / (write_seconds + sync_seconds), in bytes per second */
+    int durable;                /**< 1 if the file and its directory entry reached stable storage */
+} cgrad_checkpoint_stats;
+
+/**
+ * @brief Handle of a checkpoint that is being written in the background.
+ */
+typedef struct cgrad_checkpoint cgrad_checkpoint;
+
+/**
+ * @brief Snapshot storages and write them to a tensor file in the background.
+ *        Any existing file at path is replaced once the new file is complete and synced.
+ * @param path Output file path.
+ * @param names Array of tensor names (length n, see cgrad_storage_save).
+ * @param storages Array of storages to snapshot (length n).
+ * @param n Number of tensors.
+ * @param out Receives the handle (release with cgrad_checkpoint_free).
+ * @return CGRAD_SUCCESS if the snapshot was taken, CGRAD_ERR_STORAGE_FILE_INVALID if a name is
+ *         too long or used twice, CGRAD_ERR_ALLOC_FAILED if the staging buffer cannot be allocated.
+ *         Write errors are reported by cgrad_checkpoint_wait.
+ */
+cgrad_status cgrad_checkpoint_save_async(
+    const char* path,
+    const char* const* names,
+    const cgrad_storage* const* storages,
+    int n,
+    cgrad_checkpoint** out
+);
+
+/**
+ * @brief Check without blocking whether the background write has finished.
+ * @param ckpt Checkpoint handle.
+ * @return 1 if finished (successfully or not), 0 if still writing.
+ */
+int cgrad_checkpoint_is_done(const cgrad_checkpoint* ckpt);
+
+/**
+ * @brief Wait for the background write to finish. May be called more than once.
+ * @param ckpt Checkpoint handle.
+ * @param stats Receives the write statistics (may be NULL).
+ * @return CGRAD_SUCCESS if the file was written and renamed into place,
+ *         CGRAD_ERR_STORAGE_FILE_IO otherwise.
+ */
+cgrad_status cgrad_checkpoint_wait(cgrad_checkpoint* ckpt, cgrad_checkpoint_stats* stats);
+
+/**
+ * @brief Wait for the background write to finish and release the handle.
+ * @param ckpt Checkpoint handle (may be NULL).
+ */
+void cgrad_checkpoint_free(cgrad_checkpoint* ckpt);
+
+/**
+ * @brief Free the spare staging buffer kept for the next checkpoint.
+ *        Called by cgrad_cleanup; buffers of checkpoints still being written are not affected.
+ */
+void cgrad_checkpoint_release_buffers(void);
+
+#endif // CGRAD_CHECKPOINT_H
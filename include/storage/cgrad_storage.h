@@ -15,6 +15,20 @@ typedef struct cgrad_storage {
     void* data;                         /**< Backend-specific storage object (e.g., cgrad_tensor_f32*) */
 } cgrad_storage;
 
+/**
+ * @brief Lowerings available for cgrad_storage_conv2d.
+ */
+typedef enum cgrad_conv2d_algo {
+    CGRAD_CONV2D_AUTO,              /**< im2col unless the column buffer gets too large */
+    CGRAD_CONV2D_IM2COL,            /**< explicit im2col followed by a batched GEMM */
+    CGRAD_CONV2D_IMPLICIT_GEMM,     /**< direct kernel without a column buffer */
+} cgrad_conv2d_algo;
+
+/**
+ * @brief Maximum number of storages cgrad_storage_cat can concatenate at once.
+ */
+#define CGRAD_STORAGE_CAT_MAX_INPUTS 16
+
 // --- Initialization/Allocation ---
 
 /**
@@ -29,6 +43,28 @@ typedef struct cgrad_storage {
  */
 cgrad_status cgrad_storage_init(cgrad_storage* t, const uint32_t* shape, int ndim, const char* backend_name);
 
+/**
+ * @brief Initialize a storage around existing host memory without copying it, e.g. a
+ *        memory-mapped file. The storage is registered like a freshly allocated one, but
+ *        instead of freeing data, release(release_ctx) is called once the storage and all
+ *        its views are freed.
+ * @param t Pointer to storage to initialize.
+ * @param layout Layout of the elements in data (including its offset).
+ * @param data Memory holding the elements (not owned by the storage).
+ * @param release Callback invoked when the data is no longer referenced, or NULL.
+ * @param release_ctx Argument passed to release.
+ * @param backend_name Backend name to use (must operate on host memory, e.g. "cpu_f32").
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_NOT_IMPLEMENTED if the backend cannot wrap memory.
+ */
+cgrad_status cgrad_storage_wrap(
+    cgrad_storage* t,
+    const cgrad_storage_layout* layout,
+    void* data,
+    void (*release)(void* ctx),
+    void* release_ctx,
+    const char* backend_name
+);
+
 /**
  * @brief Perform a shallow copy of a tensor (copies data pointer, not underlying data).
  * @param src Source tensor.
@@ -70,6 +106,25 @@ cgrad_status cgrad_storage_free_global_registry(void);
  */
 size_t cgrad_storage_get_global_registry_count(void);
 
+/**
+ * @brief Get the number of storages sharing the data of t (shallow copies and views), including t itself.
+ * 
+ * A count of 1 means t is the only handle to its data and may be overwritten freely.
+ * 
+ * @param t Pointer to storage.
+ * @return Number of storages sharing the data, or 0 if t is not registered.
+ */
+size_t cgrad_storage_get_num_views(const cgrad_storage* t);
+
+/**
+ * @brief Get the uuid of the root storage owning the data of t (t's own uuid if t is the root).
+ * 
+ * @param t Pointer to storage.
+ * @param out_uuid Uuid of the root storage.
+ * @return CGRAD_SUCCESS on success, error code if t is not registered.
+ */
+cgrad_status cgrad_storage_get_root_uuid(const cgrad_storage* t, uuid_t out_uuid);
+
  // ============================================================================
  // Storage Recording API (Scoped Resource Management)
  // ============================================================================
@@ -110,6 +165,14 @@ cgrad_status cgrad_storage_free_record(struct cgrad_storage_registry_record* rec
  */
 cgrad_status cgrad_storage_fill(cgrad_storage* t, float value);
 
+/**
+ * @brief Set all elements of the tensor to zero in-place, keeping its memory. Backends clear
+ *        contiguous storages with a (parallel) memset instead of an element-wise fill.
+ * @param t Pointer to tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_zero(cgrad_storage* t);
+
 /**
  * @brief Fill the tensor with random values.
  * @param t Pointer to tensor.
@@ -158,6 +221,175 @@ cgrad_status cgrad_storage_gemm(float alpha, const cgrad_storage* a, const cgrad
  */
 cgrad_status cgrad_storage_axpy(float alpha, cgrad_storage* x, cgrad_storage* y, cgrad_storage* r);
 
+/**
+ * @brief Compute the elementwise (Hadamard) product r = alpha * x * y + beta * r.
+ *        x and y are broadcast against each other. If r is initialized, its shape
+ *        may be smaller than the broadcast shape of x and y (dims of size 1), in
+ *        which case the products are summed over those dims directly into r.
+ * @param alpha Scaling factor for the product.
+ * @param x First input tensor.
+ * @param y Second input tensor.
+ * @param beta Scaling factor for the current values in r.
+ * @param r Output tensor (initialized inside function if r->data is NULL).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_mul(float alpha, const cgrad_storage* x, const cgrad_storage* y, float beta, cgrad_storage* r);
+
+/**
+ * @brief Apply an elementwise unary function r = f(x), optionally computing dr = f'(x).
+ *        r (and dr) must have the same shape as x. r may be a shallow copy of x with the
+ *        same layout, in which case the function is applied in-place.
+ * @param op Unary function to apply.
+ * @param x Input tensor.
+ * @param r Output tensor (initialized inside function if r->data is NULL).
+ * @param dr Derivative tensor (initialized inside function if dr->data is NULL), or NULL to skip it.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_unary(cgrad_unary_op op, const cgrad_storage* x, cgrad_storage* r, cgrad_storage* dr);
+
+/**
+ * @brief Compute r = softmax(x) or r = log_softmax(x) along the last dimension.
+ *        r may be a shallow copy of x with the same layout, in which case the
+ *        result is written in-place.
+ * @param log_softmax Nonzero to compute log-softmax instead of softmax.
+ * @param x Input tensor.
+ * @param r Output tensor (initialized inside function if r->data is NULL).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax(int log_softmax, const cgrad_storage* x, cgrad_storage* r);
+
+/**
+ * @brief Accumulate the gradient of a (log-)softmax into grad_x.
+ * @param log_softmax Nonzero if y is the output of log-softmax.
+ * @param y Output of the forward pass.
+ * @param grad_y Gradient with respect to y.
+ * @param grad_x Gradient with respect to the input (must be initialized and contiguous).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax_backward(int log_softmax, const cgrad_storage* y, const cgrad_storage* grad_y, cgrad_storage* grad_x);
+
+/**
+ * @brief Compute the mean softmax cross-entropy loss of logits x against target,
+ *        where both hold one distribution per row of the last dimension.
+ * @param x Logits.
+ * @param target Target distribution with the same shape as x (e.g. one-hot rows).
+ * @param loss Output scalar (initialized inside function if loss->data is NULL).
+ * @param lse Output of per-row log(sum(exp(x))) with the last dimension reduced to 1
+ *            (initialized inside function if lse->data is NULL), or NULL to skip it.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax_cross_entropy(const cgrad_storage* x, const cgrad_storage* target, cgrad_storage* loss, cgrad_storage* lse);
+
+/**
+ * @brief Accumulate alpha times the gradients of the per-row softmax cross-entropy.
+ * @param alpha Scaling factor (e.g. upstream gradient divided by the number of rows).
+ * @param x Logits.
+ * @param target Target distribution with the same shape as x.
+ * @param lse Per-row logsumexp computed by cgrad_storage_softmax_cross_entropy.
+ * @param grad_x Gradient with respect to x (must be initialized and contiguous), or NULL.
+ * @param grad_target Gradient with respect to target (must be initialized and contiguous), or NULL.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax_cross_entropy_backward(
+    float alpha,
+    const cgrad_storage* x,
+    const cgrad_storage* target,
+    const cgrad_storage* lse,
+    cgrad_storage* grad_x,
+    cgrad_storage* grad_target
+);
+
+/**
+ * @brief Compute the 2D convolution r = conv2d(x, w) over the last two dimensions.
+ * @param algo Lowering to use.
+ * @param params Stride, padding and dilation (the kernel size is taken from w).
+ * @param x Input of shape (N, C, H, W).
+ * @param w Weight of shape (O, C, KH, KW).
+ * @param r Output of shape (N, O, OH, OW) (initialized inside function if r->data is NULL).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_conv2d(
+    cgrad_conv2d_algo algo,
+    const cgrad_conv2d_params* params,
+    const cgrad_storage* x,
+    const cgrad_storage* w,
+    cgrad_storage* r
+);
+
+/**
+ * @brief Accumulate the gradients of r = conv2d(x, w) into grad_x and grad_w.
+ * @param params Stride, padding and dilation (the kernel size is taken from w).
+ * @param x Input of shape (N, C, H, W).
+ * @param w Weight of shape (O, C, KH, KW).
+ * @param grad_r Gradient with respect to the output.
+ * @param grad_x Gradient with respect to x (must be initialized and contiguous), or NULL.
+ * @param grad_w Gradient with respect to w (must be initialized and contiguous), or NULL.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_conv2d_backward(
+    const cgrad_conv2d_params* params,
+    const cgrad_storage* x,
+    const cgrad_storage* w,
+    const cgrad_storage* grad_r,
+    cgrad_storage* grad_x,
+    cgrad_storage* grad_w
+);
+
+/**
+ * @brief Apply one optimizer step to n parameters in place, outside of any compute graph.
+ *        The parameters are handed to the backend in groups of CGRAD_BACKEND_OPTIM_MAX_TENSORS,
+ *        each group is updated in a single fused pass without allocating.
+ * @param u Update rule and hyperparameters.
+ * @param n Number of parameters.
+ * @param params Parameter storages (contiguous, modified in-place).
+ * @param grads Gradient storages (contiguous, same shapes as params).
+ * @param m SGD momentum buffers or Adam first moments (modified in-place), NULL for SGD without momentum.
+ * @param v Adam second moments (modified in-place), NULL for SGD.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_optim_step(
+    const cgrad_optim_update* u,
+    int n,
+    cgrad_storage* const* params,
+    const cgrad_storage* const* grads,
+    cgrad_storage* const* m,
+    cgrad_storage* const* v
+);
+
+/**
+ * @brief Compute the sum of squares of all elements of n storages, e.g. the squared global
+ *        norm of a set of gradients. Each group of CGRAD_BACKEND_OPTIM_MAX_TENSORS storages is
+ *        reduced in a single parallel pass.
+ * @param n Number of storages.
+ * @param ts Storages (contiguous).
+ * @param out Receives the sum of squares.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_sum_squares(int n, const cgrad_storage* const* ts, double* out);
+
+/**
+ * @brief Multiply all elements of n storages in-place by alpha, one pass per group of
+ *        CGRAD_BACKEND_OPTIM_MAX_TENSORS storages.
+ * @param n Number of storages.
+ * @param ts Storages (contiguous, modified in-place).
+ * @param alpha Scale factor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_scale(int n, cgrad_storage* const* ts, float alpha);
+
+/**
+ * @brief Clip gradients by their global L2 norm: if the norm of all n storages together
+ *        exceeds max_norm, all of them are scaled by max_norm / (norm + 1e-6). The norm is
+ *        computed in one parallel pass, the scaling is a second fused pass.
+ * @param n Number of gradient storages.
+ * @param grads Gradient storages (contiguous, modified in-place).
+ * @param max_norm Maximum global norm (> 0).
+ * @param out_norm Receives the global norm before clipping (may be NULL).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_OPTIM_INVALID_CONFIG if max_norm is not positive
+ *         (or NaN), error code otherwise.
+ */
+cgrad_status cgrad_storage_clip_grad_norm(int n, cgrad_storage* const* grads, float max_norm, float* out_norm);
+
 // --- Data Transform ---
 
 /**
@@ -182,6 +414,67 @@ cgrad_status cgrad_storage_reshape(const cgrad_storage* src, cgrad_storage* dst,
  */
 cgrad_status cgrad_storage_transpose(const cgrad_storage* src, cgrad_storage* dst, const uint32_t* perm, int ndim);
 
+/**
+ * @brief Copy the elements of src into the already initialized dst.
+ * dst may be a strided view into a larger storage (e.g. a slice) but not a broadcast.
+ * @param src Source tensor.
+ * @param dst Destination tensor with the same shape as src.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_copy(const cgrad_storage* src, cgrad_storage* dst);
+
+/**
+ * @brief Create a zero-copy view of the ranges [start, stop) with the given steps in the last ndim dims.
+ * Creates a shallow copy of the source tensor and restricts its layout (see cgrad_storage_layout_slice).
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + slice).
+ * @param start Array of first indices (length ndim).
+ * @param stop Array of end indices, exclusive (length ndim).
+ * @param step Array of steps (length ndim), or NULL for all ones.
+ * @param ndim Number of trailing dimensions to slice (≤ MAX_TENSOR_DIM).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_slice(
+    const cgrad_storage* src,
+    cgrad_storage* dst,
+    const uint32_t* start,
+    const uint32_t* stop,
+    const uint32_t* step,
+    int ndim
+);
+
+/**
+ * @brief Create a zero-copy view of the range [start, start + length) along a single dimension.
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + narrow).
+ * @param dim Dimension to narrow (negative dims count from the last dimension).
+ * @param start First index along dim.
+ * @param length Number of indices to keep.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_narrow(const cgrad_storage* src, cgrad_storage* dst, int dim, uint32_t start, uint32_t length);
+
+/**
+ * @brief Create a zero-copy view of a single index along a dimension, dropping that dimension.
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + select).
+ * @param dim Dimension to select from (negative dims count from the last dimension).
+ * @param index Index along dim.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_select(const cgrad_storage* src, cgrad_storage* dst, int dim, uint32_t index);
+
+/**
+ * @brief Concatenate n tensors along dim. Each input is copied directly into a
+ * narrowed view of the freshly allocated dst, without intermediate storages.
+ * @param srcs Array of source tensors (length n, at most CGRAD_STORAGE_CAT_MAX_INPUTS).
+ * @param n Number of source tensors.
+ * @param dim Dimension to concatenate along (negative dims count from the last dimension).
+ * @param dst Destination tensor (must be uninitialized).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_cat(const cgrad_storage* const* srcs, int n, int dim, cgrad_storage* dst);
+
 // --- Data Access/Info ---
 
 /**
@@ -0,0 +1,131 @@
+#ifndef CGRAD_STORAGE_FILE_H
+#define CGRAD_STORAGE_FILE_H
+
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file cgrad_storage_file.h
+ * @brief On-disk tensor format that can be memory-mapped for zero-copy loading.
+ *
+ * A file consists of a fixed-size header, a table with one entry per tensor (name, dtype,
+ * shape and element strides) and the raw tensor data. Every data block starts at a multiple
+ * of CGRAD_STORAGE_FILE_ALIGNMENT bytes, so mapped tensors are suitably aligned for SIMD
+ * kernels. All integers and elements are stored in native byte order.
+ *
+ * Loaded tensors wrap the mapping directly: pages are only read from disk when touched and
+ * are shared through the page cache by every process mapping the same file.
+ */
+
+#define CGRAD_STORAGE_FILE_MAGIC "CGRADTF"      /**< Magic bytes at the start of a file (8 bytes including the NUL) */
+#define CGRAD_STORAGE_FILE_VERSION 1
+#define CGRAD_STORAGE_FILE_ALIGNMENT 64         /**< Alignment of every data block in bytes */
+#define CGRAD_STORAGE_FILE_NAME_MAX 64          /**< Size of the name field, including the terminating NUL */
+
+/**
+ * @brief Element types of stored tensors.
+ */
+typedef enum cgrad_storage_file_dtype {
+    CGRAD_STORAGE_FILE_DTYPE_F32 = 1,    /**< 32 bit IEEE float, loaded as cpu_f32 storage */
+} cgrad_storage_file_dtype;
+
+/**
+ * @brief An opened (memory-mapped) tensor file.
+ *        The mapping is reference counted: it stays alive as long as the file handle or any
+ *        storage loaded from it exists.
+ */
+typedef struct cgrad_storage_file cgrad_storage_file;
+
+/**
+ * @brief Write storages to a tensor file, replacing any existing file at path.
+ *        The data of every storage is written in contiguous row-major order, so views
+ *        (transposed, sliced, ...) are stored as their logical contents.
+ *        The output is memory-mapped and filled with the backend copy op, without
+ *        intermediate buffers.
+ * @param path Output file path.
+ * @param names Array of tensor names (length n, each shorter than CGRAD_STORAGE_FILE_NAME_MAX).
+ * @param storages Array of storages to write (length n, backends must support storage_wrap).
+ * @param n Number of tensors.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_FILE_IO if the file cannot be written,
+ *         CGRAD_ERR_STORAGE_FILE_INVALID if a name is too long or used twice.
+ */
+cgrad_status cgrad_storage_save(const char* path, const char* const* names, const cgrad_storage* const* storages, int n);
+
+/**
+ * @brief Compute the size of the tensor file image holding the given storages.
+ * @param names Array of tensor names (length n).
+ * @param storages Array of storages (length n).
+ * @param n Number of tensors.
+ * @param out_size Receives the image size in bytes.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_FILE_INVALID if a name is too long or used twice.
+ */
+cgrad_status cgrad_storage_serialized_size(const char* const* names, const cgrad_storage* const* storages, int n, uint64_t* out_size);
+
+/**
+ * @brief Write the tensor file image holding the given storages into a memory buffer.
+ *        The buffer receives exactly the bytes cgrad_storage_save would write to disk, which
+ *        allows snapshotting tensors now and writing the file later.
+ * @param names Array of tensor names (length n).
+ * @param storages Array of storages (length n).
+ * @param n Number of tensors.
+ * @param buffer Destination, aligned to CGRAD_STORAGE_FILE_ALIGNMENT bytes.
+ * @param size Size of buffer in bytes (at least cgrad_storage_serialized_size).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_FILE_INVALID if a name is invalid or the buffer is too small.
+ */
+cgrad_status cgrad_storage_serialize(const char* const* names, const cgrad_storage* const* storages, int n, void* buffer, uint64_t size);
+
+/**
+ * @brief Open a tensor file by mapping it read-only into memory and validating its header.
+ * @param path File path.
+ * @param out Receives the file handle (close with cgrad_storage_file_close).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_FILE_IO if the file cannot be opened or mapped,
+ *         CGRAD_ERR_STORAGE_FILE_INVALID if it is not a valid tensor file.
+ */
+cgrad_status cgrad_storage_file_open(const char* path, cgrad_storage_file** out);
+
+/**
+ * @brief Release the file handle. The mapping is unmapped once all storages loaded from it are freed.
+ * @param file File handle (may be NULL).
+ */
+void cgrad_storage_file_close(cgrad_storage_file* file);
+
+/**
+ * @brief Get the number of tensors stored in the file.
+ * @param file File handle.
+ * @return Number of tensors, or 0 if file is NULL.
+ */
+int cgrad_storage_file_num_tensors(const cgrad_storage_file* file);
+
+/**
+ * @brief Get the name of the i-th tensor in the file.
+ * @param file File handle.
+ * @param i Tensor index (0 <= i < cgrad_storage_file_num_tensors(file)).
+ * @return The name, or NULL if i is out of range.
+ */
+const char* cgrad_storage_file_tensor_name(const cgrad_storage_file* file, int i);
+
+/**
+ * @brief Wrap a tensor of the file as cpu_f32 storage without copying its data.
+ *        The storage points into the read-only mapping: it can be used as input of any op, but
+ *        writing into it (in-place ops, optimizer updates) faults. Use cgrad_storage_file_load
+ *        for tensors that are modified.
+ * @param file File handle.
+ * @param name Name of the tensor.
+ * @param out Storage to initialize.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_FILE_TENSOR_NOT_FOUND if there is no such tensor.
+ */
+cgrad_status cgrad_storage_load_mmap(cgrad_storage_file* file, const char* name, cgrad_storage* out);
+
+/**
+ * @brief Copy a tensor of the file into newly allocated, writable storage.
+ * @param file File handle.
+ * @param name Name of the tensor.
+ * @param out Storage to initialize (contiguous, same shape as the stored tensor).
+ * @param backend_name Backend name of the new storage (e.g. "cpu_f32").
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_FILE_TENSOR_NOT_FOUND if there is no such tensor.
+ */
+cgrad_status cgrad_storage_file_load(cgrad_storage_file* file, const char* name, cgrad_storage* out, const char* backend_name);
+
+#endif // CGRAD_STORAGE_FILE_H
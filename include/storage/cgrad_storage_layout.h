@@ -9,13 +9,44 @@
 
 /**
  * @brief Structure representing the layout (shape, strides, size) of a tensor.
+ *        Each dimension holds at most 2^32 - 1 elements, while element counts, strides and
+ *        offsets are 64 bits wide so that a single storage may exceed 4G elements.
  */
 typedef struct cgrad_storage_layout {
-  uint32_t size;                  /**< Total number of elements */
+  uint64_t size;                  /**< Total number of elements */
   uint32_t shape[TENSOR_DIM]; /**< Shape of each dimension */
-  uint32_t strides[TENSOR_DIM]; /**< Strides for each dimension */
+  uint64_t strides[TENSOR_DIM]; /**< Strides for each dimension */
+  uint64_t offset;                /**< Index of the first element in the underlying data (nonzero for sliced views) */
 } cgrad_storage_layout;
 
+/**
+ * @brief Maximum number of layouts cgrad_storage_layout_collapse can collapse jointly.
+ */
+#define CGRAD_STORAGE_LAYOUT_COLLAPSE_MAX 3
+
+/**
+ * @brief Shape and strides of one or more equally shaped layouts reduced to their effective rank:
+ *        unit dims are dropped and neighbouring dims that are laid out back to back in every
+ *        layout are merged into one. Dims are stored outermost first, i.e. the innermost dim is
+ *        at index rank - 1. A contiguous tensor of any shape collapses to rank 1.
+ */
+typedef struct cgrad_storage_layout_collapsed {
+  int rank;                                                         /**< Number of remaining dims (0 for a single element) */
+  uint32_t shape[TENSOR_DIM];                                       /**< Extent of each remaining dim */
+  uint64_t strides[CGRAD_STORAGE_LAYOUT_COLLAPSE_MAX][TENSOR_DIM];  /**< Strides of each remaining dim, per layout */
+} cgrad_storage_layout_collapsed;
+
+/**
+ * @brief Geometry of a 2D convolution over the last two dims of an (N, C, H, W) input.
+ *        Index 0 refers to the height, index 1 to the width.
+ */
+typedef struct cgrad_conv2d_params {
+  uint32_t kernel[2];   /**< Kernel size (set from the weight by cgrad_storage_layout_conv2d) */
+  uint32_t stride[2];   /**< Step between output positions (>= 1) */
+  uint32_t padding[2];  /**< Implicit zeros added on both sides of the input */
+  uint32_t dilation[2]; /**< Spacing between kernel taps (>= 1) */
+} cgrad_conv2d_params;
+
 // --- Copy/Initialization ---
 
 /**
@@ -41,6 +72,7 @@ cgrad_status cgrad_storage_layout_init(cgrad_storage_layout* l, const uint32_t*
 
 /**
  * @brief Compute the flat index in the data array for the given indices and layout.
+ *        The index includes the layout offset, so it addresses the underlying data directly.
  *        Checks that all indices are within bounds (0 <= idx < shape[i]).
  *        Indices of length ndim are mapped to the last ndim dims; leading indices behave as 0.
  *        For example, indices={2,3}, ndim=2, TENSOR_DIM=4 => layout.shape={1,1,3,4}, indices used as {0,0,2,3}
@@ -78,6 +110,18 @@ cgrad_status cgrad_storage_layout_broadcast(
     int end_dim
 );
 
+/**
+ * @brief Collapse n equally shaped layouts to their joint effective rank (see cgrad_storage_layout_collapsed),
+ *        so that kernels can iterate low-rank views with rank-specialized loops instead of all TENSOR_DIM dims.
+ *        Broadcast dims (stride 0) only merge with neighbours that are broadcast in the same layouts.
+ *        Layouts with zero elements collapse to rank 1 with extent 0.
+ * @param layouts Array of layouts (length n).
+ * @param n Number of layouts (1 <= n <= CGRAD_STORAGE_LAYOUT_COLLAPSE_MAX).
+ * @param out Collapsed shape and strides; out->strides[k] belongs to layouts[k].
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH if the shapes differ.
+ */
+cgrad_status cgrad_storage_layout_collapse(const cgrad_storage_layout* const* layouts, int n, cgrad_storage_layout_collapsed* out);
+
 // --- Transform ---
 
 /**
@@ -146,4 +190,80 @@ void cgrad_storage_layout_print_shape(const cgrad_storage_layout* l, int ndim);
  */
 cgrad_status cgrad_storage_layout_reduce(cgrad_storage_layout* layout, const uint8_t* mask, int ndim);
 
+// --- Views ---
+
+/**
+ * @brief Restrict the last ndim dims of the layout to the ranges [start, stop) taken with the given steps.
+ *        Only shape, strides and offset change, so the result addresses a subset of the same data.
+ *        For example, start={1,0}, stop={3,4}, step={1,2} on a (4,4) layout => shape (2,2), offset 4.
+ * @param layout Pointer to layout (modified in-place).
+ * @param start Array of first indices (length ndim).
+ * @param stop Array of end indices, exclusive (length ndim, start <= stop <= shape).
+ * @param step Array of steps (length ndim, >= 1), or NULL for all ones.
+ * @param ndim Number of dimensions to slice (<= TENSOR_DIM).
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS if a range is invalid.
+ */
+cgrad_status cgrad_storage_layout_slice(
+    cgrad_storage_layout* layout,
+    const uint32_t* start,
+    const uint32_t* stop,
+    const uint32_t* step,
+    int ndim
+);
+
+/**
+ * @brief Restrict a single dimension of the layout to [start, start + length).
+ *        Negative dims count from the last dimension (-1 is the last), non-negative dims index
+ *        all TENSOR_DIM dims of the layout.
+ * @param layout Pointer to layout (modified in-place).
+ * @param dim Dimension to narrow.
+ * @param start First index along dim.
+ * @param length Number of indices to keep.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS if the range is invalid.
+ */
+cgrad_status cgrad_storage_layout_narrow(cgrad_storage_layout* layout, int dim, uint32_t start, uint32_t length);
+
+/**
+ * @brief Pick a single index along a dimension and drop that dimension.
+ *        The dims before dim move one position to the right and a leading dim of size 1 is added,
+ *        e.g. selecting index 2 of dim -2 in a (4,3) layout gives the row as a (3,) layout.
+ * @param layout Pointer to layout (modified in-place).
+ * @param dim Dimension to select from (same convention as cgrad_storage_layout_narrow).
+ * @param index Index along dim.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS if index is invalid.
+ */
+cgrad_status cgrad_storage_layout_select(cgrad_storage_layout* layout, int dim, uint32_t index);
+
+/**
+ * @brief Compute the layout of the concatenation of n layouts along dim.
+ *        All layouts must match in every other dimension. The output is a contiguous layout.
+ * @param layouts Array of input layouts (length n).
+ * @param n Number of input layouts (>= 1).
+ * @param dim Dimension to concatenate along (same convention as cgrad_storage_layout_narrow).
+ * @param out Output layout to initialize.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH if the shapes do not match.
+ */
+cgrad_status cgrad_storage_layout_cat(const cgrad_storage_layout* const* layouts, int n, int dim, cgrad_storage_layout* out);
+
+// --- Convolution ---
+
+/**
+ * @brief Compute the output layout of a 2D convolution.
+ *        The input x has shape (N, C, H, W) and the weight w has shape (O, C, KH, KW), both in the
+ *        last four dims (all leading dims must be 1). The output is a contiguous layout of shape
+ *        (N, O, OH, OW) with OH = (H + 2 * padding - dilation * (KH - 1) - 1) / stride + 1 (same for OW).
+ *        params->kernel is set to (KH, KW).
+ * @param x Input layout.
+ * @param w Weight layout.
+ * @param params Convolution parameters (kernel is written, all other fields are read).
+ * @param out Output layout to initialize.
+ * @return CGRAD_SUCCESS on success, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH if the shapes or parameters are invalid.
+ */
+cgrad_status cgrad_storage_layout_conv2d(
+    const cgrad_storage_layout* x,
+    const cgrad_storage_layout* w,
+    cgrad_conv2d_params* params,
+    cgrad_storage_layout* out
+);
+
 #endif // CGRAD_STORAGE_LAYOUT_H
@@ -1,5 +1,8 @@
 #include "autograd/cgrad_compute_graph.h"
 #include "autograd/cgrad_ops.h"
+#include "profiler/cgrad_profiler.h"
+#include "profiler/cgrad_hooks.h"
+#include "profiler/cgrad_memory.h"
 #include "cgrad_status.h"
 #include "third_party/uthash.h"
 #include <stdlib.h>
@@ -38,6 +41,43 @@ static cgrad_graph_node* find_node_metadata(cgrad_compute_graph* graph, uuid_t n
     return node;
 }
 
+/**
+ * @brief Record the profiler event of a node executed since span was started.
+ */
+static void profile_node(
+    const cgrad_profiler_span* span,
+    cgrad_profiler_phase phase,
+    const cgrad_graph_node* node,
+    cgrad_graph_node* const* input_nodes,
+    int num_inputs
+) {
+    const cgrad_storage_layout* input_layouts[MAX_NODE_INPUTS];
+    for (int i = 0; i < num_inputs; i++) input_layouts[i] = &input_nodes[i]->layout;
+    cgrad_profiler_end(span, phase, node->op_info.descriptor->name, input_layouts, num_inputs, &node->layout);
+}
+
+/**
+ * @brief Invoke the PRE callbacks of an op event of a node. input_layouts must outlive the event.
+ */
+static void hook_node_begin(
+    cgrad_hook_event* event,
+    cgrad_hook_kind kind,
+    const cgrad_graph_node* node,
+    cgrad_graph_node* const* input_nodes,
+    int num_inputs,
+    const cgrad_storage_layout** input_layouts
+) {
+    for (int i = 0; i < num_inputs; i++) input_layouts[i] = &input_nodes[i]->layout;
+    memset(event, 0, sizeof(*event));
+    event->kind = kind;
+    event->descriptor = node->op_info.descriptor;
+    event->metadata = &node->op_info.metadata;
+    event->inputs = input_layouts;
+    event->num_inputs = num_inputs;
+    event->output = &node->layout;
+    cgrad_hooks_begin(event);
+}
+
 /**
  * @brief Add node to metadata table.
  */
@@ -50,6 +90,16 @@ static int add_node_metadata(cgrad_compute_graph* graph, cgrad_graph_node* node)
     return CGRAD_SUCCESS;
 }
 
+/**
+ * @brief Release the operation context of a node, if any.
+ */
+static void free_node_ctx(cgrad_graph_node* node) {
+    if (node->ctx != NULL && node->op_info.descriptor != NULL && node->op_info.descriptor->free_ctx != NULL) {
+        node->op_info.descriptor->free_ctx(node->ctx);
+    }
+    node->ctx = NULL;
+}
+
 // ============================================================================
 // Backward Pass
 // ============================================================================
@@ -57,6 +107,15 @@ static int add_node_metadata(cgrad_compute_graph* graph, cgrad_graph_node* node)
 cgrad_status cgrad_compute_graph_backward(
     cgrad_compute_graph* graph,
     const uuid_t target_node_id
+) {
+    return cgrad_compute_graph_backward_with_hook(graph, target_node_id, NULL, NULL);
+}
+
+cgrad_status cgrad_compute_graph_backward_with_hook(
+    cgrad_compute_graph* graph,
+    const uuid_t target_node_id,
+    cgrad_grad_ready_hook hook,
+    void* user_data
 ) {
     if (graph == NULL) {
         return CGRAD_ERR_NULL_POINTER;
@@ -84,18 +143,38 @@ cgrad_status cgrad_compute_graph_backward(
         return ret;
     }
 
+    // Gradients of operation nodes only hold the current pass: buffers kept from an earlier
+    // backward pass over the same nodes are cleared in place, so that repeated passes (e.g. one
+    // per micro-batch) accumulate into the leaf gradients only
+    for (int i = 0; i < num_nodes; i++) {
+        cgrad_graph_node* node;
+        ret = cgrad_compute_graph_get_node(graph, sorted_ids[i], &node);
+        if (ret != CGRAD_SUCCESS) {
+            return ret;
+        }
+        if (node == target_node || node->op_info.descriptor == NULL || node->grad_storage == NULL) continue;
+        ret = cgrad_storage_zero(node->grad_storage);
+        if (ret != CGRAD_SUCCESS) {
+            return ret;
+        }
+    }
+
     // Initialize target gradient to 1.0
     if (target_node->grad_storage == NULL) {
         target_node->grad_storage = (cgrad_storage*)calloc(1, sizeof(cgrad_storage));
         if (target_node->grad_storage == NULL) {
             return CGRAD_ERR_ALLOC_FAILED;
         }
+        cgrad_memory_scope scope;
+        int tracked = CGRAD_MEMORY_ENABLED();
+        if (tracked) cgrad_memory_push_scope(CGRAD_MEMORY_GRADIENT, graph->graph_id, target_node->node_id, &scope);
         ret = cgrad_storage_init(
             target_node->grad_storage,
             target_node->layout.shape,
             TENSOR_DIM,
             target_node->backend_name
         );
+        if (tracked) cgrad_memory_pop_scope(&scope);
         if (ret != CGRAD_SUCCESS) {
             free(target_node->grad_storage);
             target_node->grad_storage = NULL;
@@ -122,8 +201,12 @@ cgrad_status cgrad_compute_graph_backward(
         // Skip if doesn't require gradients
         if (!node->requires_grad) continue;
 
-        // Skip leaf nodes (no backward to compute)
-        if (node->op_info.descriptor == NULL) continue;
+        // Skip leaf nodes (no backward to compute): all their consumers come later in the
+        // topological order, so their gradient is final here
+        if (node->op_info.descriptor == NULL) {
+            if (hook != NULL && node->grad_storage != NULL) hook(node->node_id, node->grad_storage, user_data);
+            continue;
+        }
 
         // Get incoming gradient
         if (node->grad_storage == NULL) {
@@ -136,6 +219,9 @@ cgrad_status cgrad_compute_graph_backward(
             return CGRAD_ERR_COMPUTE_GRAPH_BACKWARD_NOT_IMPLEMENTED;
         }
 
+        cgrad_profiler_span span;
+        if (CGRAD_PROFILER_ENABLED()) cgrad_profiler_begin(&span);
+
         // Get input nodes and storages
         uuid_t input_ids[MAX_NODE_INPUTS];
         int num_inputs;
@@ -163,16 +249,20 @@ cgrad_status cgrad_compute_graph_backward(
                 if (input_nodes[j]->grad_storage == NULL) {
                     return CGRAD_ERR_ALLOC_FAILED;
                 }
+                cgrad_memory_scope scope;
+                int tracked = CGRAD_MEMORY_ENABLED();
+                if (tracked) cgrad_memory_push_scope(CGRAD_MEMORY_GRADIENT, graph->graph_id, input_nodes[j]->node_id, &scope);
                 ret = cgrad_storage_init(
                     input_nodes[j]->grad_storage,
                     input_nodes[j]->layout.shape,
                     TENSOR_DIM,
                     input_nodes[j]->backend_name
                 );
+                if (tracked) cgrad_memory_pop_scope(&scope);
                 if (ret != CGRAD_SUCCESS) {
                     return ret;
                 }
-                ret = cgrad_storage_fill(input_nodes[j]->grad_storage, 0.0f);
+                ret = cgrad_storage_zero(input_nodes[j]->grad_storage);
                 if (ret != CGRAD_SUCCESS) {
                     return ret;
                 }
@@ -184,6 +274,15 @@ cgrad_status cgrad_compute_graph_backward(
             grad_inputs[j] = input_nodes[j]->grad_storage;
         }
 
+        cgrad_hook_event hook_event;
+        const cgrad_storage_layout* hook_layouts[MAX_NODE_INPUTS];
+        int hooked = CGRAD_HOOKS_ACTIVE(CGRAD_HOOK_OP_BACKWARD);
+        if (hooked) hook_node_begin(&hook_event, CGRAD_HOOK_OP_BACKWARD, node, input_nodes, num_inputs, hook_layouts);
+
+        cgrad_memory_scope scope;
+        int tracked = CGRAD_MEMORY_ENABLED();
+        if (tracked) cgrad_memory_push_scope(CGRAD_MEMORY_TEMPORARY, graph->graph_id, node->node_id, &scope);
+
         // Call backward function
         ret = op_desc->backward(
             input_storages,
@@ -195,9 +294,12 @@ cgrad_status cgrad_compute_graph_backward(
             grad_inputs,
             input_requires_grad
         );
+        if (tracked) cgrad_memory_pop_scope(&scope);
+        if (hooked) cgrad_hooks_end(&hook_event, ret);
         if (ret != CGRAD_SUCCESS) {
             return ret;
         }
+        if (CGRAD_PROFILER_ENABLED()) profile_node(&span, CGRAD_PROFILER_BACKWARD, node, input_nodes, num_inputs);
     }
 
     return CGRAD_SUCCESS;
@@ -236,8 +338,8 @@ cgrad_status cgrad_compute_graph_zero_grad_node(cgrad_compute_graph* graph, cons
         return CGRAD_SUCCESS;
     }
 
-    // Fill gradient storage with zeros instead of freeing it
-    ret = cgrad_storage_fill(node->grad_storage, 0.0f);
+    // Clear gradient storage in place instead of freeing it
+    ret = cgrad_storage_zero(node->grad_storage);
     if (ret != CGRAD_SUCCESS) {
         return ret;
     }
@@ -264,6 +366,46 @@ cgrad_status cgrad_compute_graph_set_requires_grad(
     return CGRAD_SUCCESS;
 }
 
+cgrad_status cgrad_compute_graph_set_grad_storage(
+    cgrad_compute_graph* graph,
+    const uuid_t node_id,
+    const cgrad_storage* storage
+) {
+    if (graph == NULL || storage == NULL || storage->backend == NULL || storage->data == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_graph_node* node;
+    int ret = cgrad_compute_graph_get_node(graph, node_id, &node);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    const cgrad_storage_layout* layout = storage->backend->storage_get_layout(storage->data);
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (layout->shape[d] != node->layout.shape[d]) {
+            return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+        }
+    }
+
+    cgrad_storage* grad_storage = (cgrad_storage*)calloc(1, sizeof(cgrad_storage));
+    if (grad_storage == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    ret = cgrad_storage_shallow_copy(storage, grad_storage);
+    if (ret != CGRAD_SUCCESS) {
+        free(grad_storage);
+        return ret;
+    }
+
+    if (node->grad_storage != NULL) {
+        cgrad_storage_free(node->grad_storage);
+        free(node->grad_storage);
+    }
+    node->grad_storage = grad_storage;
+    return CGRAD_SUCCESS;
+}
+
 // ============================================================================
 // Graph Management Functions
 // ============================================================================
@@ -552,6 +694,8 @@ cgrad_status cgrad_compute_graph_free(cgrad_compute_graph* graph) {
     HASH_ITER(hh, graph->node_metadata_table, node, tmp) {
         HASH_DEL(graph->node_metadata_table, node);
         
+        // Free cached operation context
+        free_node_ctx(node);
         
         // Free storage if it exists
         if (node->storage != NULL) {
@@ -849,31 +993,38 @@ void cgrad_graph_node_print(const cgrad_graph_node* node) {
 // ============================================================================
 
 /**
- * @brief Forward pass for a single operation node in the graph.
+ * @brief Check whether a node may overwrite the storage of its input.
+ *
+ * This is the case if no gradients are needed for either node, the input is an
+ * operation result whose only reference is this node (no other consumer and no
+ * tensor handle), and its storage is contiguous and not shared with any view.
  */
-static int forward_node(cgrad_compute_graph* graph, cgrad_graph_node* node) {
-
-    // Get input nodes
-    uuid_t input_ids[MAX_NODE_INPUTS];
-    int num_inputs;
-    int ret = cgrad_compute_graph_get_inputs(graph, node->node_id, input_ids, MAX_NODE_INPUTS, &num_inputs);
-    if (ret != CGRAD_SUCCESS) {
-        return ret;
-    }
+static int can_run_inplace(const cgrad_graph_node* node, const cgrad_graph_node* input_node) {
+    if (node->requires_grad || input_node->requires_grad) return 0;
+    if (input_node->op_info.descriptor == NULL) return 0;  // never overwrite leaf data
+    if (input_node->ref_count != 1) return 0;
+    if (cgrad_storage_get_num_views(input_node->storage) != 1) return 0;
+
+    const cgrad_storage* storage = input_node->storage;
+    const cgrad_storage_layout* layout = storage->backend->storage_get_layout(storage->data);
+    if (!cgrad_storage_layout_is_contiguous(layout)) return 0;
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (layout->shape[d] != node->layout.shape[d]) return 0;
+    }
+    return 1;
+}
 
-    // Get input storages
-    cgrad_storage* input_storages[MAX_NODE_INPUTS];
-    for (int i = 0; i < num_inputs; i++) {
-        cgrad_graph_node* input_node;
-        ret = cgrad_compute_graph_get_node(graph, input_ids[i], &input_node);
-        if (ret != CGRAD_SUCCESS) {
-            return ret;
-        }
-        if (input_node->storage == NULL) {
-            return CGRAD_ERR_COMPUTE_GRAPH_EXECUTION_FAILED;  // Input not computed
-        }
-        input_storages[i] = input_node->storage;
-    }
+/**
+ * @brief Allocate the output of an operation node and run its forward function.
+ */
+static int execute_node(
+    cgrad_graph_node* node,
+    const cgrad_op_descriptor* op_desc,
+    cgrad_storage** input_storages,
+    cgrad_graph_node* const* input_nodes,
+    int num_inputs
+) {
+    int ret;
 
     // Reuse existing storage or allocate new storage
     if (node->storage != NULL) {
@@ -887,10 +1038,17 @@ static int forward_node(cgrad_compute_graph* graph, cgrad_graph_node* node) {
         }
     }
 
-    // Get operation descriptor
-    const cgrad_op_descriptor* op_desc = node->op_info.descriptor;
-    if (op_desc == NULL || op_desc->forward == NULL) {
-        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    // Drop the context of a previous execution
+    free_node_ctx(node);
+
+    // Write the output into the storage of the input if nothing else can observe it
+    if (op_desc->inplace && num_inputs == 1 && can_run_inplace(node, input_nodes[0])) {
+        ret = cgrad_storage_shallow_copy(input_storages[0], node->storage);
+        if (ret != CGRAD_SUCCESS) {
+            free(node->storage);
+            node->storage = NULL;
+            return ret;
+        }
     }
 
     // Call forward function
@@ -914,6 +1072,63 @@ static int forward_node(cgrad_compute_graph* graph, cgrad_graph_node* node) {
     return CGRAD_SUCCESS;
 }
 
+/**
+ * @brief Forward pass for a single operation node in the graph.
+ */
+static int forward_node(cgrad_compute_graph* graph, cgrad_graph_node* node) {
+
+    // Get input nodes
+    uuid_t input_ids[MAX_NODE_INPUTS];
+    int num_inputs;
+    int ret = cgrad_compute_graph_get_inputs(graph, node->node_id, input_ids, MAX_NODE_INPUTS, &num_inputs);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    // Get input storages
+    cgrad_storage* input_storages[MAX_NODE_INPUTS];
+    cgrad_graph_node* input_nodes[MAX_NODE_INPUTS];
+    for (int i = 0; i < num_inputs; i++) {
+        ret = cgrad_compute_graph_get_node(graph, input_ids[i], &input_nodes[i]);
+        if (ret != CGRAD_SUCCESS) {
+            return ret;
+        }
+        if (input_nodes[i]->storage == NULL) {
+            return CGRAD_ERR_COMPUTE_GRAPH_EXECUTION_FAILED;  // Input not computed
+        }
+        input_storages[i] = input_nodes[i]->storage;
+    }
+
+    // Get operation descriptor
+    const cgrad_op_descriptor* op_desc = node->op_info.descriptor;
+    if (op_desc == NULL || op_desc->forward == NULL) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    cgrad_profiler_span span;
+    if (CGRAD_PROFILER_ENABLED()) cgrad_profiler_begin(&span);
+    cgrad_hook_event hook_event;
+    const cgrad_storage_layout* hook_layouts[MAX_NODE_INPUTS];
+    int hooked = CGRAD_HOOKS_ACTIVE(CGRAD_HOOK_OP_FORWARD);
+    if (hooked) hook_node_begin(&hook_event, CGRAD_HOOK_OP_FORWARD, node, input_nodes, num_inputs, hook_layouts);
+
+    // outputs are accounted as activations, everything else allocated by the op as temporaries
+    cgrad_memory_scope scope;
+    int tracked = CGRAD_MEMORY_ENABLED();
+    if (tracked) cgrad_memory_push_scope(CGRAD_MEMORY_TEMPORARY, graph->graph_id, node->node_id, &scope);
+
+    ret = execute_node(node, op_desc, input_storages, input_nodes, num_inputs);
+
+    if (tracked) {
+        if (ret == CGRAD_SUCCESS) cgrad_memory_tag_storage(node->storage, CGRAD_MEMORY_ACTIVATION);
+        cgrad_memory_pop_scope(&scope);
+    }
+
+    if (hooked) cgrad_hooks_end(&hook_event, ret);
+    if (ret == CGRAD_SUCCESS && CGRAD_PROFILER_ENABLED()) profile_node(&span, CGRAD_PROFILER_FORWARD, node, input_nodes, num_inputs);
+    return ret;
+}
+
 cgrad_status cgrad_compute_graph_forward(
     cgrad_compute_graph* graph,
     const uuid_t target_node_id
@@ -967,6 +1182,34 @@ cgrad_status cgrad_compute_graph_forward(
     return CGRAD_SUCCESS;
 }
 
+cgrad_status cgrad_compute_graph_invalidate(
+    cgrad_compute_graph* graph,
+    const uuid_t node_id
+) {
+    if (graph == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_graph_node* node;
+    int ret = cgrad_compute_graph_get_node(graph, node_id, &node);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    // Leaf data cannot be recomputed
+    if (node->op_info.descriptor == NULL) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    free_node_ctx(node);
+    if (node->storage != NULL) {
+        cgrad_storage_free(node->storage);
+        free(node->storage);
+        node->storage = NULL;
+    }
+    return CGRAD_SUCCESS;
+}
+
 // ============================================================================
 // Reference Counting Functions
 // ============================================================================
@@ -1021,6 +1264,9 @@ cgrad_status cgrad_compute_graph_free_node(cgrad_compute_graph* graph, cgrad_gra
     int num_inputs = 0;
     int ret = cgrad_compute_graph_get_inputs(graph, node->node_id, input_ids, MAX_NODE_INPUTS, &num_inputs);
     
+    // Free cached operation context
+    free_node_ctx(node);
+    
     // Free storage if it exists
     if (node->storage != NULL) {
         cgrad_storage_free(node->storage);
@@ -114,10 +114,9 @@ static int infer_gemm_output_shape(const cgrad_storage_layout* a_layout,
                                    cgrad_storage_layout* out_layout) {
     // For GEMM: a is (..., m, k), b is (..., k, n), output is (..., m, n)
     // Work with last 2 dimensions of TENSOR_DIM
-    int m = a_layout->shape[TENSOR_DIM - 2];
-    int k_a = a_layout->shape[TENSOR_DIM - 1];
-    int k_b = b_layout->shape[TENSOR_DIM - 2];
-    int n = b_layout->shape[TENSOR_DIM - 1];
+    uint32_t k_a = a_layout->shape[TENSOR_DIM - 1];
+    uint32_t k_b = b_layout->shape[TENSOR_DIM - 2];
+    uint32_t n = b_layout->shape[TENSOR_DIM - 1];
 
     if (k_a != k_b) {
         return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
@@ -143,6 +142,51 @@ static int infer_gemm_output_shape(const cgrad_storage_layout* a_layout,
     return CGRAD_SUCCESS;
 }
 
+/**
+ * @brief Add a single-input operation node whose output has the input's shape.
+ */
+static int add_unary_op(
+    const cgrad_tensor* tensor,
+    const cgrad_op_descriptor* descriptor,
+    cgrad_op_metadata metadata,
+    cgrad_tensor* out_tensor
+) {
+    if (tensor == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // Create operation node
+    cgrad_op_info op_info;
+    op_info.descriptor = descriptor;
+    op_info.metadata = metadata;
+
+    uuid_t input_ids[1];
+    uuid_copy(input_ids[0], tensor->node_id);
+
+    // Output is a new contiguous storage of the same shape
+    cgrad_storage_layout out_layout;
+    int ret = cgrad_storage_layout_init(&out_layout, tensor->layout.shape, TENSOR_DIM);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    ret = cgrad_compute_graph_add_op(
+        graph, &op_info, &out_layout,
+        input_ids, 1, out_tensor->node_id
+    );
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    out_tensor->layout = out_layout;
+    return CGRAD_SUCCESS;
+}
+
 // ============================================================================
 // Tensor Initialization and Management
 // ============================================================================
@@ -351,6 +395,47 @@ cgrad_status cgrad_tensor_sub(
     return CGRAD_SUCCESS;
 }
 
+cgrad_status cgrad_tensor_mul(
+    const cgrad_tensor* a,
+    const cgrad_tensor* b,
+    cgrad_tensor* out_tensor
+) {
+    if (a == NULL || b == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // Determine output shape
+    cgrad_storage_layout out_layout;
+    int ret = infer_binary_output_shape(&a->layout, &b->layout, &out_layout);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    // Create operation node
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_mul;
+
+    uuid_t input_ids[2];
+    uuid_copy(input_ids[0], a->node_id);
+    uuid_copy(input_ids[1], b->node_id);
+
+    ret = cgrad_compute_graph_add_op(
+        graph, &op_info, &out_layout,
+        input_ids, 2, out_tensor->node_id
+    );
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    out_tensor->layout = out_layout;
+    return CGRAD_SUCCESS;
+}
+
 
 cgrad_status cgrad_tensor_gemm(
     const cgrad_tensor* a,
@@ -395,6 +480,57 @@ cgrad_status cgrad_tensor_gemm(
     return CGRAD_SUCCESS;
 }
 
+cgrad_status cgrad_tensor_conv2d(
+    const cgrad_tensor* input,
+    const cgrad_tensor* weight,
+    const uint32_t* stride,
+    const uint32_t* padding,
+    const uint32_t* dilation,
+    cgrad_tensor* out_tensor
+) {
+    if (input == NULL || weight == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // Create operation node
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_conv2d;
+    op_info.metadata.conv2d.algo = CGRAD_CONV2D_AUTO;
+    cgrad_conv2d_params* params = &op_info.metadata.conv2d.params;
+    for (int i = 0; i < 2; i++) {
+        params->stride[i] = stride ? stride[i] : 1;
+        params->padding[i] = padding ? padding[i] : 0;
+        params->dilation[i] = dilation ? dilation[i] : 1;
+    }
+
+    // Determine output shape
+    cgrad_storage_layout out_layout;
+    int ret = cgrad_storage_layout_conv2d(&input->layout, &weight->layout, params, &out_layout);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    uuid_t input_ids[2];
+    uuid_copy(input_ids[0], input->node_id);
+    uuid_copy(input_ids[1], weight->node_id);
+
+    ret = cgrad_compute_graph_add_op(
+        graph, &op_info, &out_layout,
+        input_ids, 2, out_tensor->node_id
+    );
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    out_tensor->layout = out_layout;
+    return CGRAD_SUCCESS;
+}
+
 // ============================================================================
 // Unary Operations
 // ============================================================================
@@ -489,6 +625,181 @@ cgrad_status cgrad_tensor_reshape(
     return CGRAD_SUCCESS;
 }
 
+// Add a single-input view op (slice, select) whose output shape is given by view_layout.
+static cgrad_status add_view_op(
+    const cgrad_tensor* tensor,
+    const cgrad_op_info* op_info,
+    const cgrad_storage_layout* view_layout,
+    cgrad_tensor* out_tensor
+) {
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // The view's strides and offset only exist in the storage, the tensor keeps the plain shape
+    cgrad_storage_layout out_layout;
+    int ret = cgrad_storage_layout_init(&out_layout, view_layout->shape, TENSOR_DIM);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    uuid_t input_ids[1];
+    uuid_copy(input_ids[0], tensor->node_id);
+
+    ret = cgrad_compute_graph_add_op(
+        graph, op_info, &out_layout,
+        input_ids, 1, out_tensor->node_id
+    );
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    out_tensor->layout = out_layout;
+    return CGRAD_SUCCESS;
+}
+
+cgrad_status cgrad_tensor_slice(
+    const cgrad_tensor* tensor,
+    const uint32_t* start,
+    const uint32_t* stop,
+    const uint32_t* step,
+    int ndim,
+    cgrad_tensor* out_tensor
+) {
+    if (tensor == NULL || start == NULL || stop == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    // Compute output layout (validates the ranges)
+    cgrad_storage_layout view_layout = tensor->layout;
+    int ret = cgrad_storage_layout_slice(&view_layout, start, stop, step, ndim);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    // Create operation node
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_slice;
+    op_info.metadata.slice.ndim = ndim;
+    for (int i = 0; i < ndim; i++) {
+        op_info.metadata.slice.start[i] = start[i];
+        op_info.metadata.slice.stop[i] = stop[i];
+        op_info.metadata.slice.step[i] = step ? step[i] : 1;
+    }
+
+    return add_view_op(tensor, &op_info, &view_layout, out_tensor);
+}
+
+cgrad_status cgrad_tensor_narrow(
+    const cgrad_tensor* tensor,
+    int dim,
+    uint32_t start,
+    uint32_t length,
+    cgrad_tensor* out_tensor
+) {
+    if (tensor == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    // Compute output layout (validates dim and range)
+    cgrad_storage_layout view_layout = tensor->layout;
+    int ret = cgrad_storage_layout_narrow(&view_layout, dim, start, length);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    // Narrow is a slice over all dims that keeps everything but dim
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_slice;
+    op_info.metadata.slice.ndim = TENSOR_DIM;
+    int d = dim < 0 ? TENSOR_DIM + dim : dim;
+    for (int i = 0; i < TENSOR_DIM; i++) {
+        op_info.metadata.slice.start[i] = (i == d) ? start : 0;
+        op_info.metadata.slice.stop[i] = (i == d) ? start + length : tensor->layout.shape[i];
+        op_info.metadata.slice.step[i] = 1;
+    }
+
+    return add_view_op(tensor, &op_info, &view_layout, out_tensor);
+}
+
+cgrad_status cgrad_tensor_select(
+    const cgrad_tensor* tensor,
+    int dim,
+    uint32_t index,
+    cgrad_tensor* out_tensor
+) {
+    if (tensor == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    // Compute output layout (validates dim and index)
+    cgrad_storage_layout view_layout = tensor->layout;
+    int ret = cgrad_storage_layout_select(&view_layout, dim, index);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_select;
+    op_info.metadata.select.dim = dim;
+    op_info.metadata.select.index = index;
+
+    return add_view_op(tensor, &op_info, &view_layout, out_tensor);
+}
+
+cgrad_status cgrad_tensor_cat(
+    const cgrad_tensor* const* tensors,
+    int n,
+    int dim,
+    cgrad_tensor* out_tensor
+) {
+    if (tensors == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+    if (n < 1 || n > MAX_NODE_INPUTS) {
+        return CGRAD_ERR_COMPUTE_GRAPH_TOO_MANY_INPUTS;
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // Compute output layout
+    const cgrad_storage_layout* layouts[MAX_NODE_INPUTS];
+    uuid_t input_ids[MAX_NODE_INPUTS];
+    for (int k = 0; k < n; k++) {
+        if (tensors[k] == NULL) {
+            return CGRAD_ERR_NULL_POINTER;
+        }
+        layouts[k] = &tensors[k]->layout;
+        uuid_copy(input_ids[k], tensors[k]->node_id);
+    }
+
+    cgrad_storage_layout out_layout;
+    int ret = cgrad_storage_layout_cat(layouts, n, dim, &out_layout);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    // Create operation node
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_cat;
+    op_info.metadata.cat.dim = dim;
+
+    ret = cgrad_compute_graph_add_op(
+        graph, &op_info, &out_layout,
+        input_ids, n, out_tensor->node_id
+    );
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    out_tensor->layout = out_layout;
+    return CGRAD_SUCCESS;
+}
+
 cgrad_status cgrad_tensor_reduce_sum(
     const cgrad_tensor* tensor,
     const uint8_t* mask,
@@ -538,6 +849,86 @@ cgrad_status cgrad_tensor_reduce_sum(
 // Execution
 // ============================================================================
 
+cgrad_status cgrad_tensor_relu(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_relu, (cgrad_op_metadata){.unary.op = CGRAD_UNARY_RELU}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_gelu(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_gelu, (cgrad_op_metadata){.unary.op = CGRAD_UNARY_GELU}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_tanh(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_tanh, (cgrad_op_metadata){.unary.op = CGRAD_UNARY_TANH}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_sigmoid(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_sigmoid, (cgrad_op_metadata){.unary.op = CGRAD_UNARY_SIGMOID}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_exp(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_exp, (cgrad_op_metadata){.unary.op = CGRAD_UNARY_EXP}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_log(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_log, (cgrad_op_metadata){.unary.op = CGRAD_UNARY_LOG}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_softmax(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_softmax, (cgrad_op_metadata){.softmax.log = 0}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_log_softmax(const cgrad_tensor* tensor, cgrad_tensor* out_tensor) {
+    return add_unary_op(tensor, &cgrad_op_log_softmax, (cgrad_op_metadata){.softmax.log = 1}, out_tensor);
+}
+
+cgrad_status cgrad_tensor_softmax_cross_entropy(
+    const cgrad_tensor* logits,
+    const cgrad_tensor* target,
+    cgrad_tensor* out_tensor
+) {
+    if (logits == NULL || target == NULL || out_tensor == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    for (int i = 0; i < TENSOR_DIM; i++) {
+        if (logits->layout.shape[i] != target->layout.shape[i]) {
+            return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+        }
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // Create operation node
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_softmax_cross_entropy;
+
+    uuid_t input_ids[2];
+    uuid_copy(input_ids[0], logits->node_id);
+    uuid_copy(input_ids[1], target->node_id);
+
+    // Output is a scalar
+    cgrad_storage_layout out_layout;
+    uint32_t scalar_shape[1] = {1};
+    int ret = cgrad_storage_layout_init(&out_layout, scalar_shape, 1);
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    ret = cgrad_compute_graph_add_op(
+        graph, &op_info, &out_layout,
+        input_ids, 2, out_tensor->node_id
+    );
+    if (ret != CGRAD_SUCCESS) {
+        return ret;
+    }
+
+    out_tensor->layout = out_layout;
+    return CGRAD_SUCCESS;
+}
+
 cgrad_status cgrad_tensor_execute(cgrad_tensor* tensor) {
     if (!tensor) {
         return CGRAD_ERR_NULL_POINTER;
@@ -552,6 +943,19 @@ cgrad_status cgrad_tensor_execute(cgrad_tensor* tensor) {
     return cgrad_compute_graph_forward(graph, tensor->node_id);
 }
 
+cgrad_status cgrad_tensor_invalidate(cgrad_tensor* tensor) {
+    if (!tensor) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (!graph) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    return cgrad_compute_graph_invalidate(graph, tensor->node_id);
+}
+
 cgrad_storage* cgrad_tensor_get_storage(const cgrad_tensor* tensor) {
     if (tensor == NULL) {
         return NULL;
@@ -763,7 +1167,25 @@ cgrad_status cgrad_tensor_zero_grad(cgrad_tensor* tensor) {
     return cgrad_compute_graph_zero_grad_node(graph, tensor->node_id);
 }
 
+cgrad_status cgrad_tensor_set_grad_storage(cgrad_tensor* tensor, const cgrad_storage* storage) {
+    if (tensor == NULL || storage == NULL) {
+        return CGRAD_ERR_NULL_POINTER;
+    }
+
+    cgrad_compute_graph* graph = get_global_graph();
+    if (graph == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    // Delegate to compute graph
+    return cgrad_compute_graph_set_grad_storage(graph, tensor->node_id, storage);
+}
+
 cgrad_status cgrad_tensor_backward(cgrad_tensor* tensor) {
+    return cgrad_tensor_backward_with_hook(tensor, NULL, NULL);
+}
+
+cgrad_status cgrad_tensor_backward_with_hook(cgrad_tensor* tensor, cgrad_grad_ready_hook hook, void* user_data) {
     if (tensor == NULL) {
         return CGRAD_ERR_NULL_POINTER;
     }
@@ -780,5 +1202,5 @@ cgrad_status cgrad_tensor_backward(cgrad_tensor* tensor) {
     }
 
     // Delegate to compute graph
-    return cgrad_compute_graph_backward(graph, tensor->node_id);
+    return cgrad_compute_graph_backward_with_hook(graph, tensor->node_id, hook, user_data);
 }
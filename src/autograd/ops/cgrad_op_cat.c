@@ -0,0 +1,73 @@
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+/**
+ * @brief Forward pass for concatenation.
+ * 
+ * Computes: output = cat(inputs, dim)
+ * Each input is written directly into its slice of the output.
+ * No context is needed for backward pass.
+ */
+int cgrad_op_cat_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)requires_grad;
+    if (num_inputs < 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    return cgrad_storage_cat((const cgrad_storage* const*)inputs, num_inputs, metadata->cat.dim, output);
+}
+
+/**
+ * @brief Backward pass for concatenation.
+ * 
+ * For C = cat(A_0, ..., A_n, dim):
+ *   grad_A_k += narrow(grad_C, dim, offset_k, size_k)
+ * where offset_k is the summed size of the preceding inputs along dim.
+ */
+int cgrad_op_cat_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    if (num_inputs < 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    int dim = metadata->cat.dim;
+    int d = dim < 0 ? TENSOR_DIM + dim : dim;
+    uint32_t start = 0;
+
+    for (int k = 0; k < num_inputs; k++) {
+        uint32_t length = inputs[k]->backend->storage_get_layout(inputs[k]->data)->shape[d];
+
+        if (input_requires_grad[k] && grad_inputs[k] != NULL) {
+            cgrad_storage grad_part = {0};
+            int ret = cgrad_storage_narrow(grad_output, &grad_part, dim, start, length);
+            if (ret != CGRAD_SUCCESS) return ret;
+
+            ret = cgrad_storage_axpy(1.0f, &grad_part, grad_inputs[k], grad_inputs[k]);
+            cgrad_storage_free(&grad_part);
+            if (ret != CGRAD_SUCCESS) return ret;
+        }
+
+        start += length;
+    }
+
+    return CGRAD_SUCCESS;
+}
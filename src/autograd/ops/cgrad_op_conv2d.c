@@ -0,0 +1,68 @@
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+
+/**
+ * @brief Forward pass for 2D convolution.
+ *
+ * Computes: output = conv2d(input, weight)
+ * No context is needed - the backward pass rebuilds the columns it needs from
+ * the input storage, so the im2col buffer is not kept alive between passes.
+ */
+int cgrad_op_conv2d_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)requires_grad;
+    if (num_inputs != 2) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    return cgrad_storage_conv2d(metadata->conv2d.algo, &metadata->conv2d.params, inputs[0], inputs[1], output);
+}
+
+/**
+ * @brief Backward pass for 2D convolution.
+ *
+ * For Y = conv2d(X, W), with cols = im2col(X):
+ *   grad_W += sum_n grad_Y[n] @ cols[n]^T
+ *   grad_X += col2im(W^T @ grad_Y)
+ */
+int cgrad_op_conv2d_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    (void)output;
+    (void)ctx;
+
+    if (num_inputs != 2) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    cgrad_storage* grad_x = input_requires_grad[0] ? grad_inputs[0] : NULL;
+    cgrad_storage* grad_w = input_requires_grad[1] ? grad_inputs[1] : NULL;
+    if (grad_x == NULL && grad_w == NULL) {
+        return CGRAD_SUCCESS;
+    }
+
+    return cgrad_storage_conv2d_backward(
+        &metadata->conv2d.params,
+        inputs[0],
+        inputs[1],
+        grad_output,
+        grad_x,
+        grad_w
+    );
+}
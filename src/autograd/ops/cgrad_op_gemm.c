@@ -69,20 +69,21 @@ static cgrad_status cgrad_op_gemm_compute_and_accumulate_gradient(
         }
     }
     
+    // temporaries are recorded, so they must stay in scope until the record is freed
+    cgrad_storage grad_contrib = {0};
+    cgrad_storage grad_reduced = {0};
     cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
     cgrad_status err;
     
     if (needs_reduction) {
         // Broadcasting occurred: compute into temporary, reduce, then accumulate
-        cgrad_storage grad_contrib = {0};
         err = cgrad_storage_gemm(alpha, lhs, rhs, 0.0f, &grad_contrib);
         if (err != CGRAD_SUCCESS) {
             cgrad_storage_stop_recording(storage_record);
             cgrad_storage_free_record(storage_record);
             return err;
         }
-        
-        cgrad_storage grad_reduced = {0};
+
         err = cgrad_storage_reduce(1.0, &grad_contrib, reduction_mask, TENSOR_DIM, 0.0f, &grad_reduced);
         if (err != CGRAD_SUCCESS) {
             cgrad_storage_stop_recording(storage_record);
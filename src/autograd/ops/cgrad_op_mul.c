@@ -0,0 +1,73 @@
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+
+/**
+ * @brief Forward pass for elementwise multiplication.
+ * 
+ * Computes: output = a * b (with broadcasting)
+ * No context is needed - we use input storages directly in backward.
+ */
+int cgrad_op_mul_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)metadata;
+    (void)requires_grad;  // Unused for now
+    if (num_inputs != 2) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+    
+    *ctx = NULL;
+    
+    return cgrad_storage_mul(1.0f, inputs[0], inputs[1], 0.0f, output);
+}
+
+/**
+ * @brief Backward pass for elementwise multiplication with broadcasting support.
+ * 
+ * For c = a * b:
+ *   grad_a += grad_c * b (summed over dims where a was broadcasted)
+ *   grad_b += grad_c * a (summed over dims where b was broadcasted)
+ * 
+ * The products are accumulated directly into the gradient storages, so the
+ * reduction over broadcasted dims never materializes a full-size temporary.
+ */
+int cgrad_op_mul_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    (void)output;
+    (void)metadata;
+    (void)ctx;
+    
+    if (num_inputs != 2) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+    
+    int ret;
+    
+    // Gradient for input 0 (a): grad_a += grad_c * b
+    if (input_requires_grad[0] && grad_inputs[0] != NULL) {
+        ret = cgrad_storage_mul(1.0f, grad_output, inputs[1], 1.0f, grad_inputs[0]);
+        if (ret != CGRAD_SUCCESS) return ret;
+    }
+    
+    // Gradient for input 1 (b): grad_b += grad_c * a
+    if (input_requires_grad[1] && grad_inputs[1] != NULL) {
+        ret = cgrad_storage_mul(1.0f, grad_output, inputs[0], 1.0f, grad_inputs[1]);
+        if (ret != CGRAD_SUCCESS) return ret;
+    }
+    
+    return CGRAD_SUCCESS;
+}
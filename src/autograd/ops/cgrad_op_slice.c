@@ -0,0 +1,140 @@
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+/**
+ * @brief Forward pass for slice.
+ * 
+ * Computes: output = input[start:stop:step]
+ * The output is a view sharing the data of the input, nothing is copied.
+ * No context is needed for backward pass.
+ */
+int cgrad_op_slice_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)requires_grad;
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    return cgrad_storage_slice(
+        inputs[0],
+        output,
+        metadata->slice.start,
+        metadata->slice.stop,
+        metadata->slice.step,
+        metadata->slice.ndim
+    );
+}
+
+/**
+ * @brief Backward pass for slice.
+ * 
+ * For B = A[start:stop:step]:
+ *   grad_A[start:stop:step] += grad_B
+ * The gradient is accumulated in place through the same view of grad_A.
+ */
+int cgrad_op_slice_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    if (!input_requires_grad[0] || grad_inputs[0] == NULL) {
+        return CGRAD_SUCCESS;
+    }
+
+    cgrad_storage grad_view = {0};
+    int ret = cgrad_storage_slice(
+        grad_inputs[0],
+        &grad_view,
+        metadata->slice.start,
+        metadata->slice.stop,
+        metadata->slice.step,
+        metadata->slice.ndim
+    );
+    if (ret != CGRAD_SUCCESS) return ret;
+
+    ret = cgrad_storage_axpy(1.0f, grad_output, &grad_view, &grad_view);
+
+    // free the view, the data is owned by grad_A
+    cgrad_storage_free(&grad_view);
+
+    return ret;
+}
+
+/**
+ * @brief Forward pass for select.
+ * 
+ * Computes: output = input[..., index, ...] with dim dropped.
+ * The output is a view sharing the data of the input, nothing is copied.
+ */
+int cgrad_op_select_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)requires_grad;
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    return cgrad_storage_select(inputs[0], output, metadata->select.dim, metadata->select.index);
+}
+
+/**
+ * @brief Backward pass for select.
+ * 
+ * For B = select(A, dim, index):
+ *   select(grad_A, dim, index) += grad_B
+ */
+int cgrad_op_select_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    if (!input_requires_grad[0] || grad_inputs[0] == NULL) {
+        return CGRAD_SUCCESS;
+    }
+
+    cgrad_storage grad_view = {0};
+    int ret = cgrad_storage_select(grad_inputs[0], &grad_view, metadata->select.dim, metadata->select.index);
+    if (ret != CGRAD_SUCCESS) return ret;
+
+    ret = cgrad_storage_axpy(1.0f, grad_output, &grad_view, &grad_view);
+
+    // free the view, the data is owned by grad_A
+    cgrad_storage_free(&grad_view);
+
+    return ret;
+}
@@ -0,0 +1,165 @@
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include <stdlib.h>
+
+/**
+ * @brief Forward pass for softmax and log-softmax along the last dimension.
+ *
+ * Computes: output = softmax(input) or output = log_softmax(input)
+ * No context is needed - the backward pass only depends on the output.
+ *
+ * If output is already initialized it shares the data of the input (in-place
+ * execution scheduled by the compute graph) and is overwritten directly.
+ */
+int cgrad_op_softmax_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)requires_grad;
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    return cgrad_storage_softmax(metadata->softmax.log, inputs[0], output);
+}
+
+/**
+ * @brief Backward pass for softmax and log-softmax.
+ *
+ * For y = softmax(x):      grad_x += y * (grad_y - sum(grad_y * y))
+ * For y = log_softmax(x):  grad_x += grad_y - exp(y) * sum(grad_y)
+ * where the sums run over the last dimension.
+ */
+int cgrad_op_softmax_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    (void)inputs;
+    (void)ctx;
+
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    if (!input_requires_grad[0] || grad_inputs[0] == NULL) {
+        return CGRAD_SUCCESS;
+    }
+
+    return cgrad_storage_softmax_backward(metadata->softmax.log, output, grad_output, grad_inputs[0]);
+}
+
+/**
+ * @brief Forward pass for the fused softmax cross-entropy loss.
+ *
+ * Inputs are the logits and a target distribution of the same shape (e.g. one-hot
+ * rows). Computes the scalar
+ *   output = mean over rows of (logsumexp(x) * sum(t) - sum(t * x))
+ * which equals -sum(t * log_softmax(x)) without materializing the softmax.
+ *
+ * When gradients are required, only the per-row logsumexp is cached in ctx as a
+ * cgrad_storage*; the backward pass recomputes softmax from it and the logits.
+ */
+int cgrad_op_softmax_cross_entropy_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    (void)metadata;
+    if (num_inputs != 2) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    if (!requires_grad) {
+        return cgrad_storage_softmax_cross_entropy(inputs[0], inputs[1], output, NULL);
+    }
+
+    cgrad_storage* lse = (cgrad_storage*)calloc(1, sizeof(cgrad_storage));
+    if (lse == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    int ret = cgrad_storage_softmax_cross_entropy(inputs[0], inputs[1], output, lse);
+    if (ret != CGRAD_SUCCESS) {
+        if (lse->data) cgrad_storage_free(lse);
+        free(lse);
+        return ret;
+    }
+
+    *ctx = lse;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Backward pass for the fused softmax cross-entropy loss.
+ *
+ * With g the (scalar) output gradient and N the number of rows:
+ *   grad_x += g / N * (softmax(x) * sum(t) - t)
+ *   grad_t += g / N * (logsumexp(x) - x)
+ */
+int cgrad_op_softmax_cross_entropy_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    (void)output;
+    (void)metadata;
+
+    if (num_inputs != 2) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    cgrad_storage* grad_x = (input_requires_grad[0] && grad_inputs[0] != NULL) ? grad_inputs[0] : NULL;
+    cgrad_storage* grad_t = (input_requires_grad[1] && grad_inputs[1] != NULL) ? grad_inputs[1] : NULL;
+    if (grad_x == NULL && grad_t == NULL) {
+        return CGRAD_SUCCESS;
+    }
+
+    cgrad_storage* lse = (cgrad_storage*)ctx;
+    if (lse == NULL) {
+        // forward ran without requires_grad, so no logsumexp was cached
+        return CGRAD_ERR_COMPUTE_GRAPH_FORWARD_NOT_EXECUTED;
+    }
+
+    float g;
+    uint32_t idx[1] = {0};
+    int ret = cgrad_storage_get(grad_output, idx, 1, &g);
+    if (ret != CGRAD_SUCCESS) return ret;
+
+    const cgrad_storage_layout* lse_layout = lse->backend->storage_get_layout(lse->data);
+    float alpha = g / (float)lse_layout->size;
+
+    return cgrad_storage_softmax_cross_entropy_backward(alpha, inputs[0], inputs[1], lse, grad_x, grad_t);
+}
+
+/**
+ * @brief Free the logsumexp cached by the forward pass.
+ */
+void cgrad_op_softmax_cross_entropy_free_ctx(void* ctx) {
+    cgrad_storage* lse = (cgrad_storage*)ctx;
+    if (lse == NULL) return;
+    cgrad_storage_free(lse);
+    free(lse);
+}
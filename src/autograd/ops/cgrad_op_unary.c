@@ -0,0 +1,98 @@
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include <stdlib.h>
+
+/**
+ * @brief Forward pass for elementwise unary functions.
+ *
+ * Computes: output = f(input)
+ * When gradients are required, the derivative f'(input) is computed in the same
+ * pass and cached in ctx as a cgrad_storage* (the ReLU mask, 1 - tanh^2, ...).
+ * For exp the derivative equals the output, so nothing is cached and the backward
+ * pass reuses the output storage instead.
+ *
+ * If output is already initialized it shares the data of the input (in-place
+ * execution scheduled by the compute graph) and is overwritten directly.
+ */
+int cgrad_op_unary_forward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    const cgrad_op_metadata* metadata,
+    cgrad_storage* output,
+    void** ctx,
+    int requires_grad
+) {
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    *ctx = NULL;
+
+    cgrad_unary_op op = metadata->unary.op;
+    if (!requires_grad || op == CGRAD_UNARY_EXP) {
+        return cgrad_storage_unary(op, inputs[0], output, NULL);
+    }
+
+    cgrad_storage* deriv = (cgrad_storage*)calloc(1, sizeof(cgrad_storage));
+    if (deriv == NULL) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    int ret = cgrad_storage_unary(op, inputs[0], output, deriv);
+    if (ret != CGRAD_SUCCESS) {
+        if (deriv->data) cgrad_storage_free(deriv);
+        free(deriv);
+        return ret;
+    }
+
+    *ctx = deriv;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Backward pass for elementwise unary functions.
+ *
+ * For y = f(x):
+ *   grad_x += grad_y * f'(x)
+ *
+ * f'(x) is taken from the forward context, or from the output for exp.
+ */
+int cgrad_op_unary_backward(
+    cgrad_storage** inputs,
+    int num_inputs,
+    cgrad_storage* output,
+    cgrad_storage* grad_output,
+    const cgrad_op_metadata* metadata,
+    void* ctx,
+    cgrad_storage** grad_inputs,
+    const int* input_requires_grad
+) {
+    (void)inputs;
+
+    if (num_inputs != 1) {
+        return CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION;
+    }
+
+    if (!input_requires_grad[0] || grad_inputs[0] == NULL) {
+        return CGRAD_SUCCESS;
+    }
+
+    cgrad_storage* deriv = (metadata->unary.op == CGRAD_UNARY_EXP) ? output : (cgrad_storage*)ctx;
+    if (deriv == NULL) {
+        // forward ran without requires_grad, so no derivative was cached
+        return CGRAD_ERR_COMPUTE_GRAPH_FORWARD_NOT_EXECUTED;
+    }
+
+    return cgrad_storage_mul(1.0f, grad_output, deriv, 1.0f, grad_inputs[0]);
+}
+
+/**
+ * @brief Free the derivative cached by the forward pass.
+ */
+void cgrad_op_unary_free_ctx(void* ctx) {
+    cgrad_storage* deriv = (cgrad_storage*)ctx;
+    if (deriv == NULL) return;
+    cgrad_storage_free(deriv);
+    free(deriv);
+}
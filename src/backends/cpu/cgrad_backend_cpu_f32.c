@@ -6,26 +6,124 @@
 #include <stdlib.h>
 #include <math.h>
 #include <time.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <cblas.h>
 
+// Elementwise kernels only spread over multiple threads beyond this many elements per thread
+#define CGRAD_CPU_F32_PARALLEL_GRAIN (1 << 15)
+// Clearing buffers is bandwidth bound and only spreads over multiple threads beyond this many bytes per thread
+#define CGRAD_CPU_F32_ZERO_GRAIN (1 << 20)
+#define CGRAD_CPU_F32_MAX_THREADS 16
+// Batched gemm keeps the matrix pointers of up to this many batch entries on the stack
+#define CGRAD_CPU_F32_GEMM_STACK_BATCH 64
+// Softmax cross-entropy keeps the per-row losses of up to this many rows on the stack
+#define CGRAD_CPU_F32_CROSS_ENTROPY_STACK_ROWS 1024
+
 // Struct definition
 struct cgrad_backend_cpu_f32 {
     cgrad_storage_layout layout;
     float* data;
+    int is_wrapped;                 // data is external memory (storage_wrap) and is not freed
+    void (*release)(void* ctx);     // called for wrapped memory once the storage is freed, or NULL
+    void* release_ctx;
 };
 
 typedef struct cgrad_backend_cpu_f32 cgrad_backend_cpu_f32;
 
+// First element of a storage; views created by slicing start at an offset into the shared data
+static inline float* helper_cgrad_backend_cpu_f32_base(const cgrad_backend_cpu_f32* t) {
+    return t->data + t->layout.offset;
+}
+
+// Largest length or increment a single BLAS call can take. An ILP64 OpenBLAS (INTERFACE64=1)
+// has a 64 bit blasint and gets whole vectors at once, otherwise longer vectors are chunked.
+#define CGRAD_CPU_F32_BLASINT_MAX ((size_t)(sizeof(blasint) > 4 ? INT64_MAX : INT32_MAX))
+
+// y = x over n elements with 64 bit length and increments
+static inline void helper_cgrad_backend_cpu_f32_scopy(size_t n, const float* x, size_t incx, float* y, size_t incy) {
+    if (n <= CGRAD_CPU_F32_BLASINT_MAX && incx <= CGRAD_CPU_F32_BLASINT_MAX && incy <= CGRAD_CPU_F32_BLASINT_MAX) {
+        cblas_scopy((blasint)n, x, (blasint)incx, y, (blasint)incy);
+        return;
+    }
+    if (incx > CGRAD_CPU_F32_BLASINT_MAX || incy > CGRAD_CPU_F32_BLASINT_MAX) {
+        for (size_t i = 0; i < n; i++) y[i * incy] = x[i * incx];
+        return;
+    }
+    while (n > 0) {
+        size_t len = n < CGRAD_CPU_F32_BLASINT_MAX ? n : CGRAD_CPU_F32_BLASINT_MAX;
+        cblas_scopy((blasint)len, x, (blasint)incx, y, (blasint)incy);
+        x += len * incx;
+        y += len * incy;
+        n -= len;
+    }
+}
+
+// y += alpha * x over n elements with 64 bit length and increments
+static inline void helper_cgrad_backend_cpu_f32_saxpy(size_t n, float alpha, const float* x, size_t incx, float* y, size_t incy) {
+    if (n <= CGRAD_CPU_F32_BLASINT_MAX && incx <= CGRAD_CPU_F32_BLASINT_MAX && incy <= CGRAD_CPU_F32_BLASINT_MAX) {
+        cblas_saxpy((blasint)n, alpha, x, (blasint)incx, y, (blasint)incy);
+        return;
+    }
+    if (incx > CGRAD_CPU_F32_BLASINT_MAX || incy > CGRAD_CPU_F32_BLASINT_MAX) {
+        for (size_t i = 0; i < n; i++) y[i * incy] += alpha * x[i * incx];
+        return;
+    }
+    while (n > 0) {
+        size_t len = n < CGRAD_CPU_F32_BLASINT_MAX ? n : CGRAD_CPU_F32_BLASINT_MAX;
+        cblas_saxpy((blasint)len, alpha, x, (blasint)incx, y, (blasint)incy);
+        x += len * incx;
+        y += len * incy;
+        n -= len;
+    }
+}
+
+// Dot product over n elements with 64 bit length and increments
+static inline float helper_cgrad_backend_cpu_f32_sdot(size_t n, const float* x, size_t incx, const float* y, size_t incy) {
+    if (n <= CGRAD_CPU_F32_BLASINT_MAX && incx <= CGRAD_CPU_F32_BLASINT_MAX && incy <= CGRAD_CPU_F32_BLASINT_MAX) {
+        return cblas_sdot((blasint)n, x, (blasint)incx, y, (blasint)incy);
+    }
+    float acc = 0.0f;
+    if (incx > CGRAD_CPU_F32_BLASINT_MAX || incy > CGRAD_CPU_F32_BLASINT_MAX) {
+        for (size_t i = 0; i < n; i++) acc += x[i * incx] * y[i * incy];
+        return acc;
+    }
+    while (n > 0) {
+        size_t len = n < CGRAD_CPU_F32_BLASINT_MAX ? n : CGRAD_CPU_F32_BLASINT_MAX;
+        acc += cblas_sdot((blasint)len, x, (blasint)incx, y, (blasint)incy);
+        x += len * incx;
+        y += len * incy;
+        n -= len;
+    }
+    return acc;
+}
+
 static cgrad_status cgrad_backend_cpu_f32_init(void* t, const uint32_t* shape, int ndim);
+static cgrad_status cgrad_backend_cpu_f32_wrap(void* t, const cgrad_storage_layout* layout, void* data, void (*release)(void* ctx), void* release_ctx);
 static cgrad_status cgrad_backend_cpu_f32_get(const void* t, const uint32_t* indices, int ndim, float* out_value);
 static cgrad_status cgrad_backend_cpu_f32_set(void* t, const uint32_t* indices, int ndim, float value);
 static cgrad_status cgrad_backend_cpu_f32_fill(void* t, float value);
+static cgrad_status cgrad_backend_cpu_f32_zero(void* t);
 static cgrad_status cgrad_backend_cpu_f32_fill_rand(void* t);
 static cgrad_status cgrad_backend_cpu_f32_shallow_copy(const void* src, void* dst);
 static cgrad_status cgrad_backend_cpu_f32_contiguous(const void* src, void* dst);
+static cgrad_status cgrad_backend_cpu_f32_copy(const void* src, void* dst);
 static void cgrad_backend_cpu_f32_free(void* t);
 static cgrad_status cgrad_backend_cpu_f32_axpy(float alpha, void* x, void* y);
 static cgrad_status cgrad_backend_cpu_f32_gemm(float alpha, void* a, void* b, float beta, void* c);
+static cgrad_status cgrad_backend_cpu_f32_mul(float alpha, void* x, void* y, float beta, void* r);
+static cgrad_status cgrad_backend_cpu_f32_unary(cgrad_unary_op op, void* x, void* r, void* dr);
+static cgrad_status cgrad_backend_cpu_f32_softmax(int log_softmax, void* x, void* r);
+static cgrad_status cgrad_backend_cpu_f32_softmax_backward(int log_softmax, void* y, void* grad_y, void* grad_x);
+static cgrad_status cgrad_backend_cpu_f32_softmax_cross_entropy(void* x, void* target, void* loss, void* lse);
+static cgrad_status cgrad_backend_cpu_f32_softmax_cross_entropy_backward(float alpha, void* x, void* target, void* lse, void* grad_x, void* grad_target);
+static cgrad_status cgrad_backend_cpu_f32_im2col(const cgrad_conv2d_params* p, void* x, void* cols);
+static cgrad_status cgrad_backend_cpu_f32_col2im(const cgrad_conv2d_params* p, void* cols, void* x);
+static cgrad_status cgrad_backend_cpu_f32_conv2d(const cgrad_conv2d_params* p, void* x, void* w, void* r);
+static cgrad_status cgrad_backend_cpu_f32_optim_step(const cgrad_optim_update* u, int n, void* const* params, void* const* grads, void* const* m, void* const* v);
+static cgrad_status cgrad_backend_cpu_f32_sum_squares(int n, void* const* ts, double* out);
+static cgrad_status cgrad_backend_cpu_f32_scale(int n, void* const* ts, float alpha);
 static cgrad_storage_layout* cgrad_backend_cpu_f32_get_layout(void* t);
 static void cgrad_backend_cpu_f32_print_data(const void* t);
 
@@ -34,13 +132,28 @@ static cgrad_backend backend_f32_cpu = {
     .name = "cpu_f32",
     .storage_handle_size = sizeof(struct cgrad_backend_cpu_f32),
     .storage_init = cgrad_backend_cpu_f32_init,
+    .storage_wrap = cgrad_backend_cpu_f32_wrap,
     .storage_fill = cgrad_backend_cpu_f32_fill,
+    .storage_zero = cgrad_backend_cpu_f32_zero,
     .storage_fill_rand = cgrad_backend_cpu_f32_fill_rand,
     .storage_shallow_copy = cgrad_backend_cpu_f32_shallow_copy,
     .storage_contiguous = cgrad_backend_cpu_f32_contiguous,
+    .storage_copy = cgrad_backend_cpu_f32_copy,
     .storage_free = cgrad_backend_cpu_f32_free,
     .storage_axpy = cgrad_backend_cpu_f32_axpy,
     .storage_gemm = cgrad_backend_cpu_f32_gemm,
+    .storage_mul = cgrad_backend_cpu_f32_mul,
+    .storage_unary = cgrad_backend_cpu_f32_unary,
+    .storage_softmax = cgrad_backend_cpu_f32_softmax,
+    .storage_softmax_backward = cgrad_backend_cpu_f32_softmax_backward,
+    .storage_softmax_cross_entropy = cgrad_backend_cpu_f32_softmax_cross_entropy,
+    .storage_softmax_cross_entropy_backward = cgrad_backend_cpu_f32_softmax_cross_entropy_backward,
+    .storage_im2col = cgrad_backend_cpu_f32_im2col,
+    .storage_col2im = cgrad_backend_cpu_f32_col2im,
+    .storage_conv2d = cgrad_backend_cpu_f32_conv2d,
+    .storage_optim_step = cgrad_backend_cpu_f32_optim_step,
+    .storage_sum_squares = cgrad_backend_cpu_f32_sum_squares,
+    .storage_scale = cgrad_backend_cpu_f32_scale,
     .storage_get = cgrad_backend_cpu_f32_get,
     .storage_set = cgrad_backend_cpu_f32_set,
     .storage_get_layout = cgrad_backend_cpu_f32_get_layout,
@@ -53,25 +166,21 @@ static void register_f32_cpu_backend(void) {
     cgrad_register_backend(&backend_f32_cpu);
 }
 
-// Helper function for batch operations
-static int helper_cgrad_backend_cpu_f32_build_batch_array(const cgrad_backend_cpu_f32* t, float*** array, uint32_t ndim) {
+// Helper function for batch operations: pointers to the trailing ndim-dim blocks of t, in
+// batch order. array must hold one pointer per batch entry.
+static int helper_cgrad_backend_cpu_f32_fill_batch_array(const cgrad_backend_cpu_f32* t, float** array, uint32_t ndim) {
     // compute number of arrays in the batch
-    int batch_size = 1;
+    size_t batch_size = 1;
     for (int i = 0; i < TENSOR_DIM - ndim; i++) {
         batch_size *= t->layout.shape[i];
     }
     
-    // allocate memory for array of pointers
-    *array = (float**)malloc(batch_size * sizeof(float*));
-    if (!(*array)) return CGRAD_ERR_ALLOC_FAILED;
-    
     // fill array
-    uint32_t indices[TENSOR_DIM] = {0};
-    #pragma omp parallel for
     for (size_t i = 0; i < batch_size; i++) {
         size_t rem = i;
         // Compute multi-dimensional index for the batch dims in the current layout
         // The remaining ndims are set to 0
+        uint32_t indices[TENSOR_DIM] = {0};
         for (int d = TENSOR_DIM - ndim - 1; d >= 0; d--) {
             indices[d] = rem % t->layout.shape[d];
             rem /= t->layout.shape[d];
@@ -84,8 +193,135 @@ static int helper_cgrad_backend_cpu_f32_build_batch_array(const cgrad_backend_cp
         }
 
         // set pointer in array
-        (*array)[i] = t->data + idx;
+        array[i] = t->data + idx;
+    }
+    return CGRAD_SUCCESS;
+}
+
+// Describe the trailing matrix of a layout for BLAS. Row-major matrices with unit column
+// stride are passed as-is, matrices with unit row stride (e.g. a transposed view) are passed
+// with CblasTrans. Batch strides are not constrained, so broadcasted batches are not copied.
+// Returns 0 if the matrix needs to be made contiguous first.
+static int helper_cgrad_backend_cpu_f32_blas_matrix(const cgrad_storage_layout* l, CBLAS_TRANSPOSE* trans, blasint* ld) {
+    uint64_t rows = l->shape[TENSOR_DIM-2];
+    uint64_t cols = l->shape[TENSOR_DIM-1];
+    uint64_t row_stride = l->strides[TENSOR_DIM-2];
+    uint64_t col_stride = l->strides[TENSOR_DIM-1];
+    uint64_t lead;
+    if ((cols == 1 || col_stride == 1) && (rows == 1 || row_stride >= cols)) {
+        *trans = CblasNoTrans;
+        lead = (rows == 1 || row_stride < 1) ? (cols > 1 ? cols : 1) : row_stride;
+    } else if ((rows == 1 || row_stride == 1) && (cols == 1 || col_stride >= rows)) {
+        *trans = CblasTrans;
+        lead = (cols == 1 || col_stride < 1) ? (rows > 1 ? rows : 1) : col_stride;
+    } else {
+        return 0;
+    }
+    // a leading dimension BLAS cannot represent needs a compact copy as well
+    if (lead > CGRAD_CPU_F32_BLASINT_MAX) return 0;
+    *ld = (blasint)lead;
+    return 1;
+}
+
+// Kernel applied to one row of the innermost collapsed dim: n elements starting at ptrs[k]
+// with element strides incs[k] for every operand k.
+typedef void (*helper_cgrad_backend_cpu_f32_row_fn)(void* args, size_t n, float* const* ptrs, const size_t* incs);
+
+// Apply fn to every row of the collapsed layouts, with base[k] pointing at the first element of
+// operand k. Ranks up to 3 use plain nested loops, higher ranks walk the outer dims with
+// incrementally updated offsets. Being inlined into each kernel, fn is called directly.
+static inline void helper_cgrad_backend_cpu_f32_for_each_row(
+    const cgrad_storage_layout_collapsed* c,
+    int n_ops,
+    float* const* base,
+    helper_cgrad_backend_cpu_f32_row_fn fn,
+    void* args
+) {
+    float* ptrs[CGRAD_STORAGE_LAYOUT_COLLAPSE_MAX];
+    size_t incs[CGRAD_STORAGE_LAYOUT_COLLAPSE_MAX] = {0};
+    int inner = c->rank - 1;
+    for (int k = 0; k < n_ops; k++) {
+        ptrs[k] = base[k];
+        if (inner >= 0) incs[k] = c->strides[k][inner];
+    }
+
+    switch (c->rank) {
+    case 0:
+        fn(args, 1, ptrs, incs);
+        return;
+    case 1:
+        fn(args, c->shape[0], ptrs, incs);
+        return;
+    case 2:
+        for (uint32_t i = 0; i < c->shape[0]; i++) {
+            for (int k = 0; k < n_ops; k++) ptrs[k] = base[k] + i * c->strides[k][0];
+            fn(args, c->shape[1], ptrs, incs);
+        }
+        return;
+    case 3:
+        for (uint32_t i = 0; i < c->shape[0]; i++) {
+            for (uint32_t j = 0; j < c->shape[1]; j++) {
+                for (int k = 0; k < n_ops; k++) ptrs[k] = base[k] + i * c->strides[k][0] + j * c->strides[k][1];
+                fn(args, c->shape[2], ptrs, incs);
+            }
+        }
+        return;
+    default:
+        break;
+    }
+
+    uint32_t idx[TENSOR_DIM] = {0};
+    for (;;) {
+        fn(args, c->shape[inner], ptrs, incs);
+        int d = inner - 1;
+        for (; d >= 0; d--) {
+            for (int k = 0; k < n_ops; k++) ptrs[k] += c->strides[k][d];
+            if (++idx[d] < c->shape[d]) break;
+            for (int k = 0; k < n_ops; k++) ptrs[k] -= c->strides[k][d] * c->shape[d];
+            idx[d] = 0;
+        }
+        if (d < 0) break;
+    }
+}
+
+// Row kernels for the elementwise ops below
+static void helper_cgrad_backend_cpu_f32_copy_row(void* args, size_t n, float* const* ptrs, const size_t* incs) {
+    (void)args;
+    helper_cgrad_backend_cpu_f32_scopy(n, ptrs[0], incs[0], ptrs[1], incs[1]);
+}
+
+static void helper_cgrad_backend_cpu_f32_fill_row(void* args, size_t n, float* const* ptrs, const size_t* incs) {
+    helper_cgrad_backend_cpu_f32_scopy(n, (const float*)args, 0, ptrs[0], incs[0]);
+}
+
+static void helper_cgrad_backend_cpu_f32_fill_rand_row(void* args, size_t n, float* const* ptrs, const size_t* incs) {
+    (void)args;
+    for (size_t i = 0; i < n; i++) ptrs[0][i * incs[0]] = (float)rand()/(float)(RAND_MAX);
+}
+
+static void helper_cgrad_backend_cpu_f32_axpy_row(void* args, size_t n, float* const* ptrs, const size_t* incs) {
+    helper_cgrad_backend_cpu_f32_saxpy(n, *(const float*)args, ptrs[0], incs[0], ptrs[1], incs[1]);
+}
+
+// y += alpha * x for a y that is not contiguous, walking the rows of the collapsed layouts.
+// Broadcasted y views are rejected since several x would add into one element.
+static cgrad_status helper_cgrad_backend_cpu_f32_axpy_strided(
+    float alpha,
+    const cgrad_backend_cpu_f32* x_tensor,
+    cgrad_backend_cpu_f32* y_tensor
+) {
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (y_tensor->layout.strides[d] == 0 && y_tensor->layout.shape[d] > 1) return CGRAD_ERR_STORAGE_LAYOUT_BROADCAST;
     }
+    if (y_tensor->layout.size == 0) return CGRAD_SUCCESS;
+
+    const cgrad_storage_layout* layouts[2] = {&x_tensor->layout, &y_tensor->layout};
+    cgrad_storage_layout_collapsed c;
+    cgrad_status err = cgrad_storage_layout_collapse(layouts, 2, &c);
+    if (err != CGRAD_SUCCESS) return err;
+
+    float* base[2] = {helper_cgrad_backend_cpu_f32_base(x_tensor), helper_cgrad_backend_cpu_f32_base(y_tensor)};
+    helper_cgrad_backend_cpu_f32_for_each_row(&c, 2, base, helper_cgrad_backend_cpu_f32_axpy_row, &alpha);
     return CGRAD_SUCCESS;
 }
 
@@ -99,10 +335,26 @@ static cgrad_status cgrad_backend_cpu_f32_init(void* t, const uint32_t* shape, i
     
     tensor->data = (float*)calloc(tensor->layout.size, sizeof(float));
     if (!tensor->data) return CGRAD_ERR_ALLOC_FAILED;
+    tensor->is_wrapped = 0;
+    tensor->release = NULL;
+    tensor->release_ctx = NULL;
     
     return CGRAD_SUCCESS;
 }
 
+static cgrad_status cgrad_backend_cpu_f32_wrap(void* t, const cgrad_storage_layout* layout, void* data, void (*release)(void* ctx), void* release_ctx) {
+    cgrad_backend_cpu_f32* tensor = (cgrad_backend_cpu_f32*)t;
+    if (!tensor || !layout || !data) return CGRAD_ERR_NULL_POINTER;
+
+    cgrad_storage_layout_copy(&tensor->layout, layout);
+    tensor->data = (float*)data;
+    tensor->is_wrapped = 1;
+    tensor->release = release;
+    tensor->release_ctx = release_ctx;
+
+    return CGRAD_SUCCESS;
+}
+
 static cgrad_status cgrad_backend_cpu_f32_get(const void* t, const uint32_t* indices, int ndim, float* out_value) {
     const cgrad_backend_cpu_f32* tensor = (const cgrad_backend_cpu_f32*)t;
     if (!tensor || !indices || !out_value) return CGRAD_ERR_NULL_POINTER;
@@ -131,21 +383,28 @@ static cgrad_status cgrad_backend_cpu_f32_fill(void* t, float value) {
     cgrad_backend_cpu_f32* tensor = (cgrad_backend_cpu_f32*)t;
     if (!tensor || !tensor->data) return CGRAD_ERR_NULL_POINTER;
 
-    // Find the minimum nonzero stride in the tensor layout
-    int min_stride = 0;
-    for (int i = 0; i < TENSOR_DIM; i++) {
-        int stride = tensor->layout.strides[i];
-        if (stride > 0 && (min_stride == 0 || stride < min_stride)) {
-            min_stride = stride;
-        }
+    // contiguous storages are cleared with a parallel memset (+0.0f is all-zero bits)
+    if (value == 0.0f && !signbit(value) && cgrad_storage_layout_is_contiguous(&tensor->layout)) {
+        return cgrad_backend_cpu_f32_zero(t);
     }
-    if (min_stride == 0) min_stride = 1; // fallback for degenerate case
 
-    // fill the tensor
-    cblas_scopy(
+    // Views that cannot be traversed with a fixed stride (e.g. a narrowed column range
+    // of a matrix) are filled row by row
+    if (!cgrad_storage_layout_is_regular(&tensor->layout)) {
+        const cgrad_storage_layout* layouts[1] = {&tensor->layout};
+        cgrad_storage_layout_collapsed c;
+        cgrad_status err = cgrad_storage_layout_collapse(layouts, 1, &c);
+        if (err != CGRAD_SUCCESS) return err;
+        float* base[1] = {helper_cgrad_backend_cpu_f32_base(tensor)};
+        helper_cgrad_backend_cpu_f32_for_each_row(&c, 1, base, helper_cgrad_backend_cpu_f32_fill_row, &value);
+        return CGRAD_SUCCESS;
+    }
+
+    // fill the tensor with the fixed stride of the regular layout
+    helper_cgrad_backend_cpu_f32_scopy(
         tensor->layout.size,
         &value, 0,
-        tensor->data, min_stride
+        helper_cgrad_backend_cpu_f32_base(tensor), tensor->layout.strides[TENSOR_DIM - 1]
     );
 
     return CGRAD_SUCCESS;
@@ -155,8 +414,13 @@ static cgrad_status cgrad_backend_cpu_f32_fill_rand(void* t) {
     cgrad_backend_cpu_f32* tensor = (cgrad_backend_cpu_f32*)t;
     if (!tensor || !tensor->data) return CGRAD_ERR_NULL_POINTER;
     
-    for (int i = 0; i < tensor->layout.size; i++)
-        tensor->data[i] = (float)rand()/(float)(RAND_MAX);
+    // rows are visited in logical order, so views draw the same values as contiguous storages
+    const cgrad_storage_layout* layouts[1] = {&tensor->layout};
+    cgrad_storage_layout_collapsed c;
+    cgrad_status err = cgrad_storage_layout_collapse(layouts, 1, &c);
+    if (err != CGRAD_SUCCESS) return err;
+    float* base[1] = {helper_cgrad_backend_cpu_f32_base(tensor)};
+    helper_cgrad_backend_cpu_f32_for_each_row(&c, 1, base, helper_cgrad_backend_cpu_f32_fill_rand_row, NULL);
     
     return CGRAD_SUCCESS;
 }
@@ -169,65 +433,63 @@ static cgrad_status cgrad_backend_cpu_f32_shallow_copy(const void* src, void* ds
     
     cgrad_storage_layout_copy(&dst_tensor->layout, &src_tensor->layout);
     dst_tensor->data = src_tensor->data;
+    // only the root handle releases the data
+    dst_tensor->is_wrapped = 0;
+    dst_tensor->release = NULL;
+    dst_tensor->release_ctx = NULL;
     
     return CGRAD_SUCCESS;
 }
 
-static cgrad_status cgrad_backend_cpu_f32_contiguous(const void* src, void* dst) {
+static cgrad_status cgrad_backend_cpu_f32_copy(const void* src, void* dst) {
     const cgrad_backend_cpu_f32* src_tensor = (const cgrad_backend_cpu_f32*)src;
     cgrad_backend_cpu_f32* dst_tensor = (cgrad_backend_cpu_f32*)dst;
     
     if (!src_tensor || !dst_tensor) return CGRAD_ERR_NULL_POINTER;
 
-    // Check shape
+    const cgrad_storage_layout* src_layout = &src_tensor->layout;
+    const cgrad_storage_layout* dst_layout = &dst_tensor->layout;
+
+    // Check shape, and that dst does not map several elements to the same location
     for (int d = 0; d < TENSOR_DIM; d++) {
-        if (src_tensor->layout.shape[d] != dst_tensor->layout.shape[d]) {
+        if (src_layout->shape[d] != dst_layout->shape[d]) {
             return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
         }
+        if (dst_layout->strides[d] == 0 && dst_layout->shape[d] > 1) {
+            return CGRAD_ERR_STORAGE_LAYOUT_BROADCAST;
+        }
     }
+    if (dst_layout->size == 0) return CGRAD_SUCCESS;
 
-    // Check that dst is contiguous
-    if (!cgrad_storage_layout_is_contiguous(&dst_tensor->layout)) {
-        return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
-    }
+    const cgrad_storage_layout* layouts[2] = {src_layout, dst_layout};
+    cgrad_storage_layout_collapsed c;
+    cgrad_status err = cgrad_storage_layout_collapse(layouts, 2, &c);
+    if (err != CGRAD_SUCCESS) return err;
 
-    uint32_t block_size = src_tensor->layout.shape[TENSOR_DIM-1];
-    uint32_t block_ndim = 1;
+    float* base[2] = {helper_cgrad_backend_cpu_f32_base(src_tensor), helper_cgrad_backend_cpu_f32_base(dst_tensor)};
+    helper_cgrad_backend_cpu_f32_for_each_row(&c, 2, base, helper_cgrad_backend_cpu_f32_copy_row, NULL);
+    return CGRAD_SUCCESS;
+}
 
-    while (
-        block_ndim < TENSOR_DIM
-        && (
-            src_tensor->layout.strides[TENSOR_DIM - block_ndim - 1]
-            == src_tensor->layout.shape[TENSOR_DIM - block_ndim] * src_tensor->layout.strides[TENSOR_DIM - block_ndim]
-        )
-    ) {
-        block_size *= src_tensor->layout.shape[TENSOR_DIM - block_ndim - 1];
-        block_ndim++;
-    }
+static cgrad_status cgrad_backend_cpu_f32_contiguous(const void* src, void* dst) {
+    const cgrad_backend_cpu_f32* dst_tensor = (const cgrad_backend_cpu_f32*)dst;
+    if (!src || !dst_tensor) return CGRAD_ERR_NULL_POINTER;
 
-    uint32_t idx[TENSOR_DIM] = {0};
-    for (size_t offset = 0; offset < dst_tensor->layout.size; offset += block_size) {
-        for (uint32_t d = 0; d < TENSOR_DIM - block_ndim; d++) {
-            idx[d] = (offset / dst_tensor->layout.strides[d]) % dst_tensor->layout.shape[d];
-        }
-        size_t src_idx = 0, dst_idx = 0;
-        int src_err = cgrad_storage_layout_flat_index(&src_tensor->layout, idx, TENSOR_DIM, &src_idx);
-        int dst_err = cgrad_storage_layout_flat_index(&dst_tensor->layout, idx, TENSOR_DIM, &dst_idx);
-        if (src_err == CGRAD_SUCCESS && dst_err == CGRAD_SUCCESS) {
-            cblas_scopy(
-                block_size,
-                src_tensor->data + src_idx, src_tensor->layout.strides[TENSOR_DIM-1],
-                dst_tensor->data + dst_idx, 1
-            );
-        }
+    // Check that dst is contiguous
+    if (!cgrad_storage_layout_is_contiguous(&dst_tensor->layout)) {
+        return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
     }
-    return CGRAD_SUCCESS;
+    return cgrad_backend_cpu_f32_copy(src, dst);
 }
 
 static void cgrad_backend_cpu_f32_free(void* t) {
     cgrad_backend_cpu_f32* tensor = (cgrad_backend_cpu_f32*)t;
     if (tensor && tensor->data) {
-        free(tensor->data);
+        if (!tensor->is_wrapped) {
+            free(tensor->data);
+        } else if (tensor->release) {
+            tensor->release(tensor->release_ctx);
+        }
         tensor->data = NULL;
     }
 }
@@ -245,9 +507,9 @@ static cgrad_status cgrad_backend_cpu_f32_axpy(float alpha, void* x, void* y) {
         }
     }
 
-    // Check if y is contiguous (required for in-place modification)
+    // A strided y (e.g. a slice of a gradient) is updated row by row in place
     if (!cgrad_storage_layout_is_contiguous(&y_tensor->layout)) {
-        return CGRAD_ERR_NOT_IMPLEMENTED;
+        return helper_cgrad_backend_cpu_f32_axpy_strided(alpha, x_tensor, y_tensor);
     }
 
     // Make a contiguous copy of x if needed
@@ -269,11 +531,11 @@ static cgrad_status cgrad_backend_cpu_f32_axpy(float alpha, void* x, void* y) {
 
     // Use cblas_saxpy to compute y = alpha * x + y
     // Both tensors are now contiguous, so stride is 1
-    cblas_saxpy(
+    helper_cgrad_backend_cpu_f32_saxpy(
         y_tensor->layout.size,
         alpha,
-        x_used->data, 1,
-        y_tensor->data, 1
+        helper_cgrad_backend_cpu_f32_base(x_used), 1,
+        helper_cgrad_backend_cpu_f32_base(y_tensor), 1
     );
 
     if (!is_x_contiguous) {
@@ -296,75 +558,1440 @@ static cgrad_status cgrad_backend_cpu_f32_gemm(float alpha, void* a, void* b, fl
         }
     }
     
-    int a_m = a_tensor->layout.shape[TENSOR_DIM-2];
-    int a_k = a_tensor->layout.shape[TENSOR_DIM-1];
-    int b_k = b_tensor->layout.shape[TENSOR_DIM-2];
-    int b_n = b_tensor->layout.shape[TENSOR_DIM-1];
-    if (a_k != b_k) {
+    if (a_tensor->layout.shape[TENSOR_DIM-1] != b_tensor->layout.shape[TENSOR_DIM-2]) {
         return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
     }
     
-    int m = a_tensor->layout.shape[TENSOR_DIM-2];
-    int n = b_tensor->layout.shape[TENSOR_DIM-1];
-    int k = b_tensor->layout.shape[TENSOR_DIM-2];
-    int bs = a_tensor->layout.size / (m * k);
+    // Matrix sizes and the batch count are passed to BLAS as blasint
+    uint64_t batch = 1;
+    for (int d = 0; d < TENSOR_DIM - 2; d++) {
+        batch *= a_tensor->layout.shape[d];
+    }
+    if (a_tensor->layout.shape[TENSOR_DIM-2] > CGRAD_CPU_F32_BLASINT_MAX
+        || b_tensor->layout.shape[TENSOR_DIM-1] > CGRAD_CPU_F32_BLASINT_MAX
+        || b_tensor->layout.shape[TENSOR_DIM-2] > CGRAD_CPU_F32_BLASINT_MAX
+        || batch > CGRAD_CPU_F32_BLASINT_MAX) {
+        return CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE;
+    }
+    blasint m = (blasint)a_tensor->layout.shape[TENSOR_DIM-2];
+    blasint n = (blasint)b_tensor->layout.shape[TENSOR_DIM-1];
+    blasint k = (blasint)b_tensor->layout.shape[TENSOR_DIM-2];
+    blasint bs = (blasint)batch;
     
+    // BLAS reads transposed and batch-broadcasted matrices directly, everything else is copied
     cgrad_backend_cpu_f32 a_contig, b_contig;
-    int is_a_regular = cgrad_storage_layout_is_regular(&a_tensor->layout);
-    int is_b_regular = cgrad_storage_layout_is_regular(&b_tensor->layout);
+    CBLAS_TRANSPOSE transA, transB, transC;
+    blasint lda, ldb, ldc;
+    int is_a_blas = helper_cgrad_backend_cpu_f32_blas_matrix(&a_tensor->layout, &transA, &lda);
+    int is_b_blas = helper_cgrad_backend_cpu_f32_blas_matrix(&b_tensor->layout, &transB, &ldb);
+    if (!helper_cgrad_backend_cpu_f32_blas_matrix(&c_tensor->layout, &transC, &ldc) || transC != CblasNoTrans) {
+        return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+    }
     
-    if (!is_a_regular) {
+    if (!is_a_blas) {
         cgrad_backend_cpu_f32_init(&a_contig, a_tensor->layout.shape, TENSOR_DIM);
         int contig_err = cgrad_backend_cpu_f32_contiguous(a_tensor, &a_contig);
         if (contig_err != CGRAD_SUCCESS) return contig_err;
         a_tensor = &a_contig;
+        helper_cgrad_backend_cpu_f32_blas_matrix(&a_tensor->layout, &transA, &lda);
     }
-    if (!is_b_regular) {
+    if (!is_b_blas) {
         cgrad_backend_cpu_f32_init(&b_contig, b_tensor->layout.shape, TENSOR_DIM);
         int contig_err = cgrad_backend_cpu_f32_contiguous(b_tensor, &b_contig);
         if (contig_err != CGRAD_SUCCESS) {
-            if (!is_a_regular) cgrad_backend_cpu_f32_free(&a_contig);
+            if (!is_a_blas) cgrad_backend_cpu_f32_free(&a_contig);
             return contig_err;
         }
         b_tensor = &b_contig;
+        helper_cgrad_backend_cpu_f32_blas_matrix(&b_tensor->layout, &transB, &ldb);
     }
     
-    float **A_array, **B_array, **C_array;
-    int batch_err = helper_cgrad_backend_cpu_f32_build_batch_array(a_tensor, &A_array, 2);
-    if (batch_err != CGRAD_SUCCESS) return batch_err;
-    batch_err = helper_cgrad_backend_cpu_f32_build_batch_array(b_tensor, &B_array, 2);
-    if (batch_err != CGRAD_SUCCESS) { free(A_array); return batch_err; }
-    batch_err = helper_cgrad_backend_cpu_f32_build_batch_array(c_tensor, &C_array, 2);
-    if (batch_err != CGRAD_SUCCESS) { free(A_array); free(B_array); return batch_err; }
-
-    CBLAS_TRANSPOSE transA = CblasNoTrans;
-    CBLAS_TRANSPOSE transB = CblasNoTrans;
-    
-    int lda = a_tensor->layout.strides[TENSOR_DIM-2];
-    int ldb = b_tensor->layout.strides[TENSOR_DIM-2];
-    int ldc = c_tensor->layout.strides[TENSOR_DIM-2];
-
-    cblas_sgemm_batch(
-        CblasRowMajor,
-        &transA,
-        &transB,
-        &m, &n, &k,
-        &alpha,
-        (const float**)A_array, &lda,
-        (const float**)B_array, &ldb,
-        &beta,
-        C_array, &ldc,
-        1,
-        &bs
-    );
+    // one pointer array per operand, on the stack unless the batch is large
+    float* stack_array[3 * CGRAD_CPU_F32_GEMM_STACK_BATCH];
+    float** A_array = bs <= CGRAD_CPU_F32_GEMM_STACK_BATCH ? stack_array : (float**)malloc(3 * (size_t)bs * sizeof(float*));
+    if (!A_array) {
+        if (!is_a_blas) cgrad_backend_cpu_f32_free(&a_contig);
+        if (!is_b_blas) cgrad_backend_cpu_f32_free(&b_contig);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    float** B_array = A_array + bs;
+    float** C_array = B_array + bs;
+    int batch_err = helper_cgrad_backend_cpu_f32_fill_batch_array(a_tensor, A_array, 2);
+    if (batch_err == CGRAD_SUCCESS) batch_err = helper_cgrad_backend_cpu_f32_fill_batch_array(b_tensor, B_array, 2);
+    if (batch_err == CGRAD_SUCCESS) batch_err = helper_cgrad_backend_cpu_f32_fill_batch_array(c_tensor, C_array, 2);
+
+    if (batch_err == CGRAD_SUCCESS) {
+        cblas_sgemm_batch(
+            CblasRowMajor,
+            &transA,
+            &transB,
+            &m, &n, &k,
+            &alpha,
+            (const float**)A_array, &lda,
+            (const float**)B_array, &ldb,
+            &beta,
+            C_array, &ldc,
+            1,
+            &bs
+        );
+    }
     
-    free(A_array);
-    free(B_array);
-    free(C_array);
+    if (A_array != stack_array) free(A_array);
     
-    if (!is_a_regular) cgrad_backend_cpu_f32_free(&a_contig);
-    if (!is_b_regular) cgrad_backend_cpu_f32_free(&b_contig);
+    if (!is_a_blas) cgrad_backend_cpu_f32_free(&a_contig);
+    if (!is_b_blas) cgrad_backend_cpu_f32_free(&b_contig);
     
+    return batch_err;
+}
+
+// Helper computing one row of r = alpha * x * y + beta * r with the given element strides
+static void helper_cgrad_backend_cpu_f32_mul_row(
+    size_t n,
+    float alpha,
+    const float* x, size_t sx,
+    const float* y, size_t sy,
+    float beta,
+    float* r, size_t sr
+) {
+    if (sr == 0) {
+        // r is broadcasted along the row: reduce the products into a single element
+        float acc;
+        if (sx != 0 && sy != 0) {
+            acc = helper_cgrad_backend_cpu_f32_sdot(n, x, sx, y, sy);
+        } else {
+            acc = 0.0f;
+            for (size_t i = 0; i < n; i++) acc += x[i * sx] * y[i * sy];
+        }
+        *r = (beta == 0.0f) ? alpha * acc : alpha * acc + beta * (*r);
+        return;
+    }
+
+    if (sx == 1 && sy == 1 && sr == 1) {
+        // contiguous rows: let the compiler vectorize the plain loops
+        if (beta == 0.0f) {
+            for (size_t i = 0; i < n; i++) r[i] = alpha * x[i] * y[i];
+        } else {
+            for (size_t i = 0; i < n; i++) r[i] = alpha * x[i] * y[i] + beta * r[i];
+        }
+    } else if (sr == 1 && ((sx == 0 && sy == 1) || (sx == 1 && sy == 0))) {
+        // one operand is broadcasted along the row: scaled copy of the other one
+        const float* v = (sx == 0) ? y : x;
+        float s = alpha * ((sx == 0) ? x[0] : y[0]);
+        if (beta == 0.0f) {
+            for (size_t i = 0; i < n; i++) r[i] = s * v[i];
+        } else {
+            for (size_t i = 0; i < n; i++) r[i] = s * v[i] + beta * r[i];
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            float p = alpha * x[i * sx] * y[i * sy];
+            r[i * sr] = (beta == 0.0f) ? p : p + beta * r[i * sr];
+        }
+    }
+}
+
+// Row kernels for mul: r = beta * r over the distinct elements of a broadcast r, and one
+// row of r = alpha * x * y + beta * r with args pointing at {alpha, beta}
+static void helper_cgrad_backend_cpu_f32_scale_row(void* args, size_t n, float* const* ptrs, const size_t* incs) {
+    float beta = *(const float*)args;
+    for (size_t i = 0; i < n; i++) {
+        float* v = ptrs[0] + i * incs[0];
+        *v = (beta == 0.0f) ? 0.0f : beta * (*v);
+    }
+}
+
+static void helper_cgrad_backend_cpu_f32_mul_rows(void* args, size_t n, float* const* ptrs, const size_t* incs) {
+    const float* scales = (const float*)args;
+    helper_cgrad_backend_cpu_f32_mul_row(n, scales[0], ptrs[0], incs[0], ptrs[1], incs[1], scales[1], ptrs[2], incs[2]);
+}
+
+static cgrad_status cgrad_backend_cpu_f32_mul(float alpha, void* x, void* y, float beta, void* r) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    const cgrad_backend_cpu_f32* y_tensor = (const cgrad_backend_cpu_f32*)y;
+    cgrad_backend_cpu_f32* r_tensor = (cgrad_backend_cpu_f32*)r;
+
+    if (!x_tensor || !y_tensor || !r_tensor) return CGRAD_ERR_NULL_POINTER;
+
+    // Check shapes match
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (x_tensor->layout.shape[d] != r_tensor->layout.shape[d]
+            || y_tensor->layout.shape[d] != r_tensor->layout.shape[d]) {
+            return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+        }
+    }
+    if (r_tensor->layout.size == 0) return CGRAD_SUCCESS;
+
+    const cgrad_storage_layout* layouts[3] = {&x_tensor->layout, &y_tensor->layout, &r_tensor->layout};
+
+    // If r is a broadcast view, apply beta once to every distinct element of r
+    // and accumulate all products on top of it afterwards
+    int r_reduces = 0;
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (r_tensor->layout.strides[d] == 0 && r_tensor->layout.shape[d] > 1) r_reduces = 1;
+    }
+    if (r_reduces && beta != 1.0f) {
+        cgrad_storage_layout unique = r_tensor->layout;
+        for (int d = 0; d < TENSOR_DIM; d++) {
+            if (unique.strides[d] == 0) unique.shape[d] = 1;
+        }
+        const cgrad_storage_layout* unique_layouts[1] = {&unique};
+        cgrad_storage_layout_collapsed c;
+        cgrad_status err = cgrad_storage_layout_collapse(unique_layouts, 1, &c);
+        if (err != CGRAD_SUCCESS) return err;
+        float* base[1] = {helper_cgrad_backend_cpu_f32_base(r_tensor)};
+        helper_cgrad_backend_cpu_f32_for_each_row(&c, 1, base, helper_cgrad_backend_cpu_f32_scale_row, &beta);
+    }
+    if (r_reduces) beta = 1.0f;
+
+    cgrad_storage_layout_collapsed c;
+    cgrad_status err = cgrad_storage_layout_collapse(layouts, 3, &c);
+    if (err != CGRAD_SUCCESS) return err;
+
+    float scales[2] = {alpha, beta};
+    float* base[3] = {
+        helper_cgrad_backend_cpu_f32_base(x_tensor),
+        helper_cgrad_backend_cpu_f32_base(y_tensor),
+        helper_cgrad_backend_cpu_f32_base(r_tensor)
+    };
+    helper_cgrad_backend_cpu_f32_for_each_row(&c, 3, base, helper_cgrad_backend_cpu_f32_mul_rows, scales);
+
+    return CGRAD_SUCCESS;
+}
+
+// Helpers for running elementwise kernels on multiple threads
+typedef void (*helper_cgrad_backend_cpu_f32_range_fn)(void* args, size_t begin, size_t end);
+
+// Worker threads of the backend, started on the first parallel kernel and kept for the lifetime
+// of the process. Idle workers block on work_ready; a kernel publishes a job (a range split into
+// chunks), wakes as many workers as it needs and processes chunks itself until none are left.
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;      // signalled when a job with free slots is published
+    pthread_cond_t work_done;       // signalled when the last worker of a job leaves it
+    int busy;                       // a kernel owns the workers
+    int started;                    // workers are running (reset in a forked child)
+    size_t num_workers;
+    uint64_t generation;            // incremented for every published job
+    int open;                       // workers may still join the current job
+    size_t slots;                   // workers the current job still wants
+    size_t active;                  // workers that joined the current job and have not left it
+    helper_cgrad_backend_cpu_f32_range_fn fn;
+    void* args;
+    size_t n;
+    size_t chunk;
+    size_t num_chunks;
+    size_t next_chunk;              // claimed atomically by the caller and the joined workers
+} helper_cgrad_backend_cpu_f32_pool;
+
+static helper_cgrad_backend_cpu_f32_pool g_cpu_f32_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_ready = PTHREAD_COND_INITIALIZER,
+    .work_done = PTHREAD_COND_INITIALIZER,
+};
+
+// Run chunks of the job until all are claimed
+static void helper_cgrad_backend_cpu_f32_pool_run(helper_cgrad_backend_cpu_f32_range_fn fn, void* args, size_t n, size_t chunk, size_t num_chunks) {
+    for (;;) {
+        size_t c = __atomic_fetch_add(&g_cpu_f32_pool.next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= num_chunks) return;
+        size_t begin = c * chunk;
+        size_t end = begin + chunk < n ? begin + chunk : n;
+        fn(args, begin < n ? begin : n, end);
+    }
+}
+
+static void* helper_cgrad_backend_cpu_f32_pool_worker(void* arg) {
+    (void)arg;
+    helper_cgrad_backend_cpu_f32_pool* pool = &g_cpu_f32_pool;
+    uint64_t seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!(pool->open && pool->slots > 0 && pool->generation != seen)) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        seen = pool->generation;
+        pool->slots--;
+        pool->active++;
+        helper_cgrad_backend_cpu_f32_range_fn fn = pool->fn;
+        void* args = pool->args;
+        size_t n = pool->n, chunk = pool->chunk, num_chunks = pool->num_chunks;
+        pthread_mutex_unlock(&pool->lock);
+
+        helper_cgrad_backend_cpu_f32_pool_run(fn, args, n, chunk, num_chunks);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0) pthread_cond_signal(&pool->work_done);
+    }
+    return NULL;
+}
+
+// Threads do not survive fork: a child starts its own workers on its first parallel kernel
+static void helper_cgrad_backend_cpu_f32_pool_atfork_child(void) {
+    g_cpu_f32_pool = (helper_cgrad_backend_cpu_f32_pool){
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .work_ready = PTHREAD_COND_INITIALIZER,
+        .work_done = PTHREAD_COND_INITIALIZER,
+    };
+}
+
+// Start the workers once; called with the pool locked. Returns the number of running workers.
+static size_t helper_cgrad_backend_cpu_f32_pool_start(size_t wanted) {
+    helper_cgrad_backend_cpu_f32_pool* pool = &g_cpu_f32_pool;
+    if (pool->started) return pool->num_workers;
+    static int atfork_registered = 0;
+    if (!atfork_registered) {
+        atfork_registered = pthread_atfork(NULL, NULL, helper_cgrad_backend_cpu_f32_pool_atfork_child) == 0;
+    }
+    pool->started = 1;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (size_t t = 0; t < wanted; t++) {
+        pthread_t thread;
+        if (pthread_create(&thread, &attr, helper_cgrad_backend_cpu_f32_pool_worker, NULL) != 0) break;
+        pool->num_workers++;
+    }
+    pthread_attr_destroy(&attr);
+    return pool->num_workers;
+}
+
+// Split [0, n) into chunks of at least grain items and run fn on each chunk, spread over the
+// worker threads of the backend. The calling thread processes chunks as well. If the workers are
+// busy with another kernel (concurrent callers, or fn itself running a parallel kernel), the
+// whole range runs on the calling thread.
+static void helper_cgrad_backend_cpu_f32_parallel_for(size_t n, size_t grain, helper_cgrad_backend_cpu_f32_range_fn fn, void* args) {
+    static long num_cpus = 0;
+    if (num_cpus == 0) {
+        num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (num_cpus < 1) num_cpus = 1;
+    }
+
+    size_t num_threads = grain > 0 ? n / grain : n;
+    if (num_threads > (size_t)num_cpus) num_threads = (size_t)num_cpus;
+    if (num_threads > CGRAD_CPU_F32_MAX_THREADS) num_threads = CGRAD_CPU_F32_MAX_THREADS;
+    if (num_threads <= 1) {
+        fn(args, 0, n);
+        return;
+    }
+
+    helper_cgrad_backend_cpu_f32_pool* pool = &g_cpu_f32_pool;
+    if (__atomic_exchange_n(&pool->busy, 1, __ATOMIC_ACQUIRE)) {
+        fn(args, 0, n);
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    size_t max_workers = (size_t)num_cpus < CGRAD_CPU_F32_MAX_THREADS ? (size_t)num_cpus : CGRAD_CPU_F32_MAX_THREADS;
+    size_t num_workers = helper_cgrad_backend_cpu_f32_pool_start(max_workers - 1);
+    if (num_threads > num_workers + 1) num_threads = num_workers + 1;
+    if (num_threads <= 1) {
+        pthread_mutex_unlock(&pool->lock);
+        __atomic_store_n(&pool->busy, 0, __ATOMIC_RELEASE);
+        fn(args, 0, n);
+        return;
+    }
+
+    // keep chunk boundaries aligned to 16 items (one cache line of elements)
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    chunk = (chunk + 15) & ~(size_t)15;
+    size_t num_chunks = (n + chunk - 1) / chunk;
+
+    pool->fn = fn;
+    pool->args = args;
+    pool->n = n;
+    pool->chunk = chunk;
+    pool->num_chunks = num_chunks;
+    __atomic_store_n(&pool->next_chunk, 0, __ATOMIC_RELAXED);
+    pool->generation++;
+    pool->open = 1;
+    pool->slots = num_chunks - 1;
+    for (size_t t = 1; t < num_chunks; t++) pthread_cond_signal(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    helper_cgrad_backend_cpu_f32_pool_run(fn, args, n, chunk, num_chunks);
+
+    // all chunks are claimed: close the job and wait for the workers still processing theirs
+    pthread_mutex_lock(&pool->lock);
+    pool->open = 0;
+    pool->slots = 0;
+    while (pool->active > 0) pthread_cond_wait(&pool->work_done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    __atomic_store_n(&pool->busy, 0, __ATOMIC_RELEASE);
+}
+
+// Polynomial approximation of expf (Cephes coefficients, ~1 ulp on the clamped range).
+// Written without branches or libm calls so that the loops below vectorize (this relies on
+// -fno-trapping-math, which lets the compiler turn the clamps into vector min/max).
+static inline float helper_cgrad_backend_cpu_f32_expf(float x) {
+    // the upper clamp is just below ln(FLT_MAX), the largest input with a finite result
+    x = x > 88.7228317f ? 88.7228317f : x;
+    x = x < -87.3365447504019f ? -87.3365447504019f : x;
+
+    // x = k * ln(2) + f with |f| <= ln(2) / 2, rounding k via the 1.5 * 2^23 trick
+    float k = x * 1.44269504088896341f + 12582912.0f;
+    k -= 12582912.0f;
+    float f = x - k * 0.693359375f;
+    f = f + k * 2.12194440e-4f;
+
+    float p = 1.9875691500E-4f;
+    p = p * f + 1.3981999507E-3f;
+    p = p * f + 8.3334519073E-3f;
+    p = p * f + 4.1665795894E-2f;
+    p = p * f + 1.6666665459E-1f;
+    p = p * f + 5.0000001201E-1f;
+    p = p * f * f + f + 1.0f;
+
+    // scale by 2^k = 2^(k/2) * 2^(k - k/2) by building the exponent bits directly; k reaches 128
+    // at the upper clamp, where a single power of two would have the exponent bits of +inf
+    int32_t k_hi = (int32_t)k >> 1;
+    int32_t bits_hi = (k_hi + 127) << 23;
+    int32_t bits_lo = ((int32_t)k - k_hi + 127) << 23;
+    float scale_hi, scale_lo;
+    memcpy(&scale_hi, &bits_hi, sizeof(scale_hi));
+    memcpy(&scale_lo, &bits_lo, sizeof(scale_lo));
+    return p * scale_hi * scale_lo;
+}
+
+static inline float helper_cgrad_backend_cpu_f32_sigmoidf(float x) {
+    return 1.0f / (1.0f + helper_cgrad_backend_cpu_f32_expf(-x));
+}
+
+// tanh via 2 * sigmoid(2x) - 1, switching to an odd polynomial near zero where that form cancels
+static inline float helper_cgrad_backend_cpu_f32_tanhf(float x) {
+    float z = x * x;
+    float p = -5.70498872745E-3f;
+    p = p * z + 2.06390887954E-2f;
+    p = p * z - 5.37397155531E-2f;
+    p = p * z + 1.33314422036E-1f;
+    p = p * z - 3.33332819422E-1f;
+    float small = p * z * x + x;
+    float large = 2.0f * helper_cgrad_backend_cpu_f32_sigmoidf(2.0f * x) - 1.0f;
+    return z < 0.390625f ? small : large;
+}
+
+typedef struct {
+    cgrad_unary_op op;
+    const float* x;
+    float* r;
+    float* dr;
+} helper_cgrad_backend_cpu_f32_unary_args;
+
+// Apply the unary function to the flat range [begin, end) of contiguous buffers.
+// r may alias x, so every loop reads x[i] before writing r[i].
+static void helper_cgrad_backend_cpu_f32_unary_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_unary_args* args = (const helper_cgrad_backend_cpu_f32_unary_args*)arg;
+    const float* x = args->x;
+    float* r = args->r;
+    float* dr = args->dr;
+
+    switch (args->op) {
+        case CGRAD_UNARY_RELU:
+            if (dr) {
+                for (size_t i = begin; i < end; i++) {
+                    float v = x[i];
+                    dr[i] = v > 0.0f ? 1.0f : 0.0f;
+                    r[i] = v > 0.0f ? v : 0.0f;
+                }
+            } else {
+                for (size_t i = begin; i < end; i++) {
+                    float v = x[i];
+                    r[i] = v > 0.0f ? v : 0.0f;
+                }
+            }
+            break;
+
+        case CGRAD_UNARY_GELU: {
+            // gelu(x) = x * s with s = sigmoid(2u), u = sqrt(2/pi) * (x + 0.044715 * x^3)
+            // gelu'(x) = s + x * 2 * s * (1 - s) * du/dx
+            const float c0 = 0.7978845608028654f;
+            const float c1 = 0.044715f;
+            if (dr) {
+                for (size_t i = begin; i < end; i++) {
+                    float v = x[i];
+                    float u = c0 * (v + c1 * v * v * v);
+                    float s = helper_cgrad_backend_cpu_f32_sigmoidf(2.0f * u);
+                    dr[i] = s + v * 2.0f * s * (1.0f - s) * c0 * (1.0f + 3.0f * c1 * v * v);
+                    r[i] = v * s;
+                }
+            } else {
+                for (size_t i = begin; i < end; i++) {
+                    float v = x[i];
+                    float u = c0 * (v + c1 * v * v * v);
+                    r[i] = v * helper_cgrad_backend_cpu_f32_sigmoidf(2.0f * u);
+                }
+            }
+            break;
+        }
+
+        case CGRAD_UNARY_TANH:
+            for (size_t i = begin; i < end; i++) {
+                float t = helper_cgrad_backend_cpu_f32_tanhf(x[i]);
+                r[i] = t;
+            }
+            if (dr) {
+                for (size_t i = begin; i < end; i++) dr[i] = 1.0f - r[i] * r[i];
+            }
+            break;
+
+        case CGRAD_UNARY_SIGMOID:
+            for (size_t i = begin; i < end; i++) {
+                float s = helper_cgrad_backend_cpu_f32_sigmoidf(x[i]);
+                r[i] = s;
+            }
+            if (dr) {
+                for (size_t i = begin; i < end; i++) dr[i] = r[i] * (1.0f - r[i]);
+            }
+            break;
+
+        case CGRAD_UNARY_EXP:
+            for (size_t i = begin; i < end; i++) {
+                float e = helper_cgrad_backend_cpu_f32_expf(x[i]);
+                r[i] = e;
+            }
+            if (dr) {
+                for (size_t i = begin; i < end; i++) dr[i] = r[i];
+            }
+            break;
+
+        case CGRAD_UNARY_LOG:
+            if (dr) {
+                for (size_t i = begin; i < end; i++) {
+                    float v = x[i];
+                    dr[i] = 1.0f / v;
+                    r[i] = logf(v);
+                }
+            } else {
+                for (size_t i = begin; i < end; i++) r[i] = logf(x[i]);
+            }
+            break;
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_unary(cgrad_unary_op op, void* x, void* r, void* dr) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    cgrad_backend_cpu_f32* r_tensor = (cgrad_backend_cpu_f32*)r;
+    cgrad_backend_cpu_f32* dr_tensor = (cgrad_backend_cpu_f32*)dr;
+
+    if (!x_tensor || !r_tensor) return CGRAD_ERR_NULL_POINTER;
+    if (op < CGRAD_UNARY_RELU || op > CGRAD_UNARY_LOG) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // Check shapes match
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (x_tensor->layout.shape[d] != r_tensor->layout.shape[d]
+            || (dr_tensor && dr_tensor->layout.shape[d] != r_tensor->layout.shape[d])) {
+            return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+        }
+    }
+
+    // Outputs are written linearly
+    if (!cgrad_storage_layout_is_contiguous(&r_tensor->layout)
+        || (dr_tensor && !cgrad_storage_layout_is_contiguous(&dr_tensor->layout))) {
+        return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+    }
+
+    // Gather a strided x into r first and then apply the function in-place on r
+    const float* x_data = helper_cgrad_backend_cpu_f32_base(x_tensor);
+    if (!cgrad_storage_layout_is_contiguous(&x_tensor->layout)) {
+        if (x_tensor->data == r_tensor->data) return CGRAD_ERR_NOT_IMPLEMENTED;
+        int contig_err = cgrad_backend_cpu_f32_contiguous(x_tensor, r_tensor);
+        if (contig_err != CGRAD_SUCCESS) return contig_err;
+        x_data = helper_cgrad_backend_cpu_f32_base(r_tensor);
+    }
+
+    helper_cgrad_backend_cpu_f32_unary_args args = {
+        .op = op,
+        .x = x_data,
+        .r = helper_cgrad_backend_cpu_f32_base(r_tensor),
+        .dr = dr_tensor ? helper_cgrad_backend_cpu_f32_base(dr_tensor) : NULL,
+    };
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        r_tensor->layout.size,
+        CGRAD_CPU_F32_PARALLEL_GRAIN,
+        helper_cgrad_backend_cpu_f32_unary_range,
+        &args
+    );
+
+    return CGRAD_SUCCESS;
+}
+
+// Rows are processed in blocks of this many elements by the online log-sum-exp below
+#define CGRAD_CPU_F32_SOFTMAX_BLOCK 256
+
+// Maximum of a contiguous span, using independent lanes so the loop vectorizes
+static inline float helper_cgrad_backend_cpu_f32_max_span(const float* x, size_t n) {
+    float lanes[8] = {-INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; j++) lanes[j] = x[i + j] > lanes[j] ? x[i + j] : lanes[j];
+    }
+    float m = -INFINITY;
+    for (int j = 0; j < 8; j++) m = lanes[j] > m ? lanes[j] : m;
+    for (; i < n; i++) m = x[i] > m ? x[i] : m;
+    return m;
+}
+
+// Sum of exp(x - shift) over a contiguous span
+static inline float helper_cgrad_backend_cpu_f32_sum_exp_span(const float* x, size_t n, float shift) {
+    float lanes[8] = {0.0f};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; j++) lanes[j] += helper_cgrad_backend_cpu_f32_expf(x[i + j] - shift);
+    }
+    float s = 0.0f;
+    for (int j = 0; j < 8; j++) s += lanes[j];
+    for (; i < n; i++) s += helper_cgrad_backend_cpu_f32_expf(x[i] - shift);
+    return s;
+}
+
+// Sum of x * (y - shift) over a contiguous span (y may be NULL to sum x alone)
+static inline float helper_cgrad_backend_cpu_f32_dot_span(const float* x, const float* y, size_t n, float shift) {
+    float lanes[8] = {0.0f};
+    size_t i = 0;
+    if (y) {
+        for (; i + 8 <= n; i += 8) {
+            for (int j = 0; j < 8; j++) lanes[j] += x[i + j] * (y[i + j] - shift);
+        }
+    } else {
+        for (; i + 8 <= n; i += 8) {
+            for (int j = 0; j < 8; j++) lanes[j] += x[i + j];
+        }
+    }
+    float s = 0.0f;
+    for (int j = 0; j < 8; j++) s += lanes[j];
+    for (; i < n; i++) s += y ? x[i] * (y[i] - shift) : x[i];
+    return s;
+}
+
+// log(sum(exp(x))) of a row, reading it only once: the running sum is rescaled whenever a
+// block raises the running maximum, so large logits never overflow. The result is returned
+// split into the row maximum and log(sum(exp(x - max))), so that callers can form x - max
+// exactly before adding the (small) second part.
+static void helper_cgrad_backend_cpu_f32_logsumexp_row(const float* x, size_t n, float* max, float* log_sum) {
+    float m = -INFINITY;
+    float s = 0.0f;
+    for (size_t b = 0; b < n; b += CGRAD_CPU_F32_SOFTMAX_BLOCK) {
+        size_t len = n - b < CGRAD_CPU_F32_SOFTMAX_BLOCK ? n - b : CGRAD_CPU_F32_SOFTMAX_BLOCK;
+        float bm = helper_cgrad_backend_cpu_f32_max_span(x + b, len);
+        if (bm > m) {
+            s *= helper_cgrad_backend_cpu_f32_expf(m - bm);
+            m = bm;
+        }
+        s += helper_cgrad_backend_cpu_f32_sum_exp_span(x + b, len, m);
+    }
+    *max = m;
+    *log_sum = logf(s);
+}
+
+// Number of rows per thread so that each thread still sees about CGRAD_CPU_F32_PARALLEL_GRAIN elements
+static inline size_t helper_cgrad_backend_cpu_f32_row_grain(size_t cols) {
+    size_t grain = CGRAD_CPU_F32_PARALLEL_GRAIN / (cols > 0 ? cols : 1);
+    return grain > 0 ? grain : 1;
+}
+
+// Check that all given storages (NULL entries are skipped) have the shape of the first one
+static int helper_cgrad_backend_cpu_f32_same_shape(const cgrad_backend_cpu_f32** tensors, int n) {
+    for (int i = 1; i < n; i++) {
+        if (!tensors[i]) continue;
+        for (int d = 0; d < TENSOR_DIM; d++) {
+            if (tensors[i]->layout.shape[d] != tensors[0]->layout.shape[d]) return 0;
+        }
+    }
+    return 1;
+}
+
+// Check that all given storages (NULL entries are skipped) are contiguous
+static int helper_cgrad_backend_cpu_f32_all_contiguous(const cgrad_backend_cpu_f32** tensors, int n) {
+    for (int i = 0; i < n; i++) {
+        if (tensors[i] && !cgrad_storage_layout_is_contiguous(&tensors[i]->layout)) return 0;
+    }
+    return 1;
+}
+
+typedef struct {
+    int log_softmax;
+    size_t cols;
+    const float* x;
+    const float* g;
+    const float* t;
+    const float* lse;
+    float* r;
+    float* gt;
+    float alpha;
+} helper_cgrad_backend_cpu_f32_softmax_args;
+
+// Softmax over the rows [begin, end). r may alias x.
+static void helper_cgrad_backend_cpu_f32_softmax_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_softmax_args* args = (const helper_cgrad_backend_cpu_f32_softmax_args*)arg;
+    size_t n = args->cols;
+    for (size_t row = begin; row < end; row++) {
+        const float* x = args->x + row * n;
+        float* r = args->r + row * n;
+        float m, log_sum;
+        helper_cgrad_backend_cpu_f32_logsumexp_row(x, n, &m, &log_sum);
+        if (args->log_softmax) {
+            for (size_t i = 0; i < n; i++) r[i] = (x[i] - m) - log_sum;
+        } else {
+            for (size_t i = 0; i < n; i++) r[i] = helper_cgrad_backend_cpu_f32_expf((x[i] - m) - log_sum);
+        }
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_softmax(int log_softmax, void* x, void* r) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    cgrad_backend_cpu_f32* r_tensor = (cgrad_backend_cpu_f32*)r;
+    if (!x_tensor || !r_tensor) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_backend_cpu_f32* tensors[2] = {x_tensor, r_tensor};
+    if (!helper_cgrad_backend_cpu_f32_same_shape(tensors, 2)) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    if (!cgrad_storage_layout_is_contiguous(&r_tensor->layout)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+
+    // Gather a strided x into r first and then normalize r in-place
+    const float* x_data = helper_cgrad_backend_cpu_f32_base(x_tensor);
+    if (!cgrad_storage_layout_is_contiguous(&x_tensor->layout)) {
+        if (x_tensor->data == r_tensor->data) return CGRAD_ERR_NOT_IMPLEMENTED;
+        int contig_err = cgrad_backend_cpu_f32_contiguous(x_tensor, r_tensor);
+        if (contig_err != CGRAD_SUCCESS) return contig_err;
+        x_data = helper_cgrad_backend_cpu_f32_base(r_tensor);
+    }
+
+    size_t cols = r_tensor->layout.shape[TENSOR_DIM - 1];
+    helper_cgrad_backend_cpu_f32_softmax_args args = {
+        .log_softmax = log_softmax,
+        .cols = cols,
+        .x = x_data,
+        .r = helper_cgrad_backend_cpu_f32_base(r_tensor),
+    };
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        r_tensor->layout.size / cols,
+        helper_cgrad_backend_cpu_f32_row_grain(cols),
+        helper_cgrad_backend_cpu_f32_softmax_range,
+        &args
+    );
+
+    return CGRAD_SUCCESS;
+}
+
+// Softmax gradient over the rows [begin, end), accumulated into r:
+//   softmax:     gx += y * (gy - sum(gy * y))
+//   log-softmax: gx += gy - exp(y) * sum(gy)
+static void helper_cgrad_backend_cpu_f32_softmax_backward_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_softmax_args* args = (const helper_cgrad_backend_cpu_f32_softmax_args*)arg;
+    size_t n = args->cols;
+    for (size_t row = begin; row < end; row++) {
+        const float* y = args->x + row * n;
+        const float* g = args->g + row * n;
+        float* gx = args->r + row * n;
+        if (args->log_softmax) {
+            float sum = helper_cgrad_backend_cpu_f32_dot_span(g, NULL, n, 0.0f);
+            for (size_t i = 0; i < n; i++) gx[i] += g[i] - helper_cgrad_backend_cpu_f32_expf(y[i]) * sum;
+        } else {
+            float dot = helper_cgrad_backend_cpu_f32_dot_span(g, y, n, 0.0f);
+            for (size_t i = 0; i < n; i++) gx[i] += y[i] * (g[i] - dot);
+        }
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_softmax_backward(int log_softmax, void* y, void* grad_y, void* grad_x) {
+    const cgrad_backend_cpu_f32* y_tensor = (const cgrad_backend_cpu_f32*)y;
+    const cgrad_backend_cpu_f32* gy_tensor = (const cgrad_backend_cpu_f32*)grad_y;
+    cgrad_backend_cpu_f32* gx_tensor = (cgrad_backend_cpu_f32*)grad_x;
+    if (!y_tensor || !gy_tensor || !gx_tensor) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_backend_cpu_f32* tensors[3] = {y_tensor, gy_tensor, gx_tensor};
+    if (!helper_cgrad_backend_cpu_f32_same_shape(tensors, 3)) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    if (!helper_cgrad_backend_cpu_f32_all_contiguous(tensors, 3)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+
+    size_t cols = gx_tensor->layout.shape[TENSOR_DIM - 1];
+    helper_cgrad_backend_cpu_f32_softmax_args args = {
+        .log_softmax = log_softmax,
+        .cols = cols,
+        .x = helper_cgrad_backend_cpu_f32_base(y_tensor),
+        .g = helper_cgrad_backend_cpu_f32_base(gy_tensor),
+        .r = helper_cgrad_backend_cpu_f32_base(gx_tensor),
+    };
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        gx_tensor->layout.size / cols,
+        helper_cgrad_backend_cpu_f32_row_grain(cols),
+        helper_cgrad_backend_cpu_f32_softmax_backward_range,
+        &args
+    );
+
+    return CGRAD_SUCCESS;
+}
+
+// Cross-entropy of softmax(x) against t over the rows [begin, end):
+//   loss_row = lse * sum(t) - sum(t * x) = log_sum * sum(t) - sum(t * (x - max))
+// using the shifted form to avoid cancellation for large logits.
+// The per-row logsumexp is written to lse (if not NULL), the per-row loss to r.
+static void helper_cgrad_backend_cpu_f32_softmax_cross_entropy_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_softmax_args* args = (const helper_cgrad_backend_cpu_f32_softmax_args*)arg;
+    size_t n = args->cols;
+    float* lse_rows = (float*)args->lse;
+    for (size_t row = begin; row < end; row++) {
+        const float* x = args->x + row * n;
+        const float* t = args->t + row * n;
+        float m, log_sum;
+        helper_cgrad_backend_cpu_f32_logsumexp_row(x, n, &m, &log_sum);
+        float t_sum = helper_cgrad_backend_cpu_f32_dot_span(t, NULL, n, 0.0f);
+        float tx = helper_cgrad_backend_cpu_f32_dot_span(t, x, n, m);
+        if (lse_rows) lse_rows[row] = m + log_sum;
+        args->r[row] = log_sum * t_sum - tx;
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_softmax_cross_entropy(void* x, void* target, void* loss, void* lse) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    const cgrad_backend_cpu_f32* t_tensor = (const cgrad_backend_cpu_f32*)target;
+    cgrad_backend_cpu_f32* loss_tensor = (cgrad_backend_cpu_f32*)loss;
+    cgrad_backend_cpu_f32* lse_tensor = (cgrad_backend_cpu_f32*)lse;
+    if (!x_tensor || !t_tensor || !loss_tensor) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_backend_cpu_f32* tensors[3] = {x_tensor, t_tensor, lse_tensor};
+    if (!helper_cgrad_backend_cpu_f32_same_shape(tensors, 2)) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    if (!helper_cgrad_backend_cpu_f32_all_contiguous(tensors, 3)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+
+    size_t cols = x_tensor->layout.shape[TENSOR_DIM - 1];
+    size_t rows = x_tensor->layout.size / cols;
+    if (loss_tensor->layout.size != 1) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    if (lse_tensor && lse_tensor->layout.size != rows) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+
+    // per-row losses, on the stack unless the batch is large
+    float stack_losses[CGRAD_CPU_F32_CROSS_ENTROPY_STACK_ROWS];
+    float* losses = stack_losses;
+    if (rows > CGRAD_CPU_F32_CROSS_ENTROPY_STACK_ROWS) {
+        losses = (float*)malloc(rows * sizeof(float));
+        if (!losses) return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    helper_cgrad_backend_cpu_f32_softmax_args args = {
+        .cols = cols,
+        .x = helper_cgrad_backend_cpu_f32_base(x_tensor),
+        .t = helper_cgrad_backend_cpu_f32_base(t_tensor),
+        .lse = lse_tensor ? helper_cgrad_backend_cpu_f32_base(lse_tensor) : NULL,
+        .r = losses,
+    };
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        rows,
+        helper_cgrad_backend_cpu_f32_row_grain(cols),
+        helper_cgrad_backend_cpu_f32_softmax_cross_entropy_range,
+        &args
+    );
+
+    // mean over rows, summed in double so that long batches do not lose precision
+    double total = 0.0;
+    for (size_t row = 0; row < rows; row++) total += losses[row];
+    helper_cgrad_backend_cpu_f32_base(loss_tensor)[0] = (float)(total / (double)rows);
+
+    if (losses != stack_losses) free(losses);
+    return CGRAD_SUCCESS;
+}
+
+// Cross-entropy gradients over the rows [begin, end), accumulated and scaled by alpha:
+//   gx += alpha * (softmax(x) * sum(t) - t)
+//   gt += alpha * (lse - x)
+static void helper_cgrad_backend_cpu_f32_softmax_cross_entropy_backward_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_softmax_args* args = (const helper_cgrad_backend_cpu_f32_softmax_args*)arg;
+    size_t n = args->cols;
+    float alpha = args->alpha;
+    for (size_t row = begin; row < end; row++) {
+        const float* x = args->x + row * n;
+        const float* t = args->t + row * n;
+        float lse = args->lse[row];
+        if (args->r) {
+            float* gx = args->r + row * n;
+            float t_sum = helper_cgrad_backend_cpu_f32_dot_span(t, NULL, n, 0.0f);
+            for (size_t i = 0; i < n; i++) {
+                gx[i] += alpha * (helper_cgrad_backend_cpu_f32_expf(x[i] - lse) * t_sum - t[i]);
+            }
+        }
+        if (args->gt) {
+            float* gt = args->gt + row * n;
+            for (size_t i = 0; i < n; i++) gt[i] += alpha * (lse - x[i]);
+        }
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_softmax_cross_entropy_backward(
+    float alpha,
+    void* x,
+    void* target,
+    void* lse,
+    void* grad_x,
+    void* grad_target
+) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    const cgrad_backend_cpu_f32* t_tensor = (const cgrad_backend_cpu_f32*)target;
+    const cgrad_backend_cpu_f32* lse_tensor = (const cgrad_backend_cpu_f32*)lse;
+    cgrad_backend_cpu_f32* gx_tensor = (cgrad_backend_cpu_f32*)grad_x;
+    cgrad_backend_cpu_f32* gt_tensor = (cgrad_backend_cpu_f32*)grad_target;
+    if (!x_tensor || !t_tensor || !lse_tensor) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_backend_cpu_f32* tensors[5] = {x_tensor, t_tensor, gx_tensor, gt_tensor, lse_tensor};
+    if (!helper_cgrad_backend_cpu_f32_same_shape(tensors, 4)) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    if (!helper_cgrad_backend_cpu_f32_all_contiguous(tensors, 5)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+
+    size_t cols = x_tensor->layout.shape[TENSOR_DIM - 1];
+    size_t rows = x_tensor->layout.size / cols;
+    if (lse_tensor->layout.size != rows) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+
+    helper_cgrad_backend_cpu_f32_softmax_args args = {
+        .cols = cols,
+        .x = helper_cgrad_backend_cpu_f32_base(x_tensor),
+        .t = helper_cgrad_backend_cpu_f32_base(t_tensor),
+        .lse = helper_cgrad_backend_cpu_f32_base(lse_tensor),
+        .r = gx_tensor ? helper_cgrad_backend_cpu_f32_base(gx_tensor) : NULL,
+        .gt = gt_tensor ? helper_cgrad_backend_cpu_f32_base(gt_tensor) : NULL,
+        .alpha = alpha,
+    };
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        rows,
+        helper_cgrad_backend_cpu_f32_row_grain(cols),
+        helper_cgrad_backend_cpu_f32_softmax_cross_entropy_backward_range,
+        &args
+    );
+
+    return CGRAD_SUCCESS;
+}
+
+// Output channels computed together by the implicit GEMM kernel, so each input row is loaded once per block
+#define CGRAD_CPU_F32_CONV2D_OC_BLOCK 4
+
+typedef struct {
+    cgrad_conv2d_params p;
+    size_t n, c, h, w;      // input shape
+    size_t o, oh, ow;       // output channels and spatial size
+    const float* x;
+    const float* wt;
+    float* r;
+} helper_cgrad_backend_cpu_f32_conv2d_args;
+
+// Read the geometry of an (N, C, H, W) storage into args and compute the output size
+static void helper_cgrad_backend_cpu_f32_conv2d_geometry(
+    const cgrad_conv2d_params* p,
+    const cgrad_storage_layout* x,
+    helper_cgrad_backend_cpu_f32_conv2d_args* args
+) {
+    args->p = *p;
+    args->n = x->shape[TENSOR_DIM - 4];
+    args->c = x->shape[TENSOR_DIM - 3];
+    args->h = x->shape[TENSOR_DIM - 2];
+    args->w = x->shape[TENSOR_DIM - 1];
+    args->oh = (args->h + 2 * p->padding[0] - p->dilation[0] * (p->kernel[0] - 1) - 1) / p->stride[0] + 1;
+    args->ow = (args->w + 2 * p->padding[1] - p->dilation[1] * (p->kernel[1] - 1) - 1) / p->stride[1] + 1;
+}
+
+// Range [lo, hi) of output columns whose input column ow * stride + offset lies inside [0, w)
+static inline void helper_cgrad_backend_cpu_f32_conv2d_valid_range(
+    long offset, size_t stride, size_t w, size_t ow, size_t* lo, size_t* hi
+) {
+    long s = (long)stride;
+    long first = offset >= 0 ? 0 : (-offset + s - 1) / s;
+    long last = (long)w - 1 - offset;
+    long end = last < 0 ? 0 : last / s + 1;
+    if (end > (long)ow) end = (long)ow;
+    if (first > end) first = end;
+    *lo = (size_t)first;
+    *hi = (size_t)end;
+}
+
+// Unfold the rows [begin, end) of the (N * C * KH * KW, OH * OW) column matrix
+static void helper_cgrad_backend_cpu_f32_im2col_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_conv2d_args* args = (const helper_cgrad_backend_cpu_f32_conv2d_args*)arg;
+    const cgrad_conv2d_params* p = &args->p;
+    size_t kk = (size_t)p->kernel[0] * p->kernel[1];
+    for (size_t row = begin; row < end; row++) {
+        size_t plane = row / kk;  // n * C + c
+        size_t kh = (row % kk) / p->kernel[1];
+        size_t kw = row % p->kernel[1];
+        const float* x = args->x + plane * args->h * args->w;
+        float* col = args->r + row * args->oh * args->ow;
+
+        long col_offset = (long)(kw * p->dilation[1]) - (long)p->padding[1];
+        size_t lo, hi;
+        helper_cgrad_backend_cpu_f32_conv2d_valid_range(col_offset, p->stride[1], args->w, args->ow, &lo, &hi);
+
+        for (size_t oh = 0; oh < args->oh; oh++) {
+            float* out = col + oh * args->ow;
+            long ih = (long)(oh * p->stride[0] + kh * p->dilation[0]) - (long)p->padding[0];
+            if (ih < 0 || ih >= (long)args->h) {
+                memset(out, 0, args->ow * sizeof(float));
+                continue;
+            }
+            const float* in = x + ih * args->w + col_offset;
+            for (size_t ow = 0; ow < lo; ow++) out[ow] = 0.0f;
+            if (p->stride[1] == 1) {
+                memcpy(out + lo, in + lo, (hi - lo) * sizeof(float));
+            } else {
+                for (size_t ow = lo; ow < hi; ow++) out[ow] = in[ow * p->stride[1]];
+            }
+            for (size_t ow = hi; ow < args->ow; ow++) out[ow] = 0.0f;
+        }
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_im2col(const cgrad_conv2d_params* p, void* x, void* cols) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    cgrad_backend_cpu_f32* cols_tensor = (cgrad_backend_cpu_f32*)cols;
+    if (!p || !x_tensor || !cols_tensor) return CGRAD_ERR_NULL_POINTER;
+    if (!cgrad_storage_layout_is_contiguous(&x_tensor->layout)
+        || !cgrad_storage_layout_is_contiguous(&cols_tensor->layout)) {
+        return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+    }
+
+    helper_cgrad_backend_cpu_f32_conv2d_args args;
+    helper_cgrad_backend_cpu_f32_conv2d_geometry(p, &x_tensor->layout, &args);
+    size_t rows = args.n * args.c * p->kernel[0] * p->kernel[1];
+    if (cols_tensor->layout.size != rows * args.oh * args.ow) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    args.x = helper_cgrad_backend_cpu_f32_base(x_tensor);
+    args.r = helper_cgrad_backend_cpu_f32_base(cols_tensor);
+
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        rows,
+        helper_cgrad_backend_cpu_f32_row_grain(args.oh * args.ow),
+        helper_cgrad_backend_cpu_f32_im2col_range,
+        &args
+    );
+    return CGRAD_SUCCESS;
+}
+
+// Fold the column matrix back into the input planes [begin, end) (n * C + c), accumulating.
+// Each plane only receives values from its own KH * KW rows, so planes can run in parallel.
+static void helper_cgrad_backend_cpu_f32_col2im_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_conv2d_args* args = (const helper_cgrad_backend_cpu_f32_conv2d_args*)arg;
+    const cgrad_conv2d_params* p = &args->p;
+    size_t kk = (size_t)p->kernel[0] * p->kernel[1];
+    for (size_t plane = begin; plane < end; plane++) {
+        float* x = args->r + plane * args->h * args->w;
+        for (size_t k = 0; k < kk; k++) {
+            size_t kh = k / p->kernel[1];
+            size_t kw = k % p->kernel[1];
+            const float* col = args->x + (plane * kk + k) * args->oh * args->ow;
+
+            long col_offset = (long)(kw * p->dilation[1]) - (long)p->padding[1];
+            size_t lo, hi;
+            helper_cgrad_backend_cpu_f32_conv2d_valid_range(col_offset, p->stride[1], args->w, args->ow, &lo, &hi);
+
+            for (size_t oh = 0; oh < args->oh; oh++) {
+                long ih = (long)(oh * p->stride[0] + kh * p->dilation[0]) - (long)p->padding[0];
+                if (ih < 0 || ih >= (long)args->h) continue;
+                const float* in = col + oh * args->ow;
+                float* out = x + ih * args->w + col_offset;
+                if (p->stride[1] == 1) {
+                    for (size_t ow = lo; ow < hi; ow++) out[ow] += in[ow];
+                } else {
+                    for (size_t ow = lo; ow < hi; ow++) out[ow * p->stride[1]] += in[ow];
+                }
+            }
+        }
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_col2im(const cgrad_conv2d_params* p, void* cols, void* x) {
+    const cgrad_backend_cpu_f32* cols_tensor = (const cgrad_backend_cpu_f32*)cols;
+    cgrad_backend_cpu_f32* x_tensor = (cgrad_backend_cpu_f32*)x;
+    if (!p || !x_tensor || !cols_tensor) return CGRAD_ERR_NULL_POINTER;
+    if (!cgrad_storage_layout_is_contiguous(&x_tensor->layout)
+        || !cgrad_storage_layout_is_contiguous(&cols_tensor->layout)) {
+        return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+    }
+
+    helper_cgrad_backend_cpu_f32_conv2d_args args;
+    helper_cgrad_backend_cpu_f32_conv2d_geometry(p, &x_tensor->layout, &args);
+    size_t planes = args.n * args.c;
+    if (cols_tensor->layout.size != planes * p->kernel[0] * p->kernel[1] * args.oh * args.ow) {
+        return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    }
+    args.x = helper_cgrad_backend_cpu_f32_base(cols_tensor);
+    args.r = helper_cgrad_backend_cpu_f32_base(x_tensor);
+
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        planes,
+        helper_cgrad_backend_cpu_f32_row_grain(p->kernel[0] * p->kernel[1] * args.oh * args.ow),
+        helper_cgrad_backend_cpu_f32_col2im_range,
+        &args
+    );
+    return CGRAD_SUCCESS;
+}
+
+// Implicit GEMM over the tasks [begin, end), each covering one image and a block of output
+// channels: the reduction over (c, kh, kw) reads the input directly instead of an im2col buffer.
+static void helper_cgrad_backend_cpu_f32_conv2d_range(void* arg, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_conv2d_args* args = (const helper_cgrad_backend_cpu_f32_conv2d_args*)arg;
+    const cgrad_conv2d_params* p = &args->p;
+    size_t kh_size = p->kernel[0], kw_size = p->kernel[1];
+    size_t out_plane = args->oh * args->ow;
+    size_t blocks = (args->o + CGRAD_CPU_F32_CONV2D_OC_BLOCK - 1) / CGRAD_CPU_F32_CONV2D_OC_BLOCK;
+
+    for (size_t task = begin; task < end; task++) {
+        size_t n = task / blocks;
+        size_t o0 = (task % blocks) * CGRAD_CPU_F32_CONV2D_OC_BLOCK;
+        size_t nb = args->o - o0 < CGRAD_CPU_F32_CONV2D_OC_BLOCK ? args->o - o0 : CGRAD_CPU_F32_CONV2D_OC_BLOCK;
+
+        // padding rows of the block point at a scratch plane so the inner loop has no branches
+        float* out[CGRAD_CPU_F32_CONV2D_OC_BLOCK];
+        for (size_t b = 0; b < CGRAD_CPU_F32_CONV2D_OC_BLOCK; b++) {
+            out[b] = args->r + (n * args->o + o0 + (b < nb ? b : 0)) * out_plane;
+        }
+        for (size_t b = 0; b < nb; b++) memset(out[b], 0, out_plane * sizeof(float));
+
+        for (size_t c = 0; c < args->c; c++) {
+            const float* x = args->x + (n * args->c + c) * args->h * args->w;
+            for (size_t kh = 0; kh < kh_size; kh++) {
+                for (size_t kw = 0; kw < kw_size; kw++) {
+                    float wv[CGRAD_CPU_F32_CONV2D_OC_BLOCK];
+                    for (size_t b = 0; b < CGRAD_CPU_F32_CONV2D_OC_BLOCK; b++) {
+                        wv[b] = b < nb ? args->wt[(((o0 + b) * args->c + c) * kh_size + kh) * kw_size + kw] : 0.0f;
+                    }
+
+                    long col_offset = (long)(kw * p->dilation[1]) - (long)p->padding[1];
+                    size_t lo, hi;
+                    helper_cgrad_backend_cpu_f32_conv2d_valid_range(col_offset, p->stride[1], args->w, args->ow, &lo, &hi);
+
+                    for (size_t oh = 0; oh < args->oh; oh++) {
+                        long ih = (long)(oh * p->stride[0] + kh * p->dilation[0]) - (long)p->padding[0];
+                        if (ih < 0 || ih >= (long)args->h) continue;
+                        const float* in = x + ih * args->w + col_offset;
+                        float* r0 = out[0] + oh * args->ow;
+                        float* r1 = out[1] + oh * args->ow;
+                        float* r2 = out[2] + oh * args->ow;
+                        float* r3 = out[3] + oh * args->ow;
+                        if (nb < CGRAD_CPU_F32_CONV2D_OC_BLOCK) {
+                            // tail block: the padding rows alias row 0 and must not be written
+                            for (size_t b = 0; b < nb; b++) {
+                                float* rb = out[b] + oh * args->ow;
+                                for (size_t ow = lo; ow < hi; ow++) rb[ow] += wv[b] * in[ow * p->stride[1]];
+                            }
+                        } else if (p->stride[1] == 1) {
+                            for (size_t ow = lo; ow < hi; ow++) {
+                                float v = in[ow];
+                                r0[ow] += wv[0] * v;
+                                r1[ow] += wv[1] * v;
+                                r2[ow] += wv[2] * v;
+                                r3[ow] += wv[3] * v;
+                            }
+                        } else {
+                            for (size_t ow = lo; ow < hi; ow++) {
+                                float v = in[ow * p->stride[1]];
+                                r0[ow] += wv[0] * v;
+                                r1[ow] += wv[1] * v;
+                                r2[ow] += wv[2] * v;
+                                r3[ow] += wv[3] * v;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_conv2d(const cgrad_conv2d_params* p, void* x, void* w, void* r) {
+    const cgrad_backend_cpu_f32* x_tensor = (const cgrad_backend_cpu_f32*)x;
+    const cgrad_backend_cpu_f32* w_tensor = (const cgrad_backend_cpu_f32*)w;
+    cgrad_backend_cpu_f32* r_tensor = (cgrad_backend_cpu_f32*)r;
+    if (!p || !x_tensor || !w_tensor || !r_tensor) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_backend_cpu_f32* tensors[3] = {x_tensor, w_tensor, r_tensor};
+    if (!helper_cgrad_backend_cpu_f32_all_contiguous(tensors, 3)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+
+    helper_cgrad_backend_cpu_f32_conv2d_args args;
+    helper_cgrad_backend_cpu_f32_conv2d_geometry(p, &x_tensor->layout, &args);
+    args.o = w_tensor->layout.shape[TENSOR_DIM - 4];
+    if (w_tensor->layout.shape[TENSOR_DIM - 3] != args.c
+        || w_tensor->layout.shape[TENSOR_DIM - 2] != p->kernel[0]
+        || w_tensor->layout.shape[TENSOR_DIM - 1] != p->kernel[1]
+        || r_tensor->layout.size != args.n * args.o * args.oh * args.ow) {
+        return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    }
+    args.x = helper_cgrad_backend_cpu_f32_base(x_tensor);
+    args.wt = helper_cgrad_backend_cpu_f32_base(w_tensor);
+    args.r = helper_cgrad_backend_cpu_f32_base(r_tensor);
+
+    size_t blocks = (args.o + CGRAD_CPU_F32_CONV2D_OC_BLOCK - 1) / CGRAD_CPU_F32_CONV2D_OC_BLOCK;
+    size_t work = CGRAD_CPU_F32_CONV2D_OC_BLOCK * args.c * p->kernel[0] * p->kernel[1] * args.oh * args.ow;
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        args.n * blocks,
+        helper_cgrad_backend_cpu_f32_row_grain(work),
+        helper_cgrad_backend_cpu_f32_conv2d_range,
+        &args
+    );
+    return CGRAD_SUCCESS;
+}
+
+// SGD update of a contiguous span, with or without (Nesterov) momentum buffer m
+static void helper_cgrad_backend_cpu_f32_sgd_span(const cgrad_optim_update* u, float* restrict p, const float* restrict g, float* restrict m, size_t n) {
+    const float lr = u->lr, wd = u->weight_decay, mu = u->momentum;
+    if (!m) {
+        for (size_t i = 0; i < n; i++) p[i] -= lr * (g[i] + wd * p[i]);
+    } else if (u->nesterov) {
+        for (size_t i = 0; i < n; i++) {
+            float d = g[i] + wd * p[i];
+            float mi = mu * m[i] + d;
+            m[i] = mi;
+            p[i] -= lr * (d + mu * mi);
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            float mi = mu * m[i] + g[i] + wd * p[i];
+            m[i] = mi;
+            p[i] -= lr * mi;
+        }
+    }
+}
+
+// Adam / AdamW update of a contiguous span. The bias corrections are folded into the step
+// size and the denominator, so the loop is a single fused pass over p, g, m and v (it
+// vectorizes with -fno-math-errno, which turns sqrtf into a plain vector square root).
+static void helper_cgrad_backend_cpu_f32_adam_span(const cgrad_optim_update* u, float* restrict p, const float* restrict g, float* restrict m, float* restrict v, size_t n) {
+    const float b1 = u->beta1, b2 = u->beta2, eps = u->eps;
+    const float step_size = u->lr / u->bias_correction1;
+    const float inv_sqrt_bc2 = 1.0f / sqrtf(u->bias_correction2);
+    const float l2 = u->kind == CGRAD_OPTIM_ADAM ? u->weight_decay : 0.0f;
+    const float decay = u->kind == CGRAD_OPTIM_ADAMW ? 1.0f - u->lr * u->weight_decay : 1.0f;
+    for (size_t i = 0; i < n; i++) {
+        float gi = g[i] + l2 * p[i];
+        float mi = b1 * m[i] + (1.0f - b1) * gi;
+        float vi = b2 * v[i] + (1.0f - b2) * gi * gi;
+        m[i] = mi;
+        v[i] = vi;
+        p[i] = p[i] * decay - step_size * mi / (sqrtf(vi) * inv_sqrt_bc2 + eps);
+    }
+}
+
+typedef struct {
+    const cgrad_optim_update* u;
+    int n;
+    size_t offsets[CGRAD_BACKEND_OPTIM_MAX_TENSORS + 1];    // start of every tensor in the joint index space
+    float* p[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    const float* g[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    float* m[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    float* v[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+} helper_cgrad_backend_cpu_f32_optim_args;
+
+// Update the elements [begin, end) of all tensors laid out back to back
+static void helper_cgrad_backend_cpu_f32_optim_range(void* args, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_optim_args* a = (const helper_cgrad_backend_cpu_f32_optim_args*)args;
+    int t = 0;
+    while (t < a->n && a->offsets[t + 1] <= begin) t++;
+    for (; t < a->n && a->offsets[t] < end; t++) {
+        size_t lo = begin > a->offsets[t] ? begin - a->offsets[t] : 0;
+        size_t hi = (end < a->offsets[t + 1] ? end : a->offsets[t + 1]) - a->offsets[t];
+        if (a->u->kind == CGRAD_OPTIM_SGD) {
+            helper_cgrad_backend_cpu_f32_sgd_span(a->u, a->p[t] + lo, a->g[t] + lo, a->m[t] ? a->m[t] + lo : NULL, hi - lo);
+        } else {
+            helper_cgrad_backend_cpu_f32_adam_span(a->u, a->p[t] + lo, a->g[t] + lo, a->m[t] + lo, a->v[t] + lo, hi - lo);
+        }
+    }
+}
+
+// Check that a state or gradient storage matches its parameter and is contiguous
+static cgrad_status helper_cgrad_backend_cpu_f32_optim_check(const cgrad_backend_cpu_f32* param, const cgrad_backend_cpu_f32* t) {
+    if (!t) return CGRAD_ERR_NULL_POINTER;
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (t->layout.shape[d] != param->layout.shape[d]) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    }
+    if (!cgrad_storage_layout_is_contiguous(&t->layout)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+    return CGRAD_SUCCESS;
+}
+
+static cgrad_status cgrad_backend_cpu_f32_optim_step(const cgrad_optim_update* u, int n, void* const* params, void* const* grads, void* const* m, void* const* v) {
+    if (!u || !params || !grads) return CGRAD_ERR_NULL_POINTER;
+    if (n < 0 || n > CGRAD_BACKEND_OPTIM_MAX_TENSORS) return CGRAD_ERR_NOT_IMPLEMENTED;
+    if (u->kind != CGRAD_OPTIM_SGD && u->kind != CGRAD_OPTIM_ADAM && u->kind != CGRAD_OPTIM_ADAMW) return CGRAD_ERR_NOT_IMPLEMENTED;
+    int is_adam = u->kind != CGRAD_OPTIM_SGD;
+    if (is_adam && (!m || !v)) return CGRAD_ERR_NULL_POINTER;
+
+    helper_cgrad_backend_cpu_f32_optim_args args;
+    args.u = u;
+    args.n = n;
+    args.offsets[0] = 0;
+    for (int i = 0; i < n; i++) {
+        cgrad_backend_cpu_f32* p = (cgrad_backend_cpu_f32*)params[i];
+        if (!p) return CGRAD_ERR_NULL_POINTER;
+        if (!cgrad_storage_layout_is_contiguous(&p->layout)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+        cgrad_status err = helper_cgrad_backend_cpu_f32_optim_check(p, (const cgrad_backend_cpu_f32*)grads[i]);
+        if (err == CGRAD_SUCCESS && m) err = helper_cgrad_backend_cpu_f32_optim_check(p, (const cgrad_backend_cpu_f32*)m[i]);
+        if (err == CGRAD_SUCCESS && is_adam) err = helper_cgrad_backend_cpu_f32_optim_check(p, (const cgrad_backend_cpu_f32*)v[i]);
+        if (err != CGRAD_SUCCESS) return err;
+
+        args.offsets[i + 1] = args.offsets[i] + p->layout.size;
+        args.p[i] = helper_cgrad_backend_cpu_f32_base(p);
+        args.g[i] = helper_cgrad_backend_cpu_f32_base((const cgrad_backend_cpu_f32*)grads[i]);
+        args.m[i] = m ? helper_cgrad_backend_cpu_f32_base((const cgrad_backend_cpu_f32*)m[i]) : NULL;
+        args.v[i] = is_adam ? helper_cgrad_backend_cpu_f32_base((const cgrad_backend_cpu_f32*)v[i]) : NULL;
+    }
+
+    // all tensors form one index space, so small parameters share threads with large ones
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        args.offsets[n],
+        CGRAD_CPU_F32_PARALLEL_GRAIN,
+        helper_cgrad_backend_cpu_f32_optim_range,
+        &args
+    );
+
+    return CGRAD_SUCCESS;
+}
+
+// Elements per float partial sum of a sum of squares, and maximum number of parts the joint
+// index space is split into. Parts depend on the element count only, so the result is the
+// same for any number of threads.
+#define CGRAD_CPU_F32_SUM_SQUARES_BLOCK 4096
+#define CGRAD_CPU_F32_SUM_SQUARES_PARTS 64
+
+// Kahan-compensated accumulation of a double into (*sum, *c)
+static inline void helper_cgrad_backend_cpu_f32_kahan_add(double* sum, double* c, double value) {
+    double y = value - *c;
+    double t = *sum + y;
+    *c = (t - *sum) - y;
+    *sum = t;
+}
+
+// Sum of squares of a contiguous span: 16 independent float lanes per block (vectorizes
+// without reassociation), block sums accumulated in double with Kahan compensation
+static double helper_cgrad_backend_cpu_f32_sum_squares_span(const float* restrict x, size_t n) {
+    double total = 0.0, c = 0.0;
+    for (size_t start = 0; start < n; start += CGRAD_CPU_F32_SUM_SQUARES_BLOCK) {
+        size_t len = n - start < CGRAD_CPU_F32_SUM_SQUARES_BLOCK ? n - start : CGRAD_CPU_F32_SUM_SQUARES_BLOCK;
+        const float* xb = x + start;
+        float acc[16] = {0.0f};
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16) {
+            for (int l = 0; l < 16; l++) acc[l] += xb[i + l] * xb[i + l];
+        }
+        float block = 0.0f;
+        for (; i < len; i++) block += xb[i] * xb[i];
+        for (int l = 0; l < 16; l++) block += acc[l];
+        helper_cgrad_backend_cpu_f32_kahan_add(&total, &c, (double)block);
+    }
+    return total;
+}
+
+typedef struct {
+    int n;
+    size_t offsets[CGRAD_BACKEND_OPTIM_MAX_TENSORS + 1];    // start of every tensor in the joint index space
+    const float* x[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    size_t part_size;
+    double partials[CGRAD_CPU_F32_SUM_SQUARES_PARTS];
+} helper_cgrad_backend_cpu_f32_sum_squares_args;
+
+// Reduce the parts [begin, end) of the joint index space into their partial sums
+static void helper_cgrad_backend_cpu_f32_sum_squares_range(void* args, size_t begin, size_t end) {
+    helper_cgrad_backend_cpu_f32_sum_squares_args* a = (helper_cgrad_backend_cpu_f32_sum_squares_args*)args;
+    size_t total = a->offsets[a->n];
+    for (size_t part = begin; part < end; part++) {
+        size_t lo = part * a->part_size;
+        size_t hi = lo + a->part_size < total ? lo + a->part_size : total;
+        double sum = 0.0;
+        for (int t = 0; t < a->n; t++) {
+            if (a->offsets[t + 1] <= lo || a->offsets[t] >= hi) continue;
+            size_t tlo = lo > a->offsets[t] ? lo - a->offsets[t] : 0;
+            size_t thi = (hi < a->offsets[t + 1] ? hi : a->offsets[t + 1]) - a->offsets[t];
+            sum += helper_cgrad_backend_cpu_f32_sum_squares_span(a->x[t] + tlo, thi - tlo);
+        }
+        a->partials[part] = sum;
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_sum_squares(int n, void* const* ts, double* out) {
+    if (!ts || !out) return CGRAD_ERR_NULL_POINTER;
+    if (n < 0 || n > CGRAD_BACKEND_OPTIM_MAX_TENSORS) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    helper_cgrad_backend_cpu_f32_sum_squares_args args;
+    args.n = n;
+    args.offsets[0] = 0;
+    for (int i = 0; i < n; i++) {
+        const cgrad_backend_cpu_f32* t = (const cgrad_backend_cpu_f32*)ts[i];
+        if (!t) return CGRAD_ERR_NULL_POINTER;
+        if (!cgrad_storage_layout_is_contiguous(&t->layout)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+        args.offsets[i + 1] = args.offsets[i] + t->layout.size;
+        args.x[i] = helper_cgrad_backend_cpu_f32_base(t);
+    }
+
+    size_t total = args.offsets[n];
+    size_t part_size = (total + CGRAD_CPU_F32_SUM_SQUARES_PARTS - 1) / CGRAD_CPU_F32_SUM_SQUARES_PARTS;
+    if (part_size < CGRAD_CPU_F32_SUM_SQUARES_BLOCK) part_size = CGRAD_CPU_F32_SUM_SQUARES_BLOCK;
+    args.part_size = part_size;
+    size_t num_parts = (total + part_size - 1) / part_size;
+
+    size_t grain = CGRAD_CPU_F32_PARALLEL_GRAIN / part_size;
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        num_parts,
+        grain > 0 ? grain : 1,
+        helper_cgrad_backend_cpu_f32_sum_squares_range,
+        &args
+    );
+
+    double sum = 0.0, c = 0.0;
+    for (size_t p = 0; p < num_parts; p++) helper_cgrad_backend_cpu_f32_kahan_add(&sum, &c, args.partials[p]);
+    *out = sum;
+    return CGRAD_SUCCESS;
+}
+
+typedef struct {
+    int n;
+    size_t offsets[CGRAD_BACKEND_OPTIM_MAX_TENSORS + 1];    // start of every tensor in the joint index space
+    float* x[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    float alpha;
+} helper_cgrad_backend_cpu_f32_scale_args;
+
+// Scale the elements [begin, end) of all tensors laid out back to back
+static void helper_cgrad_backend_cpu_f32_scale_range(void* args, size_t begin, size_t end) {
+    const helper_cgrad_backend_cpu_f32_scale_args* a = (const helper_cgrad_backend_cpu_f32_scale_args*)args;
+    int t = 0;
+    while (t < a->n && a->offsets[t + 1] <= begin) t++;
+    for (; t < a->n && a->offsets[t] < end; t++) {
+        size_t lo = begin > a->offsets[t] ? begin - a->offsets[t] : 0;
+        size_t hi = (end < a->offsets[t + 1] ? end : a->offsets[t + 1]) - a->offsets[t];
+        float* restrict x = a->x[t];
+        const float alpha = a->alpha;
+        for (size_t i = lo; i < hi; i++) x[i] *= alpha;
+    }
+}
+
+static cgrad_status cgrad_backend_cpu_f32_scale(int n, void* const* ts, float alpha) {
+    if (!ts) return CGRAD_ERR_NULL_POINTER;
+    if (n < 0 || n > CGRAD_BACKEND_OPTIM_MAX_TENSORS) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    helper_cgrad_backend_cpu_f32_scale_args args;
+    args.n = n;
+    args.alpha = alpha;
+    args.offsets[0] = 0;
+    for (int i = 0; i < n; i++) {
+        cgrad_backend_cpu_f32* t = (cgrad_backend_cpu_f32*)ts[i];
+        if (!t) return CGRAD_ERR_NULL_POINTER;
+        if (!cgrad_storage_layout_is_contiguous(&t->layout)) return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+        args.offsets[i + 1] = args.offsets[i] + t->layout.size;
+        args.x[i] = helper_cgrad_backend_cpu_f32_base(t);
+    }
+
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        args.offsets[n],
+        CGRAD_CPU_F32_PARALLEL_GRAIN,
+        helper_cgrad_backend_cpu_f32_scale_range,
+        &args
+    );
+    return CGRAD_SUCCESS;
+}
+
+// Clear the bytes [begin, end) of a buffer
+static void helper_cgrad_backend_cpu_f32_zero_range(void* args, size_t begin, size_t end) {
+    memset((char*)args + begin, 0, end - begin);
+}
+
+static cgrad_status cgrad_backend_cpu_f32_zero(void* t) {
+    cgrad_backend_cpu_f32* tensor = (cgrad_backend_cpu_f32*)t;
+    if (!tensor || !tensor->data) return CGRAD_ERR_NULL_POINTER;
+
+    // views with gaps keep the elements between them
+    if (!cgrad_storage_layout_is_contiguous(&tensor->layout)) {
+        return cgrad_backend_cpu_f32_fill(t, 0.0f);
+    }
+
+    helper_cgrad_backend_cpu_f32_parallel_for(
+        (size_t)tensor->layout.size * sizeof(float),
+        CGRAD_CPU_F32_ZERO_GRAIN,
+        helper_cgrad_backend_cpu_f32_zero_range,
+        helper_cgrad_backend_cpu_f32_base(tensor)
+    );
     return CGRAD_SUCCESS;
 }
 
@@ -380,13 +2007,13 @@ static void cgrad_backend_cpu_f32_print_data(const void* t) {
     cgrad_storage_layout l;
     cgrad_storage_layout_init(&l, tensor->layout.shape, TENSOR_DIM);
     uint32_t idx[TENSOR_DIM] = {0};
-    for (int i = 0; i < l.size; i++) {
+    for (uint64_t i = 0; i < l.size; i++) {
         #pragma unroll
         for (int j = 0; j < TENSOR_DIM-1; j++) {
-            idx[j] = (i / l.strides[j]) % l.shape[j];
+            idx[j] = (uint32_t)((i / l.strides[j]) % l.shape[j]);
             if ((i > 0) && ((i % l.strides[j]) == 0)) printf("\n");
         }
-        idx[TENSOR_DIM-1] = (i / l.strides[TENSOR_DIM-1]) % l.shape[TENSOR_DIM-1];
+        idx[TENSOR_DIM-1] = (uint32_t)((i / l.strides[TENSOR_DIM-1]) % l.shape[TENSOR_DIM-1]);
         float value = 0.0f;
         int err = cgrad_backend_cpu_f32_get(tensor, idx, TENSOR_DIM, &value);
         if (err == CGRAD_SUCCESS) {
@@ -3,6 +3,7 @@
 #include "autograd/cgrad_tensor.h"
 #include "backends/cgrad_backend_registry.h"
 #include "storage/cgrad_storage_registry.h"
+#include "storage/cgrad_checkpoint.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -72,6 +73,9 @@ cgrad_status cgrad_cleanup(void) {
     // Step 2: Cleanup global storage registry
     int ret = cgrad_storage_free_global_registry();
 
+    // Step 3: Free the spare checkpoint staging buffer
+    cgrad_checkpoint_release_buffers();
+
     // Mark as uninitialized
     g_cgrad_initialized = 0;
     
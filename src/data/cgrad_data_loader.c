@@ -0,0 +1,416 @@
+#include "data/cgrad_data_loader.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+#include "autograd/cgrad_tensor.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DATA_LOADER_ALIGNMENT 64
+
+typedef enum data_loader_slot_state {
+    DATA_LOADER_SLOT_EMPTY,     /**< Free for the batch num_buffers after its previous one */
+    DATA_LOADER_SLOT_FILLING,   /**< A worker is copying samples into the buffers */
+    DATA_LOADER_SLOT_READY,     /**< Assembled, waiting for the consumer */
+    DATA_LOADER_SLOT_IN_USE,    /**< Delivered by the last cgrad_data_loader_next */
+} data_loader_slot_state;
+
+/**
+ * @brief One buffer of the batch ring with the leaf tensors over it.
+ */
+typedef struct data_loader_slot {
+    float* inputs_data;
+    float* targets_data;
+    cgrad_tensor inputs;
+    cgrad_tensor targets;
+    int has_inputs;
+    int has_targets;
+    data_loader_slot_state state;
+    uint64_t seq;                   /**< Sequence number (epoch * num_batches + index) of the held batch */
+} data_loader_slot;
+
+struct cgrad_data_loader {
+    cgrad_data_loader_config config;
+    void* base;                     /**< Read-only mapping of the dataset file */
+    size_t size;
+    uint64_t num_samples;
+    uint64_t num_batches;           /**< Complete batches per epoch */
+    uint64_t total;                 /**< Batches to deliver over all epochs, UINT64_MAX without limit */
+    size_t input_numel;             /**< Floats per input sample */
+    size_t target_numel;            /**< Floats per target sample */
+    size_t record_bytes;
+
+    data_loader_slot* slots;        /**< Ring of config.num_buffers slots, batch seq lives in slot seq % num_buffers */
+
+    // Shuffle permutations of the epochs in flight, epoch e lives at index e % num_perms
+    int num_perms;
+    uint64_t** perms;
+    uint64_t* perm_epochs;
+    int* perm_shuffling;            /**< 1 while a worker shuffles the permutation outside the lock */
+
+    pthread_mutex_t lock;
+    pthread_cond_t slot_empty;      /**< Signalled when the consumer recycles a slot */
+    pthread_cond_t slot_ready;      /**< Signalled when a worker finishes a batch */
+    pthread_cond_t perm_ready;      /**< Signalled when a worker finishes shuffling a permutation */
+    uint64_t next_fill;             /**< Next batch to be claimed by a worker */
+    uint64_t next_consume;          /**< Batch delivered (or to be delivered) by cgrad_data_loader_next */
+    int has_current;                /**< 1 while batch next_consume is in use by the consumer */
+    int stop;
+
+    int num_threads;
+    pthread_t* threads;
+};
+
+static uint64_t data_loader_splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Get the sample order of an epoch, shuffling it on first use. Called with the lock held.
+// The first worker of an epoch claims the permutation and shuffles it with the lock released, so
+// the consumer and the other workers are not held up at epoch boundaries; workers needing the
+// same epoch wait for it. Batches in flight lie within num_buffers consecutive sequence numbers,
+// so they span fewer than num_perms epochs and an epoch's permutation is never replaced while
+// it is in use.
+static const uint64_t* data_loader_epoch_perm(cgrad_data_loader* loader, uint64_t epoch) {
+    if (!loader->config.shuffle) return NULL;
+
+    int p = (int)(epoch % (uint64_t)loader->num_perms);
+    uint64_t* perm = loader->perms[p];
+    if (loader->perm_epochs[p] == epoch) {
+        while (loader->perm_shuffling[p]) pthread_cond_wait(&loader->perm_ready, &loader->lock);
+        return perm;
+    }
+
+    loader->perm_epochs[p] = epoch;
+    loader->perm_shuffling[p] = 1;
+    pthread_mutex_unlock(&loader->lock);
+
+    // Fisher-Yates shuffle seeded by (seed, epoch)
+    uint64_t state = loader->config.seed ^ ((epoch + 1) * 0xD1B54A32D192ED03ull);
+    for (uint64_t i = 0; i < loader->num_samples; i++) perm[i] = i;
+    for (uint64_t i = loader->num_samples - 1; i > 0; i--) {
+        uint64_t j = data_loader_splitmix64(&state) % (i + 1);
+        uint64_t tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+    }
+
+    pthread_mutex_lock(&loader->lock);
+    loader->perm_shuffling[p] = 0;
+    pthread_cond_broadcast(&loader->perm_ready);
+    return perm;
+}
+
+// Copy the samples of batch `index` of an epoch into the slot buffers
+static void data_loader_fill(const cgrad_data_loader* loader, data_loader_slot* slot, const uint64_t* perm, uint64_t index) {
+    const char* records = (const char*)loader->base;
+    uint32_t batch_size = loader->config.batch_size;
+    size_t input_bytes = loader->input_numel * sizeof(float);
+    size_t target_bytes = loader->target_numel * sizeof(float);
+    for (uint32_t i = 0; i < batch_size; i++) {
+        uint64_t pos = index * batch_size + i;
+        uint64_t sample = perm ? perm[pos] : pos;
+        const char* record = records + sample * loader->record_bytes;
+        memcpy(slot->inputs_data + (size_t)i * loader->input_numel, record, input_bytes);
+        if (target_bytes > 0) {
+            memcpy(slot->targets_data + (size_t)i * loader->target_numel, record + input_bytes, target_bytes);
+        }
+    }
+}
+
+// Claim batches in order and assemble them as soon as their slot is recycled
+static void* data_loader_worker(void* arg) {
+    cgrad_data_loader* loader = (cgrad_data_loader*)arg;
+    pthread_mutex_lock(&loader->lock);
+    while (!loader->stop && loader->next_fill < loader->total) {
+        uint64_t seq = loader->next_fill;
+        data_loader_slot* slot = &loader->slots[seq % (uint64_t)loader->config.num_buffers];
+        if (slot->state != DATA_LOADER_SLOT_EMPTY) {
+            pthread_cond_wait(&loader->slot_empty, &loader->lock);
+            continue;
+        }
+        slot->state = DATA_LOADER_SLOT_FILLING;
+        slot->seq = seq;
+        loader->next_fill++;
+        const uint64_t* perm = data_loader_epoch_perm(loader, seq / loader->num_batches);
+        pthread_mutex_unlock(&loader->lock);
+
+        data_loader_fill(loader, slot, perm, seq % loader->num_batches);
+
+        pthread_mutex_lock(&loader->lock);
+        slot->state = DATA_LOADER_SLOT_READY;
+        pthread_cond_broadcast(&loader->slot_ready);
+    }
+    pthread_mutex_unlock(&loader->lock);
+    return NULL;
+}
+
+// Allocate a batch buffer of shape (batch_size, *sample_shape) and create a leaf tensor over it.
+// The tensor's storage frees the buffer once the tensor and everything derived from it is freed.
+static cgrad_status data_loader_init_buffer(
+    uint32_t batch_size,
+    const uint32_t* sample_shape,
+    int sample_ndim,
+    float** out_data,
+    cgrad_tensor* out_tensor
+) {
+    uint32_t shape[TENSOR_DIM];
+    shape[0] = batch_size;
+    memcpy(shape + 1, sample_shape, (size_t)sample_ndim * sizeof(uint32_t));
+    cgrad_storage_layout layout;
+    cgrad_status err = cgrad_storage_layout_init(&layout, shape, sample_ndim + 1);
+    if (err != CGRAD_SUCCESS) return err;
+
+    size_t bytes = (layout.size * sizeof(float) + DATA_LOADER_ALIGNMENT - 1) / DATA_LOADER_ALIGNMENT * DATA_LOADER_ALIGNMENT;
+    float* data = (float*)aligned_alloc(DATA_LOADER_ALIGNMENT, bytes);
+    if (!data) return CGRAD_ERR_ALLOC_FAILED;
+
+    cgrad_storage storage;
+    err = cgrad_storage_wrap(&storage, &layout, data, free, data, "cpu_f32");
+    if (err != CGRAD_SUCCESS) {
+        free(data);
+        return err;
+    }
+    err = cgrad_tensor_from_storage(&storage, out_tensor);
+    cgrad_storage_free(&storage);
+    if (err != CGRAD_SUCCESS) return err;
+
+    // batches are inputs, never parameters
+    err = cgrad_tensor_set_requires_grad(out_tensor, 0);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_tensor_free(out_tensor);
+        return err;
+    }
+    *out_data = data;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Initialize a config with defaults.
+ */
+void cgrad_data_loader_config_init(cgrad_data_loader_config* config) {
+    if (!config) return;
+    memset(config, 0, sizeof(*config));
+    config->num_workers = 1;
+    config->num_buffers = 2;
+}
+
+static int data_loader_shape_valid(const uint32_t* shape, int ndim) {
+    for (int i = 0; i < ndim; i++) {
+        if (shape[i] == 0) return 0;
+    }
+    return 1;
+}
+
+// Stop and join the workers, then release everything the loader owns
+static void data_loader_destroy(cgrad_data_loader* loader) {
+    pthread_mutex_lock(&loader->lock);
+    loader->stop = 1;
+    pthread_cond_broadcast(&loader->slot_empty);
+    pthread_cond_broadcast(&loader->slot_ready);
+    pthread_mutex_unlock(&loader->lock);
+    for (int t = 0; t < loader->num_threads; t++) {
+        pthread_join(loader->threads[t], NULL);
+    }
+    free(loader->threads);
+
+    if (loader->slots) {
+        for (int i = 0; i < loader->config.num_buffers; i++) {
+            if (loader->slots[i].has_inputs) cgrad_tensor_free(&loader->slots[i].inputs);
+            if (loader->slots[i].has_targets) cgrad_tensor_free(&loader->slots[i].targets);
+        }
+        free(loader->slots);
+    }
+    if (loader->perms) {
+        for (int p = 0; p < loader->num_perms; p++) free(loader->perms[p]);
+        free(loader->perms);
+    }
+    free(loader->perm_epochs);
+    free(loader->perm_shuffling);
+    if (loader->base) munmap(loader->base, loader->size);
+    pthread_cond_destroy(&loader->perm_ready);
+    pthread_cond_destroy(&loader->slot_ready);
+    pthread_cond_destroy(&loader->slot_empty);
+    pthread_mutex_destroy(&loader->lock);
+    free(loader);
+}
+
+// Map the dataset file and derive the sample and batch counts
+static cgrad_status data_loader_map_file(cgrad_data_loader* loader) {
+    int fd = open(loader->config.path, O_RDONLY);
+    if (fd < 0) return CGRAD_ERR_STORAGE_FILE_IO;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return CGRAD_ERR_STORAGE_FILE_IO;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size % loader->record_bytes != 0 || size / loader->record_bytes < loader->config.batch_size) {
+        close(fd);
+        return CGRAD_ERR_STORAGE_FILE_INVALID;
+    }
+
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return CGRAD_ERR_STORAGE_FILE_IO;
+    madvise(base, size, loader->config.shuffle ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+    loader->base = base;
+    loader->size = size;
+    loader->num_samples = size / loader->record_bytes;
+    loader->num_batches = loader->num_samples / loader->config.batch_size;
+    uint64_t num_epochs = loader->config.num_epochs;
+    loader->total = (num_epochs == 0 || num_epochs > UINT64_MAX / loader->num_batches)
+        ? UINT64_MAX
+        : num_epochs * loader->num_batches;
+    return CGRAD_SUCCESS;
+}
+
+// Allocate the batch ring and the shuffle permutations
+static cgrad_status data_loader_init_buffers(cgrad_data_loader* loader) {
+    const cgrad_data_loader_config* c = &loader->config;
+    loader->slots = (data_loader_slot*)calloc((size_t)c->num_buffers, sizeof(data_loader_slot));
+    if (!loader->slots) return CGRAD_ERR_ALLOC_FAILED;
+    for (int i = 0; i < c->num_buffers; i++) {
+        data_loader_slot* slot = &loader->slots[i];
+        slot->state = DATA_LOADER_SLOT_EMPTY;
+        cgrad_status err = data_loader_init_buffer(c->batch_size, c->input_shape, c->input_ndim, &slot->inputs_data, &slot->inputs);
+        if (err != CGRAD_SUCCESS) return err;
+        slot->has_inputs = 1;
+        if (c->target_ndim > 0) {
+            err = data_loader_init_buffer(c->batch_size, c->target_shape, c->target_ndim, &slot->targets_data, &slot->targets);
+            if (err != CGRAD_SUCCESS) return err;
+            slot->has_targets = 1;
+        }
+    }
+
+    if (c->shuffle) {
+        loader->num_perms = (int)((uint64_t)c->num_buffers / loader->num_batches) + 2;
+        loader->perms = (uint64_t**)calloc((size_t)loader->num_perms, sizeof(uint64_t*));
+        loader->perm_epochs = (uint64_t*)malloc((size_t)loader->num_perms * sizeof(uint64_t));
+        loader->perm_shuffling = (int*)calloc((size_t)loader->num_perms, sizeof(int));
+        if (!loader->perms || !loader->perm_epochs || !loader->perm_shuffling) return CGRAD_ERR_ALLOC_FAILED;
+        for (int p = 0; p < loader->num_perms; p++) {
+            loader->perms[p] = (uint64_t*)malloc(loader->num_samples * sizeof(uint64_t));
+            if (!loader->perms[p]) return CGRAD_ERR_ALLOC_FAILED;
+            loader->perm_epochs[p] = UINT64_MAX;
+        }
+    }
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Map the dataset file, allocate the batch ring and start the workers.
+ */
+cgrad_status cgrad_data_loader_create(const cgrad_data_loader_config* config, cgrad_data_loader** out) {
+    if (!config || !config->path || !out) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+    if (config->input_ndim < 1 || config->input_ndim >= TENSOR_DIM
+        || config->target_ndim < 0 || config->target_ndim >= TENSOR_DIM
+        || !data_loader_shape_valid(config->input_shape, config->input_ndim)
+        || !data_loader_shape_valid(config->target_shape, config->target_ndim)
+        || config->batch_size == 0 || config->num_workers < 1 || config->num_buffers < 2) {
+        return CGRAD_ERR_DATA_LOADER_INVALID_CONFIG;
+    }
+
+    cgrad_data_loader* loader = (cgrad_data_loader*)calloc(1, sizeof(cgrad_data_loader));
+    if (!loader) return CGRAD_ERR_ALLOC_FAILED;
+    loader->config = *config;
+    pthread_mutex_init(&loader->lock, NULL);
+    pthread_cond_init(&loader->slot_empty, NULL);
+    pthread_cond_init(&loader->slot_ready, NULL);
+    pthread_cond_init(&loader->perm_ready, NULL);
+
+    loader->input_numel = 1;
+    for (int i = 0; i < config->input_ndim; i++) loader->input_numel *= config->input_shape[i];
+    loader->target_numel = config->target_ndim > 0 ? 1 : 0;
+    for (int i = 0; i < config->target_ndim; i++) loader->target_numel *= config->target_shape[i];
+    loader->record_bytes = (loader->input_numel + loader->target_numel) * sizeof(float);
+
+    cgrad_status err = data_loader_map_file(loader);
+    if (err == CGRAD_SUCCESS) err = data_loader_init_buffers(loader);
+    if (err == CGRAD_SUCCESS) {
+        loader->threads = (pthread_t*)malloc((size_t)config->num_workers * sizeof(pthread_t));
+        if (!loader->threads) err = CGRAD_ERR_ALLOC_FAILED;
+    }
+    for (int t = 0; err == CGRAD_SUCCESS && t < config->num_workers; t++) {
+        if (pthread_create(&loader->threads[t], NULL, data_loader_worker, loader) != 0) {
+            err = CGRAD_ERR_ALLOC_FAILED;
+        } else {
+            loader->num_threads++;
+        }
+    }
+    if (err != CGRAD_SUCCESS) {
+        data_loader_destroy(loader);
+        return err;
+    }
+
+    *out = loader;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Recycle the previously delivered batch and get the next one.
+ */
+cgrad_status cgrad_data_loader_next(cgrad_data_loader* loader, cgrad_data_batch* out) {
+    if (!loader || !out) return CGRAD_ERR_NULL_POINTER;
+    int num_buffers = loader->config.num_buffers;
+
+    pthread_mutex_lock(&loader->lock);
+    if (loader->has_current) {
+        loader->slots[loader->next_consume % (uint64_t)num_buffers].state = DATA_LOADER_SLOT_EMPTY;
+        loader->next_consume++;
+        loader->has_current = 0;
+        pthread_cond_broadcast(&loader->slot_empty);
+    }
+    if (loader->next_consume >= loader->total) {
+        pthread_mutex_unlock(&loader->lock);
+        return CGRAD_ERR_DATA_LOADER_EXHAUSTED;
+    }
+
+    data_loader_slot* slot = &loader->slots[loader->next_consume % (uint64_t)num_buffers];
+    while (slot->state != DATA_LOADER_SLOT_READY || slot->seq != loader->next_consume) {
+        pthread_cond_wait(&loader->slot_ready, &loader->lock);
+    }
+    slot->state = DATA_LOADER_SLOT_IN_USE;
+    loader->has_current = 1;
+    uint64_t seq = slot->seq;
+    pthread_mutex_unlock(&loader->lock);
+
+    out->inputs = slot->inputs;
+    if (slot->has_targets) out->targets = slot->targets;
+    out->epoch = seq / loader->num_batches;
+    out->index = seq % loader->num_batches;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Get the number of records in the dataset file.
+ */
+uint64_t cgrad_data_loader_num_samples(const cgrad_data_loader* loader) {
+    return loader ? loader->num_samples : 0;
+}
+
+/**
+ * @brief Get the number of (complete) batches per epoch.
+ */
+uint64_t cgrad_data_loader_num_batches(const cgrad_data_loader* loader) {
+    return loader ? loader->num_batches : 0;
+}
+
+/**
+ * @brief Stop the workers and release the batch ring and the mapping.
+ */
+void cgrad_data_loader_free(cgrad_data_loader* loader) {
+    if (!loader) return;
+    data_loader_destroy(loader);
+}
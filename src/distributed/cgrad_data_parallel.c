@@ -0,0 +1,526 @@
+#include "distributed/cgrad_data_parallel.h"
+#include "optim/cgrad_param_group.h"
+#include "autograd/cgrad_tensor.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define DATA_PARALLEL_MAGIC 0x43475250u         // "CGRP"
+#define DATA_PARALLEL_ALIGNMENT 64
+#define DATA_PARALLEL_SPINS 1024                // busy polls before a waiting rank goes to sleep
+#define DATA_PARALLEL_SLEEP_MS 10               // longest sleep before a waiting rank checks for aborts and timeouts
+#define DATA_PARALLEL_REDUCE_BLOCK 256          // elements reduced at a time, kept in registers/L1
+
+/**
+ * @brief A counter on its own cache line of the shared segment. Ranks waiting for it to advance
+ *        sleep on seq, a futex word shared between the processes.
+ */
+typedef struct data_parallel_counter {
+    uint64_t value;
+    uint32_t seq;                   /**< Incremented after every change of value */
+    uint32_t waiters;               /**< Ranks sleeping on seq */
+    char pad[DATA_PARALLEL_ALIGNMENT - sizeof(uint64_t) - 2 * sizeof(uint32_t)];
+} data_parallel_counter;
+
+/**
+ * @brief Start of the shared segment, written by rank 0 before it publishes magic.
+ *
+ * It is followed by the counters of every bucket (arrived, then reduced), the staging area of
+ * every rank and the result area, each aligned to DATA_PARALLEL_ALIGNMENT bytes.
+ */
+typedef struct data_parallel_header {
+    uint32_t magic;
+    int32_t world_size;
+    int32_t num_buckets;
+    uint64_t num_elements;
+    uint64_t buckets_hash;          /**< Hash of the bucket bounds, equal on all ranks of a group */
+    data_parallel_counter attached; /**< Ranks that mapped the segment */
+    data_parallel_counter aborted;  /**< Nonzero once a rank failed, releases all waiting ranks */
+} data_parallel_header;
+
+struct cgrad_data_parallel {
+    cgrad_data_parallel_config config;
+    cgrad_param_group* group;
+    float* grads;                   /**< Flat gradient buffer of the group */
+    uint64_t num_elements;
+
+    int num_buckets;
+    uint64_t* bucket_bounds;        /**< Bucket b holds the elements [bucket_bounds[b], bucket_bounds[b + 1]) */
+    int* bucket_params;             /**< Number of parameters of every bucket */
+    int* param_buckets;             /**< Bucket of every parameter */
+    int last_param;                 /**< Parameter matched by the previous hook call */
+
+    // Shared segment, NULL for a single rank
+    data_parallel_header* header;
+    size_t shm_size;
+    data_parallel_counter* arrived; /**< Per bucket: ranks that staged it, summed over all generations */
+    data_parallel_counter* reduced; /**< Per bucket: ranks that reduced their chunk, summed over all generations */
+    float* staging;                 /**< world_size staging areas of stride elements */
+    float* result;
+    size_t stride;
+
+    // Communication thread: reduces the buckets of a pass in descending order, the order in
+    // which a backward pass finishes them, so that all ranks visit them in the same order
+    pthread_mutex_t lock;
+    pthread_cond_t bucket_ready;    /**< Signalled when a bucket becomes ready or on stop */
+    pthread_cond_t pass_done;       /**< Signalled when the last bucket of a pass is reduced */
+    int* ready_params;              /**< Per bucket: parameters with final gradients in this pass */
+    int* ready;                     /**< Per bucket: 1 once all its gradients are final */
+    int next;                       /**< Next bucket to reduce, -1 when the pass is complete */
+    uint64_t generation;            /**< Number of the current pass, counting from 1 */
+    cgrad_status error;
+    int stop;
+    int has_thread;
+    pthread_t thread;
+};
+
+static size_t data_parallel_align(size_t bytes) {
+    return (bytes + DATA_PARALLEL_ALIGNMENT - 1) / DATA_PARALLEL_ALIGNMENT * DATA_PARALLEL_ALIGNMENT;
+}
+
+static uint64_t data_parallel_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static void data_parallel_sleep_ms(long ms) {
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+// Advance a shared counter and wake the ranks sleeping on it
+static void data_parallel_advance(data_parallel_counter* counter) {
+    __atomic_fetch_add(&counter->value, 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&counter->seq, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&counter->waiters, __ATOMIC_SEQ_CST) != 0) {
+        syscall(SYS_futex, &counter->seq, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+    }
+}
+
+// Wait until a shared counter reaches target, another rank aborts or the timeout expires.
+// The other ranks usually arrive within a few polls; a rank that is further behind (e.g. still
+// in its backward pass) is waited for asleep, so that the waiting thread does not take a core
+// from the kernels of its own rank.
+static cgrad_status data_parallel_wait(const cgrad_data_parallel* dp, data_parallel_counter* counter, uint64_t target) {
+    for (unsigned spin = 0; spin < DATA_PARALLEL_SPINS; spin++) {
+        if (__atomic_load_n(&counter->value, __ATOMIC_ACQUIRE) >= target) return CGRAD_SUCCESS;
+        if (__atomic_load_n(&dp->header->aborted.value, __ATOMIC_ACQUIRE)) return CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED;
+    }
+
+    uint64_t deadline = dp->config.timeout_ms > 0 ? data_parallel_now_ms() + (uint64_t)dp->config.timeout_ms : 0;
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&counter->seq, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&counter->value, __ATOMIC_ACQUIRE) >= target) return CGRAD_SUCCESS;
+        if (__atomic_load_n(&dp->header->aborted.value, __ATOMIC_ACQUIRE)) return CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED;
+        if (deadline != 0 && data_parallel_now_ms() >= deadline) return CGRAD_ERR_DATA_PARALLEL_TIMEOUT;
+
+        // sleeps until seq changes; the timeout bounds how late an abort or a timeout is noticed
+        struct timespec slice = {0, DATA_PARALLEL_SLEEP_MS * 1000000L};
+        __atomic_fetch_add(&counter->waiters, 1, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &counter->seq, FUTEX_WAIT, seq, &slice, NULL, 0);
+        __atomic_fetch_sub(&counter->waiters, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+// Reduce the elements [begin, end) of the staging areas into the result area
+static void data_parallel_reduce(const cgrad_data_parallel* dp, uint64_t begin, uint64_t end, float scale) {
+    int world_size = dp->config.world_size;
+    float acc[DATA_PARALLEL_REDUCE_BLOCK];
+    for (uint64_t lo = begin; lo < end; lo += DATA_PARALLEL_REDUCE_BLOCK) {
+        size_t n = end - lo < DATA_PARALLEL_REDUCE_BLOCK ? (size_t)(end - lo) : DATA_PARALLEL_REDUCE_BLOCK;
+        memcpy(acc, dp->staging + lo, n * sizeof(float));
+        for (int r = 1; r < world_size; r++) {
+            const float* restrict src = dp->staging + (size_t)r * dp->stride + lo;
+            for (size_t i = 0; i < n; i++) acc[i] += src[i];
+        }
+        float* restrict dst = dp->result + lo;
+        for (size_t i = 0; i < n; i++) dst[i] = acc[i] * scale;
+    }
+}
+
+// Allreduce one bucket: stage it, reduce this rank's chunk over all ranks, copy the result back.
+// Staging and result areas are reused by the next generation only after every rank is past
+// the step that reads them, which the monotonic counters guarantee.
+static cgrad_status data_parallel_allreduce_bucket(cgrad_data_parallel* dp, int b, uint64_t generation) {
+    int world_size = dp->config.world_size;
+    int rank = dp->config.rank;
+    uint64_t lo = dp->bucket_bounds[b];
+    uint64_t hi = dp->bucket_bounds[b + 1];
+    uint64_t target = generation * (uint64_t)world_size;
+
+    memcpy(dp->staging + (size_t)rank * dp->stride + lo, dp->grads + lo, (size_t)(hi - lo) * sizeof(float));
+    data_parallel_advance(&dp->arrived[b]);
+    cgrad_status err = data_parallel_wait(dp, &dp->arrived[b], target);
+    if (err != CGRAD_SUCCESS) return err;
+
+    // chunks start at multiples of 16 elements, so ranks never write to the same cache line
+    uint64_t chunk = ((hi - lo + (uint64_t)world_size - 1) / (uint64_t)world_size + 15) & ~(uint64_t)15;
+    uint64_t begin = lo + chunk * (uint64_t)rank;
+    uint64_t end = begin + chunk;
+    if (begin > hi) begin = hi;
+    if (end > hi) end = hi;
+    data_parallel_reduce(dp, begin, end, dp->config.average ? 1.0f / (float)world_size : 1.0f);
+    data_parallel_advance(&dp->reduced[b]);
+    err = data_parallel_wait(dp, &dp->reduced[b], target);
+    if (err != CGRAD_SUCCESS) return err;
+
+    memcpy(dp->grads + lo, dp->result + lo, (size_t)(hi - lo) * sizeof(float));
+    return CGRAD_SUCCESS;
+}
+
+static void* data_parallel_comm_thread(void* arg) {
+    cgrad_data_parallel* dp = (cgrad_data_parallel*)arg;
+    pthread_mutex_lock(&dp->lock);
+    while (!dp->stop) {
+        if (dp->next < 0 || !dp->ready[dp->next]) {
+            pthread_cond_wait(&dp->bucket_ready, &dp->lock);
+            continue;
+        }
+        int b = dp->next;
+        uint64_t generation = dp->generation;
+        cgrad_status err = dp->error;
+        pthread_mutex_unlock(&dp->lock);
+
+        // after a failure the remaining buckets are only skipped
+        if (err == CGRAD_SUCCESS) {
+            err = data_parallel_allreduce_bucket(dp, b, generation);
+            if (err != CGRAD_SUCCESS) __atomic_store_n(&dp->header->aborted.value, 1, __ATOMIC_RELEASE);
+        }
+
+        pthread_mutex_lock(&dp->lock);
+        if (dp->error == CGRAD_SUCCESS) dp->error = err;
+        dp->next--;
+        if (dp->next < 0) pthread_cond_broadcast(&dp->pass_done);
+    }
+    pthread_mutex_unlock(&dp->lock);
+    return NULL;
+}
+
+// Start a pass: no bucket is ready yet. Called without the lock held.
+static void data_parallel_begin_pass(cgrad_data_parallel* dp) {
+    pthread_mutex_lock(&dp->lock);
+    dp->generation++;
+    dp->error = CGRAD_SUCCESS;
+    memset(dp->ready_params, 0, (size_t)dp->num_buckets * sizeof(int));
+    memset(dp->ready, 0, (size_t)dp->num_buckets * sizeof(int));
+    dp->next = dp->num_buckets - 1;
+    pthread_mutex_unlock(&dp->lock);
+}
+
+// Mark every bucket ready (gradients that the backward pass did not reach are final as well)
+// and wait until the communication thread has reduced all of them
+static cgrad_status data_parallel_end_pass(cgrad_data_parallel* dp) {
+    pthread_mutex_lock(&dp->lock);
+    for (int b = 0; b < dp->num_buckets; b++) dp->ready[b] = 1;
+    pthread_cond_broadcast(&dp->bucket_ready);
+    while (dp->next >= 0) pthread_cond_wait(&dp->pass_done, &dp->lock);
+    cgrad_status err = dp->error;
+    pthread_mutex_unlock(&dp->lock);
+    return err;
+}
+
+// Gradient-ready hook of the backward pass: hand a bucket to the communication thread once the
+// gradients of all its parameters are final. Parameters are mostly reported in reverse order,
+// so the search starts below the previous match.
+static void data_parallel_grad_ready(const uuid_t node_id, cgrad_storage* grad_storage, void* user_data) {
+    (void)grad_storage;
+    cgrad_data_parallel* dp = (cgrad_data_parallel*)user_data;
+    const cgrad_tensor* params = cgrad_param_group_get_params(dp->group);
+    int n = cgrad_param_group_num_params(dp->group);
+    int p = -1;
+    for (int k = 1; k <= n; k++) {
+        int i = ((dp->last_param - k) % n + n) % n;
+        if (uuid_compare(params[i].node_id, node_id) == 0) {
+            p = i;
+            break;
+        }
+    }
+    if (p < 0) return;
+    dp->last_param = p;
+
+    int b = dp->param_buckets[p];
+    pthread_mutex_lock(&dp->lock);
+    if (++dp->ready_params[b] == dp->bucket_params[b]) {
+        dp->ready[b] = 1;
+        pthread_cond_broadcast(&dp->bucket_ready);
+    }
+    pthread_mutex_unlock(&dp->lock);
+}
+
+// Split the flat buffer into buckets of at least bucket_bytes along parameter boundaries
+static cgrad_status data_parallel_init_buckets(cgrad_data_parallel* dp) {
+    int n = cgrad_param_group_num_params(dp->group);
+    size_t bucket_elements = dp->config.bucket_bytes / sizeof(float);
+    if (bucket_elements == 0) bucket_elements = 1;
+
+    dp->bucket_bounds = (uint64_t*)malloc(((size_t)n + 1) * sizeof(uint64_t));
+    dp->bucket_params = (int*)calloc((size_t)n, sizeof(int));
+    dp->param_buckets = (int*)malloc((size_t)n * sizeof(int));
+    dp->ready_params = (int*)calloc((size_t)n, sizeof(int));
+    dp->ready = (int*)calloc((size_t)n, sizeof(int));
+    if (!dp->bucket_bounds || !dp->bucket_params || !dp->param_buckets || !dp->ready_params || !dp->ready) {
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    int b = -1;
+    for (int i = 0; i < n; i++) {
+        uint64_t offset = cgrad_param_group_get_offset(dp->group, i);
+        if (b < 0 || offset - dp->bucket_bounds[b] >= bucket_elements) dp->bucket_bounds[++b] = offset;
+        dp->param_buckets[i] = b;
+        dp->bucket_params[b]++;
+    }
+    dp->num_buckets = b + 1;
+    dp->bucket_bounds[0] = 0;
+    dp->bucket_bounds[dp->num_buckets] = dp->num_elements;
+    return CGRAD_SUCCESS;
+}
+
+static uint64_t data_parallel_hash_buckets(const cgrad_data_parallel* dp) {
+    uint64_t h = 1469598103934665603ull;     // FNV-1a over the bounds
+    for (int b = 0; b <= dp->num_buckets; b++) {
+        h ^= dp->bucket_bounds[b];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Create (rank 0) or open (other ranks) the shared segment and map it
+static cgrad_status data_parallel_map(cgrad_data_parallel* dp) {
+    const cgrad_data_parallel_config* c = &dp->config;
+    size_t counters_bytes = (size_t)dp->num_buckets * sizeof(data_parallel_counter);
+    dp->stride = data_parallel_align((size_t)dp->num_elements * sizeof(float)) / sizeof(float);
+    size_t header_bytes = data_parallel_align(sizeof(data_parallel_header));
+    size_t area_bytes = dp->stride * sizeof(float);
+    dp->shm_size = header_bytes + 2 * counters_bytes + (size_t)(c->world_size + 1) * area_bytes;
+
+    int fd = -1;
+    uint64_t deadline = data_parallel_now_ms() + (uint64_t)(c->timeout_ms > 0 ? c->timeout_ms : INT32_MAX);
+    if (c->rank == 0) {
+        fd = shm_open(c->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) return CGRAD_ERR_DATA_PARALLEL_SHM;
+        if (ftruncate(fd, (off_t)dp->shm_size) != 0) {
+            close(fd);
+            shm_unlink(c->name);
+            return CGRAD_ERR_DATA_PARALLEL_SHM;
+        }
+    } else {
+        // wait for rank 0 to create the segment and give it its size
+        struct stat st;
+        for (;;) {
+            if (fd < 0) fd = shm_open(c->name, O_RDWR, 0600);
+            if (fd < 0 && errno != ENOENT) return CGRAD_ERR_DATA_PARALLEL_SHM;
+            if (fd >= 0) {
+                if (fstat(fd, &st) != 0) {
+                    close(fd);
+                    return CGRAD_ERR_DATA_PARALLEL_SHM;
+                }
+                if ((size_t)st.st_size == dp->shm_size) break;
+                if (st.st_size != 0) {
+                    close(fd);
+                    return CGRAD_ERR_DATA_PARALLEL_MISMATCH;
+                }
+            }
+            if (data_parallel_now_ms() >= deadline) {
+                if (fd >= 0) close(fd);
+                return CGRAD_ERR_DATA_PARALLEL_TIMEOUT;
+            }
+            data_parallel_sleep_ms(1);
+        }
+    }
+
+    void* base = mmap(NULL, dp->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        if (c->rank == 0) shm_unlink(c->name);
+        return CGRAD_ERR_DATA_PARALLEL_SHM;
+    }
+    dp->header = (data_parallel_header*)base;
+    dp->arrived = (data_parallel_counter*)((char*)base + header_bytes);
+    dp->reduced = dp->arrived + dp->num_buckets;
+    dp->staging = (float*)((char*)base + header_bytes + 2 * counters_bytes);
+    dp->result = dp->staging + (size_t)c->world_size * dp->stride;
+
+    data_parallel_header* h = dp->header;
+    uint64_t hash = data_parallel_hash_buckets(dp);
+    if (c->rank == 0) {
+        h->world_size = c->world_size;
+        h->num_buckets = dp->num_buckets;
+        h->num_elements = dp->num_elements;
+        h->buckets_hash = hash;
+        __atomic_store_n(&h->magic, DATA_PARALLEL_MAGIC, __ATOMIC_RELEASE);
+    } else {
+        while (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != DATA_PARALLEL_MAGIC) {
+            if (data_parallel_now_ms() >= deadline) return CGRAD_ERR_DATA_PARALLEL_TIMEOUT;
+            data_parallel_sleep_ms(1);
+        }
+        if (h->world_size != c->world_size || h->num_buckets != dp->num_buckets
+            || h->num_elements != dp->num_elements || h->buckets_hash != hash) {
+            __atomic_store_n(&h->aborted.value, 1, __ATOMIC_RELEASE);
+            return CGRAD_ERR_DATA_PARALLEL_MISMATCH;
+        }
+    }
+
+    // all ranks have opened the segment once everybody attached: its name is no longer needed
+    data_parallel_advance(&h->attached);
+    cgrad_status err = data_parallel_wait(dp, &h->attached, (uint64_t)c->world_size);
+    if (c->rank == 0) shm_unlink(c->name);
+    return err;
+}
+
+/**
+ * @brief Initialize a config with defaults.
+ */
+void cgrad_data_parallel_config_init(cgrad_data_parallel_config* config) {
+    if (!config) return;
+    memset(config, 0, sizeof(*config));
+    config->world_size = 1;
+    config->bucket_bytes = (size_t)4 << 20;
+    config->average = 1;
+    config->timeout_ms = 60000;
+}
+
+/**
+ * @brief Run fn on world_size ranks, all but rank 0 in forked child processes.
+ */
+cgrad_status cgrad_data_parallel_spawn(int world_size, cgrad_data_parallel_worker fn, void* arg) {
+    if (!fn) return CGRAD_ERR_NULL_POINTER;
+    if (world_size < 1 || world_size > CGRAD_DATA_PARALLEL_MAX_RANKS) return CGRAD_ERR_DATA_PARALLEL_INVALID_CONFIG;
+
+    pid_t pids[CGRAD_DATA_PARALLEL_MAX_RANKS];
+    int num_children = 0;
+    cgrad_status err = CGRAD_SUCCESS;
+    for (int rank = 1; rank < world_size; rank++) {
+        pid_t pid = fork();
+        if (pid == 0) _exit(fn(rank, world_size, arg) == CGRAD_SUCCESS ? 0 : 1);
+        if (pid < 0) {
+            // the ranks already started time out waiting for the missing ones
+            err = CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED;
+            break;
+        }
+        pids[num_children++] = pid;
+    }
+
+    cgrad_status root_err = err == CGRAD_SUCCESS ? fn(0, world_size, arg) : err;
+    for (int i = 0; i < num_children; i++) {
+        int status = 0;
+        while (waitpid(pids[i], &status, 0) < 0 && errno == EINTR) {}
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) err = CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED;
+    }
+    return root_err != CGRAD_SUCCESS ? root_err : err;
+}
+
+/**
+ * @brief Attach a rank to the shared memory segment of its group.
+ */
+cgrad_status cgrad_data_parallel_create(
+    const cgrad_data_parallel_config* config,
+    cgrad_param_group* group,
+    cgrad_data_parallel** out
+) {
+    if (!config || !group || !out) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+    if (config->world_size < 1 || config->world_size > CGRAD_DATA_PARALLEL_MAX_RANKS
+        || config->rank < 0 || config->rank >= config->world_size || config->timeout_ms < 0
+        || (config->world_size > 1 && (!config->name || config->name[0] != '/'))) {
+        return CGRAD_ERR_DATA_PARALLEL_INVALID_CONFIG;
+    }
+
+    cgrad_data_parallel* dp = (cgrad_data_parallel*)calloc(1, sizeof(cgrad_data_parallel));
+    if (!dp) return CGRAD_ERR_ALLOC_FAILED;
+    dp->config = *config;
+    dp->config.name = NULL;         // only used while attaching
+    dp->group = group;
+    dp->grads = cgrad_param_group_get_grad_data(group);
+    dp->num_elements = cgrad_param_group_num_elements(group);
+    dp->next = -1;
+    pthread_mutex_init(&dp->lock, NULL);
+    pthread_cond_init(&dp->bucket_ready, NULL);
+    pthread_cond_init(&dp->pass_done, NULL);
+
+    cgrad_status err = dp->grads ? data_parallel_init_buckets(dp) : CGRAD_ERR_NULL_POINTER;
+    if (err == CGRAD_SUCCESS && config->world_size > 1) {
+        dp->config.name = config->name;
+        err = data_parallel_map(dp);
+        dp->config.name = NULL;
+        if (err == CGRAD_SUCCESS) {
+            dp->has_thread = pthread_create(&dp->thread, NULL, data_parallel_comm_thread, dp) == 0;
+            if (!dp->has_thread) err = CGRAD_ERR_ALLOC_FAILED;
+        }
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_data_parallel_free(dp);
+        return err;
+    }
+    *out = dp;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Backpropagate from a loss and allreduce the gradients while the backward pass runs.
+ */
+cgrad_status cgrad_data_parallel_backward(cgrad_data_parallel* dp, cgrad_tensor* loss) {
+    if (!dp || !loss) return CGRAD_ERR_NULL_POINTER;
+    if (!dp->header) return cgrad_tensor_backward(loss);
+
+    data_parallel_begin_pass(dp);
+    cgrad_status err = cgrad_tensor_backward_with_hook(loss, data_parallel_grad_ready, dp);
+    if (err != CGRAD_SUCCESS) {
+        // the other ranks cannot complete this pass without us
+        __atomic_store_n(&dp->header->aborted.value, 1, __ATOMIC_RELEASE);
+    }
+    cgrad_status comm_err = data_parallel_end_pass(dp);
+    return err != CGRAD_SUCCESS ? err : comm_err;
+}
+
+/**
+ * @brief Allreduce the current gradients of the group.
+ */
+cgrad_status cgrad_data_parallel_allreduce(cgrad_data_parallel* dp) {
+    if (!dp) return CGRAD_ERR_NULL_POINTER;
+    if (!dp->header) return CGRAD_SUCCESS;
+    data_parallel_begin_pass(dp);
+    return data_parallel_end_pass(dp);
+}
+
+/**
+ * @brief Get the number of buckets.
+ */
+int cgrad_data_parallel_num_buckets(const cgrad_data_parallel* dp) {
+    return dp ? dp->num_buckets : 0;
+}
+
+/**
+ * @brief Detach from the shared memory segment and stop the communication thread.
+ */
+void cgrad_data_parallel_free(cgrad_data_parallel* dp) {
+    if (!dp) return;
+    if (dp->has_thread) {
+        pthread_mutex_lock(&dp->lock);
+        dp->stop = 1;
+        pthread_cond_broadcast(&dp->bucket_ready);
+        pthread_mutex_unlock(&dp->lock);
+        pthread_join(dp->thread, NULL);
+    }
+    if (dp->header) munmap(dp->header, dp->shm_size);
+    pthread_cond_destroy(&dp->pass_done);
+    pthread_cond_destroy(&dp->bucket_ready);
+    pthread_mutex_destroy(&dp->lock);
+    free(dp->ready);
+    free(dp->ready_params);
+    free(dp->param_buckets);
+    free(dp->bucket_params);
+    free(dp->bucket_bounds);
+    free(dp);
+}
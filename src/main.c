@@ -1,5 +1,5 @@
 #include "cgrad.h"
-#include "storage/cgrad_storage.h"
+#include "optim/cgrad_optimizer.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <math.h>
@@ -12,7 +12,7 @@
  * 2. Performs 20 iterations of gradient descent:
  *    - Computes loss = sum(A @ B)
  *    - Computes gradients via backpropagation
- *    - Updates A using gradient descent: A = A - learning_rate * dL/dA
+ *    - Updates A with an SGD optimizer: A = A - learning_rate * dL/dA
  * 3. Prints iteration, loss, and gradient norm at each step
  */
 int main() {
@@ -54,12 +54,23 @@ int main() {
     
     const float learning_rate = 0.1f;
     const int num_iterations = 10;
+
+    cgrad_optimizer_config optim_config;
+    cgrad_optimizer_config_init(&optim_config, CGRAD_OPTIM_SGD);
+    optim_config.lr = learning_rate;
+
+    cgrad_optimizer* optimizer = NULL;
+    if (cgrad_optimizer_create(&optim_config, &A, 1, &optimizer) != CGRAD_SUCCESS) {
+        printf("Error: Failed to create optimizer\n");
+        cgrad_cleanup();
+        return 1;
+    }
     
     for (int iter = 0; iter < num_iterations; iter++) {
 
         // void* record = cgrad_storage_start_recording();
         // zero gradient of A
-        cgrad_tensor_zero_grad(&A);
+        cgrad_optimizer_zero_grad(optimizer);
 
         // ====================================================================
         // Forward Pass: Compute loss = sum(A @ B)
@@ -84,6 +95,7 @@ int main() {
         int ret = cgrad_tensor_backward(&loss);
         if (ret != 0) {
             printf("Error: Backward pass failed at iteration %d\n", iter);
+            cgrad_optimizer_free(optimizer);
             cgrad_cleanup();
             return 1;
         }
@@ -94,12 +106,7 @@ int main() {
         // ====================================================================
         // Gradient Descent Update: A = A - learning_rate * dL/dA
         // ====================================================================
-        cgrad_storage_axpy(
-            -learning_rate,
-            cgrad_tensor_get_grad_storage(&A),
-            cgrad_tensor_get_storage(&A),
-            cgrad_tensor_get_storage(&A)
-        );
+        cgrad_optimizer_step(optimizer);
 
         // cgrad_storage_free_record(record);
         cgrad_tensor_free(&C);
@@ -114,6 +121,7 @@ int main() {
     // Cleanup
     // ========================================================================
     printf("--- Cleanup ---\n");
+    cgrad_optimizer_free(optimizer);
     cgrad_status cleanup_status = cgrad_cleanup();
     if (cleanup_status != CGRAD_SUCCESS) {
         printf("Warning: Cleanup returned error code %d\n", cleanup_status);
@@ -0,0 +1,291 @@
+#include "optim/cgrad_optimizer.h"
+#include "optim/cgrad_param_group.h"
+#include "storage/cgrad_storage.h"
+#include "autograd/cgrad_tensor.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+struct cgrad_optimizer {
+    cgrad_optimizer_config config;
+    cgrad_param_group* group;           /**< Group updated through its flat buffers, or NULL */
+    int n;
+    cgrad_tensor* params;               /**< Parameter tensors (handles copied at creation), NULL for a group */
+    cgrad_storage** param_storages;     /**< Storage of every parameter, resolved once */
+    cgrad_storage* m;                   /**< Momentum buffers / first moments, NULL if unused */
+    cgrad_storage* v;                   /**< Second moments, NULL if unused */
+    int num_states;                     /**< Number of initialized entries in m and v */
+    uint64_t step;
+    int micro_batches;                  /**< Micro-batches accumulated since the last update */
+    float grad_norm;                    /**< Global gradient norm of the last step, before clipping */
+
+    // Arrays handed to cgrad_storage_optim_step, refilled every step with the
+    // parameters that have a gradient
+    cgrad_storage** step_params;
+    cgrad_storage** step_grads;
+    cgrad_storage** step_m;
+    cgrad_storage** step_v;
+};
+
+/**
+ * @brief Initialize a config with the usual defaults for an update rule.
+ */
+void cgrad_optimizer_config_init(cgrad_optimizer_config* config, cgrad_optim_kind kind) {
+    if (!config) return;
+    memset(config, 0, sizeof(*config));
+    config->kind = kind;
+    config->lr = 1e-3f;
+    config->beta1 = 0.9f;
+    config->beta2 = 0.999f;
+    config->eps = 1e-8f;
+    config->weight_decay = kind == CGRAD_OPTIM_ADAMW ? 1e-2f : 0.0f;
+}
+
+// Allocate a zero-filled state storage shaped like a parameter
+static cgrad_status optimizer_init_state(const cgrad_storage* param, cgrad_storage* state) {
+    const cgrad_storage_layout* layout = param->backend->storage_get_layout(param->data);
+    cgrad_status err = cgrad_storage_init(state, layout->shape, TENSOR_DIM, param->backend->name);
+    if (err != CGRAD_SUCCESS) return err;
+    err = cgrad_storage_zero(state);
+    if (err != CGRAD_SUCCESS) cgrad_storage_free(state);
+    return err;
+}
+
+// Allocate an optimizer for n parameter storages; the caller fills in param_storages
+static cgrad_status optimizer_alloc(const cgrad_optimizer_config* config, int n, cgrad_optimizer** out) {
+    if (n < 0 || config->kind < CGRAD_OPTIM_SGD || config->kind > CGRAD_OPTIM_ADAMW) return CGRAD_ERR_OPTIM_INVALID_CONFIG;
+    if (config->accumulation_steps < 0) return CGRAD_ERR_OPTIM_INVALID_CONFIG;
+
+    cgrad_optimizer* opt = (cgrad_optimizer*)calloc(1, sizeof(cgrad_optimizer));
+    if (!opt) return CGRAD_ERR_ALLOC_FAILED;
+    opt->config = *config;
+    opt->n = n;
+
+    size_t count = n > 0 ? (size_t)n : 1;
+    int has_m = config->kind != CGRAD_OPTIM_SGD || config->momentum != 0.0f;
+    int has_v = config->kind != CGRAD_OPTIM_SGD;
+    opt->param_storages = (cgrad_storage**)malloc(count * sizeof(cgrad_storage*));
+    opt->step_params = (cgrad_storage**)malloc(count * sizeof(cgrad_storage*));
+    opt->step_grads = (cgrad_storage**)malloc(count * sizeof(cgrad_storage*));
+    opt->step_m = (cgrad_storage**)malloc(count * sizeof(cgrad_storage*));
+    opt->step_v = (cgrad_storage**)malloc(count * sizeof(cgrad_storage*));
+    if (has_m) opt->m = (cgrad_storage*)calloc(count, sizeof(cgrad_storage));
+    if (has_v) opt->v = (cgrad_storage*)calloc(count, sizeof(cgrad_storage));
+    if (!opt->param_storages || !opt->step_params || !opt->step_grads
+        || !opt->step_m || !opt->step_v || (has_m && !opt->m) || (has_v && !opt->v)) {
+        cgrad_optimizer_free(opt);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    *out = opt;
+    return CGRAD_SUCCESS;
+}
+
+// Validate the parameter storages and allocate the state of every parameter
+static cgrad_status optimizer_init_states(cgrad_optimizer* opt) {
+    for (int i = 0; i < opt->n; i++) {
+        cgrad_storage* storage = opt->param_storages[i];
+        if (!storage || !storage->backend || !storage->data) return CGRAD_ERR_NULL_POINTER;
+        if (storage->backend != opt->param_storages[0]->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+        if (!cgrad_storage_layout_is_contiguous(storage->backend->storage_get_layout(storage->data))) {
+            return CGRAD_ERR_STORAGE_LAYOUT_NOT_CONTIGUOUS;
+        }
+
+        cgrad_status err = CGRAD_SUCCESS;
+        if (opt->m) err = optimizer_init_state(storage, &opt->m[i]);
+        if (err == CGRAD_SUCCESS && opt->v) {
+            err = optimizer_init_state(storage, &opt->v[i]);
+            if (err != CGRAD_SUCCESS && opt->m) cgrad_storage_free(&opt->m[i]);
+        }
+        if (err != CGRAD_SUCCESS) return err;
+        opt->num_states++;
+    }
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Create an optimizer for the given parameter tensors and allocate its state.
+ */
+cgrad_status cgrad_optimizer_create(
+    const cgrad_optimizer_config* config,
+    const cgrad_tensor* params,
+    int n,
+    cgrad_optimizer** out
+) {
+    if (!config || !out || (n > 0 && !params)) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+
+    cgrad_optimizer* opt = NULL;
+    cgrad_status err = optimizer_alloc(config, n, &opt);
+    if (err != CGRAD_SUCCESS) return err;
+    opt->params = (cgrad_tensor*)malloc((n > 0 ? (size_t)n : 1) * sizeof(cgrad_tensor));
+    if (!opt->params) {
+        cgrad_optimizer_free(opt);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    for (int i = 0; i < n; i++) {
+        opt->params[i] = params[i];
+        opt->param_storages[i] = cgrad_tensor_get_storage(&params[i]);
+    }
+
+    err = optimizer_init_states(opt);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_optimizer_free(opt);
+        return err;
+    }
+    *out = opt;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Create an optimizer that updates a parameter group through its flat buffers.
+ */
+cgrad_status cgrad_optimizer_create_for_group(
+    const cgrad_optimizer_config* config,
+    cgrad_param_group* group,
+    cgrad_optimizer** out
+) {
+    if (!config || !group || !out) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+
+    cgrad_optimizer* opt = NULL;
+    cgrad_status err = optimizer_alloc(config, 1, &opt);
+    if (err != CGRAD_SUCCESS) return err;
+    opt->group = group;
+    opt->param_storages[0] = cgrad_param_group_get_flat(group);
+
+    err = optimizer_init_states(opt);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_optimizer_free(opt);
+        return err;
+    }
+    *out = opt;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Update every parameter that has a gradient.
+ */
+cgrad_status cgrad_optimizer_step(cgrad_optimizer* opt) {
+    if (!opt) return CGRAD_ERR_NULL_POINTER;
+
+    // accumulation mode: the gradients keep summing up until the window is complete
+    const cgrad_optimizer_config* c = &opt->config;
+    int accumulating = c->accumulation_steps > 1;
+    if (accumulating && ++opt->micro_batches < c->accumulation_steps) return CGRAD_SUCCESS;
+    opt->micro_batches = 0;
+
+    int count = 0;
+    for (int i = 0; i < opt->n; i++) {
+        cgrad_storage* grad = opt->group
+            ? cgrad_param_group_get_flat_grad(opt->group)
+            : cgrad_tensor_get_grad_storage(&opt->params[i]);
+        if (!grad) continue;
+        opt->step_params[count] = opt->param_storages[i];
+        opt->step_grads[count] = grad;
+        opt->step_m[count] = opt->m ? &opt->m[i] : NULL;
+        opt->step_v[count] = opt->v ? &opt->v[i] : NULL;
+        count++;
+    }
+
+    // averaging over the micro-batches and clipping share a single scaling pass
+    cgrad_status err;
+    double scale = accumulating ? 1.0 / c->accumulation_steps : 1.0;
+    if (c->max_grad_norm > 0.0f) {
+        double sum;
+        err = cgrad_storage_sum_squares(count, (const cgrad_storage* const*)opt->step_grads, &sum);
+        if (err != CGRAD_SUCCESS) return err;
+        double norm = sqrt(sum) * scale;
+        opt->grad_norm = (float)norm;
+        if (norm > (double)c->max_grad_norm) scale *= (double)c->max_grad_norm / (norm + 1e-6);
+    }
+    if (scale != 1.0) {
+        err = cgrad_storage_scale(count, opt->step_grads, (float)scale);
+        if (err != CGRAD_SUCCESS) return err;
+    }
+
+    opt->step++;
+    cgrad_optim_update u = {
+        .kind = c->kind,
+        .lr = c->lr,
+        .weight_decay = c->weight_decay,
+        .momentum = c->momentum,
+        .nesterov = c->nesterov,
+        .beta1 = c->beta1,
+        .beta2 = c->beta2,
+        .eps = c->eps,
+        .bias_correction1 = (float)(1.0 - pow((double)c->beta1, (double)opt->step)),
+        .bias_correction2 = (float)(1.0 - pow((double)c->beta2, (double)opt->step)),
+    };
+    err = cgrad_storage_optim_step(
+        &u,
+        count,
+        opt->step_params,
+        (const cgrad_storage* const*)opt->step_grads,
+        opt->m ? opt->step_m : NULL,
+        opt->v ? opt->step_v : NULL
+    );
+    if (err != CGRAD_SUCCESS || !accumulating) return err;
+    return cgrad_optimizer_zero_grad(opt);
+}
+
+/**
+ * @brief Zero the gradients of all parameters.
+ */
+cgrad_status cgrad_optimizer_zero_grad(cgrad_optimizer* opt) {
+    if (!opt) return CGRAD_ERR_NULL_POINTER;
+    if (opt->group) return cgrad_param_group_zero_grad(opt->group);
+    for (int i = 0; i < opt->n; i++) {
+        cgrad_status err = cgrad_tensor_zero_grad(&opt->params[i]);
+        if (err != CGRAD_SUCCESS) return err;
+    }
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Change the learning rate used by subsequent steps.
+ */
+void cgrad_optimizer_set_lr(cgrad_optimizer* opt, float lr) {
+    if (opt) opt->config.lr = lr;
+}
+
+/**
+ * @brief Get the number of steps taken so far.
+ */
+uint64_t cgrad_optimizer_num_steps(const cgrad_optimizer* opt) {
+    return opt ? opt->step : 0;
+}
+
+/**
+ * @brief Get the number of micro-batches accumulated since the last update.
+ */
+int cgrad_optimizer_num_micro_batches(const cgrad_optimizer* opt) {
+    return opt ? opt->micro_batches : 0;
+}
+
+/**
+ * @brief Get the global gradient norm of the last step, before clipping.
+ */
+float cgrad_optimizer_get_grad_norm(const cgrad_optimizer* opt) {
+    return opt ? opt->grad_norm : 0.0f;
+}
+
+/**
+ * @brief Free the optimizer state.
+ */
+void cgrad_optimizer_free(cgrad_optimizer* opt) {
+    if (!opt) return;
+    for (int i = 0; i < opt->num_states; i++) {
+        if (opt->m) cgrad_storage_free(&opt->m[i]);
+        if (opt->v) cgrad_storage_free(&opt->v[i]);
+    }
+    free(opt->m);
+    free(opt->v);
+    free(opt->step_v);
+    free(opt->step_m);
+    free(opt->step_grads);
+    free(opt->step_params);
+    free(opt->param_storages);
+    free(opt->params);
+    free(opt);
+}
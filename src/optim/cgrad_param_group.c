@@ -0,0 +1,240 @@
+#include "optim/cgrad_param_group.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+#include "autograd/cgrad_tensor.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+struct cgrad_param_group {
+    int n;
+    int num_tensors;            /**< Number of initialized entries in params */
+    uint64_t num_elements;      /**< Elements of the flat buffers, including padding */
+    cgrad_storage flat;         /**< 1-d storage over the value buffer */
+    cgrad_storage flat_grad;    /**< 1-d storage over the gradient buffer */
+    float* grad_data;           /**< Host memory of the gradient buffer */
+    uint64_t* offsets;          /**< Start of every parameter in the flat buffers */
+    int has_flat;
+    int has_flat_grad;
+    cgrad_tensor* params;
+};
+
+// Allocate a zeroed, cache-line aligned buffer of num_elements floats and wrap it into a
+// 1-d storage that frees the buffer once the storage and all its views are gone
+static cgrad_status param_group_alloc_flat(uint64_t num_elements, const char* backend_name, cgrad_storage* out, float** out_data) {
+    size_t bytes = (size_t)num_elements * sizeof(float);
+    float* data = (float*)aligned_alloc(CGRAD_PARAM_GROUP_ALIGNMENT * sizeof(float), bytes);
+    if (!data) return CGRAD_ERR_ALLOC_FAILED;
+
+    cgrad_storage_layout layout;
+    uint32_t shape[1] = {(uint32_t)num_elements};
+    cgrad_status err = cgrad_storage_layout_init(&layout, shape, 1);
+    if (err == CGRAD_SUCCESS) err = cgrad_storage_wrap(out, &layout, data, free, data, backend_name);
+    if (err != CGRAD_SUCCESS) {
+        free(data);
+        return err;
+    }
+    err = cgrad_storage_zero(out);
+    if (err != CGRAD_SUCCESS) cgrad_storage_free(out);
+    else if (out_data) *out_data = data;
+    return err;
+}
+
+// Create a view of shape (shape, ndim) starting at element offset of a flat storage
+static cgrad_status param_group_view(const cgrad_storage* flat, const uint32_t* shape, int ndim, uint64_t offset, cgrad_storage* out) {
+    cgrad_status err = cgrad_storage_shallow_copy(flat, out);
+    if (err != CGRAD_SUCCESS) return err;
+    cgrad_storage_layout* layout = out->backend->storage_get_layout(out->data);
+    err = cgrad_storage_layout_init(layout, shape, ndim);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_free(out);
+        return err;
+    }
+    layout->offset = offset;
+    return CGRAD_SUCCESS;
+}
+
+// Create the leaf tensor of a parameter and attach its gradient view
+static cgrad_status param_group_init_param(cgrad_param_group* group, const uint32_t* shape, int ndim, uint64_t offset, cgrad_tensor* out) {
+    cgrad_storage view;
+    cgrad_status err = param_group_view(&group->flat, shape, ndim, offset, &view);
+    if (err != CGRAD_SUCCESS) return err;
+    err = cgrad_tensor_from_storage(&view, out);
+    cgrad_storage_free(&view);
+    if (err != CGRAD_SUCCESS) return err;
+
+    err = cgrad_tensor_set_requires_grad(out, 1);
+    if (err == CGRAD_SUCCESS) {
+        cgrad_storage grad_view;
+        err = param_group_view(&group->flat_grad, shape, ndim, offset, &grad_view);
+        if (err == CGRAD_SUCCESS) {
+            err = cgrad_tensor_set_grad_storage(out, &grad_view);
+            cgrad_storage_free(&grad_view);
+        }
+    }
+    if (err != CGRAD_SUCCESS) cgrad_tensor_free(out);
+    return err;
+}
+
+/**
+ * @brief Allocate the flat buffers of n parameters and create their tensors.
+ */
+cgrad_status cgrad_param_group_create(
+    const uint32_t* const* shapes,
+    const int* ndims,
+    int n,
+    const char* backend_name,
+    cgrad_param_group** out
+) {
+    if (!out || (n > 0 && (!shapes || !ndims))) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+    if (n <= 0) return CGRAD_ERR_OPTIM_INVALID_CONFIG;
+
+    // lay out the parameters back to back, each padded to the alignment
+    uint64_t* offsets = (uint64_t*)malloc((size_t)n * sizeof(uint64_t));
+    if (!offsets) return CGRAD_ERR_ALLOC_FAILED;
+    uint64_t total = 0;
+    for (int i = 0; i < n; i++) {
+        if (!shapes[i]) {
+            free(offsets);
+            return CGRAD_ERR_NULL_POINTER;
+        }
+        if (ndims[i] < 1 || ndims[i] > TENSOR_DIM) {
+            free(offsets);
+            return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+        }
+        uint64_t size = 1;
+        for (int d = 0; d < ndims[i]; d++) size *= shapes[i][d];
+        offsets[i] = total;
+        total += (size + CGRAD_PARAM_GROUP_ALIGNMENT - 1) / CGRAD_PARAM_GROUP_ALIGNMENT * CGRAD_PARAM_GROUP_ALIGNMENT;
+        if (total > UINT32_MAX) {
+            free(offsets);
+            return CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE;
+        }
+    }
+
+    cgrad_param_group* group = (cgrad_param_group*)calloc(1, sizeof(cgrad_param_group));
+    if (!group) {
+        free(offsets);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    group->n = n;
+    group->num_elements = total;
+    group->params = (cgrad_tensor*)calloc((size_t)n, sizeof(cgrad_tensor));
+    group->offsets = offsets;
+
+    cgrad_status err = group->params ? CGRAD_SUCCESS : CGRAD_ERR_ALLOC_FAILED;
+    if (err == CGRAD_SUCCESS) {
+        err = param_group_alloc_flat(total, backend_name, &group->flat, NULL);
+        group->has_flat = err == CGRAD_SUCCESS;
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = param_group_alloc_flat(total, backend_name, &group->flat_grad, &group->grad_data);
+        group->has_flat_grad = err == CGRAD_SUCCESS;
+    }
+    for (int i = 0; i < n && err == CGRAD_SUCCESS; i++) {
+        err = param_group_init_param(group, shapes[i], ndims[i], offsets[i], &group->params[i]);
+        if (err == CGRAD_SUCCESS) group->num_tensors++;
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_param_group_free(group);
+        return err;
+    }
+
+    *out = group;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Get the number of parameters.
+ */
+int cgrad_param_group_num_params(const cgrad_param_group* group) {
+    return group ? group->n : 0;
+}
+
+/**
+ * @brief Get the parameter tensors.
+ */
+cgrad_tensor* cgrad_param_group_get_params(cgrad_param_group* group) {
+    return group ? group->params : NULL;
+}
+
+/**
+ * @brief Get the flat storage of all parameter values.
+ */
+cgrad_storage* cgrad_param_group_get_flat(cgrad_param_group* group) {
+    return group ? &group->flat : NULL;
+}
+
+/**
+ * @brief Get the flat storage of all gradients.
+ */
+cgrad_storage* cgrad_param_group_get_flat_grad(cgrad_param_group* group) {
+    return group ? &group->flat_grad : NULL;
+}
+
+/**
+ * @brief Get the number of elements of the flat buffers.
+ */
+uint64_t cgrad_param_group_num_elements(const cgrad_param_group* group) {
+    return group ? group->num_elements : 0;
+}
+
+/**
+ * @brief Get the start of a parameter in the flat buffers.
+ */
+uint64_t cgrad_param_group_get_offset(const cgrad_param_group* group, int index) {
+    if (!group || index < 0 || index >= group->n) return 0;
+    return group->offsets[index];
+}
+
+/**
+ * @brief Get the host memory of the flat gradient buffer.
+ */
+float* cgrad_param_group_get_grad_data(cgrad_param_group* group) {
+    return group ? group->grad_data : NULL;
+}
+
+/**
+ * @brief Zero all gradients with a single fill of the flat gradient buffer.
+ */
+cgrad_status cgrad_param_group_zero_grad(cgrad_param_group* group) {
+    if (!group) return CGRAD_ERR_NULL_POINTER;
+    return cgrad_storage_zero(&group->flat_grad);
+}
+
+/**
+ * @brief Compute the global L2 norm of all gradients in a single pass over the flat buffer.
+ */
+cgrad_status cgrad_param_group_grad_norm(cgrad_param_group* group, float* out_norm) {
+    if (!group || !out_norm) return CGRAD_ERR_NULL_POINTER;
+    const cgrad_storage* grads[1] = {&group->flat_grad};
+    double sum;
+    cgrad_status err = cgrad_storage_sum_squares(1, grads, &sum);
+    if (err != CGRAD_SUCCESS) return err;
+    *out_norm = (float)sqrt(sum);
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Clip all gradients by their global L2 norm.
+ */
+cgrad_status cgrad_param_group_clip_grad_norm(cgrad_param_group* group, float max_norm, float* out_norm) {
+    if (!group) return CGRAD_ERR_NULL_POINTER;
+    cgrad_storage* grads[1] = {&group->flat_grad};
+    return cgrad_storage_clip_grad_norm(1, grads, max_norm, out_norm);
+}
+
+/**
+ * @brief Free the parameter tensors and the group.
+ */
+void cgrad_param_group_free(cgrad_param_group* group) {
+    if (!group) return;
+    for (int i = 0; i < group->num_tensors; i++) cgrad_tensor_free(&group->params[i]);
+    if (group->has_flat_grad) cgrad_storage_free(&group->flat_grad);
+    if (group->has_flat) cgrad_storage_free(&group->flat);
+    free(group->params);
+    free(group->offsets);
+    free(group);
+}
@@ -0,0 +1,148 @@
+#include "profiler/cgrad_hooks.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+// ============================================================================
+// Subscriber List
+// ============================================================================
+
+struct cgrad_hook {
+    unsigned kinds;             /**< Mask of subscribed kinds, 0 once retired */
+    cgrad_hook_fn fn;
+    void* user_data;
+    cgrad_hook* next;
+    cgrad_hook* retired_next;   /**< Link in the retired list, next stays valid for dispatches */
+};
+
+int g_cgrad_hook_counts[CGRAD_HOOK_NUM_KINDS] = {0};
+
+// Dispatch walks the list without locks. Register and unregister are serialized by the writer
+// lock: unregistering unlinks the entry right away and moves it to the retired list, where it
+// stays until no dispatch that may have reached it is in flight.
+static cgrad_hook* g_hooks_head = NULL;
+static cgrad_hook* g_hooks_retired = NULL;
+static int g_hooks_in_flight = 0;
+static pthread_mutex_t g_hooks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void hooks_count(unsigned kinds, int delta) {
+    for (int k = 0; k < CGRAD_HOOK_NUM_KINDS; k++) {
+        if (kinds & CGRAD_HOOK_MASK(k)) __atomic_fetch_add(&g_cgrad_hook_counts[k], delta, __ATOMIC_RELAXED);
+    }
+}
+
+// Free the retired entries once no dispatch is in flight. Entries are unlinked before they are
+// retired, so dispatches starting later cannot reach them. Called with the writer lock held.
+static void hooks_reclaim(void) {
+    if (g_hooks_retired == NULL || __atomic_load_n(&g_hooks_in_flight, __ATOMIC_SEQ_CST) != 0) return;
+    cgrad_hook* hook = g_hooks_retired;
+    g_hooks_retired = NULL;
+    while (hook != NULL) {
+        cgrad_hook* next = hook->retired_next;
+        free(hook);
+        hook = next;
+    }
+}
+
+cgrad_status cgrad_hooks_register(unsigned kinds, cgrad_hook_fn fn, void* user_data, cgrad_hook** out_hook) {
+    if (fn == NULL) return CGRAD_ERR_NULL_POINTER;
+    kinds &= CGRAD_HOOK_MASK_ALL;
+    if (kinds == 0) return CGRAD_ERR_PROFILER_INVALID_HOOK;
+
+    cgrad_hook* hook = (cgrad_hook*)malloc(sizeof(cgrad_hook));
+    if (hook == NULL) return CGRAD_ERR_ALLOC_FAILED;
+    hook->kinds = kinds;
+    hook->fn = fn;
+    hook->user_data = user_data;
+
+    // publish the fully initialized entry at the head of the list
+    pthread_mutex_lock(&g_hooks_lock);
+    hooks_reclaim();
+    hook->next = g_hooks_head;
+    __atomic_store_n(&g_hooks_head, hook, __ATOMIC_SEQ_CST);
+    hooks_count(kinds, 1);
+    pthread_mutex_unlock(&g_hooks_lock);
+
+    if (out_hook) *out_hook = hook;
+    return CGRAD_SUCCESS;
+}
+
+cgrad_status cgrad_hooks_unregister(cgrad_hook* hook) {
+    if (hook == NULL) return CGRAD_ERR_NULL_POINTER;
+    pthread_mutex_lock(&g_hooks_lock);
+    unsigned kinds = __atomic_exchange_n(&hook->kinds, 0u, __ATOMIC_RELAXED);
+    if (kinds != 0) {
+        hooks_count(kinds, -1);
+
+        // unlink the entry; its next pointer stays intact for dispatches currently on it
+        cgrad_hook** link = &g_hooks_head;
+        while (*link != NULL && *link != hook) link = &(*link)->next;
+        if (*link == hook) __atomic_store_n(link, hook->next, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&g_hooks_in_flight, __ATOMIC_SEQ_CST) == 0) {
+            free(hook);
+        } else {
+            hook->retired_next = g_hooks_retired;
+            g_hooks_retired = hook;
+        }
+    }
+    hooks_reclaim();
+    pthread_mutex_unlock(&g_hooks_lock);
+    return CGRAD_SUCCESS;
+}
+
+void cgrad_hooks_clear(void) {
+    pthread_mutex_lock(&g_hooks_lock);
+    cgrad_hook* hook = __atomic_exchange_n(&g_hooks_head, NULL, __ATOMIC_SEQ_CST);
+    while (hook != NULL) {
+        cgrad_hook* next = hook->next;
+        hooks_count(hook->kinds, -1);
+        free(hook);
+        hook = next;
+    }
+    hook = g_hooks_retired;
+    g_hooks_retired = NULL;
+    while (hook != NULL) {
+        cgrad_hook* next = hook->retired_next;
+        free(hook);
+        hook = next;
+    }
+    pthread_mutex_unlock(&g_hooks_lock);
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+static uint64_t hooks_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void hooks_dispatch(const cgrad_hook_event* event) {
+    unsigned mask = CGRAD_HOOK_MASK(event->kind);
+    __atomic_fetch_add(&g_hooks_in_flight, 1, __ATOMIC_SEQ_CST);
+    cgrad_hook* hook = __atomic_load_n(&g_hooks_head, __ATOMIC_SEQ_CST);
+    while (hook != NULL) {
+        if (__atomic_load_n(&hook->kinds, __ATOMIC_RELAXED) & mask) hook->fn(event, hook->user_data);
+        hook = __atomic_load_n(&hook->next, __ATOMIC_SEQ_CST);
+    }
+    __atomic_fetch_sub(&g_hooks_in_flight, 1, __ATOMIC_SEQ_CST);
+}
+
+void cgrad_hooks_begin(cgrad_hook_event* event) {
+    event->stage = CGRAD_HOOK_PRE;
+    event->duration_ns = 0;
+    event->status = CGRAD_SUCCESS;
+    event->start_ns = hooks_now_ns();
+    hooks_dispatch(event);
+}
+
+void cgrad_hooks_end(cgrad_hook_event* event, cgrad_status status) {
+    event->stage = CGRAD_HOOK_POST;
+    event->duration_ns = hooks_now_ns() - event->start_ns;
+    event->status = status;
+    hooks_dispatch(event);
+}
@@ -0,0 +1,331 @@
+#include "profiler/cgrad_memory.h"
+#include "cgrad_status.h"
+#include "third_party/uthash.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// ============================================================================
+// Accounting State
+// ============================================================================
+
+typedef struct memory_record {
+    uuid_t storage_id;                  /**< Root storage uuid - hash key */
+    cgrad_memory_buffer buffer;
+    int backend_index;
+    uint64_t scope_id;                  /**< Scope the buffer was allocated in */
+    UT_hash_handle hh;
+} memory_record;
+
+typedef struct memory_graph {
+    uuid_t graph_id;                    /**< Hash key */
+    cgrad_memory_stats stats;
+    UT_hash_handle hh;
+} memory_graph;
+
+int g_cgrad_memory_enabled = 0;
+
+static pthread_mutex_t g_memory_lock = PTHREAD_MUTEX_INITIALIZER;
+static memory_record* g_memory_records = NULL;
+static memory_graph* g_memory_graphs = NULL;
+static cgrad_memory_snapshot g_memory_snapshot;
+static uint64_t g_memory_next_scope = 1;
+
+static __thread cgrad_memory_scope g_memory_scope;
+
+static void memory_clear(void) {
+    memory_record *record, *tmp_record;
+    HASH_ITER(hh, g_memory_records, record, tmp_record) {
+        HASH_DEL(g_memory_records, record);
+        free(record);
+    }
+    memory_graph *graph, *tmp_graph;
+    HASH_ITER(hh, g_memory_graphs, graph, tmp_graph) {
+        HASH_DEL(g_memory_graphs, graph);
+        free(graph);
+    }
+    memset(&g_memory_snapshot, 0, sizeof(g_memory_snapshot));
+}
+
+cgrad_status cgrad_memory_start(void) {
+    pthread_mutex_lock(&g_memory_lock);
+    memory_clear();
+    g_cgrad_memory_enabled = 1;
+    pthread_mutex_unlock(&g_memory_lock);
+    return CGRAD_SUCCESS;
+}
+
+void cgrad_memory_stop(void) {
+    pthread_mutex_lock(&g_memory_lock);
+    g_cgrad_memory_enabled = 0;
+    pthread_mutex_unlock(&g_memory_lock);
+}
+
+int cgrad_memory_is_enabled(void) {
+    return g_cgrad_memory_enabled;
+}
+
+void cgrad_memory_reset(void) {
+    pthread_mutex_lock(&g_memory_lock);
+    g_cgrad_memory_enabled = 0;
+    memory_clear();
+    pthread_mutex_unlock(&g_memory_lock);
+}
+
+// ============================================================================
+// Stats Updates (called with the lock held)
+// ============================================================================
+
+static void memory_stats_add(cgrad_memory_stats* stats, const cgrad_memory_buffer* buffer) {
+    stats->live_bytes += buffer->bytes;
+    stats->live_buffers++;
+    stats->num_allocs++;
+    stats->category_bytes[buffer->category] += buffer->bytes;
+    if (stats->live_bytes > stats->peak_bytes) stats->peak_bytes = stats->live_bytes;
+}
+
+static void memory_stats_remove(cgrad_memory_stats* stats, const cgrad_memory_buffer* buffer) {
+    stats->live_bytes -= buffer->bytes;
+    stats->live_buffers--;
+    stats->num_frees++;
+    stats->category_bytes[buffer->category] -= buffer->bytes;
+}
+
+static void memory_stats_move(cgrad_memory_stats* stats, const cgrad_memory_buffer* buffer, cgrad_memory_category category) {
+    stats->category_bytes[buffer->category] -= buffer->bytes;
+    stats->category_bytes[category] += buffer->bytes;
+}
+
+static int memory_backend_index(const char* name) {
+    cgrad_memory_snapshot* s = &g_memory_snapshot;
+    for (int i = 0; i < s->num_backends; i++) {
+        if (s->backend_names[i] == name || strcmp(s->backend_names[i], name) == 0) return i;
+    }
+    if (s->num_backends == CGRAD_MEMORY_MAX_BACKENDS) return -1;
+    s->backend_names[s->num_backends] = name;
+    return s->num_backends++;
+}
+
+static memory_graph* memory_find_graph(const uuid_t graph_id, int create) {
+    memory_graph* graph = NULL;
+    HASH_FIND(hh, g_memory_graphs, graph_id, sizeof(uuid_t), graph);
+    if (graph == NULL && create) {
+        graph = (memory_graph*)calloc(1, sizeof(memory_graph));
+        if (graph == NULL) return NULL;
+        uuid_copy(graph->graph_id, graph_id);
+        HASH_ADD(hh, g_memory_graphs, graph_id, sizeof(uuid_t), graph);
+    }
+    return graph;
+}
+
+// ============================================================================
+// Instrumentation
+// ============================================================================
+
+void cgrad_memory_push_scope(cgrad_memory_category category, const uuid_t graph_id, const uuid_t node_id, cgrad_memory_scope* out_previous) {
+    *out_previous = g_memory_scope;
+    g_memory_scope.id = __atomic_fetch_add(&g_memory_next_scope, 1, __ATOMIC_RELAXED);
+    g_memory_scope.category = category;
+    uuid_copy(g_memory_scope.graph_id, graph_id);
+    uuid_copy(g_memory_scope.node_id, node_id);
+}
+
+void cgrad_memory_pop_scope(const cgrad_memory_scope* previous) {
+    g_memory_scope = *previous;
+}
+
+static void memory_record_buffer(const cgrad_storage* t, uint64_t bytes, int external) {
+    memory_record* record = (memory_record*)calloc(1, sizeof(memory_record));
+    if (record == NULL) return;     // leave the buffer unaccounted rather than fail the allocation
+    uuid_copy(record->storage_id, t->uuid);
+    cgrad_memory_buffer* buffer = &record->buffer;
+    uuid_copy(buffer->storage_id, t->uuid);
+    buffer->bytes = bytes;
+    buffer->backend_name = t->backend->name;
+    memcpy(buffer->shape, t->backend->storage_get_layout(t->data)->shape, sizeof(buffer->shape));
+    // wrapped memory keeps its category, also when wrapped while a node runs
+    record->scope_id = external ? 0 : g_memory_scope.id;
+    buffer->category = external ? CGRAD_MEMORY_EXTERNAL : CGRAD_MEMORY_OTHER;
+    if (g_memory_scope.id != 0) {
+        buffer->has_node = 1;
+        if (!external) buffer->category = g_memory_scope.category;
+        uuid_copy(buffer->graph_id, g_memory_scope.graph_id);
+        uuid_copy(buffer->node_id, g_memory_scope.node_id);
+    }
+
+    pthread_mutex_lock(&g_memory_lock);
+    if (!g_cgrad_memory_enabled || (record->backend_index = memory_backend_index(buffer->backend_name)) < 0) {
+        pthread_mutex_unlock(&g_memory_lock);
+        free(record);
+        return;
+    }
+    HASH_ADD(hh, g_memory_records, storage_id, sizeof(uuid_t), record);
+    memory_stats_add(&g_memory_snapshot.backends[record->backend_index], buffer);
+    memory_stats_add(&g_memory_snapshot.total, buffer);
+    if (buffer->has_node) {
+        memory_graph* graph = memory_find_graph(buffer->graph_id, 1);
+        if (graph) memory_stats_add(&graph->stats, buffer);
+    }
+    pthread_mutex_unlock(&g_memory_lock);
+}
+
+void cgrad_memory_record_alloc(const cgrad_storage* t, uint64_t bytes) {
+    memory_record_buffer(t, bytes, 0);
+}
+
+void cgrad_memory_record_wrap(const cgrad_storage* t, uint64_t bytes) {
+    memory_record_buffer(t, bytes, 1);
+}
+
+void cgrad_memory_record_free(const uuid_t root_id) {
+    pthread_mutex_lock(&g_memory_lock);
+    memory_record* record = NULL;
+    if (g_cgrad_memory_enabled) HASH_FIND(hh, g_memory_records, root_id, sizeof(uuid_t), record);
+    if (record != NULL) {
+        HASH_DEL(g_memory_records, record);
+        memory_stats_remove(&g_memory_snapshot.backends[record->backend_index], &record->buffer);
+        memory_stats_remove(&g_memory_snapshot.total, &record->buffer);
+        memory_graph* graph = record->buffer.has_node ? memory_find_graph(record->buffer.graph_id, 0) : NULL;
+        if (graph) memory_stats_remove(&graph->stats, &record->buffer);
+    }
+    pthread_mutex_unlock(&g_memory_lock);
+    free(record);
+}
+
+void cgrad_memory_tag_storage(const cgrad_storage* t, cgrad_memory_category category) {
+    uuid_t root_id;
+    if (g_memory_scope.id == 0 || cgrad_storage_get_root_uuid(t, root_id) != CGRAD_SUCCESS) return;
+
+    pthread_mutex_lock(&g_memory_lock);
+    memory_record* record = NULL;
+    if (g_cgrad_memory_enabled) HASH_FIND(hh, g_memory_records, root_id, sizeof(uuid_t), record);
+    // views of buffers allocated elsewhere (e.g. the input of a reshape) keep their category
+    if (record != NULL && record->scope_id == g_memory_scope.id && record->buffer.category != category) {
+        memory_stats_move(&g_memory_snapshot.backends[record->backend_index], &record->buffer, category);
+        memory_stats_move(&g_memory_snapshot.total, &record->buffer, category);
+        memory_graph* graph = memory_find_graph(record->buffer.graph_id, 0);
+        if (graph) memory_stats_move(&graph->stats, &record->buffer, category);
+        record->buffer.category = category;
+    }
+    pthread_mutex_unlock(&g_memory_lock);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+cgrad_status cgrad_memory_get_snapshot(cgrad_memory_snapshot* out_snapshot) {
+    if (out_snapshot == NULL) return CGRAD_ERR_NULL_POINTER;
+    pthread_mutex_lock(&g_memory_lock);
+    *out_snapshot = g_memory_snapshot;
+    pthread_mutex_unlock(&g_memory_lock);
+    return CGRAD_SUCCESS;
+}
+
+cgrad_status cgrad_memory_get_graph_stats(const uuid_t graph_id, cgrad_memory_stats* out_stats) {
+    if (out_stats == NULL) return CGRAD_ERR_NULL_POINTER;
+    pthread_mutex_lock(&g_memory_lock);
+    memory_graph* graph = memory_find_graph(graph_id, 0);
+    if (graph) {
+        *out_stats = graph->stats;
+    } else {
+        memset(out_stats, 0, sizeof(*out_stats));
+    }
+    pthread_mutex_unlock(&g_memory_lock);
+    return CGRAD_SUCCESS;
+}
+
+static int memory_compare_bytes(const void* a, const void* b) {
+    uint64_t x = ((const cgrad_memory_buffer*)a)->bytes, y = ((const cgrad_memory_buffer*)b)->bytes;
+    return x < y ? 1 : (x > y ? -1 : 0);
+}
+
+cgrad_status cgrad_memory_get_top_buffers(cgrad_memory_buffer* out_buffers, int max_buffers, int* out_num_buffers) {
+    if (out_num_buffers == NULL || (out_buffers == NULL && max_buffers > 0)) return CGRAD_ERR_NULL_POINTER;
+    *out_num_buffers = 0;
+
+    pthread_mutex_lock(&g_memory_lock);
+    size_t n = HASH_COUNT(g_memory_records);
+    cgrad_memory_buffer* all = n > 0 ? (cgrad_memory_buffer*)malloc(n * sizeof(cgrad_memory_buffer)) : NULL;
+    if (n > 0 && all == NULL) {
+        pthread_mutex_unlock(&g_memory_lock);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    size_t i = 0;
+    memory_record *record, *tmp;
+    HASH_ITER(hh, g_memory_records, record, tmp) {
+        all[i++] = record->buffer;
+    }
+    pthread_mutex_unlock(&g_memory_lock);
+
+    if (n > 1) qsort(all, n, sizeof(cgrad_memory_buffer), memory_compare_bytes);
+    int count = n < (size_t)max_buffers ? (int)n : max_buffers;
+    if (count > 0) memcpy(out_buffers, all, (size_t)count * sizeof(cgrad_memory_buffer));
+    *out_num_buffers = count;
+    free(all);
+    return CGRAD_SUCCESS;
+}
+
+static const char* memory_category_name(cgrad_memory_category category) {
+    switch (category) {
+        case CGRAD_MEMORY_ACTIVATION: return "activation";
+        case CGRAD_MEMORY_GRADIENT: return "gradient";
+        case CGRAD_MEMORY_TEMPORARY: return "temporary";
+        case CGRAD_MEMORY_EXTERNAL: return "external";
+        default: return "other";
+    }
+}
+
+static void memory_print_stats(const char* name, const cgrad_memory_stats* stats) {
+    printf("%-10s live: %llu B in %llu buffers  peak: %llu B  allocs: %llu  frees: %llu\n", name,
+        (unsigned long long)stats->live_bytes, (unsigned long long)stats->live_buffers,
+        (unsigned long long)stats->peak_bytes, (unsigned long long)stats->num_allocs,
+        (unsigned long long)stats->num_frees);
+    for (int c = 0; c < CGRAD_MEMORY_NUM_CATEGORIES; c++) {
+        printf("  %-10s %llu B\n", memory_category_name((cgrad_memory_category)c), (unsigned long long)stats->category_bytes[c]);
+    }
+}
+
+// Shape without the leading 1s of the right-aligned layout, e.g. (32, 64)
+static void memory_print_shape(const uint32_t* shape) {
+    int first = 0;
+    while (first < TENSOR_DIM - 1 && shape[first] == 1) first++;
+    printf("(");
+    for (int d = first; d < TENSOR_DIM; d++) {
+        printf(d > first ? ", %u" : "%u", shape[d]);
+    }
+    printf(")");
+}
+
+void cgrad_memory_print(int n) {
+    cgrad_memory_snapshot snapshot;
+    cgrad_memory_get_snapshot(&snapshot);
+    for (int i = 0; i < snapshot.num_backends; i++) {
+        memory_print_stats(snapshot.backend_names[i], &snapshot.backends[i]);
+    }
+    memory_print_stats("total", &snapshot.total);
+
+    if (n <= 0) return;
+    cgrad_memory_buffer* buffers = (cgrad_memory_buffer*)malloc((size_t)n * sizeof(cgrad_memory_buffer));
+    int count = 0;
+    if (buffers == NULL || cgrad_memory_get_top_buffers(buffers, n, &count) != CGRAD_SUCCESS) {
+        free(buffers);
+        return;
+    }
+    printf("Top %d live buffers:\n", count);
+    char uuid_str[37];
+    for (int i = 0; i < count; i++) {
+        const cgrad_memory_buffer* b = &buffers[i];
+        uuid_unparse(b->storage_id, uuid_str);
+        printf("  %12llu B  %-10s %-8s %s  Shape: ", (unsigned long long)b->bytes,
+            memory_category_name(b->category), b->backend_name, uuid_str);
+        memory_print_shape(b->shape);
+        if (b->has_node) {
+            uuid_unparse(b->node_id, uuid_str);
+            printf("  node: %s", uuid_str);
+        }
+        printf("\n");
+    }
+    free(buffers);
+}
@@ -0,0 +1,177 @@
+#include "profiler/cgrad_perf.h"
+#include "cgrad_status.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Counter Definitions
+// ============================================================================
+
+typedef struct perf_event_def {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+    int vector;                 /**< 1 for the model specific FP counters */
+} perf_event_def;
+
+// FP_ARITH_INST_RETIRED (event 0xc7): umask 0x02 scalar single, 0x08 | 0x20 | 0x80 packed
+// single over 128, 256 and 512 bit vectors
+static const perf_event_def g_perf_events[CGRAD_PERF_NUM_COUNTERS] = {
+    [CGRAD_PERF_CYCLES]           = {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 0},
+    [CGRAD_PERF_INSTRUCTIONS]     = {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 0},
+    [CGRAD_PERF_CACHE_REFERENCES] = {"cache_references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, 0},
+    [CGRAD_PERF_CACHE_MISSES]     = {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 0},
+    [CGRAD_PERF_BRANCH_MISSES]    = {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 0},
+    [CGRAD_PERF_FP_SCALAR]        = {"fp_scalar", PERF_TYPE_RAW, 0x02c7, 1},
+    [CGRAD_PERF_FP_PACKED]        = {"fp_packed", PERF_TYPE_RAW, 0xa8c7, 1},
+    [CGRAD_PERF_TASK_CLOCK_NS]    = {"task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, 0},
+    [CGRAD_PERF_PAGE_FAULTS]      = {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, 0},
+};
+
+// File descriptors opened by the calling thread: one row of CGRAD_PERF_NUM_COUNTERS per thread
+// of the process, -1 if unavailable
+static __thread int* g_perf_fds = NULL;
+static __thread int g_perf_num_threads = 0;
+static __thread int g_perf_open = 0;
+
+const char* cgrad_perf_counter_name(cgrad_perf_counter counter) {
+    if (counter < 0 || counter >= CGRAD_PERF_NUM_COUNTERS) return "unknown";
+    return g_perf_events[counter].name;
+}
+
+// ============================================================================
+// Open / Close
+// ============================================================================
+
+static int perf_open_event(const perf_event_def* def, pid_t tid) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = def->type;
+    attr.config = def->config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;           // also count the threads the thread starts later
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+}
+
+// Thread ids of the process; only the calling thread (0) if /proc is not available
+static int perf_list_threads(pid_t** out_tids) {
+    int n = 0, capacity = 0;
+    pid_t* tids = NULL;
+    DIR* dir = opendir("/proc/self/task");
+    struct dirent* entry;
+    while (dir != NULL && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+        if (n == capacity) {
+            capacity = capacity ? 2 * capacity : 16;
+            pid_t* grown = (pid_t*)realloc(tids, (size_t)capacity * sizeof(pid_t));
+            if (grown == NULL) break;
+            tids = grown;
+        }
+        tids[n++] = (pid_t)atoi(entry->d_name);
+    }
+    if (dir != NULL) closedir(dir);
+    if (n == 0) {
+        free(tids);
+        tids = (pid_t*)malloc(sizeof(pid_t));
+        if (tids == NULL) return 0;
+        tids[n++] = 0;
+    }
+    *out_tids = tids;
+    return n;
+}
+
+cgrad_status cgrad_perf_open(int vector_events) {
+    if (g_perf_open) cgrad_perf_close();
+
+    // threads started before the counters are opened (the backend workers and the BLAS threads
+    // of an earlier kernel) get counters of their own; inheritance only covers later ones
+    pid_t* tids = NULL;
+    int num_threads = perf_list_threads(&tids);
+    if (num_threads == 0) return CGRAD_ERR_PROFILER_PERF_UNAVAILABLE;
+    g_perf_fds = (int*)malloc((size_t)num_threads * CGRAD_PERF_NUM_COUNTERS * sizeof(int));
+    if (g_perf_fds == NULL) {
+        free(tids);
+        return CGRAD_ERR_PROFILER_PERF_UNAVAILABLE;
+    }
+    g_perf_num_threads = num_threads;
+
+    int num_open = 0;
+    for (int c = 0; c < CGRAD_PERF_NUM_COUNTERS; c++) {
+        int opened = 0;
+        for (int t = 0; t < num_threads; t++) {
+            int* fd = &g_perf_fds[t * CGRAD_PERF_NUM_COUNTERS + c];
+            *fd = -1;
+            if (g_perf_events[c].vector && !vector_events) continue;
+            *fd = perf_open_event(&g_perf_events[c], tids[t]);
+            opened |= *fd >= 0;
+        }
+        num_open += opened;
+    }
+    free(tids);
+    g_perf_open = 1;
+    if (num_open == 0) {
+        cgrad_perf_close();
+        return CGRAD_ERR_PROFILER_PERF_UNAVAILABLE;
+    }
+    return CGRAD_SUCCESS;
+}
+
+void cgrad_perf_close(void) {
+    if (!g_perf_open) return;
+    for (int i = 0; i < g_perf_num_threads * CGRAD_PERF_NUM_COUNTERS; i++) {
+        if (g_perf_fds[i] >= 0) close(g_perf_fds[i]);
+    }
+    free(g_perf_fds);
+    g_perf_fds = NULL;
+    g_perf_num_threads = 0;
+    g_perf_open = 0;
+}
+
+int cgrad_perf_is_open(void) {
+    return g_perf_open;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+cgrad_status cgrad_perf_read(cgrad_perf_counts* out_counts) {
+    if (out_counts == NULL) return CGRAD_ERR_NULL_POINTER;
+    memset(out_counts, 0, sizeof(*out_counts));
+    if (!g_perf_open) return CGRAD_ERR_PROFILER_PERF_UNAVAILABLE;
+
+    for (int c = 0; c < CGRAD_PERF_NUM_COUNTERS; c++) {
+        for (int t = 0; t < g_perf_num_threads; t++) {
+            // value, time enabled, time running
+            uint64_t data[3];
+            int fd = g_perf_fds[t * CGRAD_PERF_NUM_COUNTERS + c];
+            if (fd < 0 || read(fd, data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+            if (data[2] == 0) continue;     // never scheduled on the PMU
+            // extrapolate counters that shared the PMU with other events
+            out_counts->values[c] += data[2] < data[1]
+                ? (uint64_t)((double)data[0] * ((double)data[1] / (double)data[2]))
+                : data[0];
+            out_counts->available |= 1u << c;
+        }
+    }
+    return CGRAD_SUCCESS;
+}
+
+void cgrad_perf_diff(const cgrad_perf_counts* start, const cgrad_perf_counts* end, cgrad_perf_counts* out_delta) {
+    cgrad_perf_counts delta;
+    delta.available = start->available & end->available;
+    for (int c = 0; c < CGRAD_PERF_NUM_COUNTERS; c++) {
+        delta.values[c] = (delta.available & (1u << c)) && end->values[c] > start->values[c]
+            ? end->values[c] - start->values[c]
+            : 0;
+    }
+    *out_delta = delta;
+}
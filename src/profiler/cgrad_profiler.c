@@ -0,0 +1,221 @@
+#include "profiler/cgrad_profiler.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// ============================================================================
+// Profiler State
+// ============================================================================
+
+int g_cgrad_profiler_enabled = 0;
+
+static cgrad_profiler_event* g_profiler_events = NULL;
+static int g_profiler_num_events = 0;
+static int g_profiler_capacity = 0;
+static uint64_t g_profiler_origin_ns = 0;
+static uint64_t g_profiler_allocated = 0;
+
+static uint64_t profiler_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+cgrad_status cgrad_profiler_start(void) {
+    g_profiler_num_events = 0;
+    g_profiler_origin_ns = profiler_now_ns();
+    g_cgrad_profiler_enabled = 1;
+    return CGRAD_SUCCESS;
+}
+
+void cgrad_profiler_stop(void) {
+    g_cgrad_profiler_enabled = 0;
+}
+
+int cgrad_profiler_is_enabled(void) {
+    return g_cgrad_profiler_enabled;
+}
+
+void cgrad_profiler_reset(void) {
+    g_cgrad_profiler_enabled = 0;
+    free(g_profiler_events);
+    g_profiler_events = NULL;
+    g_profiler_num_events = 0;
+    g_profiler_capacity = 0;
+}
+
+const cgrad_profiler_event* cgrad_profiler_get_events(int* out_num_events) {
+    if (out_num_events) *out_num_events = g_profiler_num_events;
+    return g_profiler_num_events > 0 ? g_profiler_events : NULL;
+}
+
+// ============================================================================
+// Cost Estimates
+// ============================================================================
+
+static uint64_t profiler_numel(const uint32_t* shape) {
+    uint64_t n = 1;
+    for (int d = 0; d < TENSOR_DIM; d++) n *= shape[d];
+    return n;
+}
+
+static int profiler_is_view(const char* name) {
+    return strcmp(name, "TRANSPOSE") == 0 || strcmp(name, "RESHAPE") == 0
+        || strcmp(name, "SLICE") == 0 || strcmp(name, "SELECT") == 0;
+}
+
+// Forward FLOPs of an op; the backward pass of every op is counted as twice its forward pass
+static uint64_t profiler_forward_flops(const char* name, const cgrad_profiler_event* e) {
+    uint64_t out = profiler_numel(e->output_shape);
+    const uint32_t* in0 = e->input_shapes[0];
+    if (strcmp(name, "GEMM") == 0) {
+        return e->num_inputs > 0 ? 2 * out * in0[TENSOR_DIM - 1] : 0;
+    }
+    if (strcmp(name, "CONV2D") == 0) {
+        // weight (O, C, KH, KW): one multiply-add per output element and C * KH * KW taps
+        const uint32_t* w = e->input_shapes[1];
+        return e->num_inputs > 1 ? 2 * out * w[TENSOR_DIM - 3] * w[TENSOR_DIM - 2] * w[TENSOR_DIM - 1] : 0;
+    }
+    if (strcmp(name, "AXPY") == 0) return 2 * out;
+    if (strcmp(name, "SOFTMAX") == 0 || strcmp(name, "LOG_SOFTMAX") == 0) return 4 * out;
+    if (strcmp(name, "SOFTMAX_CROSS_ENTROPY") == 0) return e->num_inputs > 0 ? 4 * profiler_numel(in0) : 0;
+    if (strcmp(name, "REDUCE_SUM") == 0) return e->num_inputs > 0 ? profiler_numel(in0) : 0;
+    if (profiler_is_view(name) || strcmp(name, "CAT") == 0) return 0;
+    return out;     // MUL and the unary ops
+}
+
+// ============================================================================
+// Instrumentation
+// ============================================================================
+
+void cgrad_profiler_begin(cgrad_profiler_span* span) {
+    span->allocated = __atomic_load_n(&g_profiler_allocated, __ATOMIC_RELAXED);
+    span->perf.available = 0;
+    if (cgrad_perf_is_open()) cgrad_perf_read(&span->perf);
+    span->start_ns = profiler_now_ns();
+}
+
+void cgrad_profiler_end(
+    const cgrad_profiler_span* span,
+    cgrad_profiler_phase phase,
+    const char* name,
+    const cgrad_storage_layout* const* inputs,
+    int num_inputs,
+    const cgrad_storage_layout* output
+) {
+    uint64_t end_ns = profiler_now_ns();
+    cgrad_perf_counts perf = {{0}, 0};
+    if (span->perf.available) cgrad_perf_read(&perf);
+    if (g_profiler_num_events == g_profiler_capacity) {
+        int capacity = g_profiler_capacity ? 2 * g_profiler_capacity : 256;
+        cgrad_profiler_event* events = (cgrad_profiler_event*)realloc(g_profiler_events, (size_t)capacity * sizeof(cgrad_profiler_event));
+        if (events == NULL) return;     // drop the event rather than fail the pass
+        g_profiler_events = events;
+        g_profiler_capacity = capacity;
+    }
+
+    cgrad_profiler_event* e = &g_profiler_events[g_profiler_num_events++];
+    memset(e, 0, sizeof(*e));
+    e->name = name;
+    e->phase = phase;
+    e->num_inputs = num_inputs;
+    uint64_t input_elements = 0;
+    for (int i = 0; i < num_inputs; i++) {
+        if (i < CGRAD_PROFILER_MAX_INPUTS) memcpy(e->input_shapes[i], inputs[i]->shape, sizeof(e->input_shapes[i]));
+        input_elements += profiler_numel(inputs[i]->shape);
+    }
+    memcpy(e->output_shape, output->shape, sizeof(e->output_shape));
+    e->start_ns = span->start_ns - g_profiler_origin_ns;
+    e->duration_ns = end_ns - span->start_ns;
+    e->bytes_allocated = __atomic_load_n(&g_profiler_allocated, __ATOMIC_RELAXED) - span->allocated;
+    cgrad_perf_diff(&span->perf, &perf, &e->perf);
+
+    // forward reads the inputs and writes the output, backward also reads the output gradient
+    // and updates the input gradients
+    uint64_t bytes = (input_elements + profiler_numel(e->output_shape)) * sizeof(float);
+    e->flops = profiler_forward_flops(name, e);
+    if (phase == CGRAD_PROFILER_BACKWARD) {
+        e->flops *= 2;
+        e->bytes_moved = 2 * bytes;
+    } else {
+        e->bytes_moved = profiler_is_view(name) ? 0 : bytes;
+    }
+}
+
+void cgrad_profiler_add_allocation(uint64_t bytes) {
+    __atomic_fetch_add(&g_profiler_allocated, bytes, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// Chrome Trace Export
+// ============================================================================
+
+// Shape without the leading 1s of the right-aligned layout, e.g. [32,64]
+static void profiler_write_shape(FILE* f, const uint32_t* shape) {
+    int first = 0;
+    while (first < TENSOR_DIM - 1 && shape[first] == 1) first++;
+    fputc('[', f);
+    for (int d = first; d < TENSOR_DIM; d++) {
+        fprintf(f, d > first ? ",%u" : "%u", shape[d]);
+    }
+    fputc(']', f);
+}
+
+// Available counters, instructions per cycle and the share of packed FP instructions
+static void profiler_write_perf(FILE* f, const cgrad_perf_counts* perf) {
+    for (int c = 0; c < CGRAD_PERF_NUM_COUNTERS; c++) {
+        if (perf->available & (1u << c)) {
+            fprintf(f, ",\"%s\":%llu", cgrad_perf_counter_name((cgrad_perf_counter)c), (unsigned long long)perf->values[c]);
+        }
+    }
+    const uint64_t* v = perf->values;
+    unsigned ipc_mask = (1u << CGRAD_PERF_CYCLES) | (1u << CGRAD_PERF_INSTRUCTIONS);
+    if ((perf->available & ipc_mask) == ipc_mask && v[CGRAD_PERF_CYCLES] > 0) {
+        fprintf(f, ",\"ipc\":%.3f", (double)v[CGRAD_PERF_INSTRUCTIONS] / (double)v[CGRAD_PERF_CYCLES]);
+    }
+    unsigned fp_mask = (1u << CGRAD_PERF_FP_SCALAR) | (1u << CGRAD_PERF_FP_PACKED);
+    uint64_t fp = v[CGRAD_PERF_FP_SCALAR] + v[CGRAD_PERF_FP_PACKED];
+    if ((perf->available & fp_mask) == fp_mask && fp > 0) {
+        fprintf(f, ",\"vector_ratio\":%.3f", (double)v[CGRAD_PERF_FP_PACKED] / (double)fp);
+    }
+}
+
+cgrad_status cgrad_profiler_write_chrome_trace(const char* path) {
+    if (path == NULL) return CGRAD_ERR_NULL_POINTER;
+    FILE* f = fopen(path, "w");
+    if (f == NULL) return CGRAD_ERR_PROFILER_IO;
+
+    int pid = (int)getpid();
+    fprintf(f, "{\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"cgrad\"}}", pid);
+    for (int i = 0; i < g_profiler_num_events; i++) {
+        const cgrad_profiler_event* e = &g_profiler_events[i];
+        // timestamps in microseconds
+        fprintf(
+            f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":0,\"args\":{\"inputs\":[",
+            e->name, e->phase == CGRAD_PROFILER_FORWARD ? "forward" : "backward",
+            (double)e->start_ns / 1e3, (double)e->duration_ns / 1e3, pid
+        );
+        int shown = e->num_inputs < CGRAD_PROFILER_MAX_INPUTS ? e->num_inputs : CGRAD_PROFILER_MAX_INPUTS;
+        for (int j = 0; j < shown; j++) {
+            if (j > 0) fputc(',', f);
+            profiler_write_shape(f, e->input_shapes[j]);
+        }
+        fprintf(f, "],\"output\":");
+        profiler_write_shape(f, e->output_shape);
+        fprintf(
+            f, ",\"flops\":%llu,\"bytes_moved\":%llu,\"bytes_allocated\":%llu",
+            (unsigned long long)e->flops, (unsigned long long)e->bytes_moved, (unsigned long long)e->bytes_allocated
+        );
+        profiler_write_perf(f, &e->perf);
+        fprintf(f, "}}");
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+    int failed = ferror(f);
+    if (fclose(f) != 0) failed = 1;
+    return failed ? CGRAD_ERR_PROFILER_IO : CGRAD_SUCCESS;
+}
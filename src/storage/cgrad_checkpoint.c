@@ -0,0 +1,243 @@
+#include "storage/cgrad_checkpoint.h"
+#include "storage/cgrad_storage_file.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+struct cgrad_checkpoint {
+    pthread_t thread;
+    int joined;                     /**< 1 once the writer thread has been joined (or never started) */
+    int done;                       /**< Set by the writer thread when it finishes, read atomically */
+    char* path;
+    void* buffer;                   /**< Staging buffer holding the file image, released by the writer */
+    uint64_t capacity;              /**< Size of the staging buffer in bytes */
+    uint64_t size;                  /**< Size of the file image in bytes */
+    cgrad_status status;            /**< Result of the write, valid once done */
+    cgrad_checkpoint_stats stats;
+};
+
+// Staging buffer of the last finished checkpoint. Periodic checkpoints of the same parameters
+// reuse it instead of page-faulting a fresh allocation on every snapshot, so in steady state one
+// buffer is being written while the other one is ready for the next snapshot.
+static pthread_mutex_t g_checkpoint_spare_lock = PTHREAD_MUTEX_INITIALIZER;
+static void* g_checkpoint_spare = NULL;
+static uint64_t g_checkpoint_spare_capacity = 0;
+
+// Get a staging buffer of at least size bytes, preferring the spare one
+static void* checkpoint_buffer_acquire(uint64_t size, uint64_t* out_capacity) {
+    void* buffer = NULL;
+    pthread_mutex_lock(&g_checkpoint_spare_lock);
+    if (g_checkpoint_spare && g_checkpoint_spare_capacity >= size) {
+        buffer = g_checkpoint_spare;
+        *out_capacity = g_checkpoint_spare_capacity;
+        g_checkpoint_spare = NULL;
+        g_checkpoint_spare_capacity = 0;
+    }
+    pthread_mutex_unlock(&g_checkpoint_spare_lock);
+    if (buffer) return buffer;
+
+    // the image size is a multiple of the alignment, as required by aligned_alloc
+    *out_capacity = size;
+    return aligned_alloc(CGRAD_STORAGE_FILE_ALIGNMENT, (size_t)size);
+}
+
+// Keep a staging buffer as spare if it is larger than the current one, free the other
+static void checkpoint_buffer_release(void* buffer, uint64_t capacity) {
+    pthread_mutex_lock(&g_checkpoint_spare_lock);
+    if (capacity > g_checkpoint_spare_capacity) {
+        void* old = g_checkpoint_spare;
+        g_checkpoint_spare = buffer;
+        g_checkpoint_spare_capacity = capacity;
+        buffer = old;
+    }
+    pthread_mutex_unlock(&g_checkpoint_spare_lock);
+    free(buffer);
+}
+
+static double checkpoint_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Write the whole buffer in chunks of CGRAD_CHECKPOINT_WRITE_CHUNK, resuming partial writes
+static int checkpoint_write_all(int fd, const char* data, uint64_t size) {
+    while (size > 0) {
+        size_t chunk = size < CGRAD_CHECKPOINT_WRITE_CHUNK ? (size_t)size : CGRAD_CHECKPOINT_WRITE_CHUNK;
+        ssize_t written = write(fd, data, chunk);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        data += written;
+        size -= (uint64_t)written;
+    }
+    return 1;
+}
+
+// fsync the directory containing path, making a rename into it durable
+static int checkpoint_sync_dir(const char* path) {
+    const char* slash = strrchr(path, '/');
+    char* dir;
+    if (!slash) {
+        dir = strdup(".");
+    } else if (slash == path) {
+        dir = strdup("/");
+    } else {
+        dir = strndup(path, (size_t)(slash - path));
+    }
+    if (!dir) return 0;
+    int fd = open(dir, O_RDONLY);
+    free(dir);
+    if (fd < 0) return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+// Stream the staging buffer to path.tmp, sync it and rename it to path
+static void checkpoint_write(cgrad_checkpoint* ckpt) {
+    size_t path_len = strlen(ckpt->path);
+    char* tmp_path = (char*)malloc(path_len + 5);
+    cgrad_status err = CGRAD_ERR_STORAGE_FILE_IO;
+    if (tmp_path) {
+        memcpy(tmp_path, ckpt->path, path_len);
+        memcpy(tmp_path + path_len, ".tmp", 5);
+
+        int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            double t0 = checkpoint_now();
+            int ok = checkpoint_write_all(fd, (const char*)ckpt->buffer, ckpt->size);
+            double t1 = checkpoint_now();
+            int synced = ok && fsync(fd) == 0;
+            double t2 = checkpoint_now();
+            if (close(fd) != 0) ok = 0;
+            if (ok && rename(tmp_path, ckpt->path) == 0) {
+                err = CGRAD_SUCCESS;
+                synced = checkpoint_sync_dir(ckpt->path) && synced;
+            } else {
+                unlink(tmp_path);
+            }
+            double t3 = checkpoint_now();
+
+            ckpt->stats.write_seconds = t1 - t0;
+            ckpt->stats.sync_seconds = (t2 - t1) + (t3 - t2);
+            ckpt->stats.durable = err == CGRAD_SUCCESS && synced;
+            double seconds = ckpt->stats.write_seconds + ckpt->stats.sync_seconds;
+            if (err == CGRAD_SUCCESS && seconds > 0.0) {
+                ckpt->stats.throughput = (double)ckpt->size / seconds;
+            }
+        }
+        free(tmp_path);
+    }
+
+    // the snapshot is no longer needed, release it before anyone waits for the handle
+    checkpoint_buffer_release(ckpt->buffer, ckpt->capacity);
+    ckpt->buffer = NULL;
+    ckpt->status = err;
+    __atomic_store_n(&ckpt->done, 1, __ATOMIC_RELEASE);
+}
+
+static void* checkpoint_worker(void* arg) {
+    checkpoint_write((cgrad_checkpoint*)arg);
+    return NULL;
+}
+
+/**
+ * @brief Snapshot storages and write them to a tensor file in the background.
+ */
+cgrad_status cgrad_checkpoint_save_async(
+    const char* path,
+    const char* const* names,
+    const cgrad_storage* const* storages,
+    int n,
+    cgrad_checkpoint** out
+) {
+    if (!path || !out) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+
+    double t0 = checkpoint_now();
+    uint64_t size;
+    cgrad_status err = cgrad_storage_serialized_size(names, storages, n, &size);
+    if (err != CGRAD_SUCCESS) return err;
+
+    cgrad_checkpoint* ckpt = (cgrad_checkpoint*)calloc(1, sizeof(cgrad_checkpoint));
+    if (!ckpt) return CGRAD_ERR_ALLOC_FAILED;
+    ckpt->path = strdup(path);
+    ckpt->buffer = checkpoint_buffer_acquire(size, &ckpt->capacity);
+    ckpt->size = size;
+    if (!ckpt->path || !ckpt->buffer) {
+        free(ckpt->buffer);
+        free(ckpt->path);
+        free(ckpt);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+
+    err = cgrad_storage_serialize(names, storages, n, ckpt->buffer, size);
+    if (err != CGRAD_SUCCESS) {
+        checkpoint_buffer_release(ckpt->buffer, ckpt->capacity);
+        free(ckpt->path);
+        free(ckpt);
+        return err;
+    }
+    ckpt->stats.bytes = size;
+    ckpt->stats.snapshot_seconds = checkpoint_now() - t0;
+
+    // without a writer thread the checkpoint is still written, just synchronously
+    if (pthread_create(&ckpt->thread, NULL, checkpoint_worker, ckpt) != 0) {
+        checkpoint_write(ckpt);
+        ckpt->joined = 1;
+    }
+
+    *out = ckpt;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Check without blocking whether the background write has finished.
+ */
+int cgrad_checkpoint_is_done(const cgrad_checkpoint* ckpt) {
+    if (!ckpt) return 1;
+    return __atomic_load_n(&ckpt->done, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Wait for the background write to finish.
+ */
+cgrad_status cgrad_checkpoint_wait(cgrad_checkpoint* ckpt, cgrad_checkpoint_stats* stats) {
+    if (!ckpt) return CGRAD_ERR_NULL_POINTER;
+    if (!ckpt->joined) {
+        pthread_join(ckpt->thread, NULL);
+        ckpt->joined = 1;
+    }
+    if (stats) *stats = ckpt->stats;
+    return ckpt->status;
+}
+
+/**
+ * @brief Wait for the background write to finish and release the handle.
+ */
+void cgrad_checkpoint_free(cgrad_checkpoint* ckpt) {
+    if (!ckpt) return;
+    cgrad_checkpoint_wait(ckpt, NULL);
+    free(ckpt->path);
+    free(ckpt);
+}
+
+/**
+ * @brief Free the spare staging buffer kept for the next checkpoint.
+ */
+void cgrad_checkpoint_release_buffers(void) {
+    pthread_mutex_lock(&g_checkpoint_spare_lock);
+    free(g_checkpoint_spare);
+    g_checkpoint_spare = NULL;
+    g_checkpoint_spare_capacity = 0;
+    pthread_mutex_unlock(&g_checkpoint_spare_lock);
+}
@@ -3,10 +3,14 @@
 #include "storage/cgrad_storage.h"
 #include "storage/cgrad_storage_layout.h"
 #include "storage/cgrad_storage_registry.h"
+#include "profiler/cgrad_profiler.h"
+#include "profiler/cgrad_hooks.h"
+#include "profiler/cgrad_memory.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <math.h>
 
 // ============================================================================
 // Global Storage Registry
@@ -65,6 +69,23 @@ size_t cgrad_storage_get_global_registry_count(void) {
     return cgrad_storage_registry_count(g_global_registry);
 }
 
+/**
+ * @brief Get the number of storages sharing the data of t, including t itself.
+ */
+size_t cgrad_storage_get_num_views(const cgrad_storage* t) {
+    if (g_global_registry == NULL || t == NULL) return 0;
+    return cgrad_storage_registry_bucket_get_size(g_global_registry, t);
+}
+
+cgrad_status cgrad_storage_get_root_uuid(const cgrad_storage* t, uuid_t out_uuid) {
+    if (g_global_registry == NULL || t == NULL) return CGRAD_ERR_NULL_POINTER;
+    cgrad_storage root;
+    cgrad_status err = cgrad_storage_registry_get_root(g_global_registry, t, &root);
+    if (err != CGRAD_SUCCESS) return err;
+    uuid_copy(out_uuid, root.uuid);
+    return CGRAD_SUCCESS;
+}
+
 /**
  * @brief Get or create the global storage registry (private helper).
  * This is for internal use only and maintains backward compatibility.
@@ -134,6 +155,42 @@ cgrad_status cgrad_storage_free_record(cgrad_storage_registry_record* record) {
     return first_error;
 }
 
+/**
+ * @brief Allocate the backend handle and data of a storage and register it as a new root.
+ */
+static cgrad_status storage_alloc(cgrad_storage* t, const uint32_t* shape, int ndim, cgrad_backend* backend) {
+    // Allocate tensor handle using the backend's handle size
+    void* data = calloc(1, backend->storage_handle_size);
+    if (!data) return CGRAD_ERR_STORAGE_HANDLE_UNINITIALIZED;
+    
+    // initialize the tensor
+    int err = backend->storage_init(data, shape, ndim);
+    if (err != CGRAD_SUCCESS) {
+        free(data);
+        return err;
+    }
+    
+    if (CGRAD_PROFILER_ENABLED()) {
+        cgrad_profiler_add_allocation(backend->storage_get_layout(data)->size * sizeof(float));
+    }
+
+    // populate tensor attributes
+    uuid_generate(t->uuid);
+    t->data = data;
+    t->backend = backend;
+
+    // Register tensor in global registry as a new root
+    cgrad_storage_registry* registry = get_global_registry();
+    if (registry) {
+        cgrad_storage_registry_register(registry, t, NULL);
+    }
+
+    if (CGRAD_MEMORY_ENABLED()) {
+        cgrad_memory_record_alloc(t, backend->storage_get_layout(data)->size * sizeof(float));
+    }
+    return CGRAD_SUCCESS;
+}
+
 /**
  * @brief Initialize a high-level tensor with the given shape and backend type.
  * @param t Pointer to tensor to initialize.
@@ -148,30 +205,100 @@ cgrad_status cgrad_storage_init(cgrad_storage* t, const uint32_t* shape, int ndi
     cgrad_backend* backend = cgrad_get_backend(backend_name);
     if (!backend) return CGRAD_ERR_STORAGE_INVALID_BACKEND;
 
-    // Allocate tensor handle using the backend's handle size
-    void* data = calloc(1, backend->storage_handle_size);
-    if (!data) return CGRAD_ERR_STORAGE_HANDLE_UNINITIALIZED;
-    
-    // initialize the tensor
-    int err = backend->storage_init(data, shape, ndim);
+    if (!CGRAD_HOOKS_ACTIVE(CGRAD_HOOK_STORAGE_ALLOC)) {
+        return storage_alloc(t, shape, ndim, backend);
+    }
+
+    cgrad_hook_event hook;
+    memset(&hook, 0, sizeof(hook));
+    hook.kind = CGRAD_HOOK_STORAGE_ALLOC;
+    hook.storage = t;
+    hook.bytes = sizeof(float);
+    for (int d = 0; d < ndim; d++) hook.bytes *= shape[d];
+    cgrad_hooks_begin(&hook);
+    cgrad_status err = storage_alloc(t, shape, ndim, backend);
+    if (err == CGRAD_SUCCESS) hook.output = backend->storage_get_layout(t->data);
+    cgrad_hooks_end(&hook, err);
+    return err;
+}
+
+/**
+ * @brief Wrap the memory in a backend handle and register it as a new root.
+ */
+static cgrad_status storage_wrap(
+    cgrad_storage* t,
+    const cgrad_storage_layout* layout,
+    void* data,
+    void (*release)(void* ctx),
+    void* release_ctx,
+    cgrad_backend* backend
+) {
+    void* handle = calloc(1, backend->storage_handle_size);
+    if (!handle) return CGRAD_ERR_STORAGE_HANDLE_UNINITIALIZED;
+
+    int err = backend->storage_wrap(handle, layout, data, release, release_ctx);
     if (err != CGRAD_SUCCESS) {
-        free(data);
+        free(handle);
         return err;
     }
-    
-    // populate tensor attributes
+
     uuid_generate(t->uuid);
-    t->data = data;
+    t->data = handle;
     t->backend = backend;
 
-    // Register tensor in global registry as a new root
+    // wrapped memory is a new root just like freshly allocated storage
     cgrad_storage_registry* registry = get_global_registry();
     if (registry) {
         cgrad_storage_registry_register(registry, t, NULL);
     }
+
+    if (CGRAD_MEMORY_ENABLED()) {
+        cgrad_memory_record_wrap(t, backend->storage_get_layout(handle)->size * sizeof(float));
+    }
     return CGRAD_SUCCESS;
 }
 
+/**
+ * @brief Initialize a storage around existing host memory without copying it.
+ * @param t Pointer to storage to initialize.
+ * @param layout Layout of the elements in data.
+ * @param data Memory holding the elements (not owned by the storage).
+ * @param release Callback invoked with release_ctx when the storage data is freed, or NULL.
+ * @param release_ctx Argument passed to release.
+ * @param backend_name Backend name to use.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_wrap(
+    cgrad_storage* t,
+    const cgrad_storage_layout* layout,
+    void* data,
+    void (*release)(void* ctx),
+    void* release_ctx,
+    const char* backend_name
+) {
+    if (!t || !layout || !data) return CGRAD_ERR_NULL_POINTER;
+
+    cgrad_backend* backend = cgrad_get_backend(backend_name);
+    if (!backend) return CGRAD_ERR_STORAGE_INVALID_BACKEND;
+    if (!backend->storage_wrap) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    if (!CGRAD_HOOKS_ACTIVE(CGRAD_HOOK_STORAGE_ALLOC)) {
+        return storage_wrap(t, layout, data, release, release_ctx, backend);
+    }
+
+    // reported like an allocation, so that the free of its last view balances it
+    cgrad_hook_event hook;
+    memset(&hook, 0, sizeof(hook));
+    hook.kind = CGRAD_HOOK_STORAGE_ALLOC;
+    hook.storage = t;
+    hook.bytes = layout->size * sizeof(float);
+    cgrad_hooks_begin(&hook);
+    cgrad_status err = storage_wrap(t, layout, data, release, release_ctx, backend);
+    if (err == CGRAD_SUCCESS) hook.output = backend->storage_get_layout(t->data);
+    cgrad_hooks_end(&hook, err);
+    return err;
+}
+
 /**
  * @brief Perform a shallow copy of a tensor (copies handle, not data).
  * @param dst Destination tensor.
@@ -210,14 +337,9 @@ cgrad_status cgrad_storage_shallow_copy(const cgrad_storage* src, cgrad_storage*
 }
 
 /**
- * @brief Free the memory associated with a high-level tensor.
- *        Returns the error code from the registry deregistration.
- * @param t Pointer to tensor.
- * @return CGRAD_SUCCESS on success, error code otherwise.
+ * @brief Deregister a storage and free its data if it was the last view of it.
  */
-cgrad_status cgrad_storage_free(cgrad_storage* t) {
-    if (!t || !t->backend || !t->data) return CGRAD_ERR_NULL_POINTER;
-
+static cgrad_status storage_release(cgrad_storage* t, uint64_t* out_released) {
     cgrad_storage_registry* registry = get_global_registry();
     if (!registry) return CGRAD_ERR_NULL_POINTER;
 
@@ -229,10 +351,14 @@ cgrad_status cgrad_storage_free(cgrad_storage* t) {
     if (cgrad_storage_registry_bucket_get_size(registry, t) == 1) {
         // this is the only tensor in the bucket
         // free the root
+        *out_released = root.backend->storage_get_layout(root.data)->size * sizeof(float);
+        if (CGRAD_MEMORY_ENABLED()) cgrad_memory_record_free(root.uuid);
         t->backend->storage_free(root.data);
         // delete the whole bucket
         err = cgrad_storage_registry_deregister_and_delete_bucket(registry, t);
         if (err != CGRAD_SUCCESS) return err;
+        // the root handle was kept alive for this call if the root was freed before its views
+        if (uuid_compare(t->uuid, root.uuid)) free(root.data);
         // free root handle after delete
         free(t->data);
         t->data = NULL;
@@ -250,6 +376,34 @@ cgrad_status cgrad_storage_free(cgrad_storage* t) {
     return CGRAD_SUCCESS;
 }
 
+/**
+ * @brief Free the memory associated with a high-level tensor.
+ *        Returns the error code from the registry deregistration.
+ * @param t Pointer to tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_free(cgrad_storage* t) {
+    if (!t || !t->backend || !t->data) return CGRAD_ERR_NULL_POINTER;
+
+    uint64_t released = 0;
+    if (!CGRAD_HOOKS_ACTIVE(CGRAD_HOOK_STORAGE_FREE)) {
+        return storage_release(t, &released);
+    }
+
+    // the layout is only valid until the handle is freed
+    cgrad_hook_event hook;
+    memset(&hook, 0, sizeof(hook));
+    hook.kind = CGRAD_HOOK_STORAGE_FREE;
+    hook.storage = t;
+    hook.output = t->backend->storage_get_layout(t->data);
+    cgrad_hooks_begin(&hook);
+    hook.output = NULL;
+    cgrad_status err = storage_release(t, &released);
+    hook.bytes = released;
+    cgrad_hooks_end(&hook, err);
+    return err;
+}
+
 /**
  * @brief Fill the tensor with a constant value.
  * @param t Pointer to tensor.
@@ -262,6 +416,18 @@ cgrad_status cgrad_storage_fill(cgrad_storage* t, float value) {
     return t->backend->storage_fill(t->data, value);
 }
 
+/**
+ * @brief Set all elements of the tensor to zero in-place.
+ * @param t Pointer to tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_zero(cgrad_storage* t) {
+    if (!t || !t->backend || !t->data) return CGRAD_ERR_NULL_POINTER;
+    if (t->backend->storage_zero) return t->backend->storage_zero(t->data);
+    if (!t->backend->storage_fill) return CGRAD_ERR_NOT_IMPLEMENTED;
+    return t->backend->storage_fill(t->data, 0.0f);
+}
+
 /**
  * @brief Fill the tensor with random values.
  * @param t Pointer to tensor.
@@ -456,20 +622,11 @@ cgrad_status cgrad_storage_axpy(
             cgrad_storage_free_record(storage_record);
             return CGRAD_ERR_STORAGE_SHAPE_MISMATCH;
         }
-        
-        // Check if r is contiguous
-        // TODO: we can use is_regular instead of contiguous once we implemented
-        //       storage_copy as a less strict version of storage_contiguous
-        if (!cgrad_storage_layout_is_contiguous(r_layout)) {
-            cgrad_storage_stop_recording(storage_record);
-            cgrad_storage_free_record(storage_record);
-            return CGRAD_ERR_NOT_IMPLEMENTED;
-        }
     }
     
     if (uuid_compare(y->uuid, r->uuid) != 0) {
-        // y and r are different tensors, copy y to r
-        err = y_bcast.backend->storage_contiguous(y_bcast.data, r->data);
+        // y and r are different tensors, copy y to r (r may be a strided view)
+        err = y_bcast.backend->storage_copy(y_bcast.data, r->data);
         if (err != CGRAD_SUCCESS) {
             cgrad_storage_stop_recording(storage_record);
             cgrad_storage_free_record(storage_record);
@@ -492,105 +649,103 @@ cgrad_status cgrad_storage_axpy(
 
 
 /**
- * @brief Get the value at the given indices.
- * @param t Pointer to storage.
- * @param indices Array of indices.
- * @param ndim Number of dimensions in indices.
- * @param out_value Pointer to float where the value will be written.
- * @return CGRAD_SUCCESS on success, error code otherwise.
- */
-cgrad_status cgrad_storage_get(const cgrad_storage* t, const uint32_t* indices, int ndim, float* out_value) {
-    if (!t || !t->backend || !t->data) return CGRAD_ERR_NULL_POINTER;
-    if (!t->backend->storage_get) return CGRAD_ERR_NOT_IMPLEMENTED;
-    return t->backend->storage_get(t->data, indices, ndim, out_value);
-}
-
-/**
- * @brief Print the tensor's shape and contents.
- * @param t Pointer to tensor.
- */
-void cgrad_storage_print(const cgrad_storage* t) {
-    if (!t || !t->backend || !t->data) return;
-    const cgrad_storage_layout* layout = t->backend->storage_get_layout(t->data);
-    printf("Shape: ");
-    cgrad_storage_layout_print_shape(layout, TENSOR_DIM);
-    t->backend->storage_print_data(t->data);
-}
-
-/**
- * @brief Make a contiguous copy of a tensor into dst.
- * @param src Source tensor.
- * @param dst Destination tensor.
+ * @brief Compute the elementwise (Hadamard) product r = alpha * x * y + beta * r.
+ *        x and y are broadcast against each other. If r is initialized, its shape
+ *        may be smaller than the broadcast shape of x and y (dims of size 1), in
+ *        which case the products are summed over those dims directly into r.
+ * @param alpha Scaling factor for the product.
+ * @param x First input tensor.
+ * @param y Second input tensor.
+ * @param beta Scaling factor for the current values in r.
+ * @param r Output tensor (initialized inside function if r->data is NULL).
  * @return CGRAD_SUCCESS on success, error code otherwise.
  */
-cgrad_status cgrad_storage_contiguous(const cgrad_storage* src, cgrad_storage* dst) {
-    if (!dst || !src || !src->backend || !src->data)
-        return CGRAD_ERR_NULL_POINTER;
-    if (!src->backend->storage_contiguous)
-        return CGRAD_ERR_NOT_IMPLEMENTED;
+cgrad_status cgrad_storage_mul(
+    float alpha,
+    const cgrad_storage* x,
+    const cgrad_storage* y,
+    float beta,
+    cgrad_storage* r
+) {
+    // validate tensors
+    if (!x || !y || !r) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend || !y->backend) return CGRAD_ERR_NULL_POINTER;
+    if (x->backend != y->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    if (!x->backend->storage_mul) return CGRAD_ERR_NOT_IMPLEMENTED;
 
-    if (cgrad_storage_layout_is_contiguous(
-        src->backend->storage_get_layout(src->data)
-    )) {
-        // already contiguous, do a shallow copy
-        return cgrad_storage_shallow_copy(src, dst);
-    }
-    
     // record all storages created here
     cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
 
-    uint32_t* src_shape = src->backend->storage_get_layout(src->data)->shape;
-    int err = cgrad_storage_init(dst, src_shape, TENSOR_DIM, src->backend->name);
+    // create shallow copies of x and y
+    cgrad_storage x_bcast;
+    int err = cgrad_storage_shallow_copy(x, &x_bcast);
     if (err != CGRAD_SUCCESS) {
         cgrad_storage_stop_recording(storage_record);
         cgrad_storage_free_record(storage_record);
         return err;
     }
-
-    err = src->backend->storage_contiguous(src->data, dst->data);
+    cgrad_storage y_bcast;
+    err = cgrad_storage_shallow_copy(y, &y_bcast);
     if (err != CGRAD_SUCCESS) {
         cgrad_storage_stop_recording(storage_record);
         cgrad_storage_free_record(storage_record);
         return err;
     }
 
-    return CGRAD_SUCCESS;
-}
-
-/**
- * @brief Reshape a tensor, using layout reshape and backend copy ops.
- * @param src Source tensor.
- * @param dst Destination tensor.
- * @param new_shape Array of new dimensions (length ndim, may contain one -1).
- * @param ndim Number of dimensions in new_shape (<= TENSOR_DIM).
- * @return CGRAD_SUCCESS on success, error code otherwise.
- */
-cgrad_status cgrad_storage_reshape(const cgrad_storage* src, cgrad_storage* dst, const int32_t* new_shape, int ndim) {
-    if (!src || !src->backend || !src->data)
-        return CGRAD_ERR_NULL_POINTER;
-
-    if (dst->data) {
-        // TODO: write to existing buffer not supported yet
-        return CGRAD_ERR_NOT_IMPLEMENTED;
+    // broadcast layouts
+    cgrad_storage_layout* x_layout = x_bcast.backend->storage_get_layout(x_bcast.data);
+    err = cgrad_storage_layout_broadcast(
+        x_layout,
+        y_bcast.backend->storage_get_layout(y_bcast.data),
+        0,
+        TENSOR_DIM
+    );
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
     }
-    
-    // record all storages created here
-    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
-
-    if (cgrad_storage_layout_is_regular(src->backend->storage_get_layout(src->data))) {
-        // If src is regular, we can do a shallow copy
-        if (!src->backend->storage_shallow_copy)
-            return CGRAD_ERR_NOT_IMPLEMENTED;
 
-        int err = cgrad_storage_shallow_copy(src, dst);
+    cgrad_storage r_bcast;
+    if (!r->data) {
+        err = cgrad_storage_init(r, x_layout->shape, TENSOR_DIM, x->backend->name);
         if (err != CGRAD_SUCCESS) {
             cgrad_storage_stop_recording(storage_record);
             cgrad_storage_free_record(storage_record);
             return err;
         }
+        r_bcast = *r;
     } else {
-        // If src is not regular, make a contiguous copy into dst
-        int err = cgrad_storage_contiguous(src, dst);
+        if (r->backend != x->backend) {
+            cgrad_storage_stop_recording(storage_record);
+            cgrad_storage_free_record(storage_record);
+            return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+        }
+
+        // r may only be smaller than the product along dims of size 1
+        const cgrad_storage_layout* r_layout = r->backend->storage_get_layout(r->data);
+        for (int i = 0; i < TENSOR_DIM; ++i) {
+            if (r_layout->shape[i] != x_layout->shape[i] && r_layout->shape[i] != 1) {
+                cgrad_storage_stop_recording(storage_record);
+                cgrad_storage_free_record(storage_record);
+                return CGRAD_ERR_STORAGE_SHAPE_MISMATCH;
+            }
+        }
+
+        // view r with the broadcast shape (zero strides along reduced dims)
+        err = cgrad_storage_shallow_copy(r, &r_bcast);
+        if (err != CGRAD_SUCCESS) {
+            cgrad_storage_stop_recording(storage_record);
+            cgrad_storage_free_record(storage_record);
+            return err;
+        }
+        cgrad_storage_layout x_shape = *x_layout;
+        err = cgrad_storage_layout_broadcast(
+            r_bcast.backend->storage_get_layout(r_bcast.data),
+            &x_shape,
+            0,
+            TENSOR_DIM
+        );
         if (err != CGRAD_SUCCESS) {
             cgrad_storage_stop_recording(storage_record);
             cgrad_storage_free_record(storage_record);
@@ -598,34 +753,771 @@ cgrad_status cgrad_storage_reshape(const cgrad_storage* src, cgrad_storage* dst,
         }
     }
 
-    return cgrad_storage_layout_reshape(
-        dst->backend->storage_get_layout(dst->data),
-        new_shape,
-        ndim
-    );
+    err = x->backend->storage_mul(alpha, x_bcast.data, y_bcast.data, beta, r_bcast.data);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, r);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
 }
 
 /**
- * @brief Transpose the tensor according to the given permutation, applied to the last ndim dims.
- * Creates a shallow copy of the source tensor and applies the transpose to the layout.
- * @param src Source tensor.
- * @param dst Destination tensor (will be initialized with shallow copy + transpose).
- * @param perm Permutation array (length ndim).
- * @param ndim Number of trailing dimensions to permute (≤ TENSOR_DIM).
+ * @brief Apply an elementwise unary function r = f(x) and optionally dr = f'(x).
+ * @param op Unary function to apply.
+ * @param x Input storage.
+ * @param r Output storage (initialized inside function if r->data is NULL).
+ * @param dr Derivative storage (initialized inside function if dr->data is NULL), or NULL.
  * @return CGRAD_SUCCESS on success, error code otherwise.
  */
-cgrad_status cgrad_storage_transpose(const cgrad_storage* src, cgrad_storage* dst, const uint32_t* perm, int ndim) {
-    if (!src || !dst) return CGRAD_ERR_NULL_POINTER;
-    if (!src->backend || !src->data) return CGRAD_ERR_NULL_POINTER;
-    
-    // track all storages created here
+cgrad_status cgrad_storage_unary(
+    cgrad_unary_op op,
+    const cgrad_storage* x,
+    cgrad_storage* r,
+    cgrad_storage* dr
+) {
+    // validate tensors
+    if (!x || !r || !x->backend || !x->data) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend->storage_unary) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // record all storages created here
     cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
 
-    // Create shallow copy of source
-    int err = cgrad_storage_shallow_copy(src, dst);
-    if (err != CGRAD_SUCCESS) {
-        cgrad_storage_stop_recording(storage_record);
-        cgrad_storage_free_record(storage_record);
+    const cgrad_storage_layout* x_layout = x->backend->storage_get_layout(x->data);
+    cgrad_storage* outputs[2] = {r, dr};
+    int err = CGRAD_SUCCESS;
+    for (int i = 0; i < 2 && err == CGRAD_SUCCESS; i++) {
+        cgrad_storage* out = outputs[i];
+        if (!out) continue;
+        if (!out->data) {
+            err = cgrad_storage_init(out, x_layout->shape, TENSOR_DIM, x->backend->name);
+        } else if (out->backend != x->backend) {
+            err = CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+        } else {
+            const cgrad_storage_layout* out_layout = out->backend->storage_get_layout(out->data);
+            for (int d = 0; d < TENSOR_DIM; d++) {
+                if (out_layout->shape[d] != x_layout->shape[d]) {
+                    err = CGRAD_ERR_STORAGE_SHAPE_MISMATCH;
+                    break;
+                }
+            }
+        }
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = x->backend->storage_unary(op, x->data, r->data, dr ? dr->data : NULL);
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storages
+    cgrad_storage_registry_record_remove(storage_record, r);
+    if (dr) cgrad_storage_registry_record_remove(storage_record, dr);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Compute r = softmax(x) or r = log_softmax(x) along the last dimension.
+ * @param log_softmax Nonzero to compute log-softmax instead of softmax.
+ * @param x Input storage.
+ * @param r Output storage (initialized inside function if r->data is NULL).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax(int log_softmax, const cgrad_storage* x, cgrad_storage* r) {
+    // validate tensors
+    if (!x || !r || !x->backend || !x->data) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend->storage_softmax) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    const cgrad_storage_layout* x_layout = x->backend->storage_get_layout(x->data);
+    int err = CGRAD_SUCCESS;
+    if (!r->data) {
+        err = cgrad_storage_init(r, x_layout->shape, TENSOR_DIM, x->backend->name);
+    } else if (r->backend != x->backend) {
+        err = CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = x->backend->storage_softmax(log_softmax, x->data, r->data);
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, r);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Accumulate the gradient of a (log-)softmax into grad_x.
+ * @param log_softmax Nonzero if y is the output of log-softmax.
+ * @param y Output of the forward pass.
+ * @param grad_y Gradient with respect to y.
+ * @param grad_x Gradient with respect to the input (must be initialized and contiguous).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax_backward(
+    int log_softmax,
+    const cgrad_storage* y,
+    const cgrad_storage* grad_y,
+    cgrad_storage* grad_x
+) {
+    // validate tensors
+    if (!y || !grad_y || !grad_x) return CGRAD_ERR_NULL_POINTER;
+    if (!y->backend || !y->data || !grad_y->data || !grad_x->data) return CGRAD_ERR_NULL_POINTER;
+    if (y->backend != grad_y->backend || y->backend != grad_x->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    if (!y->backend->storage_softmax_backward) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    // the backend reads rows linearly
+    cgrad_storage y_contig, grad_y_contig;
+    int err = cgrad_storage_contiguous(y, &y_contig);
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_contiguous(grad_y, &grad_y_contig);
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = y->backend->storage_softmax_backward(log_softmax, y_contig.data, grad_y_contig.data, grad_x->data);
+    }
+
+    cgrad_storage_stop_recording(storage_record);
+    cgrad_status free_err = cgrad_storage_free_record(storage_record);
+    return err != CGRAD_SUCCESS ? err : free_err;
+}
+
+/**
+ * @brief Compute the mean softmax cross-entropy loss of logits x against target.
+ * @param x Logits.
+ * @param target Target distribution with the same shape as x.
+ * @param loss Output scalar (initialized inside function if loss->data is NULL).
+ * @param lse Output of per-row logsumexp (initialized inside function if lse->data is NULL), or NULL.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax_cross_entropy(
+    const cgrad_storage* x,
+    const cgrad_storage* target,
+    cgrad_storage* loss,
+    cgrad_storage* lse
+) {
+    // validate tensors
+    if (!x || !target || !loss) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend || !x->data || !target->data) return CGRAD_ERR_NULL_POINTER;
+    if (x->backend != target->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    if (!x->backend->storage_softmax_cross_entropy) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    const cgrad_storage_layout* x_layout = x->backend->storage_get_layout(x->data);
+    const cgrad_storage_layout* t_layout = target->backend->storage_get_layout(target->data);
+    int err = CGRAD_SUCCESS;
+    for (int d = 0; d < TENSOR_DIM; d++) {
+        if (x_layout->shape[d] != t_layout->shape[d]) {
+            err = CGRAD_ERR_STORAGE_SHAPE_MISMATCH;
+            break;
+        }
+    }
+
+    // outputs: a scalar loss and the per-row logsumexp
+    if (err == CGRAD_SUCCESS && !loss->data) {
+        uint32_t scalar_shape[1] = {1};
+        err = cgrad_storage_init(loss, scalar_shape, 1, x->backend->name);
+    }
+    if (err == CGRAD_SUCCESS && lse && !lse->data) {
+        uint32_t row_shape[TENSOR_DIM];
+        memcpy(row_shape, x_layout->shape, sizeof(row_shape));
+        row_shape[TENSOR_DIM - 1] = 1;
+        err = cgrad_storage_init(lse, row_shape, TENSOR_DIM, x->backend->name);
+    }
+
+    // the backend reads rows linearly
+    cgrad_storage x_contig, target_contig;
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_contiguous(x, &x_contig);
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_contiguous(target, &target_contig);
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = x->backend->storage_softmax_cross_entropy(
+            x_contig.data,
+            target_contig.data,
+            loss->data,
+            lse ? lse->data : NULL
+        );
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storages
+    cgrad_storage_registry_record_remove(storage_record, loss);
+    if (lse) cgrad_storage_registry_record_remove(storage_record, lse);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Accumulate alpha times the gradients of the per-row softmax cross-entropy.
+ * @param alpha Scaling factor for the gradients.
+ * @param x Logits.
+ * @param target Target distribution with the same shape as x.
+ * @param lse Per-row logsumexp computed by cgrad_storage_softmax_cross_entropy.
+ * @param grad_x Gradient with respect to x, or NULL.
+ * @param grad_target Gradient with respect to target, or NULL.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_softmax_cross_entropy_backward(
+    float alpha,
+    const cgrad_storage* x,
+    const cgrad_storage* target,
+    const cgrad_storage* lse,
+    cgrad_storage* grad_x,
+    cgrad_storage* grad_target
+) {
+    // validate tensors
+    if (!x || !target || !lse) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend || !x->data || !target->data || !lse->data) return CGRAD_ERR_NULL_POINTER;
+    if ((grad_x && !grad_x->data) || (grad_target && !grad_target->data)) return CGRAD_ERR_NULL_POINTER;
+    if (x->backend != target->backend || x->backend != lse->backend
+        || (grad_x && grad_x->backend != x->backend)
+        || (grad_target && grad_target->backend != x->backend)) {
+        return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    }
+    if (!x->backend->storage_softmax_cross_entropy_backward) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    // the backend reads rows linearly
+    cgrad_storage x_contig, target_contig;
+    int err = cgrad_storage_contiguous(x, &x_contig);
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_contiguous(target, &target_contig);
+    }
+    if (err == CGRAD_SUCCESS) {
+        err = x->backend->storage_softmax_cross_entropy_backward(
+            alpha,
+            x_contig.data,
+            target_contig.data,
+            lse->data,
+            grad_x ? grad_x->data : NULL,
+            grad_target ? grad_target->data : NULL
+        );
+    }
+
+    cgrad_storage_stop_recording(storage_record);
+    cgrad_status free_err = cgrad_storage_free_record(storage_record);
+    return err != CGRAD_SUCCESS ? err : free_err;
+}
+
+// Column buffers larger than this make CGRAD_CONV2D_AUTO use the implicit GEMM lowering instead
+#define CGRAD_CONV2D_IM2COL_MAX_BYTES ((size_t)256 << 20)
+
+// A 1x1 convolution with unit stride and no padding needs no unfolding: the input already is the column matrix
+static int conv2d_is_pointwise(const cgrad_conv2d_params* p) {
+    return p->kernel[0] == 1 && p->kernel[1] == 1
+        && p->stride[0] == 1 && p->stride[1] == 1
+        && p->padding[0] == 0 && p->padding[1] == 0;
+}
+
+// Sizes C * KH * KW and OH * OW of the column matrix; each becomes a single reshape dim, so
+// both must fit into int32
+static cgrad_status conv2d_matrix_dims(
+    const cgrad_conv2d_params* p,
+    const cgrad_storage_layout* x_layout,
+    const cgrad_storage_layout* out_layout,
+    int32_t* out_ckk,
+    int32_t* out_ohw
+) {
+    uint64_t ckk = (uint64_t)x_layout->shape[TENSOR_DIM - 3] * p->kernel[0] * p->kernel[1];
+    uint64_t ohw = (uint64_t)out_layout->shape[TENSOR_DIM - 2] * out_layout->shape[TENSOR_DIM - 1];
+    if (ckk > INT32_MAX || ohw > INT32_MAX) return CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE;
+    *out_ckk = (int32_t)ckk;
+    *out_ohw = (int32_t)ohw;
+    return CGRAD_SUCCESS;
+}
+
+// Build the (N, C * KH * KW, OH * OW) column matrix of a contiguous input (recorded by the caller)
+static cgrad_status conv2d_columns(
+    const cgrad_conv2d_params* p,
+    const cgrad_storage* x,
+    int32_t ckk,
+    int32_t ohw,
+    cgrad_storage* cols
+) {
+    uint32_t n = x->backend->storage_get_layout(x->data)->shape[TENSOR_DIM - 4];
+
+    if (conv2d_is_pointwise(p)) {
+        return cgrad_storage_reshape(x, cols, (const int32_t[]){(int32_t)n, ckk, ohw}, 3);
+    }
+
+    if (!x->backend->storage_im2col) return CGRAD_ERR_NOT_IMPLEMENTED;
+    int err = cgrad_storage_init(cols, (const uint32_t[]){n, (uint32_t)ckk, (uint32_t)ohw}, 3, x->backend->name);
+    if (err != CGRAD_SUCCESS) return err;
+    return x->backend->storage_im2col(p, x->data, cols->data);
+}
+
+/**
+ * @brief Compute the 2D convolution r = conv2d(x, w).
+ * @param algo Lowering to use.
+ * @param params Convolution parameters (kernel is taken from w).
+ * @param x Input of shape (N, C, H, W).
+ * @param w Weight of shape (O, C, KH, KW).
+ * @param r Output of shape (N, O, OH, OW) (initialized inside function if r->data is NULL).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_conv2d(
+    cgrad_conv2d_algo algo,
+    const cgrad_conv2d_params* params,
+    const cgrad_storage* x,
+    const cgrad_storage* w,
+    cgrad_storage* r
+) {
+    // validate tensors
+    if (!params || !x || !w || !r) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend || !x->data || !w->data) return CGRAD_ERR_NULL_POINTER;
+    if (x->backend != w->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+
+    cgrad_conv2d_params p = *params;
+    cgrad_storage_layout out_layout;
+    int err = cgrad_storage_layout_conv2d(
+        x->backend->storage_get_layout(x->data),
+        w->backend->storage_get_layout(w->data),
+        &p,
+        &out_layout
+    );
+    if (err != CGRAD_SUCCESS) return err;
+    int32_t ckk, ohw;
+    err = conv2d_matrix_dims(&p, x->backend->storage_get_layout(x->data), &out_layout, &ckk, &ohw);
+    if (err != CGRAD_SUCCESS) return err;
+
+    // pick the lowering: im2col + GEMM unless the column buffer gets too large
+    if (algo == CGRAD_CONV2D_AUTO) {
+        size_t cols_bytes = (size_t)x->backend->storage_get_layout(x->data)->shape[TENSOR_DIM - 3]
+            * p.kernel[0] * p.kernel[1] * out_layout.size / out_layout.shape[TENSOR_DIM - 3] * sizeof(float);
+        algo = (conv2d_is_pointwise(&p) || cols_bytes <= CGRAD_CONV2D_IM2COL_MAX_BYTES)
+            ? CGRAD_CONV2D_IM2COL : CGRAD_CONV2D_IMPLICIT_GEMM;
+    }
+    if (algo == CGRAD_CONV2D_IMPLICIT_GEMM && !x->backend->storage_conv2d) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    if (!r->data) {
+        err = cgrad_storage_init(r, out_layout.shape, TENSOR_DIM, x->backend->name);
+    } else if (r->backend != x->backend) {
+        err = CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    } else {
+        const cgrad_storage_layout* r_layout = r->backend->storage_get_layout(r->data);
+        for (int d = 0; d < TENSOR_DIM; d++) {
+            if (r_layout->shape[d] != out_layout.shape[d]) err = CGRAD_ERR_STORAGE_SHAPE_MISMATCH;
+        }
+        if (err == CGRAD_SUCCESS && !cgrad_storage_layout_is_contiguous(r_layout)) err = CGRAD_ERR_NOT_IMPLEMENTED;
+    }
+
+    // both lowerings read the input and weight linearly
+    // (storages are declared here since the record frees them after any nested scope ends)
+    cgrad_storage x_contig, w_contig, cols = {0}, w_mat = {0}, r_mat = {0};
+    if (err == CGRAD_SUCCESS) err = cgrad_storage_contiguous(x, &x_contig);
+    if (err == CGRAD_SUCCESS) err = cgrad_storage_contiguous(w, &w_contig);
+
+    if (err == CGRAD_SUCCESS && algo == CGRAD_CONV2D_IMPLICIT_GEMM) {
+        err = x->backend->storage_conv2d(&p, x_contig.data, w_contig.data, r->data);
+    } else if (err == CGRAD_SUCCESS) {
+        // r viewed as (N, O, OH * OW) = w viewed as (O, C * KH * KW) @ cols, broadcast over N
+        int32_t n = (int32_t)out_layout.shape[TENSOR_DIM - 4];
+        int32_t o = (int32_t)out_layout.shape[TENSOR_DIM - 3];
+        err = conv2d_columns(&p, &x_contig, ckk, ohw, &cols);
+        if (err == CGRAD_SUCCESS) err = cgrad_storage_reshape(&w_contig, &w_mat, (const int32_t[]){o, ckk}, 2);
+        if (err == CGRAD_SUCCESS) err = cgrad_storage_reshape(r, &r_mat, (const int32_t[]){n, o, ohw}, 3);
+        if (err == CGRAD_SUCCESS) err = cgrad_storage_gemm(1.0f, &w_mat, &cols, 0.0f, &r_mat);
+    }
+
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, r);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Accumulate the gradients of r = conv2d(x, w) into grad_x and grad_w.
+ * @param params Convolution parameters (kernel is taken from w).
+ * @param x Input of shape (N, C, H, W).
+ * @param w Weight of shape (O, C, KH, KW).
+ * @param grad_r Gradient with respect to the output.
+ * @param grad_x Gradient with respect to x (must be initialized and contiguous), or NULL.
+ * @param grad_w Gradient with respect to w (must be initialized and contiguous), or NULL.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_conv2d_backward(
+    const cgrad_conv2d_params* params,
+    const cgrad_storage* x,
+    const cgrad_storage* w,
+    const cgrad_storage* grad_r,
+    cgrad_storage* grad_x,
+    cgrad_storage* grad_w
+) {
+    // validate tensors
+    if (!params || !x || !w || !grad_r) return CGRAD_ERR_NULL_POINTER;
+    if (!x->backend || !x->data || !w->data || !grad_r->data) return CGRAD_ERR_NULL_POINTER;
+    if ((grad_x && !grad_x->data) || (grad_w && !grad_w->data)) return CGRAD_ERR_NULL_POINTER;
+    if (x->backend != w->backend || x->backend != grad_r->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+
+    cgrad_conv2d_params p = *params;
+    cgrad_storage_layout out_layout;
+    int err = cgrad_storage_layout_conv2d(
+        x->backend->storage_get_layout(x->data),
+        w->backend->storage_get_layout(w->data),
+        &p,
+        &out_layout
+    );
+    if (err != CGRAD_SUCCESS) return err;
+
+    int32_t n = (int32_t)out_layout.shape[TENSOR_DIM - 4];
+    int32_t o = (int32_t)out_layout.shape[TENSOR_DIM - 3];
+    int32_t ckk, ohw;
+    err = conv2d_matrix_dims(&p, x->backend->storage_get_layout(x->data), &out_layout, &ckk, &ohw);
+    if (err != CGRAD_SUCCESS) return err;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    // storages are declared here since the record frees them after any nested scope ends
+    cgrad_storage x_contig, w_contig, grad_r_contig, grad_r_mat = {0};
+    cgrad_storage cols = {0}, cols_t = {0}, grad_w_mat = {0}, per_image = {0}, summed = {0};
+    cgrad_storage w_mat = {0}, w_t = {0}, grad_x_mat = {0}, grad_cols = {0};
+
+    // grad_r viewed as (N, O, OH * OW)
+    err = cgrad_storage_contiguous(x, &x_contig);
+    if (err == CGRAD_SUCCESS) err = cgrad_storage_contiguous(w, &w_contig);
+    if (err == CGRAD_SUCCESS) err = cgrad_storage_contiguous(grad_r, &grad_r_contig);
+    if (err == CGRAD_SUCCESS) err = cgrad_storage_reshape(&grad_r_contig, &grad_r_mat, (const int32_t[]){n, o, ohw}, 3);
+
+    // grad_w viewed as (O, C * KH * KW) += sum over N of grad_r @ cols^T
+    if (err == CGRAD_SUCCESS && grad_w) {
+        err = conv2d_columns(&p, &x_contig, ckk, ohw, &cols);
+        if (err == CGRAD_SUCCESS) err = cgrad_storage_transpose(&cols, &cols_t, (const uint32_t[]){1, 0}, 2);
+        if (err == CGRAD_SUCCESS) err = cgrad_storage_reshape(grad_w, &grad_w_mat, (const int32_t[]){o, ckk}, 2);
+        if (err == CGRAD_SUCCESS && n == 1) {
+            err = cgrad_storage_gemm(1.0f, &grad_r_mat, &cols_t, 1.0f, &grad_w_mat);
+        } else if (err == CGRAD_SUCCESS) {
+            err = cgrad_storage_gemm(1.0f, &grad_r_mat, &cols_t, 0.0f, &per_image);
+            if (err == CGRAD_SUCCESS) err = cgrad_storage_reduce(1.0f, &per_image, (const uint8_t[]){1, 0, 0}, 3, 0.0f, &summed);
+            if (err == CGRAD_SUCCESS) err = cgrad_storage_axpy(1.0f, &summed, &grad_w_mat, &grad_w_mat);
+        }
+    }
+
+    // grad_x += col2im(w^T @ grad_r), with w viewed as (O, C * KH * KW)
+    if (err == CGRAD_SUCCESS && grad_x) {
+        err = cgrad_storage_reshape(&w_contig, &w_mat, (const int32_t[]){o, ckk}, 2);
+        if (err == CGRAD_SUCCESS) err = cgrad_storage_transpose(&w_mat, &w_t, (const uint32_t[]){1, 0}, 2);
+        if (err == CGRAD_SUCCESS && conv2d_is_pointwise(&p)) {
+            // the columns are the input itself, so accumulate straight into grad_x
+            err = cgrad_storage_reshape(grad_x, &grad_x_mat, (const int32_t[]){n, ckk, ohw}, 3);
+            if (err == CGRAD_SUCCESS) err = cgrad_storage_gemm(1.0f, &w_t, &grad_r_mat, 1.0f, &grad_x_mat);
+        } else if (err == CGRAD_SUCCESS) {
+            err = x->backend->storage_col2im ? CGRAD_SUCCESS : CGRAD_ERR_NOT_IMPLEMENTED;
+            if (err == CGRAD_SUCCESS) err = cgrad_storage_gemm(1.0f, &w_t, &grad_r_mat, 0.0f, &grad_cols);
+            if (err == CGRAD_SUCCESS) err = x->backend->storage_col2im(&p, grad_cols.data, grad_x->data);
+        }
+    }
+
+    cgrad_storage_stop_recording(storage_record);
+    cgrad_status free_err = cgrad_storage_free_record(storage_record);
+    return err != CGRAD_SUCCESS ? err : free_err;
+}
+
+/**
+ * @brief Apply one optimizer step to n parameters in place.
+ */
+cgrad_status cgrad_storage_optim_step(
+    const cgrad_optim_update* u,
+    int n,
+    cgrad_storage* const* params,
+    const cgrad_storage* const* grads,
+    cgrad_storage* const* m,
+    cgrad_storage* const* v
+) {
+    if (!u || (n > 0 && (!params || !grads))) return CGRAD_ERR_NULL_POINTER;
+    if (n <= 0) return CGRAD_SUCCESS;
+    if (!params[0] || !params[0]->backend) return CGRAD_ERR_NULL_POINTER;
+    cgrad_backend* backend = params[0]->backend;
+    if (!backend->storage_optim_step) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    // hand the backend its handles in fixed-size groups kept on the stack
+    void* p_data[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    void* g_data[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    void* m_data[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    void* v_data[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    for (int start = 0; start < n; start += CGRAD_BACKEND_OPTIM_MAX_TENSORS) {
+        int count = n - start < CGRAD_BACKEND_OPTIM_MAX_TENSORS ? n - start : CGRAD_BACKEND_OPTIM_MAX_TENSORS;
+        for (int i = 0; i < count; i++) {
+            const cgrad_storage* pi = params[start + i];
+            const cgrad_storage* gi = grads[start + i];
+            const cgrad_storage* mi = m ? m[start + i] : NULL;
+            const cgrad_storage* vi = v ? v[start + i] : NULL;
+            if (!pi || !pi->data || !gi || !gi->data || (m && (!mi || !mi->data)) || (v && (!vi || !vi->data))) {
+                return CGRAD_ERR_NULL_POINTER;
+            }
+            if (pi->backend != backend || gi->backend != backend
+                || (mi && mi->backend != backend) || (vi && vi->backend != backend)) {
+                return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+            }
+            p_data[i] = pi->data;
+            g_data[i] = gi->data;
+            m_data[i] = mi ? mi->data : NULL;
+            v_data[i] = vi ? vi->data : NULL;
+        }
+        int err = backend->storage_optim_step(u, count, p_data, g_data, m ? m_data : NULL, v ? v_data : NULL);
+        if (err != CGRAD_SUCCESS) return err;
+    }
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Compute the sum of squares of all elements of n storages.
+ */
+cgrad_status cgrad_storage_sum_squares(int n, const cgrad_storage* const* ts, double* out) {
+    if (!out || (n > 0 && !ts)) return CGRAD_ERR_NULL_POINTER;
+    *out = 0.0;
+    if (n <= 0) return CGRAD_SUCCESS;
+    if (!ts[0] || !ts[0]->backend) return CGRAD_ERR_NULL_POINTER;
+    cgrad_backend* backend = ts[0]->backend;
+    if (!backend->storage_sum_squares) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    void* data[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    double total = 0.0;
+    for (int start = 0; start < n; start += CGRAD_BACKEND_OPTIM_MAX_TENSORS) {
+        int count = n - start < CGRAD_BACKEND_OPTIM_MAX_TENSORS ? n - start : CGRAD_BACKEND_OPTIM_MAX_TENSORS;
+        for (int i = 0; i < count; i++) {
+            const cgrad_storage* ti = ts[start + i];
+            if (!ti || !ti->data) return CGRAD_ERR_NULL_POINTER;
+            if (ti->backend != backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+            data[i] = ti->data;
+        }
+        double sum;
+        int err = backend->storage_sum_squares(count, data, &sum);
+        if (err != CGRAD_SUCCESS) return err;
+        total += sum;
+    }
+    *out = total;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Multiply all elements of n storages in-place by alpha.
+ */
+cgrad_status cgrad_storage_scale(int n, cgrad_storage* const* ts, float alpha) {
+    if (n > 0 && !ts) return CGRAD_ERR_NULL_POINTER;
+    if (n <= 0) return CGRAD_SUCCESS;
+    if (!ts[0] || !ts[0]->backend) return CGRAD_ERR_NULL_POINTER;
+    cgrad_backend* backend = ts[0]->backend;
+    if (!backend->storage_scale) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    void* data[CGRAD_BACKEND_OPTIM_MAX_TENSORS];
+    for (int start = 0; start < n; start += CGRAD_BACKEND_OPTIM_MAX_TENSORS) {
+        int count = n - start < CGRAD_BACKEND_OPTIM_MAX_TENSORS ? n - start : CGRAD_BACKEND_OPTIM_MAX_TENSORS;
+        for (int i = 0; i < count; i++) {
+            const cgrad_storage* ti = ts[start + i];
+            if (!ti || !ti->data) return CGRAD_ERR_NULL_POINTER;
+            if (ti->backend != backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+            data[i] = ti->data;
+        }
+        int err = backend->storage_scale(count, data, alpha);
+        if (err != CGRAD_SUCCESS) return err;
+    }
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Clip gradients by their global L2 norm.
+ */
+cgrad_status cgrad_storage_clip_grad_norm(int n, cgrad_storage* const* grads, float max_norm, float* out_norm) {
+    if (n > 0 && !grads) return CGRAD_ERR_NULL_POINTER;
+    if (!(max_norm > 0.0f)) return CGRAD_ERR_OPTIM_INVALID_CONFIG;
+
+    double sum;
+    cgrad_status err = cgrad_storage_sum_squares(n, (const cgrad_storage* const*)grads, &sum);
+    if (err != CGRAD_SUCCESS) return err;
+    double norm = sqrt(sum);
+    if (out_norm) *out_norm = (float)norm;
+
+    if (norm > (double)max_norm) {
+        err = cgrad_storage_scale(n, grads, (float)((double)max_norm / (norm + 1e-6)));
+    }
+    return err;
+}
+
+/**
+ * @brief Get the value at the given indices.
+ * @param t Pointer to storage.
+ * @param indices Array of indices.
+ * @param ndim Number of dimensions in indices.
+ * @param out_value Pointer to float where the value will be written.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_get(const cgrad_storage* t, const uint32_t* indices, int ndim, float* out_value) {
+    if (!t || !t->backend || !t->data) return CGRAD_ERR_NULL_POINTER;
+    if (!t->backend->storage_get) return CGRAD_ERR_NOT_IMPLEMENTED;
+    return t->backend->storage_get(t->data, indices, ndim, out_value);
+}
+
+/**
+ * @brief Print the tensor's shape and contents.
+ * @param t Pointer to tensor.
+ */
+void cgrad_storage_print(const cgrad_storage* t) {
+    if (!t || !t->backend || !t->data) return;
+    const cgrad_storage_layout* layout = t->backend->storage_get_layout(t->data);
+    printf("Shape: ");
+    cgrad_storage_layout_print_shape(layout, TENSOR_DIM);
+    t->backend->storage_print_data(t->data);
+}
+
+/**
+ * @brief Make a contiguous copy of a tensor into dst.
+ * @param src Source tensor.
+ * @param dst Destination tensor.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_contiguous(const cgrad_storage* src, cgrad_storage* dst) {
+    if (!dst || !src || !src->backend || !src->data)
+        return CGRAD_ERR_NULL_POINTER;
+    if (!src->backend->storage_contiguous)
+        return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    if (cgrad_storage_layout_is_contiguous(
+        src->backend->storage_get_layout(src->data)
+    )) {
+        // already contiguous, do a shallow copy
+        return cgrad_storage_shallow_copy(src, dst);
+    }
+    
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    uint32_t* src_shape = src->backend->storage_get_layout(src->data)->shape;
+    int err = cgrad_storage_init(dst, src_shape, TENSOR_DIM, src->backend->name);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    err = src->backend->storage_contiguous(src->data, dst->data);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Reshape a tensor, using layout reshape and backend copy ops.
+ * @param src Source tensor.
+ * @param dst Destination tensor.
+ * @param new_shape Array of new dimensions (length ndim, may contain one -1).
+ * @param ndim Number of dimensions in new_shape (<= TENSOR_DIM).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_reshape(const cgrad_storage* src, cgrad_storage* dst, const int32_t* new_shape, int ndim) {
+    if (!src || !src->backend || !src->data)
+        return CGRAD_ERR_NULL_POINTER;
+
+    if (dst->data) {
+        // TODO: write to existing buffer not supported yet
+        return CGRAD_ERR_NOT_IMPLEMENTED;
+    }
+    
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    if (cgrad_storage_layout_is_regular(src->backend->storage_get_layout(src->data))) {
+        // If src is regular, we can do a shallow copy
+        if (!src->backend->storage_shallow_copy)
+            return CGRAD_ERR_NOT_IMPLEMENTED;
+
+        int err = cgrad_storage_shallow_copy(src, dst);
+        if (err != CGRAD_SUCCESS) {
+            cgrad_storage_stop_recording(storage_record);
+            cgrad_storage_free_record(storage_record);
+            return err;
+        }
+    } else {
+        // If src is not regular, make a contiguous copy into dst
+        int err = cgrad_storage_contiguous(src, dst);
+        if (err != CGRAD_SUCCESS) {
+            cgrad_storage_stop_recording(storage_record);
+            cgrad_storage_free_record(storage_record);
+            return err;
+        }
+    }
+
+    int err = cgrad_storage_layout_reshape(
+        dst->backend->storage_get_layout(dst->data),
+        new_shape,
+        ndim
+    );
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Transpose the tensor according to the given permutation, applied to the last ndim dims.
+ * Creates a shallow copy of the source tensor and applies the transpose to the layout.
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + transpose).
+ * @param perm Permutation array (length ndim).
+ * @param ndim Number of trailing dimensions to permute (≤ TENSOR_DIM).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_transpose(const cgrad_storage* src, cgrad_storage* dst, const uint32_t* perm, int ndim) {
+    if (!src || !dst) return CGRAD_ERR_NULL_POINTER;
+    if (!src->backend || !src->data) return CGRAD_ERR_NULL_POINTER;
+    
+    // track all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    // Create shallow copy of source
+    int err = cgrad_storage_shallow_copy(src, dst);
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
         return err;
     }
     
@@ -637,7 +1529,190 @@ cgrad_status cgrad_storage_transpose(const cgrad_storage* src, cgrad_storage* ds
         return err;
     }
 
-    return CGRAD_SUCCESS;
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Copy the elements of src into the already initialized dst.
+ *        dst may be a strided view into a larger storage (e.g. a slice), which is
+ *        how cat writes its inputs directly into the output without temporaries.
+ * @param src Source tensor.
+ * @param dst Destination tensor with the same shape as src.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_copy(const cgrad_storage* src, cgrad_storage* dst) {
+    if (!src || !dst) return CGRAD_ERR_NULL_POINTER;
+    if (!src->backend || !src->data || !dst->backend || !dst->data) return CGRAD_ERR_NULL_POINTER;
+    if (src->backend != dst->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+    if (!src->backend->storage_copy) return CGRAD_ERR_NOT_IMPLEMENTED;
+
+    return src->backend->storage_copy(src->data, dst->data);
+}
+
+/**
+ * @brief Create a zero-copy view of the ranges [start, stop) with the given steps in the last ndim dims.
+ * Creates a shallow copy of the source tensor and restricts its layout.
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + slice).
+ * @param start Array of first indices (length ndim).
+ * @param stop Array of end indices, exclusive (length ndim).
+ * @param step Array of steps (length ndim), or NULL for all ones.
+ * @param ndim Number of trailing dimensions to slice (<= TENSOR_DIM).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_slice(
+    const cgrad_storage* src,
+    cgrad_storage* dst,
+    const uint32_t* start,
+    const uint32_t* stop,
+    const uint32_t* step,
+    int ndim
+) {
+    if (!src || !dst) return CGRAD_ERR_NULL_POINTER;
+    if (!src->backend || !src->data) return CGRAD_ERR_NULL_POINTER;
+
+    // track all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    int err = cgrad_storage_shallow_copy(src, dst);
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_layout_slice(dst->backend->storage_get_layout(dst->data), start, stop, step, ndim);
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Create a zero-copy view of the range [start, start + length) along a single dimension.
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + narrow).
+ * @param dim Dimension to narrow (negative dims count from the last dimension).
+ * @param start First index along dim.
+ * @param length Number of indices to keep.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_narrow(const cgrad_storage* src, cgrad_storage* dst, int dim, uint32_t start, uint32_t length) {
+    if (!src || !dst) return CGRAD_ERR_NULL_POINTER;
+    if (!src->backend || !src->data) return CGRAD_ERR_NULL_POINTER;
+
+    // track all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    int err = cgrad_storage_shallow_copy(src, dst);
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_layout_narrow(dst->backend->storage_get_layout(dst->data), dim, start, length);
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Create a zero-copy view of a single index along a dimension, dropping that dimension.
+ * @param src Source tensor.
+ * @param dst Destination tensor (will be initialized with shallow copy + select).
+ * @param dim Dimension to select from (negative dims count from the last dimension).
+ * @param index Index along dim.
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_select(const cgrad_storage* src, cgrad_storage* dst, int dim, uint32_t index) {
+    if (!src || !dst) return CGRAD_ERR_NULL_POINTER;
+    if (!src->backend || !src->data) return CGRAD_ERR_NULL_POINTER;
+
+    // track all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    int err = cgrad_storage_shallow_copy(src, dst);
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_layout_select(dst->backend->storage_get_layout(dst->data), dim, index);
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
+}
+
+/**
+ * @brief Concatenate n tensors along dim into a newly allocated dst.
+ *        Each input is copied directly into a narrowed view of dst, so no
+ *        intermediate storages are allocated.
+ * @param srcs Array of source tensors (length n).
+ * @param n Number of source tensors (>= 1).
+ * @param dim Dimension to concatenate along (negative dims count from the last dimension).
+ * @param dst Destination tensor (must be uninitialized).
+ * @return CGRAD_SUCCESS on success, error code otherwise.
+ */
+cgrad_status cgrad_storage_cat(const cgrad_storage* const* srcs, int n, int dim, cgrad_storage* dst) {
+    if (!srcs || !dst) return CGRAD_ERR_NULL_POINTER;
+    if (n < 1 || n > CGRAD_STORAGE_CAT_MAX_INPUTS) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    if (dst->data) {
+        // TODO: write to existing buffer not supported yet
+        return CGRAD_ERR_NOT_IMPLEMENTED;
+    }
+
+    const cgrad_storage_layout* layouts[CGRAD_STORAGE_CAT_MAX_INPUTS];
+    for (int k = 0; k < n; k++) {
+        if (!srcs[k] || !srcs[k]->backend || !srcs[k]->data) return CGRAD_ERR_NULL_POINTER;
+        if (srcs[k]->backend != srcs[0]->backend) return CGRAD_ERR_STORAGE_BACKEND_MISMATCH;
+        layouts[k] = srcs[k]->backend->storage_get_layout(srcs[k]->data);
+    }
+
+    cgrad_storage_layout out_layout;
+    int err = cgrad_storage_layout_cat(layouts, n, dim, &out_layout);
+    if (err != CGRAD_SUCCESS) return err;
+
+    // record all storages created here
+    cgrad_storage_registry_record* storage_record = cgrad_storage_start_recording();
+
+    err = cgrad_storage_init(dst, out_layout.shape, TENSOR_DIM, srcs[0]->backend->name);
+
+    // write every input into its slice of dst
+    cgrad_storage part;
+    int d = dim < 0 ? TENSOR_DIM + dim : dim;
+    uint32_t start = 0;
+    for (int k = 0; k < n && err == CGRAD_SUCCESS; k++) {
+        uint32_t length = layouts[k]->shape[d];
+        err = cgrad_storage_narrow(dst, &part, dim, start, length);
+        if (err == CGRAD_SUCCESS) {
+            err = cgrad_storage_copy(srcs[k], &part);
+            cgrad_storage_free(&part);
+        }
+        start += length;
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
+
+    // cleanup and do not free output storage
+    cgrad_storage_registry_record_remove(storage_record, dst);
+    cgrad_storage_stop_recording(storage_record);
+    return cgrad_storage_free_record(storage_record);
 }
 
 /**
@@ -674,7 +1749,11 @@ cgrad_status cgrad_storage_reduce(
     // Compute the target shape using layout reduce
     cgrad_storage_layout target_layout = *layout;
     int err = cgrad_storage_layout_reduce(&target_layout, mask, ndim);
-    if (err != CGRAD_SUCCESS) return err;
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return err;
+    }
 
     // Convert to int32_t for reshape
     int32_t target_shape[TENSOR_DIM];
@@ -728,16 +1807,21 @@ cgrad_status cgrad_storage_reduce(
         if (!full_mask[i]) kept_count++;
     }
 
-    // Compute dimensions
-    int32_t kept_size = 1, summed_size = 1;
+    // Compute dimensions (each becomes a single reshape dim, so both must fit into int32)
+    uint64_t kept_size = 1, summed_size = 1;
     for (int i = 0; i < TENSOR_DIM; ++i) {
         if (full_mask[i]) summed_size *= layout->shape[i];
         else kept_size *= layout->shape[i];
     }
+    if (kept_size > INT32_MAX || summed_size > INT32_MAX) {
+        cgrad_storage_stop_recording(storage_record);
+        cgrad_storage_free_record(storage_record);
+        return CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE;
+    }
 
     // Reshape to collapse kept and summed dims
     cgrad_storage a_reshaped = {0};
-    err = cgrad_storage_reshape(&a_perm, &a_reshaped, (const int32_t[]){kept_size, summed_size}, 2);
+    err = cgrad_storage_reshape(&a_perm, &a_reshaped, (const int32_t[]){(int32_t)kept_size, (int32_t)summed_size}, 2);
     if (err != CGRAD_SUCCESS) {
         cgrad_storage_stop_recording(storage_record);
         cgrad_storage_free_record(storage_record);
@@ -746,7 +1830,7 @@ cgrad_status cgrad_storage_reduce(
     
     // Create ones tensor of shape (summed_size, 1)
     cgrad_storage ones = {0};
-    err = cgrad_storage_init(&ones, (const uint32_t[]){summed_size, 1}, 2, a_perm.backend->name);
+    err = cgrad_storage_init(&ones, (const uint32_t[]){(uint32_t)summed_size, 1}, 2, a_perm.backend->name);
     if (err != CGRAD_SUCCESS) {
         cgrad_storage_stop_recording(storage_record);
         cgrad_storage_free_record(storage_record);
@@ -0,0 +1,409 @@
+#include "storage/cgrad_storage_file.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+#include "cgrad_status.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief File header, stored at offset 0.
+ */
+typedef struct cgrad_storage_file_header {
+    char magic[8];              /**< CGRAD_STORAGE_FILE_MAGIC */
+    uint32_t version;           /**< CGRAD_STORAGE_FILE_VERSION */
+    uint32_t num_tensors;       /**< Number of entries in the tensor table */
+    uint64_t file_size;         /**< Total size of the file in bytes (detects truncated files) */
+    uint64_t reserved[5];
+} cgrad_storage_file_header;
+
+/**
+ * @brief Tensor table entry, the table directly follows the header.
+ */
+typedef struct cgrad_storage_file_entry {
+    char name[CGRAD_STORAGE_FILE_NAME_MAX];    /**< NUL-terminated tensor name */
+    uint32_t dtype;                             /**< cgrad_storage_file_dtype */
+    uint32_t ndim;                              /**< Number of used entries in shape and strides (<= TENSOR_DIM) */
+    uint32_t shape[TENSOR_DIM];                 /**< Shape, first ndim entries */
+    uint64_t strides[TENSOR_DIM];               /**< Element strides, first ndim entries */
+    uint64_t data_offset;                       /**< Byte offset of the data from the start of the file */
+    uint64_t nbytes;                            /**< Size of the data block in bytes */
+} cgrad_storage_file_entry;
+
+_Static_assert(sizeof(cgrad_storage_file_header) == 64, "unexpected header padding");
+_Static_assert(sizeof(cgrad_storage_file_entry) % 8 == 0, "unexpected entry padding");
+
+struct cgrad_storage_file {
+    void* base;                                 /**< Start of the read-only mapping */
+    size_t size;                                /**< Size of the mapping in bytes */
+    int num_tensors;
+    const cgrad_storage_file_entry* entries;    /**< Tensor table inside the mapping */
+    size_t refs;                                /**< File handle plus one per loaded storage */
+};
+
+static uint64_t storage_file_align(uint64_t offset) {
+    return (offset + CGRAD_STORAGE_FILE_ALIGNMENT - 1) / CGRAD_STORAGE_FILE_ALIGNMENT * CGRAD_STORAGE_FILE_ALIGNMENT;
+}
+
+// Drop one reference to the mapping, unmapping it with the last one.
+// Used as release callback of loaded storages, which may be freed from any thread.
+static void storage_file_release(void* ctx) {
+    cgrad_storage_file* file = (cgrad_storage_file*)ctx;
+    if (__atomic_sub_fetch(&file->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        munmap(file->base, file->size);
+        free(file);
+    }
+}
+
+// Validate names and storages and build the header and tensor table of a file holding them.
+// Data blocks are laid out back to back behind the table, each aligned to CGRAD_STORAGE_FILE_ALIGNMENT.
+// On success the caller owns *out_entries.
+static cgrad_status storage_file_plan(
+    const char* const* names,
+    const cgrad_storage* const* storages,
+    int n,
+    cgrad_storage_file_header* out_header,
+    cgrad_storage_file_entry** out_entries
+) {
+    if (n > 0 && (!names || !storages)) return CGRAD_ERR_NULL_POINTER;
+    if (n < 0) return CGRAD_ERR_STORAGE_FILE_INVALID;
+
+    for (int i = 0; i < n; i++) {
+        if (!names[i] || !storages[i] || !storages[i]->backend || !storages[i]->data) return CGRAD_ERR_NULL_POINTER;
+        if (strlen(names[i]) >= CGRAD_STORAGE_FILE_NAME_MAX) return CGRAD_ERR_STORAGE_FILE_INVALID;
+        for (int j = 0; j < i; j++) {
+            if (strcmp(names[i], names[j]) == 0) return CGRAD_ERR_STORAGE_FILE_INVALID;
+        }
+    }
+
+    cgrad_storage_file_entry* entries = (cgrad_storage_file_entry*)calloc(n > 0 ? n : 1, sizeof(cgrad_storage_file_entry));
+    if (!entries) return CGRAD_ERR_ALLOC_FAILED;
+
+    uint64_t offset = storage_file_align(sizeof(cgrad_storage_file_header) + (uint64_t)n * sizeof(cgrad_storage_file_entry));
+    for (int i = 0; i < n; i++) {
+        const cgrad_storage_layout* src = storages[i]->backend->storage_get_layout(storages[i]->data);
+        cgrad_storage_layout dense;
+        cgrad_storage_layout_init(&dense, src->shape, TENSOR_DIM);
+
+        strcpy(entries[i].name, names[i]);
+        entries[i].dtype = CGRAD_STORAGE_FILE_DTYPE_F32;
+        entries[i].ndim = TENSOR_DIM;
+        memcpy(entries[i].shape, dense.shape, sizeof(dense.shape));
+        memcpy(entries[i].strides, dense.strides, sizeof(dense.strides));
+        entries[i].data_offset = offset;
+        entries[i].nbytes = dense.size * sizeof(float);
+        offset = storage_file_align(offset + entries[i].nbytes);
+    }
+
+    memset(out_header, 0, sizeof(*out_header));
+    memcpy(out_header->magic, CGRAD_STORAGE_FILE_MAGIC, sizeof(CGRAD_STORAGE_FILE_MAGIC));
+    out_header->version = CGRAD_STORAGE_FILE_VERSION;
+    out_header->num_tensors = (uint32_t)n;
+    out_header->file_size = offset;
+
+    *out_entries = entries;
+    return CGRAD_SUCCESS;
+}
+
+// Fill in header, tensor table and data blocks of a planned file image.
+// Every storage is copied straight into its data block through a wrapped view of the image.
+static cgrad_status storage_file_fill(
+    void* base,
+    const cgrad_storage_file_header* header,
+    const cgrad_storage_file_entry* entries,
+    const cgrad_storage* const* storages,
+    int n
+) {
+    memcpy(base, header, sizeof(*header));
+    memcpy((char*)base + sizeof(*header), entries, (size_t)n * sizeof(cgrad_storage_file_entry));
+
+    // zero the alignment padding, the image may live in uninitialized memory
+    uint64_t end = sizeof(*header) + (uint64_t)n * sizeof(cgrad_storage_file_entry);
+    for (int i = 0; i < n; i++) {
+        memset((char*)base + end, 0, entries[i].data_offset - end);
+        end = entries[i].data_offset + entries[i].nbytes;
+    }
+    memset((char*)base + end, 0, header->file_size - end);
+
+    cgrad_status err = CGRAD_SUCCESS;
+    for (int i = 0; i < n && err == CGRAD_SUCCESS; i++) {
+        if (entries[i].nbytes == 0) continue;
+        cgrad_storage_layout dense;
+        cgrad_storage_layout_init(&dense, entries[i].shape, TENSOR_DIM);
+        cgrad_storage dst = {0};
+        err = cgrad_storage_wrap(&dst, &dense, (char*)base + entries[i].data_offset, NULL, NULL, storages[i]->backend->name);
+        if (err != CGRAD_SUCCESS) break;
+        err = cgrad_storage_copy(storages[i], &dst);
+        cgrad_storage_free(&dst);
+    }
+    return err;
+}
+
+// Allocate the file behind fd, map it and fill in the planned image. The blocks are reserved
+// up front: a page fault on a sparse mapping that finds the disk full raises SIGBUS instead of
+// returning an error.
+static cgrad_status storage_file_write(
+    int fd,
+    const cgrad_storage_file_header* header,
+    const cgrad_storage_file_entry* entries,
+    const cgrad_storage* const* storages,
+    int n
+) {
+    size_t file_size = header->file_size;
+    if (posix_fallocate(fd, 0, (off_t)file_size) != 0) return CGRAD_ERR_STORAGE_FILE_IO;
+    void* base = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) return CGRAD_ERR_STORAGE_FILE_IO;
+
+    cgrad_status err = storage_file_fill(base, header, entries, storages, n);
+
+    if (munmap(base, file_size) != 0 && err == CGRAD_SUCCESS) err = CGRAD_ERR_STORAGE_FILE_IO;
+    return err;
+}
+
+/**
+ * @brief Write storages to a tensor file, replacing any existing file at path.
+ *        The file is written under a temporary name and renamed into place, so readers
+ *        never observe a partially written file.
+ */
+cgrad_status cgrad_storage_save(const char* path, const char* const* names, const cgrad_storage* const* storages, int n) {
+    if (!path) return CGRAD_ERR_NULL_POINTER;
+
+    cgrad_storage_file_header header;
+    cgrad_storage_file_entry* entries;
+    cgrad_status err = storage_file_plan(names, storages, n, &header, &entries);
+    if (err != CGRAD_SUCCESS) return err;
+
+    size_t path_len = strlen(path);
+    char* tmp_path = (char*)malloc(path_len + 5);
+    if (!tmp_path) {
+        free(entries);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".tmp", 5);
+
+    err = CGRAD_ERR_STORAGE_FILE_IO;
+    int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        err = storage_file_write(fd, &header, entries, storages, n);
+        if (close(fd) != 0 && err == CGRAD_SUCCESS) err = CGRAD_ERR_STORAGE_FILE_IO;
+        if (err == CGRAD_SUCCESS && rename(tmp_path, path) != 0) err = CGRAD_ERR_STORAGE_FILE_IO;
+        if (err != CGRAD_SUCCESS) unlink(tmp_path);
+    }
+    free(tmp_path);
+    free(entries);
+    return err;
+}
+
+/**
+ * @brief Compute the size of the tensor file image holding the given storages.
+ */
+cgrad_status cgrad_storage_serialized_size(const char* const* names, const cgrad_storage* const* storages, int n, uint64_t* out_size) {
+    if (!out_size) return CGRAD_ERR_NULL_POINTER;
+
+    cgrad_storage_file_header header;
+    cgrad_storage_file_entry* entries;
+    cgrad_status err = storage_file_plan(names, storages, n, &header, &entries);
+    if (err != CGRAD_SUCCESS) return err;
+    free(entries);
+
+    *out_size = header.file_size;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Write the tensor file image holding the given storages into a memory buffer.
+ */
+cgrad_status cgrad_storage_serialize(const char* const* names, const cgrad_storage* const* storages, int n, void* buffer, uint64_t size) {
+    if (!buffer) return CGRAD_ERR_NULL_POINTER;
+
+    cgrad_storage_file_header header;
+    cgrad_storage_file_entry* entries;
+    cgrad_status err = storage_file_plan(names, storages, n, &header, &entries);
+    if (err != CGRAD_SUCCESS) return err;
+
+    if (size < header.file_size) {
+        err = CGRAD_ERR_STORAGE_FILE_INVALID;
+    } else {
+        err = storage_file_fill(buffer, &header, entries, storages, n);
+    }
+    free(entries);
+    return err;
+}
+
+// Check that an entry is well-formed and that all elements it addresses lie inside the file
+static int storage_file_entry_valid(const cgrad_storage_file_entry* e, size_t file_size) {
+    if (memchr(e->name, '\0', sizeof(e->name)) == NULL) return 0;
+    if (e->dtype != CGRAD_STORAGE_FILE_DTYPE_F32 || e->ndim > TENSOR_DIM) return 0;
+    if (e->data_offset % CGRAD_STORAGE_FILE_ALIGNMENT != 0) return 0;
+    if (e->data_offset > file_size || e->nbytes > file_size - e->data_offset) return 0;
+
+    // index of the last addressed element; bounding every stride and partial sum by the
+    // number of elements in the block keeps the products from overflowing
+    uint64_t num_elements = e->nbytes / sizeof(float);
+    uint64_t last = 0;
+    for (uint32_t i = 0; i < e->ndim; i++) {
+        if (e->shape[i] == 0) return 1;
+        if (e->strides[i] > num_elements) return 0;
+        last += (uint64_t)(e->shape[i] - 1) * e->strides[i];
+        if (last >= num_elements) return 0;
+    }
+    return num_elements > 0;
+}
+
+/**
+ * @brief Open a tensor file by mapping it read-only into memory and validating its header.
+ */
+cgrad_status cgrad_storage_file_open(const char* path, cgrad_storage_file** out) {
+    if (!path || !out) return CGRAD_ERR_NULL_POINTER;
+    *out = NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return CGRAD_ERR_STORAGE_FILE_IO;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return CGRAD_ERR_STORAGE_FILE_IO;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(cgrad_storage_file_header)) {
+        close(fd);
+        return CGRAD_ERR_STORAGE_FILE_INVALID;
+    }
+
+    // MAP_SHARED keeps the pages in the page cache, so other processes mapping the same file reuse them
+    void* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return CGRAD_ERR_STORAGE_FILE_IO;
+
+    const cgrad_storage_file_header* header = (const cgrad_storage_file_header*)base;
+    int valid = memcmp(header->magic, CGRAD_STORAGE_FILE_MAGIC, sizeof(CGRAD_STORAGE_FILE_MAGIC)) == 0
+        && header->version == CGRAD_STORAGE_FILE_VERSION
+        && header->file_size == size
+        && header->num_tensors <= (size - sizeof(*header)) / sizeof(cgrad_storage_file_entry);
+    const cgrad_storage_file_entry* entries = (const cgrad_storage_file_entry*)(header + 1);
+    for (uint32_t i = 0; valid && i < header->num_tensors; i++) {
+        valid = storage_file_entry_valid(&entries[i], size);
+    }
+    if (!valid) {
+        munmap(base, size);
+        return CGRAD_ERR_STORAGE_FILE_INVALID;
+    }
+
+    cgrad_storage_file* file = (cgrad_storage_file*)malloc(sizeof(cgrad_storage_file));
+    if (!file) {
+        munmap(base, size);
+        return CGRAD_ERR_ALLOC_FAILED;
+    }
+    file->base = base;
+    file->size = size;
+    file->num_tensors = (int)header->num_tensors;
+    file->entries = entries;
+    file->refs = 1;
+
+    *out = file;
+    return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Release the file handle. The mapping is unmapped once all storages loaded from it are freed.
+ */
+void cgrad_storage_file_close(cgrad_storage_file* file) {
+    if (!file) return;
+    storage_file_release(file);
+}
+
+/**
+ * @brief Get the number of tensors stored in the file.
+ */
+int cgrad_storage_file_num_tensors(const cgrad_storage_file* file) {
+    return file ? file->num_tensors : 0;
+}
+
+/**
+ * @brief Get the name of the i-th tensor in the file.
+ */
+const char* cgrad_storage_file_tensor_name(const cgrad_storage_file* file, int i) {
+    if (!file || i < 0 || i >= file->num_tensors) return NULL;
+    return file->entries[i].name;
+}
+
+// Find an entry by name and build the layout of its data block
+static cgrad_status storage_file_find(
+    const cgrad_storage_file* file,
+    const char* name,
+    const cgrad_storage_file_entry** out_entry,
+    cgrad_storage_layout* out_layout
+) {
+    for (int i = 0; i < file->num_tensors; i++) {
+        const cgrad_storage_file_entry* e = &file->entries[i];
+        if (strcmp(e->name, name) != 0) continue;
+
+        // stored dims are right-aligned like in cgrad_storage_layout_init
+        cgrad_storage_layout_init(out_layout, e->shape, (int)e->ndim);
+        int lead = TENSOR_DIM - (int)e->ndim;
+        for (int d = 0; d < (int)e->ndim; d++) {
+            out_layout->strides[lead + d] = e->strides[d];
+        }
+        for (int d = lead - 1; d >= 0; d--) {
+            out_layout->strides[d] = out_layout->strides[d + 1] * out_layout->shape[d + 1];
+        }
+        *out_entry = e;
+        return CGRAD_SUCCESS;
+    }
+    return CGRAD_ERR_STORAGE_FILE_TENSOR_NOT_FOUND;
+}
+
+/**
+ * @brief Wrap a tensor of the file as cpu_f32 storage without copying its data.
+ */
+cgrad_status cgrad_storage_load_mmap(cgrad_storage_file* file, const char* name, cgrad_storage* out) {
+    if (!file || !name || !out) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_storage_file_entry* entry;
+    cgrad_storage_layout layout;
+    cgrad_status err = storage_file_find(file, name, &entry, &layout);
+    if (err != CGRAD_SUCCESS) return err;
+
+    // the storage holds a reference to the mapping until it is freed
+    __atomic_add_fetch(&file->refs, 1, __ATOMIC_RELAXED);
+    void* data = (char*)file->base + entry->data_offset;
+    err = cgrad_storage_wrap(out, &layout, data, storage_file_release, file, "cpu_f32");
+    if (err != CGRAD_SUCCESS) {
+        storage_file_release(file);
+    }
+    return err;
+}
+
+/**
+ * @brief Copy a tensor of the file into newly allocated, writable storage.
+ */
+cgrad_status cgrad_storage_file_load(cgrad_storage_file* file, const char* name, cgrad_storage* out, const char* backend_name) {
+    if (!file || !name || !out) return CGRAD_ERR_NULL_POINTER;
+
+    const cgrad_storage_file_entry* entry;
+    cgrad_storage_layout layout;
+    cgrad_status err = storage_file_find(file, name, &entry, &layout);
+    if (err != CGRAD_SUCCESS) return err;
+
+    err = cgrad_storage_init(out, layout.shape, TENSOR_DIM, backend_name);
+    if (err != CGRAD_SUCCESS) return err;
+    if (layout.size == 0) return CGRAD_SUCCESS;
+
+    // the mapping is only read during the copy, so the temporary view needs no reference
+    cgrad_storage src = {0};
+    err = cgrad_storage_wrap(&src, &layout, (char*)file->base + entry->data_offset, NULL, NULL, "cpu_f32");
+    if (err == CGRAD_SUCCESS) {
+        err = cgrad_storage_copy(&src, out);
+        cgrad_storage_free(&src);
+    }
+    if (err != CGRAD_SUCCESS) {
+        cgrad_storage_free(out);
+    }
+    return err;
+}
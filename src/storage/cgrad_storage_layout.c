@@ -35,7 +35,7 @@ cgrad_status cgrad_storage_layout_init(cgrad_storage_layout* l, const uint32_t*
     l->strides[i] = l->strides[i + 1] * l->shape[i + 1];
   }
   // Compute size
-  uint32_t size = 1;
+  uint64_t size = 1;
   for (int i = 0; i < TENSOR_DIM; i++) {
     size *= l->shape[i];
   }
@@ -93,21 +93,22 @@ void cgrad_storage_layout_print_shape(const cgrad_storage_layout* l, int ndim) {
 
 /**
  * @brief Compute the flat index in the data array for the given indices and layout.
+ *        The index includes the layout offset.
  *        Indices of length ndim are mapped to the last ndim dims; leading indices behave as 0.
  */
 cgrad_status cgrad_storage_layout_flat_index(const cgrad_storage_layout* layout, const uint32_t* indices, int ndim, size_t* out_flat_index) {
   if (!layout || !indices || !out_flat_index) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
   if (ndim < 0 || ndim > TENSOR_DIM) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
-  size_t idx = 0;
-  for (int i = 0; i < TENSOR_DIM; i++) {
-    uint32_t ind = 0;
-    if (i >= TENSOR_DIM - ndim) {
-      ind = indices[i - (TENSOR_DIM - ndim)];
-    }
-    if (ind >= layout->shape[i]) {
+  // leading dims are indexed with 0, which is only out of bounds for an empty layout
+  if (layout->size == 0) return CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS;
+  const uint32_t* shape = layout->shape + (TENSOR_DIM - ndim);
+  const uint64_t* strides = layout->strides + (TENSOR_DIM - ndim);
+  size_t idx = layout->offset;
+  for (int i = 0; i < ndim; i++) {
+    if (indices[i] >= shape[i]) {
       return CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS;
     }
-    idx += ind * layout->strides[i];
+    idx += (size_t)indices[i] * strides[i];
   }
   *out_flat_index = idx;
   return CGRAD_SUCCESS;
@@ -165,6 +166,63 @@ cgrad_status cgrad_storage_layout_broadcast(
     return CGRAD_SUCCESS;
 }
 
+/**
+ * @brief Collapse n equally shaped layouts to their joint effective rank.
+ */
+cgrad_status cgrad_storage_layout_collapse(const cgrad_storage_layout* const* layouts, int n, cgrad_storage_layout_collapsed* out) {
+  if (!layouts || !out) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+  if (n < 1 || n > CGRAD_STORAGE_LAYOUT_COLLAPSE_MAX) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+  for (int k = 0; k < n; k++) {
+    if (!layouts[k]) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+    if (memcmp(layouts[k]->shape, layouts[0]->shape, sizeof(layouts[0]->shape)) != 0) {
+      return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    }
+  }
+  const uint32_t* shape = layouts[0]->shape;
+
+  out->rank = 0;
+  if (layouts[0]->size == 0) {
+    out->rank = 1;
+    out->shape[0] = 0;
+    for (int k = 0; k < n; k++) out->strides[k][0] = 0;
+    return CGRAD_SUCCESS;
+  }
+
+  // Walk from the innermost dim outwards, collecting the merged dims in reverse order
+  uint64_t extent = 0;
+  for (int d = TENSOR_DIM - 1; d >= 0; d--) {
+    if (shape[d] == 1) continue;
+    int r = out->rank - 1;
+    int mergeable = (r >= 0);
+    for (int k = 0; k < n && mergeable; k++) {
+      mergeable = layouts[k]->strides[d] == out->strides[k][r] * extent;
+    }
+    // merged extents must still fit a single dim
+    if (mergeable && extent * shape[d] <= UINT32_MAX) {
+      extent *= shape[d];
+      out->shape[r] = (uint32_t)extent;
+    } else {
+      r = out->rank++;
+      extent = shape[d];
+      out->shape[r] = shape[d];
+      for (int k = 0; k < n; k++) out->strides[k][r] = layouts[k]->strides[d];
+    }
+  }
+
+  // Reverse to store the innermost dim last
+  for (int i = 0, j = out->rank - 1; i < j; i++, j--) {
+    uint32_t s = out->shape[i];
+    out->shape[i] = out->shape[j];
+    out->shape[j] = s;
+    for (int k = 0; k < n; k++) {
+      uint64_t t = out->strides[k][i];
+      out->strides[k][i] = out->strides[k][j];
+      out->strides[k][j] = t;
+    }
+  }
+  return CGRAD_SUCCESS;
+}
+
 /**
  * @brief Transpose the layout according to the given permutation, applied to the last ndim dims.
  */
@@ -180,7 +238,7 @@ cgrad_status cgrad_storage_layout_transpose(cgrad_storage_layout* layout, const
   }
   // Copy leading dims unchanged, permute last ndim dims
   uint32_t new_shape[TENSOR_DIM];
-  uint32_t new_strides[TENSOR_DIM];
+  uint64_t new_strides[TENSOR_DIM];
   int offset = TENSOR_DIM - ndim;
   for (int i = 0; i < offset; i++) {
     new_shape[i] = layout->shape[i];
@@ -207,10 +265,10 @@ cgrad_status cgrad_storage_layout_is_regular(const cgrad_storage_layout* l) {
   if (!l) return 0;
   if (TENSOR_DIM == 0) return 1;
   // Find the scaling factor k (stride of last dim)
-  uint32_t k = l->strides[TENSOR_DIM - 1];
+  uint64_t k = l->strides[TENSOR_DIM - 1];
   if (k == 0) return 0;
   // Check all strides
-  uint32_t expected = k;
+  uint64_t expected = k;
   for (int i = TENSOR_DIM - 1; i >= 0; i--) {
     if (l->strides[i] != expected) return 0;
     if (i > 0) expected *= l->shape[i];
@@ -246,7 +304,7 @@ cgrad_status cgrad_storage_layout_reshape(cgrad_storage_layout* layout, const in
 
   // Validate new_shape and find -1
   int minus1_idx = -1;
-  uint32_t new_size = 1;
+  uint64_t new_size = 1;
   for (int i = 0; i < ndim; ++i) {
     if (new_shape[i] == -1) {
       if (minus1_idx != -1) return CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE; // More than one -1
@@ -254,14 +312,15 @@ cgrad_status cgrad_storage_layout_reshape(cgrad_storage_layout* layout, const in
     } else if (new_shape[i] <= 0) {
       return CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE;
     } else {
-      new_size *= (uint32_t)new_shape[i];
+      new_size *= (uint64_t)new_shape[i];
     }
   }
 
   uint32_t inferred_dim = 0;
   if (minus1_idx != -1) {
     if (new_size == 0 || layout->size % new_size != 0) return CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE;
-    inferred_dim = layout->size / new_size;
+    if (layout->size / new_size > UINT32_MAX) return CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE;
+    inferred_dim = (uint32_t)(layout->size / new_size);
     if (inferred_dim == 0) return CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE;
   } else {
     if (new_size != layout->size) return CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE;
@@ -282,8 +341,8 @@ cgrad_status cgrad_storage_layout_reshape(cgrad_storage_layout* layout, const in
   }
 
   // Compute new strides: like contiguous, but scale by original step size
-  uint32_t step = layout->strides[TENSOR_DIM - 1];
-  uint32_t cur_stride = step;
+  uint64_t step = layout->strides[TENSOR_DIM - 1];
+  uint64_t cur_stride = step;
   for (int i = TENSOR_DIM - 1; i >= 0; --i) {
     layout->strides[i] = cur_stride;
     cur_stride *= layout->shape[i];
@@ -291,3 +350,156 @@ cgrad_status cgrad_storage_layout_reshape(cgrad_storage_layout* layout, const in
 
   return CGRAD_SUCCESS;
 }
+
+/**
+ * @brief Map a dim argument (negative = counted from the last dim) to an index into the layout.
+ *        Returns -1 if the dim is out of range.
+ */
+static int layout_resolve_dim(int dim) {
+  int d = (dim < 0) ? TENSOR_DIM + dim : dim;
+  return (d >= 0 && d < TENSOR_DIM) ? d : -1;
+}
+
+/**
+ * @brief Recompute the size of a view and give its unit dims the strides of a regular layout,
+ *        so that views of consecutive rows are still recognized as regular/contiguous.
+ */
+static void layout_finish_view(cgrad_storage_layout* layout) {
+  layout->size = 1;
+  for (int i = 0; i < TENSOR_DIM; i++) {
+    layout->size *= layout->shape[i];
+  }
+  for (int i = TENSOR_DIM - 2; i >= 0; i--) {
+    if (layout->shape[i] == 1) {
+      layout->strides[i] = layout->strides[i + 1] * layout->shape[i + 1];
+    }
+  }
+}
+
+/**
+ * @brief Restrict the last ndim dims of the layout to the ranges [start, stop) taken with the given steps.
+ */
+cgrad_status cgrad_storage_layout_slice(
+    cgrad_storage_layout* layout,
+    const uint32_t* start,
+    const uint32_t* stop,
+    const uint32_t* step,
+    int ndim
+) {
+  if (!layout || !start || !stop) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+  if (ndim < 0 || ndim > TENSOR_DIM) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+
+  // validate all ranges before touching the layout
+  int offset = TENSOR_DIM - ndim;
+  for (int i = 0; i < ndim; i++) {
+    uint32_t k = step ? step[i] : 1;
+    if (k == 0 || start[i] > stop[i] || stop[i] > layout->shape[offset + i]) {
+      return CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS;
+    }
+  }
+
+  for (int i = 0; i < ndim; i++) {
+    int d = offset + i;
+    uint32_t k = step ? step[i] : 1;
+    layout->offset += start[i] * layout->strides[d];
+    layout->shape[d] = (stop[i] - start[i] + k - 1) / k;
+    layout->strides[d] *= k;
+  }
+  layout_finish_view(layout);
+  return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Restrict a single dimension of the layout to [start, start + length).
+ */
+cgrad_status cgrad_storage_layout_narrow(cgrad_storage_layout* layout, int dim, uint32_t start, uint32_t length) {
+  if (!layout) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+  int d = layout_resolve_dim(dim);
+  if (d < 0) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+  if ((uint64_t)start + length > layout->shape[d]) return CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS;
+
+  layout->offset += start * layout->strides[d];
+  layout->shape[d] = length;
+  layout_finish_view(layout);
+  return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Pick a single index along a dimension and drop that dimension.
+ */
+cgrad_status cgrad_storage_layout_select(cgrad_storage_layout* layout, int dim, uint32_t index) {
+  if (!layout) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+  int d = layout_resolve_dim(dim);
+  if (d < 0) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+  if (index >= layout->shape[d]) return CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS;
+
+  layout->offset += index * layout->strides[d];
+
+  // shift the leading dims right by one to drop dim
+  for (int i = d; i > 0; i--) {
+    layout->shape[i] = layout->shape[i - 1];
+    layout->strides[i] = layout->strides[i - 1];
+  }
+  layout->shape[0] = 1;
+  layout_finish_view(layout);
+  return CGRAD_SUCCESS;
+}
+
+/**
+ * @brief Compute the layout of the concatenation of n layouts along dim.
+ */
+cgrad_status cgrad_storage_layout_cat(const cgrad_storage_layout* const* layouts, int n, int dim, cgrad_storage_layout* out) {
+  if (!layouts || !out) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+  if (n < 1) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+  int d = layout_resolve_dim(dim);
+  if (d < 0) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+
+  uint32_t shape[TENSOR_DIM];
+  memcpy(shape, layouts[0]->shape, sizeof(shape));
+  shape[d] = 0;
+  for (int k = 0; k < n; k++) {
+    if (!layouts[k]) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+    for (int i = 0; i < TENSOR_DIM; i++) {
+      if (i != d && layouts[k]->shape[i] != shape[i]) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    }
+    shape[d] += layouts[k]->shape[d];
+  }
+  return cgrad_storage_layout_init(out, shape, TENSOR_DIM);
+}
+
+/**
+ * @brief Compute the output layout of a 2D convolution and set params->kernel from w.
+ */
+cgrad_status cgrad_storage_layout_conv2d(
+    const cgrad_storage_layout* x,
+    const cgrad_storage_layout* w,
+    cgrad_conv2d_params* params,
+    cgrad_storage_layout* out
+) {
+  if (!x || !w || !params || !out) return CGRAD_ERR_STORAGE_LAYOUT_NULL_POINTER;
+
+  // only (N, C, H, W) inputs and (O, C, KH, KW) weights
+  for (int i = 0; i < TENSOR_DIM - 4; ++i) {
+    if (x->shape[i] != 1 || w->shape[i] != 1) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+  }
+  if (x->shape[TENSOR_DIM - 3] != w->shape[TENSOR_DIM - 3]) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+
+  uint32_t out_hw[2];
+  for (int i = 0; i < 2; ++i) {
+    if (params->stride[i] == 0 || params->dilation[i] == 0) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    uint32_t kernel = w->shape[TENSOR_DIM - 2 + i];
+    uint64_t padded = (uint64_t)x->shape[TENSOR_DIM - 2 + i] + 2 * (uint64_t)params->padding[i];
+    uint64_t extent = (uint64_t)params->dilation[i] * (kernel - 1) + 1;
+    if (kernel == 0 || extent > padded) return CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH;
+    params->kernel[i] = kernel;
+    out_hw[i] = (uint32_t)((padded - extent) / params->stride[i] + 1);
+  }
+
+  uint32_t out_shape[4] = {
+    x->shape[TENSOR_DIM - 4],
+    w->shape[TENSOR_DIM - 4],
+    out_hw[0],
+    out_hw[1]
+  };
+  return cgrad_storage_layout_init(out, out_shape, 4);
+}
@@ -257,6 +257,12 @@ cgrad_status cgrad_storage_registry_deregister_and_delete_bucket(cgrad_storage_r
     // Remove t from bucket's tensor_map
     remove_from_bucket(bucket, t);
 
+    // Remove t from all active records
+    cgrad_storage_registry_record *record, *tmp_record;
+    HASH_ITER(hh, registry->active_records, record, tmp_record) {
+        cgrad_storage_registry_record_remove(record, t);
+    }
+
     // Remove t from registry
     HASH_DEL(registry->storage_map, reg_entry);
     free(reg_entry);
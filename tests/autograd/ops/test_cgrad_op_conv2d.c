@@ -0,0 +1,321 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cgrad.h"
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+#define OP_CONV2D_EPSILON 1e-4f
+#define OP_CONV2D_GRAD_INIT 0.5f
+
+typedef struct conv2d_test_case {
+    uint32_t n, c, h, w, o, kh, kw;
+    cgrad_conv2d_params params;
+} conv2d_test_case;
+
+// ============================================================================
+// Reference Implementation
+// ============================================================================
+
+static uint32_t conv2d_out_dim(uint32_t in, uint32_t k, uint32_t stride, uint32_t pad, uint32_t dil) {
+    return (in + 2 * pad - dil * (k - 1) - 1) / stride + 1;
+}
+
+// Naive convolution; also scatters grad_y into grad_x and grad_w when grad_y is given
+static void conv2d_ref(
+    const conv2d_test_case* tc,
+    const float* x, const float* w, const float* grad_y,
+    double* y, double* grad_x, double* grad_w
+) {
+    const cgrad_conv2d_params* p = &tc->params;
+    uint32_t oh = conv2d_out_dim(tc->h, tc->kh, p->stride[0], p->padding[0], p->dilation[0]);
+    uint32_t ow = conv2d_out_dim(tc->w, tc->kw, p->stride[1], p->padding[1], p->dilation[1]);
+
+    for (uint32_t n = 0; n < tc->n; n++)
+    for (uint32_t o = 0; o < tc->o; o++)
+    for (uint32_t i = 0; i < oh; i++)
+    for (uint32_t j = 0; j < ow; j++) {
+        size_t yi = ((n * tc->o + o) * oh + i) * ow + j;
+        double acc = 0.0;
+        for (uint32_t c = 0; c < tc->c; c++)
+        for (uint32_t ki = 0; ki < tc->kh; ki++)
+        for (uint32_t kj = 0; kj < tc->kw; kj++) {
+            int64_t hi = (int64_t)i * p->stride[0] - p->padding[0] + ki * p->dilation[0];
+            int64_t wj = (int64_t)j * p->stride[1] - p->padding[1] + kj * p->dilation[1];
+            if (hi < 0 || hi >= tc->h || wj < 0 || wj >= tc->w) continue;
+            size_t xi = ((n * tc->c + c) * tc->h + hi) * tc->w + wj;
+            size_t wi = ((o * tc->c + c) * tc->kh + ki) * tc->kw + kj;
+            acc += (double)x[xi] * w[wi];
+            if (grad_y) {
+                grad_x[xi] += (double)grad_y[yi] * w[wi];
+                grad_w[wi] += (double)grad_y[yi] * x[xi];
+            }
+        }
+        y[yi] = acc;
+    }
+}
+
+// Convert a flat index into the 4D index of a (N, C, H, W) storage
+static void conv2d_unflatten(const cgrad_storage* t, size_t flat, uint32_t idx[4]) {
+    const uint32_t* shape = t->backend->storage_get_layout(t->data)->shape + TENSOR_DIM - 4;
+    for (int d = 3; d >= 0; d--) {
+        idx[d] = (uint32_t)(flat % shape[d]);
+        flat /= shape[d];
+    }
+}
+
+// Fill a storage with a deterministic pattern and mirror it into values
+static void conv2d_fill_pattern(cgrad_storage* t, float* values, float scale, float phase) {
+    size_t size = t->backend->storage_get_layout(t->data)->size;
+    for (size_t i = 0; i < size; i++) {
+        uint32_t idx[4];
+        conv2d_unflatten(t, i, idx);
+        values[i] = sinf(scale * (float)i + phase);
+        t->backend->storage_set(t->data, idx, 4, values[i]);
+    }
+}
+
+static void assert_conv2d_close(const cgrad_storage* t, const double* expected) {
+    size_t size = t->backend->storage_get_layout(t->data)->size;
+    for (size_t i = 0; i < size; i++) {
+        uint32_t idx[4];
+        float value;
+        conv2d_unflatten(t, i, idx);
+        cgrad_storage_get(t, idx, 4, &value);
+        assert_true(fabs(value - expected[i]) <= OP_CONV2D_EPSILON * fmax(1.0, fabs(expected[i])));
+    }
+}
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int conv2d_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int conv2d_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// Run forward (and backward if requested) of the conv2d op and compare with the reference
+static void check_conv2d_op(const conv2d_test_case* tc, cgrad_conv2d_algo algo, int check_backward) {
+    const cgrad_conv2d_params* p = &tc->params;
+    uint32_t oh = conv2d_out_dim(tc->h, tc->kh, p->stride[0], p->padding[0], p->dilation[0]);
+    uint32_t ow = conv2d_out_dim(tc->w, tc->kw, p->stride[1], p->padding[1], p->dilation[1]);
+
+    cgrad_storage x, w, y = {0}, grad_x, grad_w, grad_y;
+    cgrad_storage_init(&x, (uint32_t[]){tc->n, tc->c, tc->h, tc->w}, 4, "cpu_f32");
+    cgrad_storage_init(&w, (uint32_t[]){tc->o, tc->c, tc->kh, tc->kw}, 4, "cpu_f32");
+    cgrad_storage_init(&grad_x, (uint32_t[]){tc->n, tc->c, tc->h, tc->w}, 4, "cpu_f32");
+    cgrad_storage_init(&grad_w, (uint32_t[]){tc->o, tc->c, tc->kh, tc->kw}, 4, "cpu_f32");
+    cgrad_storage_init(&grad_y, (uint32_t[]){tc->n, tc->o, oh, ow}, 4, "cpu_f32");
+    cgrad_storage_fill(&grad_x, OP_CONV2D_GRAD_INIT);
+    cgrad_storage_fill(&grad_w, OP_CONV2D_GRAD_INIT);
+
+    size_t x_size = (size_t)tc->n * tc->c * tc->h * tc->w;
+    size_t w_size = (size_t)tc->o * tc->c * tc->kh * tc->kw;
+    size_t y_size = (size_t)tc->n * tc->o * oh * ow;
+    float* x_values = malloc(x_size * sizeof(float));
+    float* w_values = malloc(w_size * sizeof(float));
+    float* grad_y_values = malloc(y_size * sizeof(float));
+    conv2d_fill_pattern(&x, x_values, 0.37f, 0.0f);
+    conv2d_fill_pattern(&w, w_values, 0.11f, 1.0f);
+    conv2d_fill_pattern(&grad_y, grad_y_values, 0.23f, 0.5f);
+
+    double* y_ref = calloc(y_size, sizeof(double));
+    double* grad_x_ref = calloc(x_size, sizeof(double));
+    double* grad_w_ref = calloc(w_size, sizeof(double));
+    for (size_t i = 0; i < x_size; i++) grad_x_ref[i] = OP_CONV2D_GRAD_INIT;
+    for (size_t i = 0; i < w_size; i++) grad_w_ref[i] = OP_CONV2D_GRAD_INIT;
+    conv2d_ref(tc, x_values, w_values, grad_y_values, y_ref, grad_x_ref, grad_w_ref);
+
+    cgrad_storage* inputs[2] = {&x, &w};
+    cgrad_storage* grad_inputs[2] = {&grad_x, &grad_w};
+    int input_requires_grad[2] = {1, 1};
+    cgrad_op_metadata metadata = {0};
+    metadata.conv2d.params = tc->params;
+    metadata.conv2d.algo = algo;
+
+    void* ctx = NULL;
+    int ret = cgrad_op_conv2d.forward(inputs, 2, &metadata, &y, &ctx, check_backward);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_null(ctx);
+
+    cgrad_storage_layout* y_layout = y.backend->storage_get_layout(y.data);
+    assert_int_equal(y_layout->shape[TENSOR_DIM - 4], tc->n);
+    assert_int_equal(y_layout->shape[TENSOR_DIM - 3], tc->o);
+    assert_int_equal(y_layout->shape[TENSOR_DIM - 2], oh);
+    assert_int_equal(y_layout->shape[TENSOR_DIM - 1], ow);
+    assert_conv2d_close(&y, y_ref);
+
+    if (check_backward) {
+        ret = cgrad_op_conv2d.backward(inputs, 2, &y, &grad_y, &metadata, ctx, grad_inputs, input_requires_grad);
+        assert_int_equal(ret, CGRAD_SUCCESS);
+        assert_conv2d_close(&grad_x, grad_x_ref);
+        assert_conv2d_close(&grad_w, grad_w_ref);
+    }
+
+    free(x_values);
+    free(w_values);
+    free(grad_y_values);
+    free(y_ref);
+    free(grad_x_ref);
+    free(grad_w_ref);
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&w);
+    cgrad_storage_free(&y);
+    cgrad_storage_free(&grad_x);
+    cgrad_storage_free(&grad_w);
+    cgrad_storage_free(&grad_y);
+}
+
+// Odd output channel count exercises the tail of the blocked implicit GEMM kernel
+static const conv2d_test_case conv2d_test_cases[] = {
+    {2, 3, 7, 6, 5, 3, 2, {.stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1}}},
+    {2, 3, 7, 6, 5, 3, 3, {.stride = {2, 1}, .padding = {1, 2}, .dilation = {1, 1}}},
+    {1, 2, 9, 8, 4, 3, 3, {.stride = {1, 2}, .padding = {2, 1}, .dilation = {2, 2}}},
+    {3, 4, 5, 5, 6, 2, 2, {.stride = {3, 3}, .padding = {1, 1}, .dilation = {1, 3}}},
+};
+
+#define CONV2D_NUM_TEST_CASES (sizeof(conv2d_test_cases) / sizeof(conv2d_test_cases[0]))
+
+// ============================================================================
+// Tests: Forward with both lowerings
+// ============================================================================
+
+static void test_op_conv2d_forward_im2col(void **state) {
+    (void) state;
+    for (size_t i = 0; i < CONV2D_NUM_TEST_CASES; i++) {
+        check_conv2d_op(&conv2d_test_cases[i], CGRAD_CONV2D_IM2COL, 0);
+    }
+}
+
+static void test_op_conv2d_forward_implicit_gemm(void **state) {
+    (void) state;
+    for (size_t i = 0; i < CONV2D_NUM_TEST_CASES; i++) {
+        check_conv2d_op(&conv2d_test_cases[i], CGRAD_CONV2D_IMPLICIT_GEMM, 0);
+    }
+}
+
+// ============================================================================
+// Test: Backward (gradients accumulate into prefilled storages)
+// ============================================================================
+
+static void test_op_conv2d_backward(void **state) {
+    (void) state;
+    for (size_t i = 0; i < CONV2D_NUM_TEST_CASES; i++) {
+        check_conv2d_op(&conv2d_test_cases[i], CGRAD_CONV2D_AUTO, 1);
+    }
+}
+
+// ============================================================================
+// Test: 1x1 convolution (columns alias the input)
+// ============================================================================
+
+static void test_op_conv2d_pointwise(void **state) {
+    (void) state;
+    conv2d_test_case tc = {2, 6, 4, 5, 3, 1, 1, {.stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1}}};
+    check_conv2d_op(&tc, CGRAD_CONV2D_IM2COL, 1);
+    check_conv2d_op(&tc, CGRAD_CONV2D_IMPLICIT_GEMM, 0);
+
+    tc.n = 1;
+    check_conv2d_op(&tc, CGRAD_CONV2D_IM2COL, 1);
+}
+
+// ============================================================================
+// Test: Invalid shapes
+// ============================================================================
+
+static void test_op_conv2d_shape_mismatch(void **state) {
+    (void) state;
+
+    cgrad_storage x, w, y = {0};
+    cgrad_storage_init(&x, (uint32_t[]){1, 3, 5, 5}, 4, "cpu_f32");
+    cgrad_storage_init(&w, (uint32_t[]){2, 4, 3, 3}, 4, "cpu_f32");
+
+    cgrad_storage* inputs[2] = {&x, &w};
+    cgrad_op_metadata metadata = {0};
+    metadata.conv2d.params = (cgrad_conv2d_params){.stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1}};
+
+    void* ctx = NULL;
+    int ret = cgrad_op_conv2d.forward(inputs, 2, &metadata, &y, &ctx, 0);
+    assert_int_equal(ret, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH);
+    assert_null(y.data);
+
+    // kernel larger than the padded input
+    cgrad_storage w_large;
+    cgrad_storage_init(&w_large, (uint32_t[]){2, 3, 7, 7}, 4, "cpu_f32");
+    inputs[1] = &w_large;
+    ret = cgrad_op_conv2d.forward(inputs, 2, &metadata, &y, &ctx, 0);
+    assert_int_equal(ret, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH);
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&w);
+    cgrad_storage_free(&w_large);
+}
+
+// ============================================================================
+// Test: Column matrix too large
+// ============================================================================
+
+// Wrap a single element broadcast to shape via zero strides
+static void conv2d_wrap_broadcast(cgrad_storage* t, float* data, const uint32_t* shape) {
+    cgrad_storage_layout layout;
+    assert_int_equal(cgrad_storage_layout_init(&layout, shape, 4), CGRAD_SUCCESS);
+    for (int i = 0; i < TENSOR_DIM; i++) layout.strides[i] = 0;
+    assert_int_equal(cgrad_storage_wrap(t, &layout, data, NULL, NULL, "cpu_f32"), CGRAD_SUCCESS);
+}
+
+static void test_op_conv2d_too_large(void **state) {
+    (void) state;
+
+    // C * KH * KW = 2^32 does not fit into a single int32 reshape dim
+    float value = 1.0f;
+    cgrad_storage x, w, grad_r, y = {0};
+    conv2d_wrap_broadcast(&x, &value, (const uint32_t[]){1, 65536, 256, 256});
+    conv2d_wrap_broadcast(&w, &value, (const uint32_t[]){1, 65536, 256, 256});
+    cgrad_storage_init(&grad_r, (uint32_t[]){1, 1, 1, 1}, 4, "cpu_f32");
+
+    cgrad_conv2d_params params = {.stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1}};
+    assert_int_equal(cgrad_storage_conv2d(CGRAD_CONV2D_AUTO, &params, &x, &w, &y), CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE);
+    assert_null(y.data);
+    assert_int_equal(cgrad_storage_conv2d_backward(&params, &x, &w, &grad_r, NULL, NULL), CGRAD_ERR_STORAGE_LAYOUT_TOO_LARGE);
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&w);
+    cgrad_storage_free(&grad_r);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_op_conv2d_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_op_conv2d_forward_im2col, conv2d_setup_test, conv2d_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_conv2d_forward_implicit_gemm, conv2d_setup_test, conv2d_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_conv2d_backward, conv2d_setup_test, conv2d_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_conv2d_pointwise, conv2d_setup_test, conv2d_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_conv2d_shape_mismatch, conv2d_setup_test, conv2d_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_conv2d_too_large, conv2d_setup_test, conv2d_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_op_conv2d", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_op_conv2d_tests();
+}
+#endif
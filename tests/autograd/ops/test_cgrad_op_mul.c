@@ -0,0 +1,324 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cgrad.h"
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+#define OP_MUL_EPSILON 1e-4f
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int mul_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int mul_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Test: MUL forward
+// ============================================================================
+
+static void test_op_mul_forward(void **state) {
+    (void) state;
+    
+    uint32_t shape[] = {2, 3};
+    cgrad_storage a, b, c = {0};
+    
+    cgrad_storage_init(&a, shape, 2, "cpu_f32");
+    cgrad_storage_init(&b, shape, 2, "cpu_f32");
+    
+    // a = [[0, 1, 2], [3, 4, 5]], b = 2
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            uint32_t idx[2] = {i, j};
+            a.backend->storage_set(a.data, idx, 2, (float)(i * 3 + j));
+        }
+    }
+    cgrad_storage_fill(&b, 2.0f);
+    
+    const cgrad_op_descriptor* op_desc = &cgrad_op_mul;
+    cgrad_storage* inputs[2] = {&a, &b};
+    cgrad_op_metadata metadata = {0};
+    
+    void* ctx = NULL;
+    int ret = op_desc->forward(inputs, 2, &metadata, &c, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    float value;
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            uint32_t idx[2] = {i, j};
+            cgrad_storage_get(&c, idx, 2, &value);
+            assert_true(fabsf(value - 2.0f * (float)(i * 3 + j)) < OP_MUL_EPSILON);
+        }
+    }
+    
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&c);
+}
+
+// ============================================================================
+// Test: MUL forward - broadcasting (2, 1) * (1, 3)
+// ============================================================================
+
+static void test_op_mul_forward_broadcast(void **state) {
+    (void) state;
+    
+    uint32_t a_shape[] = {2, 1};
+    uint32_t b_shape[] = {1, 3};
+    cgrad_storage a, b, c = {0};
+    
+    cgrad_storage_init(&a, a_shape, 2, "cpu_f32");
+    cgrad_storage_init(&b, b_shape, 2, "cpu_f32");
+    
+    // a = [[1], [2]], b = [[1, 2, 3]] -> c = outer product
+    for (uint32_t i = 0; i < 2; i++) {
+        a.backend->storage_set(a.data, (uint32_t[]){i, 0}, 2, (float)(i + 1));
+    }
+    for (uint32_t j = 0; j < 3; j++) {
+        b.backend->storage_set(b.data, (uint32_t[]){0, j}, 2, (float)(j + 1));
+    }
+    
+    cgrad_storage* inputs[2] = {&a, &b};
+    cgrad_op_metadata metadata = {0};
+    void* ctx = NULL;
+    int ret = cgrad_op_mul.forward(inputs, 2, &metadata, &c, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    float value;
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            uint32_t idx[2] = {i, j};
+            cgrad_storage_get(&c, idx, 2, &value);
+            assert_true(fabsf(value - (float)((i + 1) * (j + 1))) < OP_MUL_EPSILON);
+        }
+    }
+    
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&c);
+}
+
+// ============================================================================
+// Test: MUL backward - basic
+// ============================================================================
+
+static void test_op_mul_backward_basic(void **state) {
+    (void) state;
+    
+    uint32_t shape[] = {2, 2};
+    cgrad_storage a, b, c = {0};
+    cgrad_storage grad_a, grad_b, grad_c;
+    
+    cgrad_storage_init(&a, shape, 2, "cpu_f32");
+    cgrad_storage_init(&b, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_a, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_b, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_c, shape, 2, "cpu_f32");
+    
+    cgrad_storage_fill(&a, 2.0f);
+    cgrad_storage_fill(&b, 3.0f);
+    cgrad_storage_fill(&grad_a, 1.0f);  // existing gradient, must be accumulated into
+    cgrad_storage_fill(&grad_b, 0.0f);
+    cgrad_storage_fill(&grad_c, 0.5f);
+    
+    cgrad_storage* inputs[2] = {&a, &b};
+    cgrad_storage* grad_inputs[2] = {&grad_a, &grad_b};
+    int input_requires_grad[2] = {1, 1};
+    cgrad_op_metadata metadata = {0};
+    
+    void* ctx = NULL;
+    int ret = cgrad_op_mul.forward(inputs, 2, &metadata, &c, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    ret = cgrad_op_mul.backward(inputs, 2, &c, &grad_c, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // grad_a = 1 + 0.5 * 3, grad_b = 0.5 * 2
+    float value;
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 2; j++) {
+            uint32_t idx[2] = {i, j};
+            cgrad_storage_get(&grad_a, idx, 2, &value);
+            assert_true(fabsf(value - 2.5f) < OP_MUL_EPSILON);
+            cgrad_storage_get(&grad_b, idx, 2, &value);
+            assert_true(fabsf(value - 1.0f) < OP_MUL_EPSILON);
+        }
+    }
+    
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&c);
+    cgrad_storage_free(&grad_a);
+    cgrad_storage_free(&grad_b);
+    cgrad_storage_free(&grad_c);
+}
+
+// ============================================================================
+// Test: MUL backward - broadcasting (2, 1) * (2, 3)
+// ============================================================================
+
+static void test_op_mul_backward_broadcast(void **state) {
+    (void) state;
+    
+    // Forward: x: (2, 1) * y: (2, 3) -> output: (2, 3)
+    // Backward: grad_output: (2, 3) = all ones
+    // grad_x should be (2, 1) = row sums of y
+    // grad_y should be (2, 3) = x broadcasted
+    
+    uint32_t x_shape[] = {2, 1};
+    uint32_t y_shape[] = {2, 3};
+    cgrad_storage x, y, output = {0};
+    cgrad_storage grad_x, grad_y, grad_output;
+    
+    cgrad_storage_init(&x, x_shape, 2, "cpu_f32");
+    cgrad_storage_init(&y, y_shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_x, x_shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_y, y_shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_output, y_shape, 2, "cpu_f32");
+    
+    // x = [[2], [3]], y = [[0, 1, 2], [3, 4, 5]]
+    for (uint32_t i = 0; i < 2; i++) {
+        x.backend->storage_set(x.data, (uint32_t[]){i, 0}, 2, (float)(i + 2));
+        for (uint32_t j = 0; j < 3; j++) {
+            y.backend->storage_set(y.data, (uint32_t[]){i, j}, 2, (float)(i * 3 + j));
+        }
+    }
+    cgrad_storage_fill(&grad_x, 0.0f);
+    cgrad_storage_fill(&grad_y, 0.0f);
+    cgrad_storage_fill(&grad_output, 1.0f);
+    
+    cgrad_storage* inputs[2] = {&x, &y};
+    cgrad_storage* grad_inputs[2] = {&grad_x, &grad_y};
+    int input_requires_grad[2] = {1, 1};
+    cgrad_op_metadata metadata = {0};
+    
+    void* ctx = NULL;
+    int ret = cgrad_op_mul.forward(inputs, 2, &metadata, &output, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    ret = cgrad_op_mul.backward(inputs, 2, &output, &grad_output, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // grad_x should be [[3], [12]]
+    float expected_x[2] = {3.0f, 12.0f};
+    float value;
+    for (uint32_t i = 0; i < 2; i++) {
+        cgrad_storage_get(&grad_x, (uint32_t[]){i, 0}, 2, &value);
+        assert_true(fabsf(value - expected_x[i]) < OP_MUL_EPSILON);
+    }
+    
+    // grad_y should be [[2, 2, 2], [3, 3, 3]]
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            cgrad_storage_get(&grad_y, (uint32_t[]){i, j}, 2, &value);
+            assert_true(fabsf(value - (float)(i + 2)) < OP_MUL_EPSILON);
+        }
+    }
+    
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+    cgrad_storage_free(&output);
+    cgrad_storage_free(&grad_x);
+    cgrad_storage_free(&grad_y);
+    cgrad_storage_free(&grad_output);
+}
+
+// ============================================================================
+// Test: MUL backward - broadcasting scalar (1, 1) * (3, 4) with transposed input
+// ============================================================================
+
+static void test_op_mul_backward_broadcast_scalar_transposed(void **state) {
+    (void) state;
+    
+    uint32_t s_shape[] = {1, 1};
+    uint32_t y_shape[] = {4, 3};
+    cgrad_storage s, y, y_t, output = {0};
+    cgrad_storage grad_s, grad_output;
+    
+    cgrad_storage_init(&s, s_shape, 2, "cpu_f32");
+    cgrad_storage_init(&y, y_shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_s, s_shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_output, (uint32_t[]){3, 4}, 2, "cpu_f32");
+    
+    // y = [[0..2], [3..5], ...], y_t = transpose(y) is (3, 4) and non-contiguous
+    for (uint32_t i = 0; i < 4; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            y.backend->storage_set(y.data, (uint32_t[]){i, j}, 2, (float)(i * 3 + j));
+        }
+    }
+    assert_int_equal(cgrad_storage_transpose(&y, &y_t, (uint32_t[]){1, 0}, 2), CGRAD_SUCCESS);
+    cgrad_storage_fill(&s, 2.0f);
+    cgrad_storage_fill(&grad_s, 1.0f);
+    cgrad_storage_fill(&grad_output, 1.0f);
+    
+    cgrad_storage* inputs[2] = {&s, &y_t};
+    cgrad_storage* grad_inputs[2] = {&grad_s, NULL};
+    int input_requires_grad[2] = {1, 0};
+    cgrad_op_metadata metadata = {0};
+    
+    void* ctx = NULL;
+    int ret = cgrad_op_mul.forward(inputs, 2, &metadata, &output, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // output[i][j] = 2 * y[j][i]
+    float value;
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint32_t j = 0; j < 4; j++) {
+            cgrad_storage_get(&output, (uint32_t[]){i, j}, 2, &value);
+            assert_true(fabsf(value - 2.0f * (float)(j * 3 + i)) < OP_MUL_EPSILON);
+        }
+    }
+    
+    ret = cgrad_op_mul.backward(inputs, 2, &output, &grad_output, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // grad_s = 1 + sum(y) = 1 + 66
+    cgrad_storage_get(&grad_s, (uint32_t[]){0, 0}, 2, &value);
+    assert_true(fabsf(value - 67.0f) < OP_MUL_EPSILON);
+    
+    cgrad_storage_free(&s);
+    cgrad_storage_free(&y_t);
+    cgrad_storage_free(&y);
+    cgrad_storage_free(&output);
+    cgrad_storage_free(&grad_s);
+    cgrad_storage_free(&grad_output);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_op_mul_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_op_mul_forward, mul_setup_test, mul_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_mul_forward_broadcast, mul_setup_test, mul_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_mul_backward_basic, mul_setup_test, mul_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_mul_backward_broadcast, mul_setup_test, mul_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_mul_backward_broadcast_scalar_transposed, mul_setup_test, mul_teardown_test),
+    };
+    
+    return cmocka_run_group_tests_name("cgrad_op_mul", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_op_mul_tests();
+}
+#endif
@@ -0,0 +1,302 @@
+#include <stdarg.h>
+#include "cgrad.h"
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+#define OP_SLICE_EPSILON 1e-5f
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int slice_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int slice_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Initialize a (rows, cols) storage with a[i][j] = i * cols + j.
+static void slice_init_iota(cgrad_storage* t, uint32_t rows, uint32_t cols) {
+    cgrad_storage_init(t, (uint32_t[]){rows, cols}, 2, "cpu_f32");
+    for (uint32_t i = 0; i < rows; i++) {
+        for (uint32_t j = 0; j < cols; j++) {
+            t->backend->storage_set(t->data, (uint32_t[]){i, j}, 2, (float)(i * cols + j));
+        }
+    }
+}
+
+static float slice_get(const cgrad_storage* t, uint32_t i, uint32_t j) {
+    float value = 0.0f;
+    assert_int_equal(cgrad_storage_get(t, (uint32_t[]){i, j}, 2, &value), CGRAD_SUCCESS);
+    return value;
+}
+
+// ============================================================================
+// Test: Slice forward is a view into the input
+// ============================================================================
+
+static void test_op_slice_forward_view(void **state) {
+    (void) state;
+
+    cgrad_storage a, b;
+    slice_init_iota(&a, 4, 4);
+
+    // rows 1..2, every second column
+    cgrad_op_metadata metadata = {0};
+    metadata.slice.ndim = 2;
+    metadata.slice.start[0] = 1; metadata.slice.stop[0] = 3; metadata.slice.step[0] = 1;
+    metadata.slice.start[1] = 0; metadata.slice.stop[1] = 4; metadata.slice.step[1] = 2;
+
+    cgrad_storage* inputs[1] = {&a};
+    void* ctx = NULL;
+    memset(&b, 0, sizeof(b));
+    int ret = cgrad_op_slice.forward(inputs, 1, &metadata, &b, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 2; j++) {
+            assert_true(fabsf(slice_get(&b, i, j) - (float)((i + 1) * 4 + 2 * j)) < OP_SLICE_EPSILON);
+        }
+    }
+
+    // writes through the source are visible in the view
+    a.backend->storage_set(a.data, (uint32_t[]){2, 2}, 2, -1.0f);
+    assert_true(fabsf(slice_get(&b, 1, 1) + 1.0f) < OP_SLICE_EPSILON);
+
+    // a contiguous copy of the view holds only the selected elements
+    cgrad_storage c = {0};
+    assert_int_equal(cgrad_storage_contiguous(&b, &c), CGRAD_SUCCESS);
+    assert_true(fabsf(slice_get(&c, 0, 1) - 6.0f) < OP_SLICE_EPSILON);
+
+    cgrad_storage_free(&c);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&a);
+}
+
+// ============================================================================
+// Test: Slice backward scatters into the sliced region
+// ============================================================================
+
+static void test_op_slice_backward(void **state) {
+    (void) state;
+
+    cgrad_storage a, b, grad_a, grad_b;
+    slice_init_iota(&a, 4, 4);
+    cgrad_storage_init(&grad_a, (uint32_t[]){4, 4}, 2, "cpu_f32");
+    cgrad_storage_fill(&grad_a, 1.0f);
+
+    cgrad_op_metadata metadata = {0};
+    metadata.slice.ndim = 2;
+    metadata.slice.start[0] = 1; metadata.slice.stop[0] = 3; metadata.slice.step[0] = 1;
+    metadata.slice.start[1] = 1; metadata.slice.stop[1] = 4; metadata.slice.step[1] = 2;
+
+    cgrad_storage* inputs[1] = {&a};
+    void* ctx = NULL;
+    memset(&b, 0, sizeof(b));
+    int ret = cgrad_op_slice.forward(inputs, 1, &metadata, &b, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    slice_init_iota(&grad_b, 2, 2);
+    cgrad_storage* grad_inputs[1] = {&grad_a};
+    int input_requires_grad[1] = {1};
+    ret = cgrad_op_slice.backward(inputs, 1, &b, &grad_b, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    // grad_a[1 + i][1 + 2j] += grad_b[i][j], everything else is untouched
+    for (uint32_t i = 0; i < 4; i++) {
+        for (uint32_t j = 0; j < 4; j++) {
+            float expected = 1.0f;
+            if (i >= 1 && i < 3 && (j == 1 || j == 3)) expected += (float)((i - 1) * 2 + j / 2);
+            assert_true(fabsf(slice_get(&grad_a, i, j) - expected) < OP_SLICE_EPSILON);
+        }
+    }
+
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&grad_a);
+    cgrad_storage_free(&grad_b);
+}
+
+// ============================================================================
+// Test: Select forward and backward
+// ============================================================================
+
+static void test_op_select(void **state) {
+    (void) state;
+
+    cgrad_storage a, b, grad_a, grad_b;
+    slice_init_iota(&a, 3, 4);
+    cgrad_storage_init(&grad_a, (uint32_t[]){3, 4}, 2, "cpu_f32");
+    cgrad_storage_fill(&grad_a, 0.0f);
+
+    // column 2
+    cgrad_op_metadata metadata = {0};
+    metadata.select.dim = -1;
+    metadata.select.index = 2;
+
+    cgrad_storage* inputs[1] = {&a};
+    void* ctx = NULL;
+    memset(&b, 0, sizeof(b));
+    int ret = cgrad_op_select.forward(inputs, 1, &metadata, &b, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    cgrad_storage_layout* layout = b.backend->storage_get_layout(b.data);
+    assert_int_equal(layout->shape[TENSOR_DIM - 1], 3);
+    assert_int_equal(layout->shape[TENSOR_DIM - 2], 1);
+    float value;
+    for (uint32_t i = 0; i < 3; i++) {
+        cgrad_storage_get(&b, (uint32_t[]){i}, 1, &value);
+        assert_true(fabsf(value - (float)(i * 4 + 2)) < OP_SLICE_EPSILON);
+    }
+
+    cgrad_storage_init(&grad_b, (uint32_t[]){3}, 1, "cpu_f32");
+    cgrad_storage_fill(&grad_b, 2.0f);
+    cgrad_storage* grad_inputs[1] = {&grad_a};
+    int input_requires_grad[1] = {1};
+    ret = cgrad_op_select.backward(inputs, 1, &b, &grad_b, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint32_t j = 0; j < 4; j++) {
+            float expected = (j == 2) ? 2.0f : 0.0f;
+            assert_true(fabsf(slice_get(&grad_a, i, j) - expected) < OP_SLICE_EPSILON);
+        }
+    }
+
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&grad_a);
+    cgrad_storage_free(&grad_b);
+}
+
+// ============================================================================
+// Test: Cat forward and backward
+// ============================================================================
+
+static void test_op_cat(void **state) {
+    (void) state;
+
+    cgrad_storage a, b, c, grad_a, grad_b, grad_c;
+    slice_init_iota(&a, 2, 3);
+    slice_init_iota(&b, 2, 2);
+    cgrad_storage_init(&grad_a, (uint32_t[]){2, 3}, 2, "cpu_f32");
+    cgrad_storage_init(&grad_b, (uint32_t[]){2, 2}, 2, "cpu_f32");
+    cgrad_storage_fill(&grad_a, 0.0f);
+    cgrad_storage_fill(&grad_b, 0.0f);
+
+    cgrad_op_metadata metadata = {0};
+    metadata.cat.dim = -1;
+
+    cgrad_storage* inputs[2] = {&a, &b};
+    void* ctx = NULL;
+    memset(&c, 0, sizeof(c));
+    int ret = cgrad_op_cat.forward(inputs, 2, &metadata, &c, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    cgrad_storage_layout* layout = c.backend->storage_get_layout(c.data);
+    assert_int_equal(layout->shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(layout->shape[TENSOR_DIM - 1], 5);
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 5; j++) {
+            float expected = (j < 3) ? (float)(i * 3 + j) : (float)(i * 2 + j - 3);
+            assert_true(fabsf(slice_get(&c, i, j) - expected) < OP_SLICE_EPSILON);
+        }
+    }
+
+    slice_init_iota(&grad_c, 2, 5);
+    cgrad_storage* grad_inputs[2] = {&grad_a, &grad_b};
+    int input_requires_grad[2] = {1, 1};
+    ret = cgrad_op_cat.backward(inputs, 2, &c, &grad_c, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            assert_true(fabsf(slice_get(&grad_a, i, j) - (float)(i * 5 + j)) < OP_SLICE_EPSILON);
+        }
+        for (uint32_t j = 0; j < 2; j++) {
+            assert_true(fabsf(slice_get(&grad_b, i, j) - (float)(i * 5 + j + 3)) < OP_SLICE_EPSILON);
+        }
+    }
+
+    // mismatching shapes are rejected
+    cgrad_storage d = {0};
+    metadata.cat.dim = -2;
+    ret = cgrad_op_cat.forward(inputs, 2, &metadata, &d, &ctx, 1);
+    assert_int_equal(ret, CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH);
+
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&c);
+    cgrad_storage_free(&grad_a);
+    cgrad_storage_free(&grad_b);
+    cgrad_storage_free(&grad_c);
+}
+
+// ============================================================================
+// Test: Math ops read sliced views through their offset
+// ============================================================================
+
+static void test_op_slice_gemm_on_view(void **state) {
+    (void) state;
+
+    cgrad_storage a, rows, r;
+    slice_init_iota(&a, 4, 2);
+
+    // rows 2..3 of a form a contiguous view with a nonzero offset
+    assert_int_equal(cgrad_storage_narrow(&a, &rows, -2, 2, 2), CGRAD_SUCCESS);
+
+    // r = rows^T * rows
+    cgrad_storage rows_t = {0};
+    memset(&r, 0, sizeof(r));
+    assert_int_equal(cgrad_storage_transpose(&rows, &rows_t, (uint32_t[]){1, 0}, 2), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_gemm(1.0f, &rows_t, &rows, 0.0f, &r), CGRAD_SUCCESS);
+
+    // rows = {{4, 5}, {6, 7}}
+    assert_true(fabsf(slice_get(&r, 0, 0) - (16.0f + 36.0f)) < OP_SLICE_EPSILON);
+    assert_true(fabsf(slice_get(&r, 0, 1) - (20.0f + 42.0f)) < OP_SLICE_EPSILON);
+    assert_true(fabsf(slice_get(&r, 1, 1) - (25.0f + 49.0f)) < OP_SLICE_EPSILON);
+
+    cgrad_storage_free(&r);
+    cgrad_storage_free(&rows_t);
+    cgrad_storage_free(&rows);
+    cgrad_storage_free(&a);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_op_slice_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_op_slice_forward_view, slice_setup_test, slice_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_slice_backward, slice_setup_test, slice_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_select, slice_setup_test, slice_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_cat, slice_setup_test, slice_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_slice_gemm_on_view, slice_setup_test, slice_teardown_test),
+    };
+    return cmocka_run_group_tests_name("cgrad_op_slice", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_op_slice_tests();
+}
+#endif
@@ -0,0 +1,362 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cgrad.h"
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+#define OP_SOFTMAX_EPSILON 1e-5f
+#define OP_SOFTMAX_ROWS 3
+#define OP_SOFTMAX_COLS 5
+
+// The last row is far outside the range of expf to check the max shift
+static const float softmax_test_logits[OP_SOFTMAX_ROWS][OP_SOFTMAX_COLS] = {
+    {1.0f, 2.0f, 3.0f, 4.0f, 5.0f},
+    {-0.5f, 0.25f, 0.0f, -2.0f, 1.5f},
+    {1000.0f, 1001.0f, 999.0f, 1002.0f, 998.0f},
+};
+
+static const float softmax_test_grad[OP_SOFTMAX_ROWS][OP_SOFTMAX_COLS] = {
+    {0.1f, -0.2f, 0.3f, 0.0f, 1.0f},
+    {-1.0f, 0.5f, 0.5f, 2.0f, 0.0f},
+    {0.25f, 0.25f, -0.5f, 1.0f, -1.0f},
+};
+
+// ============================================================================
+// Reference Implementations
+// ============================================================================
+
+static void softmax_ref(const float* x, double* y, int n) {
+    double m = x[0];
+    for (int i = 1; i < n; i++) m = x[i] > m ? x[i] : m;
+    double s = 0.0;
+    for (int i = 0; i < n; i++) s += exp(x[i] - m);
+    for (int i = 0; i < n; i++) y[i] = exp(x[i] - m) / s;
+}
+
+static double logsumexp_ref(const float* x, int n) {
+    double m = x[0];
+    for (int i = 1; i < n; i++) m = x[i] > m ? x[i] : m;
+    double s = 0.0;
+    for (int i = 0; i < n; i++) s += exp(x[i] - m);
+    return m + log(s);
+}
+
+static void assert_softmax_close(float value, double expected) {
+    assert_true(fabs(value - expected) <= OP_SOFTMAX_EPSILON * fmax(1.0, fabs(expected)));
+}
+
+static void softmax_fill_rows(cgrad_storage* t, const float values[OP_SOFTMAX_ROWS][OP_SOFTMAX_COLS]) {
+    for (uint32_t i = 0; i < OP_SOFTMAX_ROWS; i++) {
+        for (uint32_t j = 0; j < OP_SOFTMAX_COLS; j++) {
+            t->backend->storage_set(t->data, (uint32_t[]){i, j}, 2, values[i][j]);
+        }
+    }
+}
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int softmax_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int softmax_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// Run forward and backward of (log-)softmax and compare with the references
+static void check_softmax_op(const cgrad_op_descriptor* op_desc, int log_softmax) {
+    uint32_t shape[] = {OP_SOFTMAX_ROWS, OP_SOFTMAX_COLS};
+    cgrad_storage x, y = {0}, grad_x, grad_y;
+
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_y, shape, 2, "cpu_f32");
+    softmax_fill_rows(&x, softmax_test_logits);
+    softmax_fill_rows(&grad_y, softmax_test_grad);
+    cgrad_storage_fill(&grad_x, 0.0f);
+
+    cgrad_storage* inputs[1] = {&x};
+    cgrad_storage* grad_inputs[1] = {&grad_x};
+    int input_requires_grad[1] = {1};
+    cgrad_op_metadata metadata = {0};
+    metadata.softmax.log = log_softmax;
+
+    void* ctx = NULL;
+    int ret = op_desc->forward(inputs, 1, &metadata, &y, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_null(ctx);
+
+    ret = op_desc->backward(inputs, 1, &y, &grad_y, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < OP_SOFTMAX_ROWS; i++) {
+        const float* g = softmax_test_grad[i];
+        double p[OP_SOFTMAX_COLS];
+        softmax_ref(softmax_test_logits[i], p, OP_SOFTMAX_COLS);
+
+        // softmax: dx = p * (g - sum(g * p)), log-softmax: dx = g - p * sum(g)
+        double dot = 0.0, sum = 0.0;
+        for (int j = 0; j < OP_SOFTMAX_COLS; j++) {
+            dot += g[j] * p[j];
+            sum += g[j];
+        }
+
+        for (uint32_t j = 0; j < OP_SOFTMAX_COLS; j++) {
+            float value;
+            cgrad_storage_get(&y, (uint32_t[]){i, j}, 2, &value);
+            assert_softmax_close(value, log_softmax ? log(p[j]) : p[j]);
+
+            cgrad_storage_get(&grad_x, (uint32_t[]){i, j}, 2, &value);
+            assert_softmax_close(value, log_softmax ? g[j] - p[j] * sum : p[j] * (g[j] - dot));
+        }
+    }
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+    cgrad_storage_free(&grad_x);
+    cgrad_storage_free(&grad_y);
+}
+
+// ============================================================================
+// Tests: Softmax and log-softmax
+// ============================================================================
+
+static void test_op_softmax(void **state) {
+    (void) state;
+    check_softmax_op(&cgrad_op_softmax, 0);
+}
+
+static void test_op_log_softmax(void **state) {
+    (void) state;
+    check_softmax_op(&cgrad_op_log_softmax, 1);
+}
+
+// ============================================================================
+// Test: Softmax of a transposed (non-contiguous) input
+// ============================================================================
+
+static void test_op_softmax_forward_transposed(void **state) {
+    (void) state;
+
+    uint32_t shape[] = {OP_SOFTMAX_ROWS, OP_SOFTMAX_COLS};
+    cgrad_storage x, x_t, y = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    softmax_fill_rows(&x, softmax_test_logits);
+    assert_int_equal(cgrad_storage_transpose(&x, &x_t, (uint32_t[]){1, 0}, 2), CGRAD_SUCCESS);
+
+    cgrad_storage* inputs[1] = {&x_t};
+    cgrad_op_metadata metadata = {0};
+
+    void* ctx = NULL;
+    int ret = cgrad_op_softmax.forward(inputs, 1, &metadata, &y, &ctx, 0);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    // rows of y are the columns of the logits
+    for (uint32_t j = 0; j < OP_SOFTMAX_COLS; j++) {
+        float column[OP_SOFTMAX_ROWS];
+        double p[OP_SOFTMAX_ROWS];
+        for (int i = 0; i < OP_SOFTMAX_ROWS; i++) column[i] = softmax_test_logits[i][j];
+        softmax_ref(column, p, OP_SOFTMAX_ROWS);
+        for (uint32_t i = 0; i < OP_SOFTMAX_ROWS; i++) {
+            float value;
+            cgrad_storage_get(&y, (uint32_t[]){j, i}, 2, &value);
+            assert_softmax_close(value, p[i]);
+        }
+    }
+
+    cgrad_storage_free(&x_t);
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+}
+
+// ============================================================================
+// Test: Long rows spanning several blocks of the online logsumexp
+// ============================================================================
+
+static void test_op_softmax_forward_long_rows(void **state) {
+    (void) state;
+
+    // increasing logits force the running maximum to be rescaled in every block
+    uint32_t shape[] = {2, 1000};
+    cgrad_storage x, y = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    float row[1000], neg_row[1000];
+    for (uint32_t j = 0; j < 1000; j++) {
+        row[j] = 0.02f * (float)j;
+        neg_row[j] = -row[j];
+        x.backend->storage_set(x.data, (uint32_t[]){0, j}, 2, row[j]);
+        x.backend->storage_set(x.data, (uint32_t[]){1, j}, 2, neg_row[j]);
+    }
+
+    int ret = cgrad_storage_softmax(1, &x, &y);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    double lse = logsumexp_ref(row, 1000);
+    float value;
+    cgrad_storage_get(&y, (uint32_t[]){0, 999}, 2, &value);
+    assert_softmax_close(value, row[999] - lse);
+    cgrad_storage_get(&y, (uint32_t[]){0, 3}, 2, &value);
+    assert_softmax_close(value, row[3] - lse);
+    cgrad_storage_get(&y, (uint32_t[]){1, 0}, 2, &value);
+    assert_softmax_close(value, neg_row[0] - logsumexp_ref(neg_row, 1000));
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+}
+
+// ============================================================================
+// Tests: Softmax cross-entropy
+// ============================================================================
+
+static void test_op_softmax_cross_entropy(void **state) {
+    (void) state;
+
+    uint32_t shape[] = {OP_SOFTMAX_ROWS, OP_SOFTMAX_COLS};
+    cgrad_storage x, t, loss = {0}, grad_x, grad_t, grad_loss;
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&t, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_t, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_loss, (uint32_t[]){1}, 1, "cpu_f32");
+    softmax_fill_rows(&x, softmax_test_logits);
+    cgrad_storage_fill(&grad_x, 0.0f);
+    cgrad_storage_fill(&grad_t, 0.0f);
+    cgrad_storage_fill(&grad_loss, 3.0f);
+
+    // one-hot targets for the first rows, a soft distribution for the last
+    const uint32_t labels[OP_SOFTMAX_ROWS - 1] = {4, 0};
+    cgrad_storage_fill(&t, 0.0f);
+    for (uint32_t i = 0; i < OP_SOFTMAX_ROWS - 1; i++) {
+        t.backend->storage_set(t.data, (uint32_t[]){i, labels[i]}, 2, 1.0f);
+    }
+    t.backend->storage_set(t.data, (uint32_t[]){2, 1}, 2, 0.25f);
+    t.backend->storage_set(t.data, (uint32_t[]){2, 3}, 2, 0.75f);
+
+    cgrad_storage* inputs[2] = {&x, &t};
+    cgrad_storage* grad_inputs[2] = {&grad_x, &grad_t};
+    int input_requires_grad[2] = {1, 1};
+    cgrad_op_metadata metadata = {0};
+
+    void* ctx = NULL;
+    int ret = cgrad_op_softmax_cross_entropy.forward(inputs, 2, &metadata, &loss, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_non_null(ctx);
+
+    ret = cgrad_op_softmax_cross_entropy.backward(inputs, 2, &loss, &grad_loss, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    // loss = mean_i -sum_j t_ij * log p_ij
+    double expected_loss = 0.0;
+    for (uint32_t i = 0; i < OP_SOFTMAX_ROWS; i++) {
+        double p[OP_SOFTMAX_COLS];
+        double lse = logsumexp_ref(softmax_test_logits[i], OP_SOFTMAX_COLS);
+        softmax_ref(softmax_test_logits[i], p, OP_SOFTMAX_COLS);
+        for (uint32_t j = 0; j < OP_SOFTMAX_COLS; j++) {
+            float tij, value;
+            cgrad_storage_get(&t, (uint32_t[]){i, j}, 2, &tij);
+            expected_loss -= tij * log(p[j]) / OP_SOFTMAX_ROWS;
+
+            // targets sum to one, so dx = g / N * (p - t) and dt = g / N * (lse - x)
+            cgrad_storage_get(&grad_x, (uint32_t[]){i, j}, 2, &value);
+            assert_softmax_close(value, 3.0 / OP_SOFTMAX_ROWS * (p[j] - tij));
+            // lse - x cancels for the large logits, so compare relative to the input magnitude
+            cgrad_storage_get(&grad_t, (uint32_t[]){i, j}, 2, &value);
+            double expected = 3.0 / OP_SOFTMAX_ROWS * (lse - softmax_test_logits[i][j]);
+            assert_true(fabs(value - expected) <= OP_SOFTMAX_EPSILON * fmax(1.0, fabs(lse)));
+        }
+    }
+
+    float value;
+    const cgrad_storage_layout* loss_layout = loss.backend->storage_get_layout(loss.data);
+    assert_int_equal(loss_layout->size, 1);
+    cgrad_storage_get(&loss, (uint32_t[]){0}, 1, &value);
+    assert_softmax_close(value, expected_loss);
+
+    cgrad_op_softmax_cross_entropy.free_ctx(ctx);
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&t);
+    cgrad_storage_free(&loss);
+    cgrad_storage_free(&grad_x);
+    cgrad_storage_free(&grad_t);
+    cgrad_storage_free(&grad_loss);
+}
+
+static void test_op_softmax_cross_entropy_no_grad(void **state) {
+    (void) state;
+
+    uint32_t shape[] = {2, 4};
+    cgrad_storage x, t, loss = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&t, shape, 2, "cpu_f32");
+    cgrad_storage_fill(&x, 7.0f);
+    cgrad_storage_fill(&t, 0.25f);
+
+    cgrad_storage* inputs[2] = {&x, &t};
+    cgrad_op_metadata metadata = {0};
+
+    void* ctx = (void*)&x;
+    int ret = cgrad_op_softmax_cross_entropy.forward(inputs, 2, &metadata, &loss, &ctx, 0);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_null(ctx);
+
+    // uniform logits against a uniform target: loss = log(4)
+    float value;
+    cgrad_storage_get(&loss, (uint32_t[]){0}, 1, &value);
+    assert_softmax_close(value, log(4.0));
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&t);
+    cgrad_storage_free(&loss);
+}
+
+static void test_op_softmax_cross_entropy_shape_mismatch(void **state) {
+    (void) state;
+
+    cgrad_storage x, t, loss = {0};
+    cgrad_storage_init(&x, (uint32_t[]){2, 4}, 2, "cpu_f32");
+    cgrad_storage_init(&t, (uint32_t[]){2, 3}, 2, "cpu_f32");
+
+    int ret = cgrad_storage_softmax_cross_entropy(&x, &t, &loss, NULL);
+    assert_int_equal(ret, CGRAD_ERR_STORAGE_SHAPE_MISMATCH);
+    assert_null(loss.data);
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&t);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_op_softmax_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_op_softmax, softmax_setup_test, softmax_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_log_softmax, softmax_setup_test, softmax_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_softmax_forward_transposed, softmax_setup_test, softmax_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_softmax_forward_long_rows, softmax_setup_test, softmax_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_softmax_cross_entropy, softmax_setup_test, softmax_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_softmax_cross_entropy_no_grad, softmax_setup_test, softmax_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_softmax_cross_entropy_shape_mismatch, softmax_setup_test, softmax_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_op_softmax", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_op_softmax_tests();
+}
+#endif
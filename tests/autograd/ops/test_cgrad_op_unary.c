@@ -0,0 +1,326 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cgrad.h"
+#include "autograd/cgrad_ops.h"
+#include "cgrad_status.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_layout.h"
+
+#define OP_UNARY_EPSILON 1e-5f
+#define OP_UNARY_NUM_VALUES 12
+
+static const float unary_test_values[OP_UNARY_NUM_VALUES] = {
+    -20.0f, -5.0f, -1.5f, -0.6f, -0.1f, -1e-3f, 1e-3f, 0.1f, 0.6f, 1.5f, 5.0f, 20.0f
+};
+
+// ============================================================================
+// Reference Implementations
+// ============================================================================
+
+static float unary_ref(cgrad_unary_op op, float x) {
+    switch (op) {
+        case CGRAD_UNARY_RELU: return x > 0.0f ? x : 0.0f;
+        case CGRAD_UNARY_GELU: {
+            double u = 0.7978845608028654 * (x + 0.044715 * x * x * x);
+            return (float)(0.5 * x * (1.0 + tanh(u)));
+        }
+        case CGRAD_UNARY_TANH: return tanhf(x);
+        case CGRAD_UNARY_SIGMOID: return (float)(1.0 / (1.0 + exp(-x)));
+        case CGRAD_UNARY_EXP: return expf(x);
+        case CGRAD_UNARY_LOG: return logf(x);
+    }
+    return NAN;
+}
+
+static float unary_ref_grad(cgrad_unary_op op, float x) {
+    switch (op) {
+        case CGRAD_UNARY_RELU: return x > 0.0f ? 1.0f : 0.0f;
+        case CGRAD_UNARY_GELU: {
+            double c = 0.7978845608028654;
+            double u = c * (x + 0.044715 * x * x * x);
+            double t = tanh(u);
+            return (float)(0.5 * (1.0 + t) + 0.5 * x * (1.0 - t * t) * c * (1.0 + 3.0 * 0.044715 * x * x));
+        }
+        case CGRAD_UNARY_TANH: return 1.0f - tanhf(x) * tanhf(x);
+        case CGRAD_UNARY_SIGMOID: {
+            double s = 1.0 / (1.0 + exp(-x));
+            return (float)(s * (1.0 - s));
+        }
+        case CGRAD_UNARY_EXP: return expf(x);
+        case CGRAD_UNARY_LOG: return 1.0f / x;
+    }
+    return NAN;
+}
+
+static void assert_close(float value, float expected) {
+    // relative tolerance for large magnitudes (exp), absolute otherwise
+    float tol = OP_UNARY_EPSILON * fmaxf(1.0f, fabsf(expected));
+    assert_true(fabsf(value - expected) <= tol);
+}
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int unary_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int unary_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// Run forward and backward of op on the test values and compare with the references
+static void check_unary_op(const cgrad_op_descriptor* op_desc, cgrad_unary_op op) {
+    uint32_t shape[] = {3, 4};
+    cgrad_storage x, y = {0}, grad_x, grad_y;
+
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_x, shape, 2, "cpu_f32");
+    cgrad_storage_init(&grad_y, shape, 2, "cpu_f32");
+
+    // log is only defined for positive inputs
+    for (uint32_t i = 0; i < OP_UNARY_NUM_VALUES; i++) {
+        float v = unary_test_values[i];
+        if (op == CGRAD_UNARY_LOG) v = fabsf(v);
+        x.backend->storage_set(x.data, (uint32_t[]){i / 4, i % 4}, 2, v);
+    }
+    cgrad_storage_fill(&grad_x, 0.0f);
+    cgrad_storage_fill(&grad_y, 2.0f);
+
+    cgrad_storage* inputs[1] = {&x};
+    cgrad_storage* grad_inputs[1] = {&grad_x};
+    int input_requires_grad[1] = {1};
+    cgrad_op_metadata metadata = {0};
+    metadata.unary.op = op;
+
+    void* ctx = NULL;
+    int ret = op_desc->forward(inputs, 1, &metadata, &y, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    ret = op_desc->backward(inputs, 1, &y, &grad_y, &metadata, ctx, grad_inputs, input_requires_grad);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < OP_UNARY_NUM_VALUES; i++) {
+        float v, value;
+        uint32_t idx[2] = {i / 4, i % 4};
+        cgrad_storage_get(&x, idx, 2, &v);
+        cgrad_storage_get(&y, idx, 2, &value);
+        assert_close(value, unary_ref(op, v));
+        cgrad_storage_get(&grad_x, idx, 2, &value);
+        assert_close(value, 2.0f * unary_ref_grad(op, v));
+    }
+
+    op_desc->free_ctx(ctx);
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+    cgrad_storage_free(&grad_x);
+    cgrad_storage_free(&grad_y);
+}
+
+// ============================================================================
+// Tests: Forward and backward of each function
+// ============================================================================
+
+static void test_op_unary_relu(void **state) {
+    (void) state;
+    check_unary_op(&cgrad_op_relu, CGRAD_UNARY_RELU);
+}
+
+static void test_op_unary_gelu(void **state) {
+    (void) state;
+    check_unary_op(&cgrad_op_gelu, CGRAD_UNARY_GELU);
+}
+
+static void test_op_unary_tanh(void **state) {
+    (void) state;
+    check_unary_op(&cgrad_op_tanh, CGRAD_UNARY_TANH);
+}
+
+static void test_op_unary_sigmoid(void **state) {
+    (void) state;
+    check_unary_op(&cgrad_op_sigmoid, CGRAD_UNARY_SIGMOID);
+}
+
+static void test_op_unary_exp(void **state) {
+    (void) state;
+    check_unary_op(&cgrad_op_exp, CGRAD_UNARY_EXP);
+}
+
+static void test_op_unary_log(void **state) {
+    (void) state;
+    check_unary_op(&cgrad_op_log, CGRAD_UNARY_LOG);
+}
+
+// ============================================================================
+// Test: exp stays finite up to ln(FLT_MAX)
+// ============================================================================
+
+static void test_op_unary_exp_near_overflow(void **state) {
+    (void) state;
+
+    // inputs around the clamp, up to just below ln(FLT_MAX) ~ 88.7228, and beyond it
+    const float values[] = {88.0f, 88.3762626647949f, 88.5f, 88.72f, 88.7228317f, 100.0f};
+    uint32_t shape[] = {1, 6};
+    cgrad_storage x, y = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    for (uint32_t i = 0; i < 6; i++) {
+        x.backend->storage_set(x.data, (uint32_t[]){0, i}, 2, values[i]);
+    }
+
+    cgrad_storage* inputs[1] = {&x};
+    cgrad_op_metadata metadata = {0};
+    metadata.unary.op = CGRAD_UNARY_EXP;
+
+    void* ctx = NULL;
+    int ret = cgrad_op_exp.forward(inputs, 1, &metadata, &y, &ctx, 0);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    float value;
+    for (uint32_t i = 0; i < 6; i++) {
+        cgrad_storage_get(&y, (uint32_t[]){0, i}, 2, &value);
+        assert_true(isfinite(value));
+        if (i < 5) assert_close(value, expf(values[i]));
+    }
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+}
+
+// ============================================================================
+// Test: Forward without requires_grad caches nothing
+// ============================================================================
+
+static void test_op_unary_forward_no_grad(void **state) {
+    (void) state;
+
+    uint32_t shape[] = {2, 2};
+    cgrad_storage x, y = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    cgrad_storage_fill(&x, -1.0f);
+
+    cgrad_storage* inputs[1] = {&x};
+    cgrad_op_metadata metadata = {0};
+    metadata.unary.op = CGRAD_UNARY_RELU;
+
+    void* ctx = (void*)&x;
+    int ret = cgrad_op_relu.forward(inputs, 1, &metadata, &y, &ctx, 0);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_null(ctx);
+
+    float value;
+    cgrad_storage_get(&y, (uint32_t[]){1, 1}, 2, &value);
+    assert_true(fabsf(value) < OP_UNARY_EPSILON);
+
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+}
+
+// ============================================================================
+// Test: Forward on a transposed (non-contiguous) input
+// ============================================================================
+
+static void test_op_unary_forward_transposed(void **state) {
+    (void) state;
+
+    uint32_t shape[] = {2, 3};
+    cgrad_storage x, x_t, y = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+            x.backend->storage_set(x.data, (uint32_t[]){i, j}, 2, (float)(i * 3 + j) - 2.5f);
+        }
+    }
+    assert_int_equal(cgrad_storage_transpose(&x, &x_t, (uint32_t[]){1, 0}, 2), CGRAD_SUCCESS);
+
+    cgrad_storage* inputs[1] = {&x_t};
+    cgrad_op_metadata metadata = {0};
+    metadata.unary.op = CGRAD_UNARY_SIGMOID;
+
+    void* ctx = NULL;
+    int ret = cgrad_op_sigmoid.forward(inputs, 1, &metadata, &y, &ctx, 0);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+
+    float value;
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint32_t j = 0; j < 2; j++) {
+            cgrad_storage_get(&y, (uint32_t[]){i, j}, 2, &value);
+            assert_close(value, unary_ref(CGRAD_UNARY_SIGMOID, (float)(j * 3 + i) - 2.5f));
+        }
+    }
+
+    cgrad_storage_free(&x_t);
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+}
+
+// ============================================================================
+// Test: Large input (split over multiple threads)
+// ============================================================================
+
+static void test_op_unary_forward_large(void **state) {
+    (void) state;
+
+    uint32_t shape[] = {512, 1024};
+    cgrad_storage x, y = {0};
+    cgrad_storage_init(&x, shape, 2, "cpu_f32");
+    cgrad_storage_fill_rand(&x);
+
+    cgrad_storage* inputs[1] = {&x};
+    cgrad_op_metadata metadata = {0};
+    metadata.unary.op = CGRAD_UNARY_TANH;
+
+    void* ctx = NULL;
+    int ret = cgrad_op_tanh.forward(inputs, 1, &metadata, &y, &ctx, 1);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_non_null(ctx);
+
+    // spot check rows spread over the whole buffer
+    float v, value;
+    for (uint32_t i = 0; i < 512; i += 37) {
+        uint32_t idx[2] = {i, (i * 7) % 1024};
+        cgrad_storage_get(&x, idx, 2, &v);
+        cgrad_storage_get(&y, idx, 2, &value);
+        assert_close(value, tanhf(v));
+    }
+
+    cgrad_op_tanh.free_ctx(ctx);
+    cgrad_storage_free(&x);
+    cgrad_storage_free(&y);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_op_unary_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_op_unary_relu, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_gelu, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_tanh, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_sigmoid, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_exp, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_log, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_exp_near_overflow, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_forward_no_grad, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_forward_transposed, unary_setup_test, unary_teardown_test),
+        cmocka_unit_test_setup_teardown(test_op_unary_forward_large, unary_setup_test, unary_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_op_unary", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_op_unary_tests();
+}
+#endif
@@ -0,0 +1,262 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_ops.h"
+#include "autograd/cgrad_tensor.h"
+#include "storage/cgrad_storage.h"
+#include "../support/cgrad_alloc_counter.h"
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int allocations_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int allocations_teardown_test(void **state) {
+    (void) state;
+    cgrad_alloc_counter_stop();
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Counts are only meaningful if the allocation functions are interposed (dynamically linked binary)
+static void allocations_require_counter(void) {
+    if (!cgrad_alloc_counter_is_available()) skip();
+}
+
+typedef void (*allocations_step_fn)(void* ctx);
+
+// Allocations of one step in steady state. After warm-up steps, every measured step must make
+// the same number of allocations and free all of them, so steps neither grow nor retain memory.
+static uint64_t allocations_per_step(allocations_step_fn step, void* ctx) {
+    step(ctx);
+    step(ctx);
+    uint64_t first = 0;
+    for (int i = 0; i < 3; i++) {
+        cgrad_alloc_counter_start();
+        step(ctx);
+        cgrad_alloc_counter_stop();
+        uint64_t allocs = cgrad_alloc_counter_allocs();
+        assert_int_equal(cgrad_alloc_counter_frees(), allocs);
+        if (i == 0) first = allocs;
+        assert_int_equal(allocs, first);
+    }
+    return first;
+}
+
+// Storages of a (batch, m, k) x (k, n) gemm with b broadcast over the batch
+typedef struct allocations_gemm {
+    cgrad_storage a, b, b_batched, r, grad_r, grad_a, grad_b;
+    uint8_t batch_mask[3];
+} allocations_gemm;
+
+static void allocations_gemm_init(allocations_gemm* g) {
+    uint32_t shape_a[] = {4, 8, 16};
+    uint32_t shape_b[] = {16, 8};
+    uint32_t shape_b_batched[] = {4, 16, 8};
+    uint32_t shape_r[] = {4, 8, 8};
+    memset(g, 0, sizeof(*g));
+    assert_int_equal(cgrad_storage_init(&g->a, shape_a, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&g->b, shape_b, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&g->b_batched, shape_b_batched, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&g->r, shape_r, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&g->grad_r, shape_r, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&g->grad_a, shape_a, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&g->grad_b, shape_b, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill_rand(&g->a), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill_rand(&g->b), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill_rand(&g->b_batched), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill(&g->grad_r, 1.0f), CGRAD_SUCCESS);
+    g->batch_mask[0] = 1;
+}
+
+static void allocations_backend_gemm_step(void* ctx) {
+    allocations_gemm* g = (allocations_gemm*)ctx;
+    assert_int_equal(g->a.backend->storage_gemm(1.0f, g->a.data, g->b_batched.data, 0.0f, g->r.data), CGRAD_SUCCESS);
+}
+
+static void allocations_backend_axpy_step(void* ctx) {
+    allocations_gemm* g = (allocations_gemm*)ctx;
+    assert_int_equal(g->a.backend->storage_axpy(0.5f, g->a.data, g->grad_a.data), CGRAD_SUCCESS);
+}
+
+static void allocations_storage_gemm_step(void* ctx) {
+    allocations_gemm* g = (allocations_gemm*)ctx;
+    assert_int_equal(cgrad_storage_gemm(1.0f, &g->a, &g->b, 0.0f, &g->r), CGRAD_SUCCESS);
+}
+
+static void allocations_storage_reduce_step(void* ctx) {
+    allocations_gemm* g = (allocations_gemm*)ctx;
+    cgrad_storage sum = {0};
+    assert_int_equal(cgrad_storage_reduce(1.0f, &g->a, g->batch_mask, 3, 0.0f, &sum), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&sum), CGRAD_SUCCESS);
+}
+
+static void allocations_gemm_backward_step(void* ctx) {
+    allocations_gemm* g = (allocations_gemm*)ctx;
+    cgrad_storage* inputs[] = {&g->a, &g->b};
+    cgrad_storage* grads[] = {&g->grad_a, &g->grad_b};
+    int requires_grad[] = {1, 1};
+    assert_int_equal(cgrad_op_gemm_backward(inputs, 2, &g->r, &g->grad_r, NULL, NULL, grads, requires_grad), CGRAD_SUCCESS);
+}
+
+// Softmax cross-entropy of (4, 8, 16) logits with and without the per-row logsumexp output
+typedef struct allocations_cross_entropy {
+    cgrad_storage x, t, loss, lse;
+} allocations_cross_entropy;
+
+static void allocations_cross_entropy_init(allocations_cross_entropy* c) {
+    uint32_t shape[] = {4, 8, 16};
+    uint32_t loss_shape[] = {1};
+    uint32_t lse_shape[] = {4, 8, 1};
+    assert_int_equal(cgrad_storage_init(&c->x, shape, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&c->t, shape, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&c->loss, loss_shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&c->lse, lse_shape, 3, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill_rand(&c->x), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill(&c->t, 1.0f / 16.0f), CGRAD_SUCCESS);
+}
+
+static void allocations_backend_cross_entropy_step(void* ctx) {
+    allocations_cross_entropy* c = (allocations_cross_entropy*)ctx;
+    const cgrad_backend* backend = c->x.backend;
+    assert_int_equal(backend->storage_softmax_cross_entropy(c->x.data, c->t.data, c->loss.data, c->lse.data), CGRAD_SUCCESS);
+    assert_int_equal(backend->storage_softmax_cross_entropy(c->x.data, c->t.data, c->loss.data, NULL), CGRAD_SUCCESS);
+}
+
+// loss = sum(relu(x @ w)) with x (8, 16) and w (16, 8)
+typedef struct allocations_graph {
+    cgrad_tensor x, w, h, r, loss;
+} allocations_graph;
+
+static void allocations_graph_init(allocations_graph* g) {
+    uint32_t x_shape[] = {8, 16};
+    uint32_t w_shape[] = {16, 8};
+    uint8_t mask[] = {1, 1};
+    assert_int_equal(cgrad_tensor_init(&g->x, x_shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_init(&g->w, w_shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill_rand(&g->x), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill_rand(&g->w), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_set_requires_grad(&g->w, 1), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_gemm(&g->x, &g->w, &g->h), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_relu(&g->h, &g->r), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_reduce_sum(&g->r, mask, 2, &g->loss), CGRAD_SUCCESS);
+}
+
+static void allocations_graph_cached_step(void* ctx) {
+    allocations_graph* g = (allocations_graph*)ctx;
+    assert_int_equal(cgrad_tensor_execute(&g->loss), CGRAD_SUCCESS);
+}
+
+// Drops the cached loss so that gemm, relu and reduce_sum all run again
+static void allocations_graph_forward_step(void* ctx) {
+    allocations_graph* g = (allocations_graph*)ctx;
+    assert_int_equal(cgrad_tensor_invalidate(&g->loss), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_execute(&g->loss), CGRAD_SUCCESS);
+}
+
+static void allocations_graph_backward_step(void* ctx) {
+    allocations_graph* g = (allocations_graph*)ctx;
+    assert_int_equal(cgrad_tensor_zero_grad(&g->w), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_backward(&g->loss), CGRAD_SUCCESS);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void test_allocations_counter(void **state) {
+    (void) state;
+    allocations_require_counter();
+    // call through a volatile pointer so that the pair is not optimized away
+    void* (*volatile alloc)(size_t) = malloc;
+    cgrad_alloc_counter_start();
+    void* p = alloc(24);
+    free(p);
+    cgrad_alloc_counter_stop();
+    free(alloc(8));
+
+    assert_int_equal(cgrad_alloc_counter_allocs(), 1);
+    assert_int_equal(cgrad_alloc_counter_frees(), 1);
+    assert_int_equal(cgrad_alloc_counter_bytes(), 24);
+}
+
+static void test_allocations_backend_kernels(void **state) {
+    (void) state;
+    allocations_require_counter();
+    allocations_gemm g;
+    allocations_gemm_init(&g);
+
+    // kernels writing into initialized storages do not allocate
+    assert_int_equal(allocations_per_step(allocations_backend_gemm_step, &g), 0);
+    assert_int_equal(allocations_per_step(allocations_backend_axpy_step, &g), 0);
+
+    allocations_cross_entropy c;
+    allocations_cross_entropy_init(&c);
+    assert_int_equal(allocations_per_step(allocations_backend_cross_entropy_step, &c), 0);
+}
+
+static void test_allocations_storage_ops(void **state) {
+    (void) state;
+    allocations_require_counter();
+    allocations_gemm g;
+    allocations_gemm_init(&g);
+
+    // Broadcasting and transposing views keep no registry records or entries alive. The counts
+    // are pinned so that any new allocation on these paths fails: besides storages and view
+    // handles, every step pays registry bookkeeping (scope records with their hash tables,
+    // registry entries, bucket nodes and record nodes of each registered storage).
+    // gemm: 2 broadcast views (2), bookkeeping (11)
+    assert_int_equal(allocations_per_step(allocations_storage_gemm_step, &g), 13);
+    // reduce: 3 storages with handle and buffer (6), 4 views (4), bookkeeping (57)
+    assert_int_equal(allocations_per_step(allocations_storage_reduce_step, &g), 67);
+    // gemm backward: 4 storages with handle and buffer (8), 12 views (12), bookkeeping (146)
+    assert_int_equal(allocations_per_step(allocations_gemm_backward_step, &g), 166);
+}
+
+static void test_allocations_graph_steps(void **state) {
+    (void) state;
+    allocations_require_counter();
+    allocations_graph g;
+    allocations_graph_init(&g);
+
+    // executing an executed graph again reuses its results
+    assert_int_equal(allocations_per_step(allocations_graph_cached_step, &g), 0);
+    // recomputing gemm -> relu -> reduce_sum, pinned like the storage ops above: 5 storages with
+    // handle and buffer (10), the storage object of the loss and the relu derivative (2),
+    // 6 views (6), bookkeeping (77)
+    assert_int_equal(allocations_per_step(allocations_graph_forward_step, &g), 95);
+    // backward: 1 gradient buffer (1), 11 views (11), bookkeeping (81)
+    assert_int_equal(allocations_per_step(allocations_graph_backward_step, &g), 93);
+}
+
+int run_cgrad_allocations_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_allocations_counter, allocations_setup_test, allocations_teardown_test),
+        cmocka_unit_test_setup_teardown(test_allocations_backend_kernels, allocations_setup_test, allocations_teardown_test),
+        cmocka_unit_test_setup_teardown(test_allocations_storage_ops, allocations_setup_test, allocations_teardown_test),
+        cmocka_unit_test_setup_teardown(test_allocations_graph_steps, allocations_setup_test, allocations_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_allocations", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_allocations_tests();
+}
+#endif
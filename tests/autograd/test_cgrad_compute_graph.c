@@ -4,6 +4,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "autograd/cgrad_compute_graph.h"
 #include "autograd/cgrad_ops.h"
@@ -692,6 +693,56 @@ static void test_cgrad_compute_graph_backward_requires_forward(void **state) {
     cgrad_compute_graph_free(&graph);
 }
 
+// ============================================================================
+// Test: Invalidate - recompute after in-place changes of a leaf
+// ============================================================================
+
+static void test_cgrad_compute_graph_invalidate(void **state) {
+    (void) state;
+    
+    cgrad_compute_graph graph;
+    cgrad_compute_graph_create(&graph);
+    
+    cgrad_storage_layout layout;
+    uint32_t shape[] = {2, 2};
+    cgrad_storage_layout_init(&layout, shape, 2);
+    
+    cgrad_storage* storage = (cgrad_storage*)malloc(sizeof(cgrad_storage));
+    cgrad_storage_init(storage, shape, 2, "cpu_f32");
+    cgrad_storage_fill(storage, 1.0f);
+    uuid_t leaf_id;
+    cgrad_compute_graph_add_leaf(&graph, &layout, storage, leaf_id);
+    
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_relu;
+    op_info.metadata.unary.op = CGRAD_UNARY_RELU;
+    uuid_t relu_id;
+    cgrad_compute_graph_add_op(&graph, &op_info, &layout, &leaf_id, 1, relu_id);
+    
+    float value;
+    cgrad_graph_node* relu_node;
+    cgrad_compute_graph_get_node(&graph, relu_id, &relu_node);
+    assert_int_equal(cgrad_compute_graph_forward(&graph, relu_id), CGRAD_SUCCESS);
+    
+    // The cached result does not see the new leaf data until it is invalidated
+    cgrad_storage_fill(storage, 2.0f);
+    assert_int_equal(cgrad_compute_graph_forward(&graph, relu_id), CGRAD_SUCCESS);
+    cgrad_storage_get(relu_node->storage, (uint32_t[]){1, 1}, 2, &value);
+    assert_true(value == 1.0f);
+    
+    assert_int_equal(cgrad_compute_graph_invalidate(&graph, relu_id), CGRAD_SUCCESS);
+    assert_null(relu_node->storage);
+    assert_int_equal(cgrad_compute_graph_backward(&graph, relu_id), CGRAD_ERR_COMPUTE_GRAPH_FORWARD_NOT_EXECUTED);
+    assert_int_equal(cgrad_compute_graph_forward(&graph, relu_id), CGRAD_SUCCESS);
+    cgrad_storage_get(relu_node->storage, (uint32_t[]){1, 1}, 2, &value);
+    assert_true(value == 2.0f);
+    
+    // Leaf data cannot be recomputed
+    assert_int_equal(cgrad_compute_graph_invalidate(&graph, leaf_id), CGRAD_ERR_COMPUTE_GRAPH_INVALID_OPERATION);
+    
+    cgrad_compute_graph_free(&graph);
+}
+
 // ============================================================================
 // Test: Backward - grad_storage initialization
 // ============================================================================
@@ -775,6 +826,72 @@ static void test_cgrad_compute_graph_backward_zero_grad(void **state) {
     cgrad_compute_graph_free(&graph);
 }
 
+// ============================================================================
+// Test: In-place Execution of Unary Operations
+// ============================================================================
+
+// Build x -> log -> relu with x = 0.5 and return the value left in the log node's storage
+static float run_log_relu_graph(int requires_grad, int release_log_handle) {
+    cgrad_compute_graph graph;
+    cgrad_compute_graph_create(&graph);
+    
+    cgrad_storage_layout layout;
+    uint32_t shape[] = {2, 2};
+    cgrad_storage_layout_init(&layout, shape, 2);
+    
+    cgrad_storage* storage = (cgrad_storage*)malloc(sizeof(cgrad_storage));
+    cgrad_storage_init(storage, shape, 2, "cpu_f32");
+    cgrad_storage_fill(storage, 0.5f);
+    uuid_t leaf_id;
+    cgrad_compute_graph_add_leaf(&graph, &layout, storage, leaf_id);
+    cgrad_compute_graph_set_requires_grad(&graph, leaf_id, requires_grad);
+    
+    cgrad_op_info op_info;
+    op_info.descriptor = &cgrad_op_log;
+    op_info.metadata.unary.op = CGRAD_UNARY_LOG;
+    uuid_t log_id;
+    cgrad_compute_graph_add_op(&graph, &op_info, &layout, &leaf_id, 1, log_id);
+    
+    op_info.descriptor = &cgrad_op_relu;
+    op_info.metadata.unary.op = CGRAD_UNARY_RELU;
+    uuid_t relu_id;
+    cgrad_compute_graph_add_op(&graph, &op_info, &layout, &log_id, 1, relu_id);
+    
+    // Drop the handle to the log node so that relu is its only consumer
+    if (release_log_handle) {
+        cgrad_compute_graph_decrement_ref(&graph, log_id);
+    }
+    
+    int ret = cgrad_compute_graph_forward(&graph, relu_id);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    float value;
+    cgrad_graph_node* relu_node;
+    cgrad_compute_graph_get_node(&graph, relu_id, &relu_node);
+    cgrad_storage_get(relu_node->storage, (uint32_t[]){1, 1}, 2, &value);
+    assert_true(value == 0.0f);
+    
+    cgrad_graph_node* log_node;
+    cgrad_compute_graph_get_node(&graph, log_id, &log_node);
+    cgrad_storage_get(log_node->storage, (uint32_t[]){1, 1}, 2, &value);
+    
+    cgrad_compute_graph_free(&graph);
+    return value;
+}
+
+static void test_cgrad_compute_graph_unary_inplace(void **state) {
+    (void) state;
+    
+    // relu overwrites the storage of log when nothing else can observe it
+    assert_true(run_log_relu_graph(0, 1) == 0.0f);
+    
+    // log is still referenced by its handle: no in-place execution
+    assert_true(run_log_relu_graph(0, 0) == logf(0.5f));
+    
+    // gradients are required: log's storage must stay intact
+    assert_true(run_log_relu_graph(1, 1) == logf(0.5f));
+}
+
 // ============================================================================
 // Test Suite
 // ============================================================================
@@ -796,8 +913,10 @@ int run_cgrad_compute_graph_tests(void) {
         cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_backward_requires_grad_set, graph_setup_test, graph_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_backward_requires_grad_inheritance, graph_setup_test, graph_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_backward_requires_forward, graph_setup_test, graph_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_invalidate, graph_setup_test, graph_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_backward_grad_storage_init, graph_setup_test, graph_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_backward_zero_grad, graph_setup_test, graph_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_compute_graph_unary_inplace, graph_setup_test, graph_teardown_test),
     };
     
     return cmocka_run_group_tests_name("cgrad_compute_graph", tests, NULL, NULL);
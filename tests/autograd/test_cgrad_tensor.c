@@ -132,6 +132,37 @@ static void test_cgrad_tensor_sub(void **state) {
     assert_true(fabs(value - 3.0f) < EPSILON);  // 5.0 - 2.0 = 3.0
 }
 
+// ============================================================================
+// Test: Tensor Mul
+// ============================================================================
+
+static void test_cgrad_tensor_mul(void **state) {
+    (void) state;
+    
+    cgrad_tensor a, b, c;
+    uint32_t shape_a[] = {2, 3};
+    uint32_t shape_b[] = {1, 3};
+    
+    cgrad_tensor_init(&a, shape_a, 2, "cpu_f32");
+    cgrad_tensor_init(&b, shape_b, 2, "cpu_f32");
+    
+    cgrad_tensor_fill(&a, 3.0f);
+    cgrad_tensor_fill(&b, 2.0f);
+    
+    int ret = cgrad_tensor_mul(&a, &b, &c);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // Output should be broadcast to (2, 3)
+    assert_int_equal(c.layout.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(c.layout.shape[TENSOR_DIM - 1], 3);
+    
+    float value;
+    uint32_t indices[] = {1, 2};
+    ret = cgrad_tensor_get(&c, indices, 2, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 6.0f) < EPSILON);  // 3.0 * 2.0 = 6.0
+}
+
 // ============================================================================
 // Test: Tensor GEMM
 // ============================================================================
@@ -515,6 +546,207 @@ static void test_cgrad_tensor_gradient_gemm(void **state) {
     assert_non_null(grad_storage);
 }
 
+// ============================================================================
+// Test: Gradient through an activation
+// ============================================================================
+
+static void test_cgrad_tensor_gradient_activation(void **state) {
+    (void) state;
+    
+    cgrad_tensor a, b, loss;
+    uint32_t shape[] = {2, 3};
+    
+    cgrad_tensor_init(&a, shape, 2, "cpu_f32");
+    cgrad_tensor_fill(&a, 0.5f);
+    
+    // loss = sum(sigmoid(a))
+    int ret = cgrad_tensor_sigmoid(&a, &b);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_int_equal(b.layout.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(b.layout.shape[TENSOR_DIM - 1], 3);
+    
+    uint8_t mask[] = {1, 1};
+    ret = cgrad_tensor_reduce_sum(&b, mask, 2, &loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    ret = cgrad_tensor_execute(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_backward(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // d/da sigmoid(a) = s * (1 - s)
+    float s = 1.0f / (1.0f + expf(-0.5f));
+    float value;
+    uint32_t indices[] = {1, 2};
+    ret = cgrad_tensor_get(&b, indices, 2, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - s) < EPSILON);
+    
+    cgrad_tensor grad_a;
+    ret = cgrad_tensor_get_gradient(&a, &grad_a);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_get(&grad_a, indices, 2, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - s * (1.0f - s)) < EPSILON);
+}
+
+// ============================================================================
+// Test: Gradient through the fused softmax cross-entropy loss
+// ============================================================================
+
+static void test_cgrad_tensor_gradient_softmax_cross_entropy(void **state) {
+    (void) state;
+    
+    cgrad_tensor logits, target, loss;
+    uint32_t shape[] = {2, 4};
+    
+    cgrad_tensor_init(&logits, shape, 2, "cpu_f32");
+    cgrad_tensor_init(&target, shape, 2, "cpu_f32");
+    cgrad_tensor_fill(&logits, 1.0f);
+    cgrad_tensor_fill(&target, 0.0f);
+    
+    // class 2 for both rows
+    cgrad_storage* target_storage = cgrad_tensor_get_storage(&target);
+    assert_non_null(target_storage);
+    target_storage->backend->storage_set(target_storage->data, (uint32_t[]){0, 2}, 2, 1.0f);
+    target_storage->backend->storage_set(target_storage->data, (uint32_t[]){1, 2}, 2, 1.0f);
+    
+    int ret = cgrad_tensor_softmax_cross_entropy(&logits, &target, &loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    for (int i = 0; i < TENSOR_DIM; i++) {
+        assert_int_equal(loss.layout.shape[i], 1);
+    }
+    
+    ret = cgrad_tensor_execute(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_backward(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // uniform logits: loss = log(4), d/dlogits = (0.25 - t) / 2
+    float value;
+    ret = cgrad_tensor_get(&loss, (uint32_t[]){0}, 1, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - logf(4.0f)) < EPSILON);
+    
+    cgrad_tensor grad_logits;
+    ret = cgrad_tensor_get_gradient(&logits, &grad_logits);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_get(&grad_logits, (uint32_t[]){1, 2}, 2, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - (0.25f - 1.0f) / 2.0f) < EPSILON);
+    ret = cgrad_tensor_get(&grad_logits, (uint32_t[]){0, 3}, 2, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 0.25f / 2.0f) < EPSILON);
+}
+
+static void test_cgrad_tensor_gradient_conv2d(void **state) {
+    (void) state;
+    
+    cgrad_tensor input, weight, out, loss;
+    cgrad_tensor_init(&input, (uint32_t[]){1, 1, 3, 3}, 4, "cpu_f32");
+    cgrad_tensor_init(&weight, (uint32_t[]){1, 1, 2, 2}, 4, "cpu_f32");
+    cgrad_tensor_fill(&input, 1.0f);
+    cgrad_tensor_fill(&weight, 1.0f);
+    
+    // 2x2 kernel with stride 2 and padding 1 covers every input element exactly once
+    int ret = cgrad_tensor_conv2d(&input, &weight, (uint32_t[]){2, 2}, (uint32_t[]){1, 1}, NULL, &out);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_int_equal(out.layout.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(out.layout.shape[TENSOR_DIM - 1], 2);
+    
+    uint8_t mask[] = {1, 1, 1, 1};
+    ret = cgrad_tensor_reduce_sum(&out, mask, 4, &loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_execute(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_backward(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // output taps see 1, 2, 2 and 4 valid inputs
+    float value;
+    ret = cgrad_tensor_get(&out, (uint32_t[]){0, 0, 0, 1}, 4, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 2.0f) < EPSILON);
+    ret = cgrad_tensor_get(&out, (uint32_t[]){0, 0, 1, 1}, 4, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 4.0f) < EPSILON);
+    
+    cgrad_tensor grad_input, grad_weight;
+    ret = cgrad_tensor_get_gradient(&input, &grad_input);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_get(&grad_input, (uint32_t[]){0, 0, 2, 1}, 4, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 1.0f) < EPSILON);
+    
+    // each weight tap sees as many inputs as it covers over all outputs
+    ret = cgrad_tensor_get_gradient(&weight, &grad_weight);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_get(&grad_weight, (uint32_t[]){0, 0, 0, 0}, 4, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 1.0f) < EPSILON);
+    ret = cgrad_tensor_get(&grad_weight, (uint32_t[]){0, 0, 1, 1}, 4, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 4.0f) < EPSILON);
+}
+
+static void test_cgrad_tensor_gradient_slice_and_cat(void **state) {
+    (void) state;
+    
+    cgrad_tensor a, b, left, row, cat, loss;
+    cgrad_tensor_init(&a, (uint32_t[]){3, 4}, 2, "cpu_f32");
+    cgrad_tensor_init(&b, (uint32_t[]){1, 4}, 2, "cpu_f32");
+    cgrad_tensor_fill(&a, 1.0f);
+    cgrad_tensor_fill(&b, 2.0f);
+    
+    // stack columns 1..2 of a on top of every second column of b
+    int ret = cgrad_tensor_narrow(&a, -1, 1, 2, &left);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_int_equal(left.layout.shape[TENSOR_DIM - 1], 2);
+    ret = cgrad_tensor_slice(&b, (uint32_t[]){0, 0}, (uint32_t[]){1, 4}, (uint32_t[]){1, 2}, 2, &row);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_int_equal(row.layout.shape[TENSOR_DIM - 1], 2);
+    
+    const cgrad_tensor* parts[2] = {&left, &row};
+    ret = cgrad_tensor_cat(parts, 2, -2, &cat);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_int_equal(cat.layout.shape[TENSOR_DIM - 2], 4);
+    assert_int_equal(cat.layout.shape[TENSOR_DIM - 1], 2);
+    
+    uint8_t mask[] = {1, 1};
+    ret = cgrad_tensor_reduce_sum(&cat, mask, 2, &loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    ret = cgrad_tensor_backward(&loss);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    
+    // 3 * 2 ones + 2 twos
+    float value;
+    ret = cgrad_tensor_get(&loss, (uint32_t[]){0}, 1, &value);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_true(fabs(value - 10.0f) < EPSILON);
+    
+    // only the narrowed columns and the sliced entries receive gradient
+    cgrad_tensor grad_a, grad_b;
+    ret = cgrad_tensor_get_gradient(&a, &grad_a);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    cgrad_tensor_get(&grad_a, (uint32_t[]){2, 0}, 2, &value);
+    assert_true(fabs(value) < EPSILON);
+    cgrad_tensor_get(&grad_a, (uint32_t[]){2, 2}, 2, &value);
+    assert_true(fabs(value - 1.0f) < EPSILON);
+    ret = cgrad_tensor_get_gradient(&b, &grad_b);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    cgrad_tensor_get(&grad_b, (uint32_t[]){0, 2}, 2, &value);
+    assert_true(fabs(value - 1.0f) < EPSILON);
+    cgrad_tensor_get(&grad_b, (uint32_t[]){0, 3}, 2, &value);
+    assert_true(fabs(value) < EPSILON);
+    
+    // select drops the dimension
+    cgrad_tensor col;
+    ret = cgrad_tensor_select(&a, -1, 3, &col);
+    assert_int_equal(ret, CGRAD_SUCCESS);
+    assert_int_equal(col.layout.shape[TENSOR_DIM - 1], 3);
+    assert_int_equal(col.layout.shape[TENSOR_DIM - 2], 1);
+}
+
 // ============================================================================
 // Test: Tensor Get (with auto-execute)
 // ============================================================================
@@ -879,6 +1111,38 @@ static void test_cgrad_tensor_zero_grad_no_gradient(void **state) {
     assert_int_equal(ret, CGRAD_SUCCESS);
 }
 
+static void test_cgrad_tensor_backward_accumulates(void **state) {
+    (void) state;
+    
+    // loss = sum(a * a) with a = 0.5, so every backward pass adds 2 * a = 1 to the gradient of a
+    cgrad_tensor a, b, loss;
+    uint32_t shape[] = {2, 3};
+    uint8_t mask[] = {1, 1};
+    cgrad_tensor_init(&a, shape, 2, "cpu_f32");
+    cgrad_tensor_fill(&a, 0.5f);
+    assert_int_equal(cgrad_tensor_mul(&a, &a, &b), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_reduce_sum(&b, mask, 2, &loss), CGRAD_SUCCESS);
+    
+    // the gradient of the intermediate b is reset by every pass, only the leaf accumulates
+    uint32_t indices[] = {1, 2};
+    float value;
+    for (int pass = 1; pass <= 3; pass++) {
+        assert_int_equal(cgrad_tensor_backward(&loss), CGRAD_SUCCESS);
+        cgrad_storage_get(cgrad_tensor_get_grad_storage(&a), indices, 2, &value);
+        assert_true(fabs(value - (float)pass) < EPSILON);
+        cgrad_storage_get(cgrad_tensor_get_grad_storage(&b), indices, 2, &value);
+        assert_true(fabs(value - 1.0f) < EPSILON);
+    }
+    
+    // after zeroing, the same buffer starts over
+    cgrad_storage* grad_a = cgrad_tensor_get_grad_storage(&a);
+    assert_int_equal(cgrad_tensor_zero_grad(&a), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_backward(&loss), CGRAD_SUCCESS);
+    assert_ptr_equal(cgrad_tensor_get_grad_storage(&a), grad_a);
+    cgrad_storage_get(grad_a, indices, 2, &value);
+    assert_true(fabs(value - 1.0f) < EPSILON);
+}
+
 // ============================================================================
 // Test Suite
 // ============================================================================
@@ -889,6 +1153,11 @@ int run_cgrad_tensor_tests(void) {
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_fill, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_add, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_sub, tensor_setup_test, tensor_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_tensor_mul, tensor_setup_test, tensor_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_tensor_gradient_activation, tensor_setup_test, tensor_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_tensor_gradient_softmax_cross_entropy, tensor_setup_test, tensor_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_tensor_gradient_conv2d, tensor_setup_test, tensor_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_tensor_gradient_slice_and_cat, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_gemm, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_transpose, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_reshape, tensor_setup_test, tensor_teardown_test),
@@ -909,6 +1178,7 @@ int run_cgrad_tensor_tests(void) {
         cmocka_unit_test_setup_teardown(test_cgrad_gradient_mode_inference, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_zero_grad_specific, tensor_setup_test, tensor_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_tensor_zero_grad_no_gradient, tensor_setup_test, tensor_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_tensor_backward_accumulates, tensor_setup_test, tensor_teardown_test),
     };
     
     return cmocka_run_group_tests_name("cgrad_tensor", tests, NULL, NULL);
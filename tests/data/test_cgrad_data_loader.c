@@ -0,0 +1,191 @@
+#include <cmocka.h>
+#include "cgrad.h"
+#include "data/cgrad_data_loader.h"
+#include "autograd/cgrad_tensor.h"
+#include "cgrad_status.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define DATA_LOADER_TEST_SAMPLES 10
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static char data_loader_path[64];
+
+// Dataset of DATA_LOADER_TEST_SAMPLES records: input (i, i + 0.5, i + 0.25), target 10 * i
+static int data_loader_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    strcpy(data_loader_path, "/tmp/cgrad_test_data_loader_XXXXXX");
+    int fd = mkstemp(data_loader_path);
+    if (fd < 0) return -1;
+    FILE* f = fdopen(fd, "wb");
+    if (!f) return -1;
+    for (int i = 0; i < DATA_LOADER_TEST_SAMPLES; i++) {
+        float record[4] = {(float)i, i + 0.5f, i + 0.25f, 10.0f * i};
+        fwrite(record, sizeof(float), 4, f);
+    }
+    fclose(f);
+    return 0;
+}
+
+static int data_loader_teardown_test(void **state) {
+    (void) state;
+    unlink(data_loader_path);
+    cgrad_cleanup();
+    return 0;
+}
+
+static void data_loader_test_config(cgrad_data_loader_config* config) {
+    cgrad_data_loader_config_init(config);
+    config->path = data_loader_path;
+    config->input_shape[0] = 3;
+    config->input_ndim = 1;
+    config->target_shape[0] = 1;
+    config->target_ndim = 1;
+    config->batch_size = 4;
+}
+
+// Check that every row of a batch is a consistent record and return the sample index of row i
+static int data_loader_check_row(const cgrad_data_batch* batch, uint32_t i) {
+    float values[4];
+    for (uint32_t j = 0; j < 3; j++) {
+        uint32_t idx[2] = {i, j};
+        assert_int_equal(cgrad_tensor_get(&batch->inputs, idx, 2, &values[j]), CGRAD_SUCCESS);
+    }
+    uint32_t idx[2] = {i, 0};
+    assert_int_equal(cgrad_tensor_get(&batch->targets, idx, 2, &values[3]), CGRAD_SUCCESS);
+    assert_float_equal(values[1], values[0] + 0.5f, 1e-6);
+    assert_float_equal(values[2], values[0] + 0.25f, 1e-6);
+    assert_float_equal(values[3], values[0] * 10.0f, 1e-6);
+    return (int)values[0];
+}
+
+static void test_cgrad_data_loader_sequential(void **state) {
+    (void) state;
+    cgrad_data_loader_config config;
+    data_loader_test_config(&config);
+    config.num_epochs = 2;
+
+    cgrad_data_loader* loader = NULL;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_data_loader_num_samples(loader), DATA_LOADER_TEST_SAMPLES);
+    assert_int_equal(cgrad_data_loader_num_batches(loader), 2);
+
+    // the incomplete last batch (samples 8 and 9) is dropped
+    cgrad_data_batch batch;
+    for (uint64_t epoch = 0; epoch < 2; epoch++) {
+        for (uint64_t b = 0; b < 2; b++) {
+            assert_int_equal(cgrad_data_loader_next(loader, &batch), CGRAD_SUCCESS);
+            assert_int_equal(batch.epoch, epoch);
+            assert_int_equal(batch.index, b);
+            assert_int_equal(batch.inputs.layout.shape[TENSOR_DIM - 2], 4);
+            assert_int_equal(batch.inputs.layout.shape[TENSOR_DIM - 1], 3);
+            for (uint32_t i = 0; i < 4; i++) {
+                assert_int_equal(data_loader_check_row(&batch, i), (int)(b * 4 + i));
+            }
+        }
+    }
+    assert_int_equal(cgrad_data_loader_next(loader, &batch), CGRAD_ERR_DATA_LOADER_EXHAUSTED);
+    assert_int_equal(cgrad_data_loader_next(loader, &batch), CGRAD_ERR_DATA_LOADER_EXHAUSTED);
+    cgrad_data_loader_free(loader);
+}
+
+// Collect the sample order of the first num_epochs epochs
+static void data_loader_collect(cgrad_data_loader_config* config, int num_epochs, int* out_order) {
+    cgrad_data_loader* loader = NULL;
+    assert_int_equal(cgrad_data_loader_create(config, &loader), CGRAD_SUCCESS);
+    cgrad_data_batch batch;
+    for (int b = 0; b < num_epochs * 2; b++) {
+        assert_int_equal(cgrad_data_loader_next(loader, &batch), CGRAD_SUCCESS);
+        assert_int_equal(batch.epoch * 2 + batch.index, b);
+        for (uint32_t i = 0; i < 4; i++) {
+            out_order[b * 4 + i] = data_loader_check_row(&batch, i);
+        }
+    }
+    cgrad_data_loader_free(loader);
+}
+
+static void test_cgrad_data_loader_shuffle(void **state) {
+    (void) state;
+    cgrad_data_loader_config config;
+    data_loader_test_config(&config);
+    config.shuffle = 1;
+    config.seed = 42;
+    config.num_workers = 3;
+    config.num_buffers = 5;
+
+    // more buffers than batches per epoch: several epochs are assembled at once
+    int order[8 * 8], again[8 * 8];
+    data_loader_collect(&config, 8, order);
+    data_loader_collect(&config, 8, again);
+    assert_memory_equal(order, again, sizeof(order));
+
+    // every epoch draws distinct samples, and not all epochs in the same order
+    int differs = 0;
+    for (int epoch = 0; epoch < 8; epoch++) {
+        int seen[DATA_LOADER_TEST_SAMPLES] = {0};
+        for (int i = 0; i < 8; i++) {
+            int sample = order[epoch * 8 + i];
+            assert_in_range(sample, 0, DATA_LOADER_TEST_SAMPLES - 1);
+            assert_int_equal(seen[sample], 0);
+            seen[sample] = 1;
+        }
+        differs |= memcmp(&order[epoch * 8], &order[0], 8 * sizeof(int)) != 0;
+    }
+    assert_true(differs);
+}
+
+static void test_cgrad_data_loader_errors(void **state) {
+    (void) state;
+    cgrad_data_loader_config config;
+    cgrad_data_loader* loader = NULL;
+
+    data_loader_test_config(&config);
+    config.batch_size = 0;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_ERR_DATA_LOADER_INVALID_CONFIG);
+    data_loader_test_config(&config);
+    config.num_buffers = 1;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_ERR_DATA_LOADER_INVALID_CONFIG);
+    data_loader_test_config(&config);
+    config.input_ndim = TENSOR_DIM;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_ERR_DATA_LOADER_INVALID_CONFIG);
+
+    // the file size must be a multiple of the record size and hold at least one batch
+    data_loader_test_config(&config);
+    config.input_shape[0] = 2;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_ERR_STORAGE_FILE_INVALID);
+    data_loader_test_config(&config);
+    config.batch_size = DATA_LOADER_TEST_SAMPLES + 1;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_ERR_STORAGE_FILE_INVALID);
+    data_loader_test_config(&config);
+    config.path = "/nonexistent/cgrad.data";
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_ERR_STORAGE_FILE_IO);
+    assert_null(loader);
+
+    // freeing a loader with batches still being assembled
+    data_loader_test_config(&config);
+    config.num_buffers = 4;
+    assert_int_equal(cgrad_data_loader_create(&config, &loader), CGRAD_SUCCESS);
+    cgrad_data_loader_free(loader);
+}
+
+int run_cgrad_data_loader_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_cgrad_data_loader_sequential, data_loader_setup_test, data_loader_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_data_loader_shuffle, data_loader_setup_test, data_loader_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_data_loader_errors, data_loader_setup_test, data_loader_teardown_test),
+    };
+    return cmocka_run_group_tests_name("cgrad_data_loader", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_data_loader_tests();
+}
+#endif
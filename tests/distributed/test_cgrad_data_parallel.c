@@ -0,0 +1,280 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include <sys/resource.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "optim/cgrad_param_group.h"
+#include "distributed/cgrad_data_parallel.h"
+
+#define DATA_PARALLEL_TEST_RANKS 3
+#define DATA_PARALLEL_TEST_EPSILON 1e-5f
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int data_parallel_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int data_parallel_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Workers run in child processes and report failures through their status instead of cmocka
+#define DATA_PARALLEL_CHECK(cond) do { if (!(cond)) { err = CGRAD_ERR_DATA_PARALLEL_MISMATCH; goto done; } } while (0)
+
+typedef struct data_parallel_test_args {
+    char name[64];
+} data_parallel_test_args;
+
+static void data_parallel_test_name(data_parallel_test_args* args, const char* test) {
+    snprintf(args->name, sizeof(args->name), "/cgrad_test_%s_%d", test, (int)getpid());
+}
+
+// Four parameters of shapes (3, 5), (7), (2, 2) and (40): with 64-byte buckets every
+// parameter gets its own bucket, parameter 2 is never used by the loss
+static cgrad_param_group* data_parallel_make_group(void) {
+    uint32_t shape0[] = {3, 5};
+    uint32_t shape1[] = {7};
+    uint32_t shape2[] = {2, 2};
+    uint32_t shape3[] = {40};
+    const uint32_t* shapes[] = {shape0, shape1, shape2, shape3};
+    int ndims[] = {2, 1, 2, 1};
+    cgrad_param_group* group = NULL;
+    cgrad_param_group_create(shapes, ndims, 4, "cpu_f32", &group);
+    return group;
+}
+
+static cgrad_status data_parallel_attach(const data_parallel_test_args* args, int rank, int world_size, cgrad_param_group* group, cgrad_data_parallel** dp) {
+    cgrad_data_parallel_config config;
+    cgrad_data_parallel_config_init(&config);
+    config.name = args->name;
+    config.world_size = world_size;
+    config.rank = rank;
+    config.bucket_bytes = 64;
+    config.timeout_ms = 20000;
+    return cgrad_data_parallel_create(&config, group, dp);
+}
+
+// ============================================================================
+// Test: allreduce of the flat gradient buffers
+// ============================================================================
+
+static cgrad_status data_parallel_allreduce_worker(int rank, int world_size, void* arg) {
+    cgrad_data_parallel* dp = NULL;
+    cgrad_param_group* group = data_parallel_make_group();
+    cgrad_status err = group ? data_parallel_attach((const data_parallel_test_args*)arg, rank, world_size, group, &dp) : CGRAD_ERR_NULL_POINTER;
+    if (err != CGRAD_SUCCESS) goto done;
+    DATA_PARALLEL_CHECK(cgrad_data_parallel_num_buckets(dp) == 4);
+
+    // rank r contributes (r + 1) * (i + 1) at element i, the average is (world_size + 1) / 2 * (i + 1)
+    float* grads = cgrad_param_group_get_grad_data(group);
+    uint64_t n = cgrad_param_group_num_elements(group);
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint64_t i = 0; i < n; i++) grads[i] = (float)(rank + 1) * (float)(i + 1);
+        err = cgrad_data_parallel_allreduce(dp);
+        if (err != CGRAD_SUCCESS) goto done;
+        for (uint64_t i = 0; i < n; i++) {
+            DATA_PARALLEL_CHECK(fabsf(grads[i] - (float)(world_size + 1) * 0.5f * (float)(i + 1)) < DATA_PARALLEL_TEST_EPSILON * (float)(i + 1));
+        }
+    }
+
+done:
+    cgrad_data_parallel_free(dp);
+    cgrad_param_group_free(group);
+    return err;
+}
+
+static void test_data_parallel_allreduce(void **state) {
+    (void) state;
+    data_parallel_test_args args;
+    data_parallel_test_name(&args, "allreduce");
+    assert_int_equal(cgrad_data_parallel_spawn(DATA_PARALLEL_TEST_RANKS, data_parallel_allreduce_worker, &args), CGRAD_SUCCESS);
+}
+
+// ============================================================================
+// Test: allreduce overlapping with the backward pass
+// ============================================================================
+
+// loss = sum(params[0]) + 2 * sum(params[1]) + 3 * sum(params[3]), scaled by rank + 1
+static cgrad_status data_parallel_loss(cgrad_param_group* group, int rank, cgrad_tensor* loss) {
+    static const int used[] = {0, 1, 3};
+    cgrad_tensor* params = cgrad_param_group_get_params(group);
+    cgrad_tensor terms[3], sums[3], partial;
+    uint8_t mask[] = {1, 1};
+    cgrad_status err = CGRAD_SUCCESS;
+    for (int k = 0; k < 3 && err == CGRAD_SUCCESS; k++) {
+        cgrad_tensor* p = &params[used[k]];
+        cgrad_tensor c;
+        int ndim = used[k] == 0 ? 2 : 1;
+        const uint32_t* shape = &p->layout.shape[TENSOR_DIM - ndim];
+        err = cgrad_tensor_init(&c, shape, ndim, "cpu_f32");
+        if (err == CGRAD_SUCCESS) err = cgrad_tensor_fill(&c, (float)((k + 1) * (rank + 1)));
+        if (err == CGRAD_SUCCESS) err = cgrad_tensor_set_requires_grad(&c, 0);
+        if (err == CGRAD_SUCCESS) err = cgrad_tensor_mul(p, &c, &terms[k]);
+        if (err == CGRAD_SUCCESS) err = cgrad_tensor_reduce_sum(&terms[k], mask, ndim, &sums[k]);
+    }
+    if (err == CGRAD_SUCCESS) err = cgrad_tensor_add(&sums[0], &sums[1], &partial);
+    if (err == CGRAD_SUCCESS) err = cgrad_tensor_add(&partial, &sums[2], loss);
+    return err;
+}
+
+static cgrad_status data_parallel_backward_worker(int rank, int world_size, void* arg) {
+    cgrad_data_parallel* dp = NULL;
+    cgrad_param_group* group = data_parallel_make_group();
+    cgrad_status err = group ? data_parallel_attach((const data_parallel_test_args*)arg, rank, world_size, group, &dp) : CGRAD_ERR_NULL_POINTER;
+    if (err != CGRAD_SUCCESS) goto done;
+
+    float* grads = cgrad_param_group_get_grad_data(group);
+    float mean_rank = (float)(world_size + 1) * 0.5f;
+    for (int pass = 0; pass < 2; pass++) {
+        err = cgrad_param_group_zero_grad(group);
+        if (err != CGRAD_SUCCESS) goto done;
+        // the unused parameter is reduced as well
+        uint64_t unused = cgrad_param_group_get_offset(group, 2);
+        for (int i = 0; i < 4; i++) grads[unused + i] = (float)rank;
+
+        cgrad_tensor loss;
+        err = data_parallel_loss(group, rank, &loss);
+        if (err == CGRAD_SUCCESS) err = cgrad_data_parallel_backward(dp, &loss);
+        if (err != CGRAD_SUCCESS) goto done;
+
+        static const int params[] = {0, 1, 3};
+        static const int sizes[] = {15, 7, 40};
+        for (int k = 0; k < 3; k++) {
+            uint64_t offset = cgrad_param_group_get_offset(group, params[k]);
+            for (int i = 0; i < sizes[k]; i++) {
+                DATA_PARALLEL_CHECK(fabsf(grads[offset + i] - (float)(k + 1) * mean_rank) < DATA_PARALLEL_TEST_EPSILON);
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            DATA_PARALLEL_CHECK(fabsf(grads[unused + i] - (float)(world_size - 1) * 0.5f) < DATA_PARALLEL_TEST_EPSILON);
+        }
+    }
+
+done:
+    cgrad_data_parallel_free(dp);
+    cgrad_param_group_free(group);
+    return err;
+}
+
+static void test_data_parallel_backward(void **state) {
+    (void) state;
+    data_parallel_test_args args;
+    data_parallel_test_name(&args, "backward");
+    assert_int_equal(cgrad_data_parallel_spawn(DATA_PARALLEL_TEST_RANKS, data_parallel_backward_worker, &args), CGRAD_SUCCESS);
+}
+
+// ============================================================================
+// Test: invalid configurations and failing workers
+// ============================================================================
+
+static cgrad_status data_parallel_failing_worker(int rank, int world_size, void* arg) {
+    (void) world_size;
+    (void) arg;
+    return rank == 1 ? CGRAD_ERR_NOT_IMPLEMENTED : CGRAD_SUCCESS;
+}
+
+static void test_data_parallel_errors(void **state) {
+    (void) state;
+    cgrad_param_group* group = data_parallel_make_group();
+    assert_non_null(group);
+
+    cgrad_data_parallel_config config;
+    cgrad_data_parallel_config_init(&config);
+    cgrad_data_parallel* dp = NULL;
+
+    config.world_size = 2;
+    config.rank = 2;
+    config.name = "/cgrad_test_invalid";
+    assert_int_equal(cgrad_data_parallel_create(&config, group, &dp), CGRAD_ERR_DATA_PARALLEL_INVALID_CONFIG);
+    config.rank = 0;
+    config.name = "no_slash";
+    assert_int_equal(cgrad_data_parallel_create(&config, group, &dp), CGRAD_ERR_DATA_PARALLEL_INVALID_CONFIG);
+    assert_null(dp);
+
+    // a single rank needs no segment: allreduce leaves the gradients as they are
+    config.world_size = 1;
+    config.name = NULL;
+    assert_int_equal(cgrad_data_parallel_create(&config, group, &dp), CGRAD_SUCCESS);
+    cgrad_param_group_get_grad_data(group)[0] = 3.0f;
+    assert_int_equal(cgrad_data_parallel_allreduce(dp), CGRAD_SUCCESS);
+    assert_true(cgrad_param_group_get_grad_data(group)[0] == 3.0f);
+    cgrad_data_parallel_free(dp);
+
+    assert_int_equal(cgrad_data_parallel_spawn(2, data_parallel_failing_worker, NULL), CGRAD_ERR_DATA_PARALLEL_WORKER_FAILED);
+    cgrad_param_group_free(group);
+}
+
+// ============================================================================
+// Test: waiting for a late rank sleeps instead of spinning
+// ============================================================================
+
+static double data_parallel_cpu_seconds(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + 1e-6 * (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+// rank 1 joins the allreduce 300 ms late, rank 0 must not burn that time on its cpu
+static cgrad_status data_parallel_late_rank_worker(int rank, int world_size, void* arg) {
+    cgrad_data_parallel* dp = NULL;
+    cgrad_param_group* group = data_parallel_make_group();
+    cgrad_status err = group ? data_parallel_attach((const data_parallel_test_args*)arg, rank, world_size, group, &dp) : CGRAD_ERR_NULL_POINTER;
+    if (err != CGRAD_SUCCESS) goto done;
+
+    if (rank == 1) usleep(300000);
+    double start = data_parallel_cpu_seconds();
+    err = cgrad_data_parallel_allreduce(dp);
+    if (err != CGRAD_SUCCESS) goto done;
+    if (rank == 0) DATA_PARALLEL_CHECK(data_parallel_cpu_seconds() - start < 0.1);
+
+done:
+    cgrad_data_parallel_free(dp);
+    cgrad_param_group_free(group);
+    return err;
+}
+
+static void test_data_parallel_wait_sleeps(void **state) {
+    (void) state;
+    data_parallel_test_args args;
+    data_parallel_test_name(&args, "wait");
+    assert_int_equal(cgrad_data_parallel_spawn(2, data_parallel_late_rank_worker, &args), CGRAD_SUCCESS);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_data_parallel_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_data_parallel_allreduce, data_parallel_setup_test, data_parallel_teardown_test),
+        cmocka_unit_test_setup_teardown(test_data_parallel_backward, data_parallel_setup_test, data_parallel_teardown_test),
+        cmocka_unit_test_setup_teardown(test_data_parallel_errors, data_parallel_setup_test, data_parallel_teardown_test),
+        cmocka_unit_test_setup_teardown(test_data_parallel_wait_sleeps, data_parallel_setup_test, data_parallel_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_data_parallel", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_data_parallel_tests();
+}
+#endif
@@ -0,0 +1,354 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "optim/cgrad_optimizer.h"
+
+#define OPTIMIZER_EPSILON 1e-5f
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int optimizer_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int optimizer_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Parameter p of shape (2, 3) with p[i] = i + 1 and a constant tensor g with
+// g[i] = 0.5 * i - 1, so that loss = sum(p * g) gives dloss/dp = g
+static void optimizer_make_param(cgrad_tensor* p, cgrad_tensor* g) {
+    uint32_t shape[] = {2, 3};
+    cgrad_tensor_init(p, shape, 2, "cpu_f32");
+    cgrad_tensor_init(g, shape, 2, "cpu_f32");
+    cgrad_tensor_set_requires_grad(p, 1);
+    cgrad_tensor_set_requires_grad(g, 0);
+
+    cgrad_storage* ps = cgrad_tensor_get_storage(p);
+    cgrad_storage* gs = cgrad_tensor_get_storage(g);
+    for (uint32_t i = 0; i < 6; i++) {
+        uint32_t idx[2] = {i / 3, i % 3};
+        ps->backend->storage_set(ps->data, idx, 2, (float)(i + 1));
+        gs->backend->storage_set(gs->data, idx, 2, 0.5f * (float)i - 1.0f);
+    }
+}
+
+static void optimizer_backward(const cgrad_tensor* p, const cgrad_tensor* g) {
+    cgrad_tensor prod, loss;
+    uint8_t mask[] = {1, 1};
+    assert_int_equal(cgrad_tensor_mul(p, g, &prod), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_reduce_sum(&prod, mask, 2, &loss), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_backward(&loss), CGRAD_SUCCESS);
+}
+
+static float optimizer_get(const cgrad_tensor* t, uint32_t i) {
+    float value = 0.0f;
+    cgrad_storage_get(cgrad_tensor_get_storage(t), (uint32_t[]){i / 3, i % 3}, 2, &value);
+    return value;
+}
+
+static float optimizer_sign(float x) {
+    return x > 0.0f ? 1.0f : (x < 0.0f ? -1.0f : 0.0f);
+}
+
+// ============================================================================
+// Test: SGD
+// ============================================================================
+
+static void test_optimizer_sgd(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+    optimizer_backward(&p, &g);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_SGD);
+    config.lr = 0.1f;
+    config.weight_decay = 0.01f;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_num_steps(opt), 1);
+
+    for (uint32_t i = 0; i < 6; i++) {
+        float p0 = (float)(i + 1);
+        float grad = 0.5f * (float)i - 1.0f + 0.01f * p0;
+        assert_true(fabsf(optimizer_get(&p, i) - (p0 - 0.1f * grad)) < OPTIMIZER_EPSILON);
+    }
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: SGD with momentum over two steps
+// ============================================================================
+
+static void test_optimizer_sgd_momentum(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+    optimizer_backward(&p, &g);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_SGD);
+    config.lr = 0.1f;
+    config.momentum = 0.9f;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_SUCCESS);
+
+    // the gradient does not depend on p, so both steps see the same gradient:
+    // buf1 = g, buf2 = 0.9 * g + g
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 6; i++) {
+        float grad = 0.5f * (float)i - 1.0f;
+        float expected = (float)(i + 1) - 0.1f * grad - 0.1f * 1.9f * grad;
+        assert_true(fabsf(optimizer_get(&p, i) - expected) < OPTIMIZER_EPSILON);
+    }
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: Adam first step moves every parameter by lr against its gradient
+// ============================================================================
+
+static void test_optimizer_adam(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+    optimizer_backward(&p, &g);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_ADAM);
+    config.lr = 0.01f;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+
+    // with bias correction m_hat = g and v_hat = g^2 after the first step
+    for (uint32_t i = 0; i < 6; i++) {
+        float grad = 0.5f * (float)i - 1.0f;
+        float expected = (float)(i + 1) - 0.01f * grad / (fabsf(grad) + 1e-8f);
+        assert_true(fabsf(optimizer_get(&p, i) - expected) < OPTIMIZER_EPSILON);
+    }
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: AdamW applies decoupled weight decay
+// ============================================================================
+
+static void test_optimizer_adamw(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+    optimizer_backward(&p, &g);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_ADAMW);
+    config.lr = 0.01f;
+    config.weight_decay = 0.1f;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 6; i++) {
+        float p0 = (float)(i + 1);
+        float grad = 0.5f * (float)i - 1.0f;
+        float expected = p0 * (1.0f - 0.01f * 0.1f) - 0.01f * optimizer_sign(grad);
+        assert_true(fabsf(optimizer_get(&p, i) - expected) < OPTIMIZER_EPSILON);
+    }
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: gradient clipping before the step
+// ============================================================================
+
+static void test_optimizer_clip_grad_norm(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+    optimizer_backward(&p, &g);
+
+    // the gradient {-1, -0.5, 0, 0.5, 1, 1.5} has norm sqrt(4.75)
+    float norm = sqrtf(4.75f);
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_SGD);
+    config.lr = 1.0f;
+    config.max_grad_norm = 0.5f;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+    assert_true(fabsf(cgrad_optimizer_get_grad_norm(opt) - norm) < OPTIMIZER_EPSILON);
+
+    // the update is the gradient rescaled to norm 0.5
+    for (uint32_t i = 0; i < 6; i++) {
+        float grad = 0.5f * (float)i - 1.0f;
+        float expected = (float)(i + 1) - grad * 0.5f / norm;
+        assert_true(fabsf(optimizer_get(&p, i) - expected) < OPTIMIZER_EPSILON);
+    }
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: gradient accumulation over micro-batches
+// ============================================================================
+
+static void test_optimizer_accumulation(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_SGD);
+    config.lr = 0.1f;
+    config.accumulation_steps = 3;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_SUCCESS);
+
+    // the first two micro-batches only accumulate
+    for (int k = 1; k <= 2; k++) {
+        optimizer_backward(&p, &g);
+        assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+        assert_int_equal(cgrad_optimizer_num_micro_batches(opt), k);
+        assert_int_equal(cgrad_optimizer_num_steps(opt), 0);
+        assert_true(optimizer_get(&p, 5) == 6.0f);
+    }
+
+    // the third one updates with the mean gradient and clears the gradient buffer
+    optimizer_backward(&p, &g);
+    cgrad_storage* grad = cgrad_tensor_get_grad_storage(&p);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_num_micro_batches(opt), 0);
+    assert_int_equal(cgrad_optimizer_num_steps(opt), 1);
+    assert_ptr_equal(cgrad_tensor_get_grad_storage(&p), grad);
+
+    for (uint32_t i = 0; i < 6; i++) {
+        float mean_grad = 0.5f * (float)i - 1.0f;
+        assert_true(fabsf(optimizer_get(&p, i) - ((float)(i + 1) - 0.1f * mean_grad)) < OPTIMIZER_EPSILON);
+        float value = -1.0f;
+        cgrad_storage_get(grad, (uint32_t[]){i / 3, i % 3}, 2, &value);
+        assert_true(value == 0.0f);
+    }
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: parameters without gradient are skipped
+// ============================================================================
+
+static void test_optimizer_skip_without_grad(void **state) {
+    (void) state;
+
+    cgrad_tensor params[2], g, g_unused;
+    optimizer_make_param(&params[0], &g);
+    optimizer_make_param(&params[1], &g_unused);
+    optimizer_backward(&params[0], &g);
+    assert_null(cgrad_tensor_get_grad_storage(&params[1]));
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_ADAM);
+    config.lr = 0.01f;
+
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create(&config, params, 2, &opt), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 6; i++) {
+        float grad = 0.5f * (float)i - 1.0f;
+        assert_true(fabsf(optimizer_get(&params[0], i) - ((float)(i + 1) - 0.01f * optimizer_sign(grad))) < OPTIMIZER_EPSILON);
+        assert_true(fabsf(optimizer_get(&params[1], i) - (float)(i + 1)) < OPTIMIZER_EPSILON);
+    }
+
+    // zeroing the gradients keeps them allocated
+    assert_int_equal(cgrad_optimizer_zero_grad(opt), CGRAD_SUCCESS);
+    float value = -1.0f;
+    cgrad_storage_get(cgrad_tensor_get_grad_storage(&params[0]), (uint32_t[]){0, 0}, 2, &value);
+    assert_true(value == 0.0f);
+
+    cgrad_optimizer_free(opt);
+}
+
+// ============================================================================
+// Test: invalid configs are rejected
+// ============================================================================
+
+static void test_optimizer_invalid_config(void **state) {
+    (void) state;
+
+    cgrad_tensor p, g;
+    optimizer_make_param(&p, &g);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer* opt = NULL;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_SGD);
+    assert_int_equal(cgrad_optimizer_create(&config, &p, -1, &opt), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+
+    config.kind = (cgrad_optim_kind)(CGRAD_OPTIM_ADAMW + 1);
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_ADAM);
+    config.accumulation_steps = -1;
+    assert_int_equal(cgrad_optimizer_create(&config, &p, 1, &opt), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+    assert_null(opt);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_optimizer_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_optimizer_sgd, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_sgd_momentum, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_adam, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_adamw, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_clip_grad_norm, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_accumulation, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_skip_without_grad, optimizer_setup_test, optimizer_teardown_test),
+        cmocka_unit_test_setup_teardown(test_optimizer_invalid_config, optimizer_setup_test, optimizer_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_optimizer", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_optimizer_tests();
+}
+#endif
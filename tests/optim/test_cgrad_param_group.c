@@ -0,0 +1,213 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "optim/cgrad_param_group.h"
+#include "optim/cgrad_optimizer.h"
+
+#define PARAM_GROUP_EPSILON 1e-5f
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int param_group_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int param_group_teardown_test(void **state) {
+    (void) state;
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Three parameters of shapes (2, 3), (5) and (4, 1): with padding to 16 elements they
+// start at flat offsets 0, 16 and 32
+static cgrad_param_group* param_group_make(void) {
+    uint32_t shape0[] = {2, 3};
+    uint32_t shape1[] = {5};
+    uint32_t shape2[] = {4, 1};
+    const uint32_t* shapes[] = {shape0, shape1, shape2};
+    int ndims[] = {2, 1, 2};
+
+    cgrad_param_group* group = NULL;
+    assert_int_equal(cgrad_param_group_create(shapes, ndims, 3, "cpu_f32", &group), CGRAD_SUCCESS);
+    return group;
+}
+
+static float param_group_flat_get(cgrad_storage* flat, uint32_t i) {
+    float value = -1.0f;
+    assert_int_equal(cgrad_storage_get(flat, (uint32_t[]){i}, 1, &value), CGRAD_SUCCESS);
+    return value;
+}
+
+// loss = sum(params[0] * c) with c = 2, so the gradient of params[0] is 2 and the other
+// parameters receive no gradient
+static void param_group_backward(cgrad_param_group* group) {
+    cgrad_tensor* params = cgrad_param_group_get_params(group);
+    cgrad_tensor c, prod, loss;
+    uint32_t shape[] = {2, 3};
+    uint8_t mask[] = {1, 1};
+    assert_int_equal(cgrad_tensor_init(&c, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill(&c, 2.0f), CGRAD_SUCCESS);
+    cgrad_tensor_set_requires_grad(&c, 0);
+    assert_int_equal(cgrad_tensor_mul(&params[0], &c, &prod), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_reduce_sum(&prod, mask, 2, &loss), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_backward(&loss), CGRAD_SUCCESS);
+}
+
+// ============================================================================
+// Test: parameters are views into the flat buffer
+// ============================================================================
+
+static void test_param_group_layout(void **state) {
+    (void) state;
+
+    cgrad_param_group* group = param_group_make();
+    assert_int_equal(cgrad_param_group_num_params(group), 3);
+    cgrad_tensor* params = cgrad_param_group_get_params(group);
+    cgrad_storage* flat = cgrad_param_group_get_flat(group);
+    assert_int_equal(flat->backend->storage_get_layout(flat->data)->size, 48);
+
+    assert_int_equal(params[0].layout.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(params[0].layout.shape[TENSOR_DIM - 1], 3);
+    assert_int_equal(params[1].layout.shape[TENSOR_DIM - 1], 5);
+
+    assert_int_equal(cgrad_tensor_fill(&params[0], 1.0f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill(&params[1], 2.0f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill(&params[2], 3.0f), CGRAD_SUCCESS);
+
+    for (uint32_t i = 0; i < 48; i++) {
+        float expected = 0.0f;
+        if (i < 6) expected = 1.0f;
+        else if (i >= 16 && i < 21) expected = 2.0f;
+        else if (i >= 32 && i < 36) expected = 3.0f;
+        assert_true(param_group_flat_get(flat, i) == expected);
+    }
+
+    // writes through the flat storage are visible through the parameters
+    cgrad_storage_fill(flat, 4.0f);
+    float value = 0.0f;
+    assert_int_equal(cgrad_tensor_get(&params[2], (uint32_t[]){3, 0}, 2, &value), CGRAD_SUCCESS);
+    assert_true(value == 4.0f);
+
+    cgrad_param_group_free(group);
+}
+
+// ============================================================================
+// Test: backward accumulates into the flat gradient buffer
+// ============================================================================
+
+static void test_param_group_grad(void **state) {
+    (void) state;
+
+    cgrad_param_group* group = param_group_make();
+    cgrad_tensor* params = cgrad_param_group_get_params(group);
+    cgrad_storage* flat_grad = cgrad_param_group_get_flat_grad(group);
+    cgrad_tensor_fill(&params[0], 1.0f);
+
+    // gradients are attached at creation, before any backward pass
+    assert_non_null(cgrad_tensor_get_grad_storage(&params[2]));
+
+    param_group_backward(group);
+    for (uint32_t i = 0; i < 48; i++) {
+        assert_true(param_group_flat_get(flat_grad, i) == (i < 6 ? 2.0f : 0.0f));
+    }
+
+    // sqrt(6 * 2^2)
+    float norm = 0.0f;
+    assert_int_equal(cgrad_param_group_grad_norm(group, &norm), CGRAD_SUCCESS);
+    assert_true(fabsf(norm - sqrtf(24.0f)) < PARAM_GROUP_EPSILON);
+
+    // a second backward pass accumulates
+    param_group_backward(group);
+    assert_true(param_group_flat_get(flat_grad, 5) == 4.0f);
+
+    assert_int_equal(cgrad_param_group_zero_grad(group), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_param_group_grad_norm(group, &norm), CGRAD_SUCCESS);
+    assert_true(norm == 0.0f);
+
+    cgrad_param_group_free(group);
+}
+
+// ============================================================================
+// Test: optimizer over the flat buffers
+// ============================================================================
+
+static void test_param_group_optimizer(void **state) {
+    (void) state;
+
+    cgrad_param_group* group = param_group_make();
+    cgrad_tensor* params = cgrad_param_group_get_params(group);
+    cgrad_tensor_fill(&params[0], 1.0f);
+    cgrad_tensor_fill(&params[1], 1.0f);
+
+    cgrad_optimizer_config config;
+    cgrad_optimizer_config_init(&config, CGRAD_OPTIM_ADAMW);
+    config.lr = 0.1f;
+    config.weight_decay = 0.5f;
+    cgrad_optimizer* opt = NULL;
+    assert_int_equal(cgrad_optimizer_create_for_group(&config, group, &opt), CGRAD_SUCCESS);
+
+    param_group_backward(group);
+    assert_int_equal(cgrad_optimizer_step(opt), CGRAD_SUCCESS);
+
+    // params[0]: decay and a step of lr against the gradient; params[1]: zero gradient, decay only
+    cgrad_storage* flat = cgrad_param_group_get_flat(group);
+    for (uint32_t i = 0; i < 48; i++) {
+        float expected = 0.0f;
+        if (i < 6) expected = 1.0f * (1.0f - 0.1f * 0.5f) - 0.1f;
+        else if (i >= 16 && i < 21) expected = 1.0f - 0.1f * 0.5f;
+        assert_true(fabsf(param_group_flat_get(flat, i) - expected) < PARAM_GROUP_EPSILON);
+    }
+
+    assert_int_equal(cgrad_optimizer_zero_grad(opt), CGRAD_SUCCESS);
+    assert_true(param_group_flat_get(cgrad_param_group_get_flat_grad(group), 0) == 0.0f);
+
+    cgrad_optimizer_free(opt);
+    cgrad_param_group_free(group);
+}
+
+// ============================================================================
+// Test: a group needs at least one parameter
+// ============================================================================
+
+static void test_param_group_empty(void **state) {
+    (void) state;
+
+    cgrad_param_group* group = NULL;
+    assert_int_equal(cgrad_param_group_create(NULL, NULL, 0, "cpu_f32", &group), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+    assert_null(group);
+}
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+int run_cgrad_param_group_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_param_group_layout, param_group_setup_test, param_group_teardown_test),
+        cmocka_unit_test_setup_teardown(test_param_group_grad, param_group_setup_test, param_group_teardown_test),
+        cmocka_unit_test_setup_teardown(test_param_group_optimizer, param_group_setup_test, param_group_teardown_test),
+        cmocka_unit_test_setup_teardown(test_param_group_empty, param_group_setup_test, param_group_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_param_group", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_param_group_tests();
+}
+#endif
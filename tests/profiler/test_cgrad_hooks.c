@@ -0,0 +1,234 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "storage/cgrad_storage.h"
+#include "profiler/cgrad_hooks.h"
+#include "../support/cgrad_alloc_counter.h"
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int hooks_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int hooks_teardown_test(void **state) {
+    (void) state;
+    cgrad_hooks_clear();
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+#define HOOKS_TEST_MAX_EVENTS 64
+
+typedef struct hooks_test_log {
+    int num_events;
+    cgrad_hook_kind kinds[HOOKS_TEST_MAX_EVENTS];
+    cgrad_hook_stage stages[HOOKS_TEST_MAX_EVENTS];
+    const char* names[HOOKS_TEST_MAX_EVENTS];
+    int num_inputs[HOOKS_TEST_MAX_EVENTS];
+    uint64_t bytes[HOOKS_TEST_MAX_EVENTS];
+    cgrad_status status[HOOKS_TEST_MAX_EVENTS];
+} hooks_test_log;
+
+static void hooks_test_record(const cgrad_hook_event* event, void* user_data) {
+    hooks_test_log* log = (hooks_test_log*)user_data;
+    if (log->num_events == HOOKS_TEST_MAX_EVENTS) return;
+    int i = log->num_events++;
+    log->kinds[i] = event->kind;
+    log->stages[i] = event->stage;
+    log->names[i] = event->descriptor ? event->descriptor->name : NULL;
+    log->num_inputs[i] = event->num_inputs;
+    log->bytes[i] = event->bytes;
+    log->status[i] = event->status;
+}
+
+static int hooks_test_count(const hooks_test_log* log, cgrad_hook_kind kind, cgrad_hook_stage stage) {
+    int n = 0;
+    for (int i = 0; i < log->num_events; i++) n += log->kinds[i] == kind && log->stages[i] == stage;
+    return n;
+}
+
+// Unregisters its own subscriber on the first event
+typedef struct hooks_test_once {
+    cgrad_hook* hook;
+    int num_events;
+} hooks_test_once;
+
+static void hooks_test_unregister_self(const cgrad_hook_event* event, void* user_data) {
+    (void) event;
+    hooks_test_once* once = (hooks_test_once*)user_data;
+    once->num_events++;
+    assert_int_equal(cgrad_hooks_unregister(once->hook), CGRAD_SUCCESS);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void test_hooks_op_events(void **state) {
+    (void) state;
+    hooks_test_log log = {0};
+    unsigned kinds = CGRAD_HOOK_MASK(CGRAD_HOOK_OP_FORWARD) | CGRAD_HOOK_MASK(CGRAD_HOOK_OP_BACKWARD);
+    assert_int_equal(cgrad_hooks_register(kinds, hooks_test_record, &log, NULL), CGRAD_SUCCESS);
+
+    cgrad_tensor a, b, c;
+    uint32_t shape[] = {2, 3};
+    assert_int_equal(cgrad_tensor_init(&a, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_init(&b, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_add(&a, &b, &c), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_execute(&c), CGRAD_SUCCESS);
+
+    // PRE and POST around the forward pass of the single op
+    assert_int_equal(log.num_events, 2);
+    assert_int_equal(log.kinds[0], CGRAD_HOOK_OP_FORWARD);
+    assert_int_equal(log.stages[0], CGRAD_HOOK_PRE);
+    assert_int_equal(log.stages[1], CGRAD_HOOK_POST);
+    assert_string_equal(log.names[1], "AXPY");
+    assert_int_equal(log.num_inputs[1], 2);
+    assert_int_equal(log.status[1], CGRAD_SUCCESS);
+
+    assert_int_equal(cgrad_tensor_backward(&c), CGRAD_SUCCESS);
+    assert_int_equal(hooks_test_count(&log, CGRAD_HOOK_OP_BACKWARD, CGRAD_HOOK_PRE), 1);
+    assert_int_equal(hooks_test_count(&log, CGRAD_HOOK_OP_BACKWARD, CGRAD_HOOK_POST), 1);
+    assert_int_equal(hooks_test_count(&log, CGRAD_HOOK_STORAGE_ALLOC, CGRAD_HOOK_PRE), 0);
+}
+
+static void test_hooks_storage_events(void **state) {
+    (void) state;
+    hooks_test_log log = {0};
+    unsigned kinds = CGRAD_HOOK_MASK(CGRAD_HOOK_STORAGE_ALLOC) | CGRAD_HOOK_MASK(CGRAD_HOOK_STORAGE_FREE);
+    assert_int_equal(cgrad_hooks_register(kinds, hooks_test_record, &log, NULL), CGRAD_SUCCESS);
+
+    cgrad_storage s, view;
+    uint32_t shape[] = {4, 5};
+    assert_int_equal(cgrad_storage_init(&s, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(log.num_events, 2);
+    assert_int_equal(log.kinds[0], CGRAD_HOOK_STORAGE_ALLOC);
+    assert_int_equal(log.bytes[0], 20 * sizeof(float));
+    assert_int_equal(log.stages[1], CGRAD_HOOK_POST);
+
+    // the data is only released with its last view
+    assert_int_equal(cgrad_storage_shallow_copy(&s, &view), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&view), CGRAD_SUCCESS);
+    assert_int_equal(log.num_events, 4);
+    assert_int_equal(log.kinds[3], CGRAD_HOOK_STORAGE_FREE);
+    assert_int_equal(log.bytes[3], 0);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(log.num_events, 6);
+    assert_int_equal(log.stages[5], CGRAD_HOOK_POST);
+    assert_int_equal(log.bytes[5], 20 * sizeof(float));
+
+    // wrapped memory is reported with the same bytes on wrap and on the free of its last view
+    cgrad_storage_layout layout;
+    assert_int_equal(cgrad_storage_layout_init(&layout, shape, 2), CGRAD_SUCCESS);
+    float* data = (float*)calloc(20, sizeof(float));
+    assert_non_null(data);
+    assert_int_equal(cgrad_storage_wrap(&s, &layout, data, free, data, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(log.num_events, 8);
+    assert_int_equal(log.kinds[6], CGRAD_HOOK_STORAGE_ALLOC);
+    assert_int_equal(log.bytes[6], 20 * sizeof(float));
+    assert_int_equal(log.stages[7], CGRAD_HOOK_POST);
+    assert_int_equal(log.status[7], CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(log.num_events, 10);
+    assert_int_equal(log.kinds[9], CGRAD_HOOK_STORAGE_FREE);
+    assert_int_equal(log.bytes[9], 20 * sizeof(float));
+}
+
+static void test_hooks_unregister(void **state) {
+    (void) state;
+    hooks_test_log first = {0}, second = {0};
+    cgrad_hook* hook = NULL;
+    unsigned kinds = CGRAD_HOOK_MASK(CGRAD_HOOK_STORAGE_ALLOC);
+    assert_int_equal(cgrad_hooks_register(kinds, hooks_test_record, &first, &hook), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_hooks_register(kinds, hooks_test_record, &second, NULL), CGRAD_SUCCESS);
+
+    cgrad_storage s;
+    uint32_t shape[] = {3};
+    assert_int_equal(cgrad_storage_init(&s, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(first.num_events, 2);
+    assert_int_equal(second.num_events, 2);
+
+    assert_int_equal(cgrad_hooks_unregister(hook), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&s, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(first.num_events, 2);
+    assert_int_equal(second.num_events, 4);
+
+    // nothing is dispatched once all subscribers are gone
+    cgrad_hooks_clear();
+    assert_int_equal(cgrad_storage_init(&s, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(second.num_events, 4);
+
+    assert_int_equal(cgrad_hooks_register(0, hooks_test_record, &first, NULL), CGRAD_ERR_PROFILER_INVALID_HOOK);
+    assert_int_equal(cgrad_hooks_register(kinds, NULL, &first, NULL), CGRAD_ERR_NULL_POINTER);
+}
+
+static void test_hooks_unregister_reclaims(void **state) {
+    (void) state;
+    if (!cgrad_alloc_counter_is_available()) skip();
+    unsigned kinds = CGRAD_HOOK_MASK(CGRAD_HOOK_STORAGE_ALLOC);
+    cgrad_storage s;
+    uint32_t shape[] = {3};
+
+    // a subscriber registered and unregistered around every step is freed again every step
+    hooks_test_log log = {0};
+    cgrad_alloc_counter_start();
+    for (int step = 0; step < 100; step++) {
+        cgrad_hook* hook = NULL;
+        assert_int_equal(cgrad_hooks_register(kinds, hooks_test_record, &log, &hook), CGRAD_SUCCESS);
+        assert_int_equal(cgrad_storage_init(&s, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+        assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+        assert_int_equal(cgrad_hooks_unregister(hook), CGRAD_SUCCESS);
+    }
+    cgrad_alloc_counter_stop();
+    assert_int_equal(log.num_events, HOOKS_TEST_MAX_EVENTS);
+    assert_int_equal(cgrad_alloc_counter_frees(), cgrad_alloc_counter_allocs());
+
+    // unregistering during a dispatch defers the free to the next register or unregister
+    hooks_test_once once = {0};
+    cgrad_hook* other = NULL;
+    cgrad_alloc_counter_start();
+    assert_int_equal(cgrad_hooks_register(kinds, hooks_test_unregister_self, &once, &once.hook), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&s, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_hooks_register(kinds, hooks_test_record, &log, &other), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_hooks_unregister(other), CGRAD_SUCCESS);
+    cgrad_alloc_counter_stop();
+    assert_int_equal(once.num_events, 1);
+    assert_int_equal(cgrad_alloc_counter_frees(), cgrad_alloc_counter_allocs());
+}
+
+int run_cgrad_hooks_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_hooks_op_events, hooks_setup_test, hooks_teardown_test),
+        cmocka_unit_test_setup_teardown(test_hooks_storage_events, hooks_setup_test, hooks_teardown_test),
+        cmocka_unit_test_setup_teardown(test_hooks_unregister, hooks_setup_test, hooks_teardown_test),
+        cmocka_unit_test_setup_teardown(test_hooks_unregister_reclaims, hooks_setup_test, hooks_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_hooks", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_hooks_tests();
+}
+#endif
@@ -0,0 +1,209 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "storage/cgrad_storage.h"
+#include "optim/cgrad_param_group.h"
+#include "profiler/cgrad_memory.h"
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int memory_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int memory_teardown_test(void **state) {
+    (void) state;
+    cgrad_memory_reset();
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void test_memory_backend_stats(void **state) {
+    (void) state;
+    cgrad_storage s, t, view;
+    uint32_t shape[] = {2, 3};
+    cgrad_memory_snapshot snapshot;
+
+    // allocations before start are not accounted, also when freed
+    assert_int_equal(cgrad_storage_init(&t, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_is_enabled(), 0);
+    assert_int_equal(cgrad_memory_start(), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_is_enabled(), 1);
+    assert_int_equal(cgrad_storage_free(&t), CGRAD_SUCCESS);
+
+    assert_int_equal(cgrad_storage_init(&s, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&t, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.num_backends, 1);
+    assert_string_equal(snapshot.backend_names[0], "cpu_f32");
+    assert_int_equal(snapshot.backends[0].live_bytes, 48);
+    assert_int_equal(snapshot.backends[0].live_buffers, 2);
+    assert_int_equal(snapshot.backends[0].category_bytes[CGRAD_MEMORY_OTHER], 48);
+    assert_int_equal(snapshot.backends[0].num_frees, 0);
+
+    // views keep the buffer alive
+    assert_int_equal(cgrad_storage_shallow_copy(&s, &view), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.live_bytes, 48);
+
+    assert_int_equal(cgrad_storage_free(&view), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&t), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.live_bytes, 0);
+    assert_int_equal(snapshot.total.peak_bytes, 48);
+    assert_int_equal(snapshot.total.num_allocs, 2);
+    assert_int_equal(snapshot.total.num_frees, 2);
+}
+
+static void test_memory_graph_attribution(void **state) {
+    (void) state;
+    cgrad_tensor a, b, c;
+    uint32_t shape[] = {2, 3};
+    cgrad_memory_snapshot snapshot;
+
+    assert_int_equal(cgrad_memory_start(), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_init(&a, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_init(&b, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_add(&a, &b, &c), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_execute(&c), CGRAD_SUCCESS);
+
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.category_bytes[CGRAD_MEMORY_OTHER], 48);
+    assert_int_equal(snapshot.total.category_bytes[CGRAD_MEMORY_ACTIVATION], 24);
+
+    // gradients of the output and both inputs
+    assert_int_equal(cgrad_tensor_backward(&c), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.category_bytes[CGRAD_MEMORY_GRADIENT], 72);
+
+    // the activation is attributed to its node and graph
+    cgrad_memory_buffer buffers[16];
+    int n = 0;
+    assert_int_equal(cgrad_memory_get_top_buffers(buffers, 16, &n), CGRAD_SUCCESS);
+    const cgrad_memory_buffer* activation = NULL;
+    for (int i = 0; i < n; i++) {
+        if (buffers[i].category == CGRAD_MEMORY_ACTIVATION) activation = &buffers[i];
+    }
+    assert_non_null(activation);
+    assert_int_equal(activation->has_node, 1);
+    assert_int_equal(uuid_compare(activation->node_id, c.node_id), 0);
+
+    cgrad_memory_stats graph_stats;
+    assert_int_equal(cgrad_memory_get_graph_stats(activation->graph_id, &graph_stats), CGRAD_SUCCESS);
+    assert_int_equal(graph_stats.category_bytes[CGRAD_MEMORY_ACTIVATION], 24);
+    assert_int_equal(graph_stats.category_bytes[CGRAD_MEMORY_GRADIENT], 72);
+    assert_int_equal(graph_stats.category_bytes[CGRAD_MEMORY_OTHER], 0);
+
+    assert_int_equal(cgrad_tensor_free(&c), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_free(&a), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_free(&b), CGRAD_SUCCESS);
+}
+
+static void test_memory_top_buffers(void **state) {
+    (void) state;
+    cgrad_storage small, large, medium;
+    uint32_t small_shape[] = {4};
+    uint32_t large_shape[] = {100, 100};
+    uint32_t medium_shape[] = {10, 10};
+
+    assert_int_equal(cgrad_memory_start(), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&small, small_shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&large, large_shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&medium, medium_shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+
+    cgrad_memory_buffer buffers[2];
+    int n = 0;
+    assert_int_equal(cgrad_memory_get_top_buffers(buffers, 2, &n), CGRAD_SUCCESS);
+    assert_int_equal(n, 2);
+    assert_int_equal(buffers[0].bytes, 40000);
+    assert_int_equal(uuid_compare(buffers[0].storage_id, large.uuid), 0);
+    assert_int_equal(buffers[0].shape[TENSOR_DIM - 2], 100);
+    assert_int_equal(buffers[0].has_node, 0);
+    assert_int_equal(buffers[1].bytes, 400);
+
+    assert_int_equal(cgrad_storage_free(&large), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_top_buffers(buffers, 2, &n), CGRAD_SUCCESS);
+    assert_int_equal(buffers[0].bytes, 400);
+    assert_int_equal(buffers[1].bytes, 16);
+
+    assert_int_equal(cgrad_storage_free(&small), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&medium), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_top_buffers(buffers, 2, &n), CGRAD_SUCCESS);
+    assert_int_equal(n, 0);
+}
+
+static void test_memory_wrapped_buffers(void **state) {
+    (void) state;
+    cgrad_storage s, view;
+    uint32_t shape[] = {8, 8};
+    cgrad_storage_layout layout;
+    cgrad_memory_snapshot snapshot;
+
+    assert_int_equal(cgrad_memory_start(), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_layout_init(&layout, shape, 2), CGRAD_SUCCESS);
+    float* data = (float*)calloc(64, sizeof(float));
+    assert_non_null(data);
+    assert_int_equal(cgrad_storage_wrap(&s, &layout, data, free, data, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_shallow_copy(&s, &view), CGRAD_SUCCESS);
+
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.live_bytes, 256);
+    assert_int_equal(snapshot.total.category_bytes[CGRAD_MEMORY_EXTERNAL], 256);
+    cgrad_memory_buffer buffers[1];
+    int n = 0;
+    assert_int_equal(cgrad_memory_get_top_buffers(buffers, 1, &n), CGRAD_SUCCESS);
+    assert_int_equal(n, 1);
+    assert_int_equal(buffers[0].category, CGRAD_MEMORY_EXTERNAL);
+    assert_int_equal(uuid_compare(buffers[0].storage_id, s.uuid), 0);
+
+    assert_int_equal(cgrad_storage_free(&s), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_free(&view), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.live_bytes, 0);
+    assert_int_equal(snapshot.total.peak_bytes, 256);
+
+    // the flat value and gradient buffers of a parameter group
+    uint32_t param_shape[] = {4, 16};
+    const uint32_t* shapes[] = {param_shape};
+    int ndims[] = {2};
+    cgrad_param_group* group = NULL;
+    assert_int_equal(cgrad_param_group_create(shapes, ndims, 1, "cpu_f32", &group), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.category_bytes[CGRAD_MEMORY_EXTERNAL], 2 * 64 * sizeof(float));
+    cgrad_param_group_free(group);
+    assert_int_equal(cgrad_memory_get_snapshot(&snapshot), CGRAD_SUCCESS);
+    assert_int_equal(snapshot.total.live_bytes, 0);
+}
+
+int run_cgrad_memory_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_memory_backend_stats, memory_setup_test, memory_teardown_test),
+        cmocka_unit_test_setup_teardown(test_memory_graph_attribution, memory_setup_test, memory_teardown_test),
+        cmocka_unit_test_setup_teardown(test_memory_top_buffers, memory_setup_test, memory_teardown_test),
+        cmocka_unit_test_setup_teardown(test_memory_wrapped_buffers, memory_setup_test, memory_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_memory", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_memory_tests();
+}
+#endif
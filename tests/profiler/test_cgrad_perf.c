@@ -0,0 +1,164 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "profiler/cgrad_perf.h"
+#include "profiler/cgrad_profiler.h"
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int perf_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int perf_teardown_test(void **state) {
+    (void) state;
+    cgrad_perf_close();
+    cgrad_profiler_reset();
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void test_perf_counter_names(void **state) {
+    (void) state;
+    assert_string_equal(cgrad_perf_counter_name(CGRAD_PERF_CYCLES), "cycles");
+    assert_string_equal(cgrad_perf_counter_name(CGRAD_PERF_CACHE_MISSES), "cache_misses");
+    assert_string_equal(cgrad_perf_counter_name(CGRAD_PERF_TASK_CLOCK_NS), "task_clock_ns");
+    assert_string_equal(cgrad_perf_counter_name(CGRAD_PERF_NUM_COUNTERS), "unknown");
+}
+
+static void test_perf_read(void **state) {
+    (void) state;
+    cgrad_perf_counts counts;
+    assert_int_equal(cgrad_perf_is_open(), 0);
+    assert_int_equal(cgrad_perf_read(&counts), CGRAD_ERR_PROFILER_PERF_UNAVAILABLE);
+    assert_int_equal(counts.available, 0);
+    assert_int_equal(cgrad_perf_read(NULL), CGRAD_ERR_NULL_POINTER);
+
+    cgrad_status err = cgrad_perf_open(0);
+    if (err == CGRAD_ERR_PROFILER_PERF_UNAVAILABLE) skip();
+    assert_int_equal(err, CGRAD_SUCCESS);
+    assert_int_equal(cgrad_perf_is_open(), 1);
+
+    cgrad_perf_counts start, end, delta;
+    assert_int_equal(cgrad_perf_read(&start), CGRAD_SUCCESS);
+    assert_true(start.available != 0);
+    // vector events were not requested
+    assert_false(start.available & (1u << CGRAD_PERF_FP_SCALAR));
+    assert_false(start.available & (1u << CGRAD_PERF_FP_PACKED));
+
+    volatile float acc = 0.0f;
+    for (int i = 0; i < 1000000; i++) acc += (float)i;
+    assert_int_equal(cgrad_perf_read(&end), CGRAD_SUCCESS);
+    cgrad_perf_diff(&start, &end, &delta);
+    assert_int_equal(delta.available, start.available & end.available);
+    if (delta.available & (1u << CGRAD_PERF_TASK_CLOCK_NS)) {
+        assert_true(delta.values[CGRAD_PERF_TASK_CLOCK_NS] > 0);
+    }
+    if (delta.available & (1u << CGRAD_PERF_INSTRUCTIONS)) {
+        assert_true(delta.values[CGRAD_PERF_INSTRUCTIONS] >= 1000000);
+    }
+
+    cgrad_perf_close();
+    assert_int_equal(cgrad_perf_is_open(), 0);
+}
+
+static void test_perf_profiler_events(void **state) {
+    (void) state;
+    cgrad_status err = cgrad_perf_open(0);
+    if (err == CGRAD_ERR_PROFILER_PERF_UNAVAILABLE) skip();
+    assert_int_equal(err, CGRAD_SUCCESS);
+
+    cgrad_tensor x, y;
+    uint32_t shape[] = {64, 64};
+    assert_int_equal(cgrad_tensor_init(&x, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill(&x, 1.0f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_profiler_start(), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_gemm(&x, &x, &y), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_execute(&y), CGRAD_SUCCESS);
+    cgrad_profiler_stop();
+
+    int n = 0;
+    const cgrad_profiler_event* events = cgrad_profiler_get_events(&n);
+    assert_true(n > 0);
+    for (int i = 0; i < n; i++) {
+        assert_true(events[i].perf.available != 0);
+    }
+}
+
+// Busy thread started before the counters are opened
+typedef struct perf_test_spinner {
+    int go;
+    volatile float acc;
+} perf_test_spinner;
+
+static void* perf_test_spin(void* arg) {
+    perf_test_spinner* spinner = (perf_test_spinner*)arg;
+    while (!__atomic_load_n(&spinner->go, __ATOMIC_ACQUIRE)) {
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+    }
+    for (int i = 0; i < 50000000; i++) spinner->acc += (float)i;
+    return NULL;
+}
+
+static void test_perf_existing_threads(void **state) {
+    (void) state;
+    perf_test_spinner spinner = {0, 0.0f};
+    pthread_t thread;
+    assert_int_equal(pthread_create(&thread, NULL, perf_test_spin, &spinner), 0);
+
+    cgrad_status err = cgrad_perf_open(0);
+    if (err == CGRAD_ERR_PROFILER_PERF_UNAVAILABLE) {
+        __atomic_store_n(&spinner.go, 1, __ATOMIC_RELEASE);
+        pthread_join(thread, NULL);
+        skip();
+    }
+    assert_int_equal(err, CGRAD_SUCCESS);
+
+    // the calling thread only waits: the counted work is the spinner's
+    cgrad_perf_counts start, end, delta;
+    assert_int_equal(cgrad_perf_read(&start), CGRAD_SUCCESS);
+    __atomic_store_n(&spinner.go, 1, __ATOMIC_RELEASE);
+    pthread_join(thread, NULL);
+    assert_int_equal(cgrad_perf_read(&end), CGRAD_SUCCESS);
+    cgrad_perf_diff(&start, &end, &delta);
+    if (delta.available & (1u << CGRAD_PERF_INSTRUCTIONS)) {
+        assert_true(delta.values[CGRAD_PERF_INSTRUCTIONS] >= 50000000);
+    }
+    if (delta.available & (1u << CGRAD_PERF_TASK_CLOCK_NS)) {
+        assert_true(delta.values[CGRAD_PERF_TASK_CLOCK_NS] >= 10000000);
+    }
+}
+
+int run_cgrad_perf_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_perf_counter_names, perf_setup_test, perf_teardown_test),
+        cmocka_unit_test_setup_teardown(test_perf_read, perf_setup_test, perf_teardown_test),
+        cmocka_unit_test_setup_teardown(test_perf_profiler_events, perf_setup_test, perf_teardown_test),
+        cmocka_unit_test_setup_teardown(test_perf_existing_threads, perf_setup_test, perf_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_perf", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_perf_tests();
+}
+#endif
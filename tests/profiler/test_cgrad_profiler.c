@@ -0,0 +1,166 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cgrad.h"
+#include "cgrad_status.h"
+#include "autograd/cgrad_tensor.h"
+#include "profiler/cgrad_profiler.h"
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static int profiler_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    return 0;
+}
+
+static int profiler_teardown_test(void **state) {
+    (void) state;
+    cgrad_profiler_reset();
+    cgrad_cleanup();
+    return 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// loss = sum(relu(x @ w)) with x (2, 3) and w (3, 4)
+static void profiler_run_step(cgrad_tensor* x, cgrad_tensor* w, cgrad_tensor* h, cgrad_tensor* r, cgrad_tensor* loss) {
+    uint32_t x_shape[] = {2, 3};
+    uint32_t w_shape[] = {3, 4};
+    uint8_t mask[] = {1, 1};
+    assert_int_equal(cgrad_tensor_init(x, x_shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_init(w, w_shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill(x, 1.0f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_fill(w, 0.5f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_gemm(x, w, h), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_relu(h, r), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_reduce_sum(r, mask, 2, loss), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_execute(loss), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_tensor_backward(loss), CGRAD_SUCCESS);
+}
+
+static const cgrad_profiler_event* profiler_find(const char* name, cgrad_profiler_phase phase) {
+    int n = 0;
+    const cgrad_profiler_event* events = cgrad_profiler_get_events(&n);
+    for (int i = 0; i < n; i++) {
+        if (strcmp(events[i].name, name) == 0 && events[i].phase == phase) return &events[i];
+    }
+    return NULL;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void test_profiler_disabled(void **state) {
+    (void) state;
+    cgrad_tensor x, w, h, r, loss;
+
+    assert_int_equal(cgrad_profiler_is_enabled(), 0);
+    profiler_run_step(&x, &w, &h, &r, &loss);
+
+    int n = -1;
+    assert_null(cgrad_profiler_get_events(&n));
+    assert_int_equal(n, 0);
+}
+
+static void test_profiler_events(void **state) {
+    (void) state;
+    cgrad_tensor x, w, h, r, loss;
+
+    assert_int_equal(cgrad_profiler_start(), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_profiler_is_enabled(), 1);
+    profiler_run_step(&x, &w, &h, &r, &loss);
+    cgrad_profiler_stop();
+
+    // one forward and one backward event per op node
+    int n = 0;
+    assert_non_null(cgrad_profiler_get_events(&n));
+    assert_int_equal(n, 6);
+
+    const cgrad_profiler_event* gemm = profiler_find("GEMM", CGRAD_PROFILER_FORWARD);
+    assert_non_null(gemm);
+    assert_int_equal(gemm->num_inputs, 2);
+    assert_int_equal(gemm->input_shapes[0][TENSOR_DIM - 2], 2);
+    assert_int_equal(gemm->input_shapes[0][TENSOR_DIM - 1], 3);
+    assert_int_equal(gemm->input_shapes[1][TENSOR_DIM - 1], 4);
+    assert_int_equal(gemm->output_shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(gemm->output_shape[TENSOR_DIM - 1], 4);
+    assert_int_equal(gemm->flops, 2 * 2 * 3 * 4);
+    assert_int_equal(gemm->bytes_moved, (6 + 12 + 8) * sizeof(float));
+    assert_true(gemm->bytes_allocated >= 8 * sizeof(float));
+
+    const cgrad_profiler_event* gemm_backward = profiler_find("GEMM", CGRAD_PROFILER_BACKWARD);
+    assert_non_null(gemm_backward);
+    assert_int_equal(gemm_backward->flops, 2 * gemm->flops);
+    assert_true(gemm_backward->start_ns >= gemm->start_ns + gemm->duration_ns);
+
+    const cgrad_profiler_event* reduce = profiler_find("REDUCE_SUM", CGRAD_PROFILER_FORWARD);
+    assert_non_null(reduce);
+    assert_int_equal(reduce->flops, 8);
+    assert_non_null(profiler_find("RELU", CGRAD_PROFILER_BACKWARD));
+
+    // nothing is recorded after stop, and start discards the previous events
+    assert_int_equal(cgrad_profiler_is_enabled(), 0);
+    assert_int_equal(cgrad_tensor_backward(&loss), CGRAD_SUCCESS);
+    cgrad_profiler_get_events(&n);
+    assert_int_equal(n, 6);
+    assert_int_equal(cgrad_profiler_start(), CGRAD_SUCCESS);
+    cgrad_profiler_get_events(&n);
+    assert_int_equal(n, 0);
+}
+
+static void test_profiler_chrome_trace(void **state) {
+    (void) state;
+    cgrad_tensor x, w, h, r, loss;
+
+    assert_int_equal(cgrad_profiler_start(), CGRAD_SUCCESS);
+    profiler_run_step(&x, &w, &h, &r, &loss);
+    cgrad_profiler_stop();
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cgrad_test_profiler_%d.json", (int)getpid());
+    assert_int_equal(cgrad_profiler_write_chrome_trace(path), CGRAD_SUCCESS);
+
+    FILE* f = fopen(path, "r");
+    assert_non_null(f);
+    char buffer[8192];
+    size_t size = fread(buffer, 1, sizeof(buffer) - 1, f);
+    buffer[size] = '\0';
+    fclose(f);
+    unlink(path);
+
+    assert_int_equal(strncmp(buffer, "{\"traceEvents\":[", 16), 0);
+    assert_non_null(strstr(buffer, "\"name\":\"GEMM\",\"cat\":\"forward\",\"ph\":\"X\""));
+    assert_non_null(strstr(buffer, "\"name\":\"GEMM\",\"cat\":\"backward\",\"ph\":\"X\""));
+    assert_non_null(strstr(buffer, "\"inputs\":[[2,3],[3,4]],\"output\":[2,4],\"flops\":48"));
+    assert_non_null(strstr(buffer, "\"displayTimeUnit\":\"ns\"}"));
+
+    assert_int_equal(cgrad_profiler_write_chrome_trace("/nonexistent/trace.json"), CGRAD_ERR_PROFILER_IO);
+}
+
+int run_cgrad_profiler_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_profiler_disabled, profiler_setup_test, profiler_teardown_test),
+        cmocka_unit_test_setup_teardown(test_profiler_events, profiler_setup_test, profiler_teardown_test),
+        cmocka_unit_test_setup_teardown(test_profiler_chrome_trace, profiler_setup_test, profiler_teardown_test),
+    };
+
+    return cmocka_run_group_tests_name("cgrad_profiler", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_profiler_tests();
+}
+#endif
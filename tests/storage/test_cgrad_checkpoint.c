@@ -0,0 +1,138 @@
+#include <cmocka.h>
+#include "cgrad.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_file.h"
+#include "storage/cgrad_checkpoint.h"
+#include "cgrad_status.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static char checkpoint_path[64];
+
+static int checkpoint_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    strcpy(checkpoint_path, "/tmp/cgrad_test_checkpoint_XXXXXX");
+    int fd = mkstemp(checkpoint_path);
+    if (fd < 0) return -1;
+    close(fd);
+    return 0;
+}
+
+static int checkpoint_teardown_test(void **state) {
+    (void) state;
+    unlink(checkpoint_path);
+    cgrad_cleanup();
+    return 0;
+}
+
+static float checkpoint_get(const cgrad_storage* t, uint32_t i, uint32_t j) {
+    uint32_t idx[2] = {i, j};
+    float value = -1.0f;
+    assert_int_equal(cgrad_storage_get(t, idx, 2, &value), CGRAD_SUCCESS);
+    return value;
+}
+
+static void test_cgrad_checkpoint_save_async(void **state) {
+    (void) state;
+    uint32_t shape_w[2] = {64, 128};
+    uint32_t shape_b[2] = {1, 128};
+    cgrad_storage w, b;
+    assert_int_equal(cgrad_storage_init(&w, shape_w, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&b, shape_b, 2, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill(&w, 1.5f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill(&b, -2.0f), CGRAD_SUCCESS);
+
+    const char* names[2] = {"w", "b"};
+    const cgrad_storage* storages[2] = {&w, &b};
+    cgrad_checkpoint* ckpt = NULL;
+    assert_int_equal(cgrad_checkpoint_save_async(checkpoint_path, names, storages, 2, &ckpt), CGRAD_SUCCESS);
+    assert_non_null(ckpt);
+
+    // the storages can be updated right away, the checkpoint holds the snapshot
+    assert_int_equal(cgrad_storage_fill(&w, 7.0f), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_fill(&b, 7.0f), CGRAD_SUCCESS);
+
+    cgrad_checkpoint_stats stats;
+    assert_int_equal(cgrad_checkpoint_wait(ckpt, &stats), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_checkpoint_is_done(ckpt), 1);
+    assert_int_equal(cgrad_checkpoint_wait(ckpt, NULL), CGRAD_SUCCESS);
+    assert_int_equal(stats.durable, 1);
+    assert_true(stats.bytes > (64 + 1) * 128 * sizeof(float));
+    assert_true(stats.snapshot_seconds >= 0.0);
+    assert_true(stats.throughput > 0.0);
+    cgrad_checkpoint_free(ckpt);
+
+    // the file matches a synchronous save of the snapshot
+    uint64_t size;
+    assert_int_equal(cgrad_storage_serialized_size(names, storages, 2, &size), CGRAD_SUCCESS);
+    assert_int_equal(size, stats.bytes);
+
+    cgrad_storage_file* file = NULL;
+    assert_int_equal(cgrad_storage_file_open(checkpoint_path, &file), CGRAD_SUCCESS);
+    cgrad_storage w_loaded, b_loaded;
+    assert_int_equal(cgrad_storage_load_mmap(file, "w", &w_loaded), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_load_mmap(file, "b", &b_loaded), CGRAD_SUCCESS);
+    cgrad_storage_file_close(file);
+    assert_float_equal(checkpoint_get(&w_loaded, 0, 0), 1.5f, 1e-6);
+    assert_float_equal(checkpoint_get(&w_loaded, 63, 127), 1.5f, 1e-6);
+    assert_float_equal(checkpoint_get(&b_loaded, 0, 17), -2.0f, 1e-6);
+
+    cgrad_storage_free(&b_loaded);
+    cgrad_storage_free(&w_loaded);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&w);
+}
+
+static void test_cgrad_checkpoint_errors(void **state) {
+    (void) state;
+    uint32_t shape[2] = {2, 2};
+    cgrad_storage a;
+    assert_int_equal(cgrad_storage_init(&a, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    const cgrad_storage* storages[2] = {&a, &a};
+
+    // invalid names are rejected before anything is written
+    const char* duplicate[2] = {"x", "x"};
+    cgrad_checkpoint* ckpt = NULL;
+    assert_int_equal(cgrad_checkpoint_save_async(checkpoint_path, duplicate, storages, 2, &ckpt), CGRAD_ERR_STORAGE_FILE_INVALID);
+    assert_null(ckpt);
+
+    // write errors are reported on completion
+    const char* names[1] = {"x"};
+    assert_int_equal(cgrad_checkpoint_save_async("/nonexistent/cgrad.ckpt", names, storages, 1, &ckpt), CGRAD_SUCCESS);
+    cgrad_checkpoint_stats stats;
+    assert_int_equal(cgrad_checkpoint_wait(ckpt, &stats), CGRAD_ERR_STORAGE_FILE_IO);
+    assert_int_equal(stats.durable, 0);
+    cgrad_checkpoint_free(ckpt);
+
+    // the handle can be released without waiting
+    assert_int_equal(cgrad_checkpoint_save_async(checkpoint_path, names, storages, 1, &ckpt), CGRAD_SUCCESS);
+    cgrad_checkpoint_free(ckpt);
+    cgrad_storage_file* file = NULL;
+    assert_int_equal(cgrad_storage_file_open(checkpoint_path, &file), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_file_num_tensors(file), 1);
+    cgrad_storage_file_close(file);
+
+    cgrad_storage_free(&a);
+}
+
+int run_cgrad_checkpoint_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_cgrad_checkpoint_save_async, checkpoint_setup_test, checkpoint_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_checkpoint_errors, checkpoint_setup_test, checkpoint_teardown_test),
+    };
+    return cmocka_run_group_tests_name("cgrad_checkpoint", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_checkpoint_tests();
+}
+#endif
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 // ============================================================================
 // Setup and Teardown
@@ -258,16 +259,111 @@ static void test_cgrad_storage_reduce(void **state) {
     cgrad_storage_free(&t);
 }
 
+static void test_cgrad_storage_sum_squares(void **state) {
+    (void)state;
+    // sizes span several reduction blocks and do not divide evenly into them
+    uint32_t sizes[3] = {1000, 300001, 7};
+    float values[3] = {1.0f, 0.5f, -2.0f};
+    cgrad_storage ts[3];
+    const cgrad_storage* ptrs[3];
+    double expected = 0.0;
+    for (int i = 0; i < 3; i++) {
+        assert_int_equal(cgrad_storage_init(&ts[i], &sizes[i], 1, "cpu_f32"), CGRAD_SUCCESS);
+        assert_int_equal(cgrad_storage_fill(&ts[i], values[i]), CGRAD_SUCCESS);
+        ptrs[i] = &ts[i];
+        expected += (double)sizes[i] * values[i] * values[i];
+    }
+
+    double sum = 0.0;
+    assert_int_equal(cgrad_storage_sum_squares(3, ptrs, &sum), CGRAD_SUCCESS);
+    assert_true(fabs(sum - expected) < 1e-6 * expected);
+
+    assert_int_equal(cgrad_storage_sum_squares(0, ptrs, &sum), CGRAD_SUCCESS);
+    assert_true(sum == 0.0);
+
+    for (int i = 0; i < 3; i++) cgrad_storage_free(&ts[i]);
+}
+
+static void test_cgrad_storage_clip_grad_norm(void **state) {
+    (void)state;
+    // global norm of {3, 3, 3, 3} and {4, 4, 4, 4} is sqrt(4 * 9 + 4 * 16) = 10
+    uint32_t shape[1] = {4};
+    cgrad_storage a, b;
+    assert_int_equal(cgrad_storage_init(&a, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_init(&b, shape, 1, "cpu_f32"), CGRAD_SUCCESS);
+    cgrad_storage_fill(&a, 3.0f);
+    cgrad_storage_fill(&b, 4.0f);
+    cgrad_storage* grads[2] = {&a, &b};
+
+    // below the threshold nothing changes
+    float norm = 0.0f;
+    assert_int_equal(cgrad_storage_clip_grad_norm(2, grads, 20.0f, &norm), CGRAD_SUCCESS);
+    assert_float_equal(norm, 10.0f, 1e-5);
+    float v = 0.0f;
+    cgrad_storage_get(&a, (uint32_t[]){0}, 1, &v);
+    assert_float_equal(v, 3.0f, 1e-6);
+
+    // above it all storages are scaled by the same factor
+    assert_int_equal(cgrad_storage_clip_grad_norm(2, grads, 5.0f, &norm), CGRAD_SUCCESS);
+    assert_float_equal(norm, 10.0f, 1e-5);
+    cgrad_storage_get(&a, (uint32_t[]){3}, 1, &v);
+    assert_float_equal(v, 1.5f, 1e-5);
+    cgrad_storage_get(&b, (uint32_t[]){3}, 1, &v);
+    assert_float_equal(v, 2.0f, 1e-5);
+
+    // the threshold must be positive; rejected calls leave the gradients untouched
+    assert_int_equal(cgrad_storage_clip_grad_norm(2, grads, 0.0f, &norm), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+    assert_int_equal(cgrad_storage_clip_grad_norm(2, grads, -1.0f, &norm), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+    assert_int_equal(cgrad_storage_clip_grad_norm(2, grads, NAN, &norm), CGRAD_ERR_OPTIM_INVALID_CONFIG);
+    cgrad_storage_get(&a, (uint32_t[]){3}, 1, &v);
+    assert_float_equal(v, 1.5f, 1e-5);
+
+    cgrad_storage_free(&a);
+    cgrad_storage_free(&b);
+}
+
+static void test_cgrad_storage_zero(void **state) {
+    (void)state;
+    // large enough to be cleared by several threads
+    uint32_t shape[2] = {1024, 1031};
+    cgrad_storage a, view;
+    assert_int_equal(cgrad_storage_init(&a, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    cgrad_storage_fill(&a, 2.0f);
+    assert_int_equal(cgrad_storage_zero(&a), CGRAD_SUCCESS);
+    float v = -1.0f;
+    cgrad_storage_get(&a, (uint32_t[]){0, 0}, 2, &v);
+    assert_float_equal(v, 0.0f, 0.0);
+    cgrad_storage_get(&a, (uint32_t[]){1023, 1030}, 2, &v);
+    assert_float_equal(v, 0.0f, 0.0);
+
+    // a column range is not contiguous: only its elements are cleared
+    cgrad_storage_fill(&a, 2.0f);
+    assert_int_equal(cgrad_storage_narrow(&a, &view, -1, 1, 2), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_zero(&view), CGRAD_SUCCESS);
+    cgrad_storage_get(&a, (uint32_t[]){5, 0}, 2, &v);
+    assert_float_equal(v, 2.0f, 0.0);
+    cgrad_storage_get(&a, (uint32_t[]){5, 2}, 2, &v);
+    assert_float_equal(v, 0.0f, 0.0);
+    cgrad_storage_get(&a, (uint32_t[]){5, 3}, 2, &v);
+    assert_float_equal(v, 2.0f, 0.0);
+
+    cgrad_storage_free(&view);
+    cgrad_storage_free(&a);
+}
+
 int run_cgrad_storage_tests(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_cgrad_storage_init_and_free, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_init_errors, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_fill, storage_setup_test, storage_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_zero, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_contiguous, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_reshape, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_registry_root_freed_only_after_all_children, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_gemm_write_to_existing_tensor, storage_setup_test, storage_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_reduce, storage_setup_test, storage_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_sum_squares, storage_setup_test, storage_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_clip_grad_norm, storage_setup_test, storage_teardown_test),
     };
     return cmocka_run_group_tests_name("cgrad_storage", tests, NULL, NULL);
 }
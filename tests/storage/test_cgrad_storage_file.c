@@ -0,0 +1,198 @@
+#include <cmocka.h>
+#include "cgrad.h"
+#include "storage/cgrad_storage.h"
+#include "storage/cgrad_storage_file.h"
+#include "storage/cgrad_storage_layout.h"
+#include "cgrad_status.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/resource.h>
+
+// ============================================================================
+// Setup and Teardown
+// ============================================================================
+
+static char storage_file_path[64];
+
+static int storage_file_setup_test(void **state) {
+    (void) state;
+    cgrad_init();
+    strcpy(storage_file_path, "/tmp/cgrad_test_storage_file_XXXXXX");
+    int fd = mkstemp(storage_file_path);
+    if (fd < 0) return -1;
+    close(fd);
+    return 0;
+}
+
+static int storage_file_teardown_test(void **state) {
+    (void) state;
+    unlink(storage_file_path);
+    cgrad_cleanup();
+    return 0;
+}
+
+// Fill a 2D storage with t[i][j] = i * 10 + j
+static void storage_file_init_iota(cgrad_storage* t, uint32_t rows, uint32_t cols) {
+    uint32_t shape[2] = {rows, cols};
+    assert_int_equal(cgrad_storage_init(t, shape, 2, "cpu_f32"), CGRAD_SUCCESS);
+    for (uint32_t i = 0; i < rows; i++) {
+        for (uint32_t j = 0; j < cols; j++) {
+            uint32_t idx[2] = {i, j};
+            assert_int_equal(t->backend->storage_set(t->data, idx, 2, (float)(i * 10 + j)), CGRAD_SUCCESS);
+        }
+    }
+}
+
+static float storage_file_get(const cgrad_storage* t, uint32_t i, uint32_t j) {
+    uint32_t idx[2] = {i, j};
+    float value = -1.0f;
+    assert_int_equal(cgrad_storage_get(t, idx, 2, &value), CGRAD_SUCCESS);
+    return value;
+}
+
+static void test_cgrad_storage_file_roundtrip(void **state) {
+    (void) state;
+    cgrad_storage a, b, b_t;
+    storage_file_init_iota(&a, 3, 4);
+    storage_file_init_iota(&b, 2, 5);
+    uint32_t perm[2] = {1, 0};
+    assert_int_equal(cgrad_storage_transpose(&b, &b_t, perm, 2), CGRAD_SUCCESS);
+
+    // views are stored with their logical contents
+    const char* names[2] = {"layer.weight", "layer.bias"};
+    const cgrad_storage* storages[2] = {&a, &b_t};
+    assert_int_equal(cgrad_storage_save(storage_file_path, names, storages, 2), CGRAD_SUCCESS);
+
+    cgrad_storage_file* file = NULL;
+    assert_int_equal(cgrad_storage_file_open(storage_file_path, &file), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_file_num_tensors(file), 2);
+    assert_string_equal(cgrad_storage_file_tensor_name(file, 0), "layer.weight");
+    assert_string_equal(cgrad_storage_file_tensor_name(file, 1), "layer.bias");
+    assert_null(cgrad_storage_file_tensor_name(file, 2));
+
+    cgrad_storage w, bias, bias_copy;
+    assert_int_equal(cgrad_storage_load_mmap(file, "layer.weight", &w), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_load_mmap(file, "layer.bias", &bias), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_file_load(file, "layer.bias", &bias_copy, "cpu_f32"), CGRAD_SUCCESS);
+
+    // the mapping outlives the file handle while storages reference it
+    cgrad_storage_file_close(file);
+
+    const cgrad_storage_layout* l = bias.backend->storage_get_layout(bias.data);
+    assert_int_equal(l->shape[TENSOR_DIM - 2], 5);
+    assert_int_equal(l->shape[TENSOR_DIM - 1], 2);
+    assert_int_equal(cgrad_storage_layout_is_contiguous(l), 1);
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint32_t j = 0; j < 4; j++) {
+            assert_float_equal(storage_file_get(&w, i, j), (float)(i * 10 + j), 1e-6);
+        }
+    }
+    for (uint32_t i = 0; i < 5; i++) {
+        for (uint32_t j = 0; j < 2; j++) {
+            assert_float_equal(storage_file_get(&bias, i, j), (float)(j * 10 + i), 1e-6);
+            assert_float_equal(storage_file_get(&bias_copy, i, j), (float)(j * 10 + i), 1e-6);
+        }
+    }
+
+    // mapped storages work as op inputs, copies are writable
+    cgrad_storage sum = {0};
+    assert_int_equal(cgrad_storage_axpy(1.0f, &bias, &bias_copy, &bias_copy), CGRAD_SUCCESS);
+    assert_float_equal(storage_file_get(&bias_copy, 4, 1), 2.0f * 14.0f, 1e-6);
+    assert_int_equal(cgrad_storage_mul(1.0f, &w, &w, 0.0f, &sum), CGRAD_SUCCESS);
+    assert_float_equal(storage_file_get(&sum, 2, 3), 23.0f * 23.0f, 1e-4);
+
+    cgrad_storage_free(&sum);
+    cgrad_storage_free(&bias_copy);
+    cgrad_storage_free(&bias);
+    cgrad_storage_free(&w);
+    cgrad_storage_free(&b_t);
+    cgrad_storage_free(&b);
+    cgrad_storage_free(&a);
+}
+
+static void test_cgrad_storage_file_errors(void **state) {
+    (void) state;
+    cgrad_storage a;
+    storage_file_init_iota(&a, 2, 2);
+    const cgrad_storage* storages[2] = {&a, &a};
+
+    // names must be unique and fit the name field
+    const char* duplicate[2] = {"x", "x"};
+    assert_int_equal(cgrad_storage_save(storage_file_path, duplicate, storages, 2), CGRAD_ERR_STORAGE_FILE_INVALID);
+    char long_name[CGRAD_STORAGE_FILE_NAME_MAX + 1];
+    memset(long_name, 'a', CGRAD_STORAGE_FILE_NAME_MAX);
+    long_name[CGRAD_STORAGE_FILE_NAME_MAX] = '\0';
+    const char* too_long[1] = {long_name};
+    assert_int_equal(cgrad_storage_save(storage_file_path, too_long, storages, 1), CGRAD_ERR_STORAGE_FILE_INVALID);
+
+    // the empty file created by the setup is not a tensor file
+    cgrad_storage_file* file = NULL;
+    assert_int_equal(cgrad_storage_file_open(storage_file_path, &file), CGRAD_ERR_STORAGE_FILE_INVALID);
+    assert_null(file);
+    assert_int_equal(cgrad_storage_file_open("/nonexistent/cgrad.tensors", &file), CGRAD_ERR_STORAGE_FILE_IO);
+
+    // unknown tensor names
+    const char* names[1] = {"x"};
+    assert_int_equal(cgrad_storage_save(storage_file_path, names, storages, 1), CGRAD_SUCCESS);
+    assert_int_equal(cgrad_storage_file_open(storage_file_path, &file), CGRAD_SUCCESS);
+    cgrad_storage missing;
+    assert_int_equal(cgrad_storage_load_mmap(file, "y", &missing), CGRAD_ERR_STORAGE_FILE_TENSOR_NOT_FOUND);
+    assert_int_equal(cgrad_storage_file_load(file, "y", &missing, "cpu_f32"), CGRAD_ERR_STORAGE_FILE_TENSOR_NOT_FOUND);
+    cgrad_storage_file_close(file);
+
+    // truncated files are rejected
+    assert_int_equal(truncate(storage_file_path, 100), 0);
+    assert_int_equal(cgrad_storage_file_open(storage_file_path, &file), CGRAD_ERR_STORAGE_FILE_INVALID);
+
+    cgrad_storage_free(&a);
+}
+
+static void test_cgrad_storage_file_save_no_space(void **state) {
+    (void) state;
+    cgrad_storage a;
+    storage_file_init_iota(&a, 64, 64);
+    const cgrad_storage* storages[1] = {&a};
+    const char* names[1] = {"a"};
+
+    // a file size limit below the image size makes reserving the blocks fail like a full disk
+    struct rlimit old_limit, limit;
+    assert_int_equal(getrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    limit = old_limit;
+    limit.rlim_cur = 4096;
+    void (*old_handler)(int) = signal(SIGXFSZ, SIG_IGN);
+    assert_int_equal(setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+    cgrad_status err = cgrad_storage_save(storage_file_path, names, storages, 1);
+
+    assert_int_equal(setrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    signal(SIGXFSZ, old_handler);
+    assert_int_equal(err, CGRAD_ERR_STORAGE_FILE_IO);
+
+    // neither the temporary file nor a partial image is left behind
+    char tmp_path[sizeof(storage_file_path) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", storage_file_path);
+    assert_int_not_equal(access(tmp_path, F_OK), 0);
+    cgrad_storage_file* file = NULL;
+    assert_int_equal(cgrad_storage_file_open(storage_file_path, &file), CGRAD_ERR_STORAGE_FILE_INVALID);
+
+    cgrad_storage_free(&a);
+}
+
+int run_cgrad_storage_file_tests(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_file_roundtrip, storage_file_setup_test, storage_file_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_file_errors, storage_file_setup_test, storage_file_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_file_save_no_space, storage_file_setup_test, storage_file_teardown_test),
+    };
+    return cmocka_run_group_tests_name("cgrad_storage_file", tests, NULL, NULL);
+}
+
+#ifndef TEST_ALL_MAIN
+int main(void) {
+    return run_cgrad_storage_file_tests();
+}
+#endif
@@ -359,8 +359,8 @@ static void test_cgrad_storage_layout_broadcast(void **state) {
     assert_int_equal(cgrad_storage_layout_init(&l1, shape1, 2), 0);
     assert_int_equal(cgrad_storage_layout_init(&l2, shape2, 2), 0);
     
-    uint32_t l1_size_before = l1.size;
-    uint32_t l2_size_before = l2.size;
+    uint64_t l1_size_before = l1.size;
+    uint64_t l2_size_before = l2.size;
     assert_int_equal(l1_size_before, 4);  // 1 * 4
     assert_int_equal(l2_size_before, 12); // 3 * 4
     
@@ -480,6 +480,172 @@ static void test_cgrad_storage_layout_broadcast(void **state) {
 // Test Suite
 // ============================================================================
 
+static void test_cgrad_storage_layout_slice(void **state) {
+    (void)state;
+    cgrad_storage_layout l;
+    uint32_t shape[2] = {4, 4};
+    cgrad_storage_layout_init(&l, shape, 2);
+
+    // rows 1..2, every second column
+    uint32_t start[2] = {1, 0}, stop[2] = {3, 4}, step[2] = {1, 2};
+    assert_int_equal(cgrad_storage_layout_slice(&l, start, stop, step, 2), CGRAD_SUCCESS);
+    assert_int_equal(l.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(l.shape[TENSOR_DIM - 1], 2);
+    assert_int_equal(l.strides[TENSOR_DIM - 2], 4);
+    assert_int_equal(l.strides[TENSOR_DIM - 1], 2);
+    assert_int_equal(l.offset, 4);
+    assert_int_equal(l.size, 4);
+
+    // flat indices include the offset: element (1, 1) of the view is (2, 2) of the source
+    uint32_t idx[2] = {1, 1};
+    size_t flat = 0;
+    assert_int_equal(cgrad_storage_layout_flat_index(&l, idx, 2, &flat), CGRAD_SUCCESS);
+    assert_int_equal(flat, 2 * 4 + 2);
+
+    // invalid ranges
+    cgrad_storage_layout_init(&l, shape, 2);
+    uint32_t bad_stop[2] = {5, 4};
+    assert_int_equal(cgrad_storage_layout_slice(&l, start, bad_stop, NULL, 2), CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS);
+    uint32_t bad_step[2] = {0, 1};
+    assert_int_equal(cgrad_storage_layout_slice(&l, start, stop, bad_step, 2), CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS);
+}
+
+static void test_cgrad_storage_layout_narrow_and_select(void **state) {
+    (void)state;
+    cgrad_storage_layout l;
+    uint32_t shape[3] = {2, 4, 3};
+    cgrad_storage_layout_init(&l, shape, 3);
+
+    // narrowing the leading dim keeps the view contiguous
+    assert_int_equal(cgrad_storage_layout_narrow(&l, -3, 1, 1), CGRAD_SUCCESS);
+    assert_int_equal(l.shape[TENSOR_DIM - 3], 1);
+    assert_int_equal(l.offset, 12);
+    assert_int_equal(cgrad_storage_layout_is_contiguous(&l), 1);
+
+    // narrowing an inner dim does not
+    cgrad_storage_layout_init(&l, shape, 3);
+    assert_int_equal(cgrad_storage_layout_narrow(&l, -1, 1, 2), CGRAD_SUCCESS);
+    assert_int_equal(l.shape[TENSOR_DIM - 1], 2);
+    assert_int_equal(l.offset, 1);
+    assert_int_equal(cgrad_storage_layout_is_contiguous(&l), 0);
+    assert_int_equal(cgrad_storage_layout_narrow(&l, -1, 1, 2), CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS);
+
+    // selecting a row drops the dim and shifts the leading dims right
+    cgrad_storage_layout_init(&l, shape, 3);
+    assert_int_equal(cgrad_storage_layout_select(&l, -2, 2), CGRAD_SUCCESS);
+    assert_int_equal(l.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(l.shape[TENSOR_DIM - 1], 3);
+    assert_int_equal(l.strides[TENSOR_DIM - 2], 12);
+    assert_int_equal(l.strides[TENSOR_DIM - 1], 1);
+    assert_int_equal(l.offset, 6);
+    assert_int_equal(l.size, 6);
+    assert_int_equal(cgrad_storage_layout_select(&l, -1, 3), CGRAD_ERR_STORAGE_LAYOUT_INDEX_OUT_OF_BOUNDS);
+}
+
+static void test_cgrad_storage_layout_cat(void **state) {
+    (void)state;
+    cgrad_storage_layout a, b, out;
+    uint32_t shape_a[2] = {2, 3};
+    uint32_t shape_b[2] = {2, 5};
+    cgrad_storage_layout_init(&a, shape_a, 2);
+    cgrad_storage_layout_init(&b, shape_b, 2);
+
+    const cgrad_storage_layout* layouts[2] = {&a, &b};
+    assert_int_equal(cgrad_storage_layout_cat(layouts, 2, -1, &out), CGRAD_SUCCESS);
+    assert_int_equal(out.shape[TENSOR_DIM - 2], 2);
+    assert_int_equal(out.shape[TENSOR_DIM - 1], 8);
+    assert_int_equal(out.offset, 0);
+    assert_int_equal(cgrad_storage_layout_is_contiguous(&out), 1);
+
+    // other dims must match
+    assert_int_equal(cgrad_storage_layout_cat(layouts, 2, -2, &out), CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH);
+}
+
+static void test_cgrad_storage_layout_large(void **state) {
+    (void)state;
+    cgrad_storage_layout l;
+    // 2^16 x (2^16 + 1) elements exceed the 32 bit range (no data is allocated here)
+    uint32_t shape[2] = {65536, 65537};
+    assert_int_equal(cgrad_storage_layout_init(&l, shape, 2), CGRAD_SUCCESS);
+    assert_true(l.size == 65536ULL * 65537ULL);
+    assert_true(l.strides[TENSOR_DIM - 3] == 65536ULL * 65537ULL);
+
+    // the flat index of the last element does not wrap around
+    uint32_t last[2] = {65535, 65536};
+    size_t idx = 0;
+    assert_int_equal(cgrad_storage_layout_flat_index(&l, last, 2, &idx), CGRAD_SUCCESS);
+    assert_true(idx == 65536ULL * 65537ULL - 1);
+
+    // views keep 64 bit offsets
+    assert_int_equal(cgrad_storage_layout_narrow(&l, -2, 65535, 1), CGRAD_SUCCESS);
+    assert_true(l.offset == 65535ULL * 65537ULL);
+    assert_int_equal(cgrad_storage_layout_is_contiguous(&l), 1);
+
+    // reshape infers dims from a 64 bit size, but a single dim must still fit 32 bits
+    cgrad_storage_layout_init(&l, shape, 2);
+    assert_int_equal(cgrad_storage_layout_reshape(&l, (const int32_t[]){2, -1, 32768}, 3), CGRAD_SUCCESS);
+    assert_int_equal(l.shape[TENSOR_DIM - 2], 65537);
+    assert_true(l.strides[TENSOR_DIM - 3] == 65537ULL * 32768ULL);
+    cgrad_storage_layout_init(&l, shape, 2);
+    assert_int_equal(cgrad_storage_layout_reshape(&l, (const int32_t[]){-1}, 1), CGRAD_ERR_STORAGE_LAYOUT_RESHAPE_INVALID_SHAPE);
+}
+
+static void test_cgrad_storage_layout_collapse(void **state) {
+    (void)state;
+    cgrad_storage_layout a, b;
+    cgrad_storage_layout_collapsed c;
+    const cgrad_storage_layout* layouts[2] = {&a, &b};
+
+    // a contiguous tensor collapses to a single dim regardless of its shape
+    uint32_t shape[3] = {2, 3, 4};
+    cgrad_storage_layout_init(&a, shape, 3);
+    assert_int_equal(cgrad_storage_layout_collapse(layouts, 1, &c), CGRAD_SUCCESS);
+    assert_int_equal(c.rank, 1);
+    assert_int_equal(c.shape[0], 24);
+    assert_true(c.strides[0][0] == 1);
+
+    // transposing the last two dims keeps the leading dim mergeable only with the matching operand
+    cgrad_storage_layout_init(&b, shape, 3);
+    uint32_t perm[3] = {0, 2, 1};
+    uint32_t shape_t[3] = {2, 4, 3};
+    cgrad_storage_layout_init(&a, shape_t, 3);
+    cgrad_storage_layout_transpose(&b, perm, 3);
+    assert_int_equal(cgrad_storage_layout_collapse(layouts, 2, &c), CGRAD_SUCCESS);
+    assert_int_equal(c.rank, 3);
+    assert_int_equal(c.shape[0], 2);
+    assert_int_equal(c.shape[1], 4);
+    assert_int_equal(c.shape[2], 3);
+    assert_true(c.strides[0][2] == 1 && c.strides[0][1] == 3 && c.strides[0][0] == 12);
+    assert_true(c.strides[1][2] == 4 && c.strides[1][1] == 1 && c.strides[1][0] == 12);
+
+    // unit dims are dropped and broadcast dims merge with each other
+    uint32_t row[4] = {1, 1, 5, 6};
+    cgrad_storage_layout_init(&a, row, 4);
+    cgrad_storage_layout_init(&b, row, 4);
+    a.strides[TENSOR_DIM - 2] = 0;
+    a.strides[TENSOR_DIM - 1] = 0;
+    assert_int_equal(cgrad_storage_layout_collapse(layouts, 2, &c), CGRAD_SUCCESS);
+    assert_int_equal(c.rank, 1);
+    assert_int_equal(c.shape[0], 30);
+    assert_true(c.strides[0][0] == 0 && c.strides[1][0] == 1);
+
+    // a single element has rank 0, an empty layout rank 1 with extent 0
+    uint32_t one[1] = {1};
+    cgrad_storage_layout_init(&a, one, 1);
+    assert_int_equal(cgrad_storage_layout_collapse(layouts, 1, &c), CGRAD_SUCCESS);
+    assert_int_equal(c.rank, 0);
+    uint32_t empty[2] = {3, 0};
+    cgrad_storage_layout_init(&a, empty, 2);
+    assert_int_equal(cgrad_storage_layout_collapse(layouts, 1, &c), CGRAD_SUCCESS);
+    assert_int_equal(c.rank, 1);
+    assert_int_equal(c.shape[0], 0);
+
+    // shapes must match
+    cgrad_storage_layout_init(&a, shape, 3);
+    cgrad_storage_layout_init(&b, shape_t, 3);
+    assert_int_equal(cgrad_storage_layout_collapse(layouts, 2, &c), CGRAD_ERR_STORAGE_LAYOUT_SHAPE_MISMATCH);
+}
+
 int run_cgrad_storage_layout_tests(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_init_and_copy, layout_setup_test, layout_teardown_test),
@@ -493,6 +659,11 @@ int run_cgrad_storage_layout_tests(void) {
         cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_reshape, layout_setup_test, layout_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_reduce, layout_setup_test, layout_teardown_test),
         cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_broadcast, layout_setup_test, layout_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_slice, layout_setup_test, layout_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_narrow_and_select, layout_setup_test, layout_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_cat, layout_setup_test, layout_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_large, layout_setup_test, layout_teardown_test),
+        cmocka_unit_test_setup_teardown(test_cgrad_storage_layout_collapse, layout_setup_test, layout_teardown_test),
     };
     return cmocka_run_group_tests_name("cgrad_storage_layout", tests, NULL, NULL);
 }
@@ -0,0 +1,152 @@
+#define _GNU_SOURCE
+#include "cgrad_alloc_counter.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Counter State
+// ============================================================================
+
+static int g_counting = 0;
+static int g_interposed = 0;
+static uint64_t g_allocs = 0;
+static uint64_t g_frees = 0;
+static uint64_t g_bytes = 0;
+
+static void alloc_counter_count(uint64_t allocs, uint64_t frees, uint64_t bytes) {
+    g_interposed = 1;
+    if (!__atomic_load_n(&g_counting, __ATOMIC_RELAXED)) return;
+    if (allocs) __atomic_fetch_add(&g_allocs, allocs, __ATOMIC_RELAXED);
+    if (frees) __atomic_fetch_add(&g_frees, frees, __ATOMIC_RELAXED);
+    if (bytes) __atomic_fetch_add(&g_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+void cgrad_alloc_counter_start(void) {
+    __atomic_store_n(&g_allocs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_frees, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_counting, 1, __ATOMIC_SEQ_CST);
+}
+
+void cgrad_alloc_counter_stop(void) {
+    __atomic_store_n(&g_counting, 0, __ATOMIC_SEQ_CST);
+}
+
+int cgrad_alloc_counter_is_available(void) {
+    // call through a volatile pointer so that the pair is not optimized away
+    void* (*volatile alloc)(size_t) = malloc;
+    void (*volatile release)(void*) = free;
+    release(alloc(1));
+    return g_interposed;
+}
+
+uint64_t cgrad_alloc_counter_allocs(void) {
+    return __atomic_load_n(&g_allocs, __ATOMIC_RELAXED);
+}
+
+uint64_t cgrad_alloc_counter_frees(void) {
+    return __atomic_load_n(&g_frees, __ATOMIC_RELAXED);
+}
+
+uint64_t cgrad_alloc_counter_bytes(void) {
+    return __atomic_load_n(&g_bytes, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// Next Definitions
+// ============================================================================
+
+static void* (*g_next_malloc)(size_t) = NULL;
+static void* (*g_next_calloc)(size_t, size_t) = NULL;
+static void* (*g_next_realloc)(void*, size_t) = NULL;
+static void* (*g_next_aligned_alloc)(size_t, size_t) = NULL;
+static int (*g_next_posix_memalign)(void**, size_t, size_t) = NULL;
+static void (*g_next_free)(void*) = NULL;
+
+// dlsym itself may allocate before the next definitions are known; those requests are served
+// from a static buffer that is never freed
+static _Alignas(16) char g_bootstrap[4096];
+static size_t g_bootstrap_used = 0;
+static int g_resolving = 0;
+
+static void* alloc_counter_bootstrap(size_t size) {
+    size = (size + 15) & ~(size_t)15;
+    if (g_bootstrap_used + size > sizeof(g_bootstrap)) return NULL;
+    void* p = g_bootstrap + g_bootstrap_used;
+    g_bootstrap_used += size;
+    return p;
+}
+
+static int alloc_counter_is_bootstrap(const void* p) {
+    return (const char*)p >= g_bootstrap && (const char*)p < g_bootstrap + sizeof(g_bootstrap);
+}
+
+// Resolve the next definitions on first use; the first allocation happens before any thread is started
+static int alloc_counter_resolve(void) {
+    if (g_next_free) return 1;
+    if (g_resolving) return 0;
+    g_resolving = 1;
+    g_next_malloc = (void* (*)(size_t))dlsym(RTLD_NEXT, "malloc");
+    g_next_calloc = (void* (*)(size_t, size_t))dlsym(RTLD_NEXT, "calloc");
+    g_next_realloc = (void* (*)(void*, size_t))dlsym(RTLD_NEXT, "realloc");
+    g_next_aligned_alloc = (void* (*)(size_t, size_t))dlsym(RTLD_NEXT, "aligned_alloc");
+    g_next_posix_memalign = (int (*)(void**, size_t, size_t))dlsym(RTLD_NEXT, "posix_memalign");
+    g_next_free = (void (*)(void*))dlsym(RTLD_NEXT, "free");
+    g_resolving = 0;
+    return g_next_free != NULL;
+}
+
+// ============================================================================
+// Interposed Functions
+// ============================================================================
+
+void* malloc(size_t size) {
+    if (!alloc_counter_resolve()) return alloc_counter_bootstrap(size);
+    alloc_counter_count(1, 0, size);
+    return g_next_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (!alloc_counter_resolve()) {
+        // the bootstrap buffer is zero-initialized and never reused
+        return size && count > SIZE_MAX / size ? NULL : alloc_counter_bootstrap(count * size);
+    }
+    alloc_counter_count(1, 0, (uint64_t)count * size);
+    return g_next_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size) {
+    if (alloc_counter_is_bootstrap(p)) {
+        // move out of the bootstrap buffer; the old block holds at most the rest of the buffer
+        void* q = malloc(size);
+        if (q) {
+            size_t available = (size_t)(g_bootstrap + sizeof(g_bootstrap) - (char*)p);
+            memcpy(q, p, size < available ? size : available);
+        }
+        return q;
+    }
+    if (!alloc_counter_resolve()) return p == NULL ? alloc_counter_bootstrap(size) : NULL;
+    alloc_counter_count(1, p != NULL, size);
+    return g_next_realloc(p, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (!alloc_counter_resolve()) return NULL;
+    alloc_counter_count(1, 0, size);
+    return g_next_aligned_alloc(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (!alloc_counter_resolve()) return ENOMEM;
+    alloc_counter_count(1, 0, size);
+    return g_next_posix_memalign(out, alignment, size);
+}
+
+void free(void* p) {
+    if (p == NULL || alloc_counter_is_bootstrap(p)) return;
+    alloc_counter_count(0, 1, 0);
+    if (alloc_counter_resolve()) g_next_free(p);
+}
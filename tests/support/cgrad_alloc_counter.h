@@ -0,0 +1,54 @@
+#ifndef CGRAD_ALLOC_COUNTER_H
+#define CGRAD_ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+/**
+ * @file cgrad_alloc_counter.h
+ * @brief Heap allocation counter for the tests.
+ *
+ * tests/support/cgrad_alloc_counter.c interposes malloc, calloc, realloc, aligned_alloc,
+ * posix_memalign and free for the whole test binary and forwards them to the next definition
+ * (libc, or the sanitizer runtime). While counting, every call from any thread is counted, so
+ * a test can assert how many allocations a forward or backward step makes:
+ *
+ *     cgrad_alloc_counter_start();
+ *     step();
+ *     cgrad_alloc_counter_stop();
+ *     assert_int_equal(cgrad_alloc_counter_allocs(), 0);
+ *
+ * Allocations made by libraries the step calls into (e.g. BLAS) are counted as well.
+ */
+
+/**
+ * @brief Reset the counts and start counting.
+ */
+void cgrad_alloc_counter_start(void);
+
+/**
+ * @brief Stop counting. The counts are kept until the next start.
+ */
+void cgrad_alloc_counter_stop(void);
+
+/**
+ * @brief Check whether the allocation functions are interposed, i.e. counts are meaningful.
+ * @return 1 if interposed, 0 otherwise (e.g. in a statically linked binary).
+ */
+int cgrad_alloc_counter_is_available(void);
+
+/**
+ * @brief Number of allocations (malloc, calloc, realloc, aligned_alloc, posix_memalign) counted.
+ */
+uint64_t cgrad_alloc_counter_allocs(void);
+
+/**
+ * @brief Number of frees of non-NULL pointers counted.
+ */
+uint64_t cgrad_alloc_counter_frees(void);
+
+/**
+ * @brief Bytes requested by the counted allocations.
+ */
+uint64_t cgrad_alloc_counter_bytes(void);
+
+#endif // CGRAD_ALLOC_COUNTER_H
@@ -3,13 +3,29 @@
 #include "storage/test_cgrad_storage.c"
 #include "backends/cpu/test_cgrad_backend_cpu_f32.c"
 #include "storage/test_cgrad_storage_registry.c"
+#include "storage/test_cgrad_storage_file.c"
+#include "storage/test_cgrad_checkpoint.c"
+#include "data/test_cgrad_data_loader.c"
+#include "optim/test_cgrad_optimizer.c"
+#include "optim/test_cgrad_param_group.c"
+#include "distributed/test_cgrad_data_parallel.c"
+#include "profiler/test_cgrad_profiler.c"
+#include "profiler/test_cgrad_hooks.c"
+#include "profiler/test_cgrad_memory.c"
+#include "profiler/test_cgrad_perf.c"
 #include "autograd/test_cgrad_compute_graph.c"
 #include "autograd/test_cgrad_tensor.c"
+#include "autograd/test_cgrad_allocations.c"
 #include "autograd/ops/test_cgrad_op_axpy.c"
 #include "autograd/ops/test_cgrad_op_gemm.c"
 #include "autograd/ops/test_cgrad_op_transpose.c"
 #include "autograd/ops/test_cgrad_op_reshape.c"
 #include "autograd/ops/test_cgrad_op_reduce_sum.c"
+#include "autograd/ops/test_cgrad_op_mul.c"
+#include "autograd/ops/test_cgrad_op_unary.c"
+#include "autograd/ops/test_cgrad_op_softmax.c"
+#include "autograd/ops/test_cgrad_op_conv2d.c"
+#include "autograd/ops/test_cgrad_op_slice.c"
 
 int main(void) {
     int failed = 0;
@@ -17,12 +33,28 @@ int main(void) {
     failed |= run_cgrad_storage_tests();
     failed |= run_cgrad_backend_cpu_f32_tests();
     failed |= run_cgrad_storage_registry_tests();
+    failed |= run_cgrad_storage_file_tests();
+    failed |= run_cgrad_checkpoint_tests();
+    failed |= run_cgrad_data_loader_tests();
+    failed |= run_cgrad_optimizer_tests();
+    failed |= run_cgrad_param_group_tests();
+    failed |= run_cgrad_data_parallel_tests();
+    failed |= run_cgrad_profiler_tests();
+    failed |= run_cgrad_hooks_tests();
+    failed |= run_cgrad_memory_tests();
+    failed |= run_cgrad_perf_tests();
     failed |= run_cgrad_compute_graph_tests();
     failed |= run_cgrad_tensor_tests();
+    failed |= run_cgrad_allocations_tests();
     failed |= run_cgrad_op_axpy_tests();
     failed |= run_cgrad_op_gemm_tests();
     failed |= run_cgrad_op_transpose_tests();
     failed |= run_cgrad_op_reshape_tests();
     failed |= run_cgrad_op_reduce_sum_tests();
+    failed |= run_cgrad_op_mul_tests();
+    failed |= run_cgrad_op_unary_tests();
+    failed |= run_cgrad_op_softmax_tests();
+    failed |= run_cgrad_op_conv2d_tests();
+    failed |= run_cgrad_op_slice_tests();
     return failed;
 }